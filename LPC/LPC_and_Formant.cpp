@@ -25,9 +25,8 @@
 #include "LPC_and_Formant.h"
 #include "LPC_and_Polynomial.h"
 #include "NUM2.h"
-#include <thread>
+#include "MelderThread.h"
 #include <atomic>
-#include <vector>
 
 void Formant_Frame_init (Formant_Frame me, integer numberOfFormants) {
 	if (numberOfFormants > 0)
@@ -139,8 +138,7 @@ autoFormant LPC_to_Formant_noThreads (LPC me, double margin) {
 
 autoFormant LPC_to_Formant (LPC me, double margin) {
 	try {
-		const integer numberOfProcessors = std::thread::hardware_concurrency ();
-		if (numberOfProcessors  <= 1) {
+		if (MelderThread_getMaximumNumberOfThreads () <= 1) {
 			/*
 				We cannot use multithreading.
 			*/
@@ -169,55 +167,34 @@ autoFormant LPC_to_Formant (LPC me, double margin) {
 			Formant_Frame_init (formantFrame, maximumNumberOfFormants);
 		}
 		
-		constexpr integer maximumNumberOfThreads = 16;
-		integer numberOfThreads, numberOfFramesPerThread = 25;
-		NUMgetThreadingInfo (numberOfFrames, std::min (numberOfProcessors, maximumNumberOfThreads), & numberOfFramesPerThread, & numberOfThreads);
+		const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfFrames, 25);
 		/*
 			Reserve working memory for each thread
 		*/
-		autoPolynomial polynomials [maximumNumberOfThreads + 1];
-		autoRoots roots [maximumNumberOfThreads + 1];
+		std::vector <autoPolynomial> polynomials (uinteger (numberOfThreads + 1));   // base 1
+		std::vector <autoRoots> roots (uinteger (numberOfThreads + 1));
 		for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
 			polynomials [ithread] = Polynomial_create (-1.0, 1.0, my maxnCoefficients);
 			roots [ithread] = Roots_create (my maxnCoefficients);
 		}
 		autoMAT workspaces = newMATraw (numberOfThreads, maximumNumberOfPolynomialCoefficients * (maximumNumberOfPolynomialCoefficients + 9));
-		std::vector <std::thread> thread (numberOfThreads);
 		std::atomic<integer> numberOfSuspectFrames (0);
-		
-		try {
-			for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
-				Polynomial p = polynomials [ithread]. get ();
-				Roots r = roots [ithread]. get ();
-				Formant formant = thee. get ();
-				LPC lpc = me;
-				VEC workspace = workspaces. row (ithread);
-				const integer firstFrame = 1 + (ithread - 1) * numberOfFramesPerThread;
-				const integer lastFrame = ( ithread == numberOfThreads ? numberOfFrames : firstFrame + numberOfFramesPerThread - 1 );
 
-				thread [ithread - 1] = std::thread ([=, & numberOfSuspectFrames] () {
-					for (integer iframe = firstFrame; iframe <= lastFrame; iframe ++) {
-						const LPC_Frame lpcFrame = & lpc -> d_frames [iframe];
-						const Formant_Frame formantFrame = & formant -> frames [iframe];
-						try {
-							LPC_Frame_into_Formant_Frame_mt (lpcFrame, formantFrame, my samplingPeriod, margin, p, r, workspace);
-						} catch (MelderError) {
-							numberOfSuspectFrames ++;
-						}
-					}
-				});
-			}
-		} catch (MelderError) {
-			for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
-				if (thread [ithread - 1]. joinable ())
-					thread [ithread - 1]. join ();
+		MelderThread_parallelFor (numberOfFrames, numberOfThreads, [&] (integer ithread, integer firstFrame, integer lastFrame) {
+			Polynomial p = polynomials [ithread]. get ();
+			Roots r = roots [ithread]. get ();
+			VEC workspace = workspaces. row (ithread);
+			for (integer iframe = firstFrame; iframe <= lastFrame; iframe ++) {
+				const LPC_Frame lpcFrame = & my d_frames [iframe];
+				const Formant_Frame formantFrame = & thy frames [iframe];
+				try {
+					LPC_Frame_into_Formant_Frame_mt (lpcFrame, formantFrame, my samplingPeriod, margin, p, r, workspace);
+				} catch (MelderError) {
+					numberOfSuspectFrames ++;
+				}
 			}
-			throw;
-		}
-		for (integer ithread = 1; ithread <= numberOfThreads; ithread ++)
-			thread [ithread - 1]. join ();
-	
-				
+		});
+
 		Formant_sort (thee. get ());
 		if (numberOfSuspectFrames > 0)
 			Melder_warning ((integer) numberOfSuspectFrames, U" formant frames out of ", numberOfFrames, U" are suspect.");
@@ -29,11 +29,10 @@
 #include "Sound_extensions.h"
 #include "Vector.h"
 #include "Spectrum.h"
-#include <thread>
 #include <atomic>
-#include <functional>
 #include <vector>
 #include "NUM2.h"
+#include "MelderThread.h"
 
 #define LPC_METHOD_AUTO 1
 #define LPC_METHOD_COVAR 2
@@ -488,8 +487,7 @@ static autoLPC Sound_to_LPC_noThreads (Sound me, int predictionOrder, double ana
 }
 
 static autoLPC Sound_to_LPC (Sound me, int predictionOrder, double analysisWidth, double dt, double preEmphasisFrequency, kLPC_Analysis method, double tol1, double tol2) {
-	const integer numberOfProcessors = std::thread::hardware_concurrency ();
-	if (numberOfProcessors <= 1) {
+	if (MelderThread_getMaximumNumberOfThreads () <= 1) {
 		/*
 			We cannot use multithreading.
 		*/
@@ -521,13 +519,11 @@ static autoLPC Sound_to_LPC (Sound me, int predictionOrder, double analysisWidth
 	if (preEmphasisFrequency < samplingFrequency / 2.0)
 		Sound_preEmphasis (sound.get(), preEmphasisFrequency);
 	
-	constexpr integer maximumNumberOfThreads = 16;
-	integer numberOfThreads, numberOfFramesPerThread = 25;
-	NUMgetThreadingInfo (numberOfFrames, std::min (numberOfProcessors, maximumNumberOfThreads), & numberOfFramesPerThread, & numberOfThreads);
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfFrames, 25);
 	/*
 		We have to reserve all the needed working memory for each thread beforehand.
 	*/
-	autoSound sframe [maximumNumberOfThreads + 1];
+	std::vector <autoSound> sframe (uinteger (numberOfThreads + 1));   // base 1
 	for (integer ithread = 1; ithread <= numberOfThreads; ithread ++)
 		sframe [ithread] = Sound_createSimple (1, windowDuration, samplingFrequency);
 	
@@ -536,47 +532,31 @@ static autoLPC Sound_to_LPC (Sound me, int predictionOrder, double analysisWidth
 		U"The workspace size is not properly defined.");
 	autoMAT workspace = newMATraw (numberOfThreads, worspaceSize);
 
-	std::vector <std::thread> thread (numberOfThreads);
 	std::atomic<integer> frameErrorCount (0);
 	
-	try {
-		for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
-			Sound soundFrame = sframe [ithread]. get(), fullsound = sound.get(), windowFrame = window.get();
-			VEC threadWorkspace = workspace. row (ithread);
-			LPC lpc = thee.get();
-			const integer firstFrame = 1 + (ithread - 1) * numberOfFramesPerThread;
-			const integer lastFrame = ( ithread == numberOfThreads ? numberOfFrames : firstFrame + numberOfFramesPerThread - 1 );
-			
-			thread [ithread - 1] = std::thread ([=, & frameErrorCount]() {
-				for (integer iframe = firstFrame; iframe <= lastFrame; iframe ++) {
-					const LPC_Frame lpcframe = & lpc -> d_frames [iframe];
-					const double t = Sampled_indexToX (lpc, iframe);
-					Sound_into_Sound (fullsound, soundFrame, t - windowDuration / 2.0);
-					Vector_subtractMean (soundFrame);
-					Sounds_multiply (soundFrame, windowFrame);
-					integer status = 1;
-					if (method == kLPC_Analysis :: AUTOCORRELATION)
-						status = Sound_into_LPC_Frame_auto (soundFrame, lpcframe, threadWorkspace);
-					else if (method == kLPC_Analysis :: COVARIANCE)
-						status = Sound_into_LPC_Frame_covar (soundFrame, lpcframe, threadWorkspace);
-					else if (method == kLPC_Analysis :: BURG)
-						status = Sound_into_LPC_Frame_burg (soundFrame, lpcframe, threadWorkspace);
-					else if (method == kLPC_Analysis :: MARPLE)
-						status = Sound_into_LPC_Frame_marple (soundFrame, lpcframe, tol1, tol2, threadWorkspace);
-					if (status != 0)
-						++ frameErrorCount;
-				}
-			});
-		}
-	} catch (MelderError) {
-		for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
-			if (thread [ithread - 1]. joinable ())
-				thread [ithread - 1]. join ();
+	MelderThread_parallelFor (numberOfFrames, numberOfThreads, [&] (integer ithread, integer firstFrame, integer lastFrame) {
+		Sound soundFrame = sframe [ithread]. get(), fullsound = sound.get(), windowFrame = window.get();
+		VEC threadWorkspace = workspace. row (ithread);
+		LPC lpc = thee.get();
+		for (integer iframe = firstFrame; iframe <= lastFrame; iframe ++) {
+			const LPC_Frame lpcframe = & lpc -> d_frames [iframe];
+			const double t = Sampled_indexToX (lpc, iframe);
+			Sound_into_Sound (fullsound, soundFrame, t - windowDuration / 2.0);
+			Vector_subtractMean (soundFrame);
+			Sounds_multiply (soundFrame, windowFrame);
+			integer status = 1;
+			if (method == kLPC_Analysis :: AUTOCORRELATION)
+				status = Sound_into_LPC_Frame_auto (soundFrame, lpcframe, threadWorkspace);
+			else if (method == kLPC_Analysis :: COVARIANCE)
+				status = Sound_into_LPC_Frame_covar (soundFrame, lpcframe, threadWorkspace);
+			else if (method == kLPC_Analysis :: BURG)
+				status = Sound_into_LPC_Frame_burg (soundFrame, lpcframe, threadWorkspace);
+			else if (method == kLPC_Analysis :: MARPLE)
+				status = Sound_into_LPC_Frame_marple (soundFrame, lpcframe, tol1, tol2, threadWorkspace);
+			if (status != 0)
+				++ frameErrorCount;
 		}
-		throw;
-	}
-	for (integer ithread = 1; ithread <= numberOfThreads; ithread ++)
-		thread [ithread - 1]. join ();
+	});
 	
 	return thee;
 }
@@ -57,10 +57,10 @@ bool FileInMemoryManager_hasDirectory (FileInMemoryManager me, conststring32 nam
 		return FileInMemorySet_hasDirectory (my files.get(), name);
 }
 
-autoFileInMemoryManager FileInMemoryManager_create (FileInMemorySet files) {
+autoFileInMemoryManager FileInMemoryManager_create (autoFileInMemorySet files) {
 	try {
 		autoFileInMemoryManager me = Thing_new (FileInMemoryManager);
-		my files = Data_copy (files);
+		my files = files.move();
 		my openFiles = FileInMemorySet_create ();
 		my openFiles -> _initializeOwnership (false);
 		return me;
@@ -114,14 +114,55 @@ autoFileInMemorySet FileInMemoryManager_extractFiles (FileInMemoryManager me, kM
 	return FileInMemorySet_extractFiles (my files.get(), which, criterion);
 }
 
-static integer _FileInMemoryManager_getIndexInOpenFiles (FileInMemoryManager me, FILE *stream) {
+/*
+	espeak-ng opens, reads and closes its dictionary, phoneme and voice files many times per utterance,
+	so a stream should find its file without comparing paths.
+	The index is (re)built when it is needed after FileInMemoryManager_invalidateIndex ().
+*/
+static void _FileInMemoryManager_index (FileInMemoryManager me) {
+	if (my indexIsValid)
+		return;
+	my fileIndexOfPath. clear ();
+	my fileIndexOfPath. reserve (uinteger (my files -> size));
+	for (integer ifile = 1; ifile <= my files -> size; ifile ++) {
+		const FileInMemory fim = static_cast<FileInMemory> (my files -> at [ifile]);
+		my fileIndexOfPath. emplace (fim -> d_path.get(), ifile);   // the first of equal paths wins, as in FileInMemorySet_lookUp
+	}
+	my openFileOfStream. assign (uinteger (my files -> size + 1), nullptr);
+	for (integer iopen = 1; iopen <= my openFiles -> size; iopen ++) {
+		const FileInMemory fim = static_cast<FileInMemory> (my openFiles -> at [iopen]);
+		const auto found = my fileIndexOfPath. find (fim -> d_path.get());   // not FileInMemoryManager_lookUp (), which would index again
+		if (found != my fileIndexOfPath. end ())
+			my openFileOfStream [uinteger (found -> second)] = fim;
+	}
+	my indexIsValid = true;
+}
+
+void FileInMemoryManager_invalidateIndex (FileInMemoryManager me) {
+	my indexIsValid = false;
+}
+
+integer FileInMemoryManager_lookUp (FileInMemoryManager me, conststring32 path) {
+	_FileInMemoryManager_index (me);
+	const auto found = my fileIndexOfPath. find (path);
+	return found == my fileIndexOfPath. end () ? 0 : found -> second;
+}
+
+static FileInMemory _FileInMemoryManager_getOpenFile (FileInMemoryManager me, FILE *stream) {
 	const integer filesIndex = reinterpret_cast<integer> (stream);
 	Melder_require (filesIndex > 0 && filesIndex <= my files -> size,
 		U": Invalid file index: ", filesIndex);
+	_FileInMemoryManager_index (me);
+	return my openFileOfStream [uinteger (filesIndex)];
+}
 
-	const FileInMemory fim = static_cast<FileInMemory> (my files -> at [filesIndex]);
-	const integer openFilesIndex = FileInMemorySet_lookUp (my openFiles.get(), fim -> d_path.get());
-	return openFilesIndex;
+static integer _FileInMemoryManager_getIndexInOpenFiles (FileInMemoryManager me, FILE *stream) {
+	const FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
+	if (fim)
+		for (integer iopen = 1; iopen <= my openFiles -> size; iopen ++)
+			if (my openFiles -> at [iopen] == fim)
+				return iopen;
+	return 0;
 }
 
 /* 
@@ -174,12 +215,13 @@ FILE *FileInMemoryManager_fopen (FileInMemoryManager me, const char *filename, c
 	try {
 		integer index = 0;
 		if (*mode == 'r') { // also covers mode == 'rb'
-			index = FileInMemorySet_lookUp (my files.get(), Melder_peek8to32(filename));
+			index = FileInMemoryManager_lookUp (me, Melder_peek8to32(filename));
 			if (index > 0) {
 				const FileInMemory fim = (FileInMemory) my files -> at [index];
-				if (fim -> d_position == 0) // not open
+				if (! my openFileOfStream [uinteger (index)]) { // not open
 					my openFiles -> addItem_ref (fim);
-				else // reset position
+					my openFileOfStream [uinteger (index)] = fim;
+				} else // reset position
 					fim -> d_position = 0;
 			} else {
 				// file does not exist, set error condition?
@@ -214,9 +256,8 @@ FILE *FileInMemoryManager_fopen (FileInMemoryManager me, const char *filename, c
 	none
 */
 void FileInMemoryManager_rewind (FileInMemoryManager me, FILE *stream) {
-	const integer openFilesIndex = _FileInMemoryManager_getIndexInOpenFiles (me, stream);
-	if (openFilesIndex > 0) {
-		const FileInMemory fim = static_cast<FileInMemory> (my openFiles -> at [openFilesIndex]);
+	const FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
+	if (fim) {
 		fim -> d_position = 0;
 		fim -> d_errno = 0;
 		fim -> ungetChar = -1;
@@ -252,6 +293,7 @@ int FileInMemoryManager_fclose (FileInMemoryManager me, FILE *stream) {
 		fim -> d_errno = 0;
 		fim -> ungetChar = -1;
 		my openFiles -> removeItem (openFilesIndex);
+		my openFileOfStream [uinteger (reinterpret_cast<integer> (stream))] = nullptr;
 	}
 	return my errorNumber = 0; // always ok
 }
@@ -280,10 +322,9 @@ int FileInMemoryManager_fclose (FileInMemoryManager me, FILE *stream) {
 	Otherwise, zero is returned.
 */
 int FileInMemoryManager_feof (FileInMemoryManager me, FILE *stream) {
-	const integer openFilesIndex = _FileInMemoryManager_getIndexInOpenFiles (me, stream);
+	const FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
 	int eof = 0;
-	if (openFilesIndex > 0) {
-		const FileInMemory fim = static_cast<FileInMemory> (my openFiles -> at [openFilesIndex]);
+	if (fim) {
 		if (fim -> d_position >= fim -> d_numberOfBytes)
 			eof = 1;
 	}
@@ -329,10 +370,9 @@ int FileInMemoryManager_feof (FileInMemoryManager me, FILE *stream) {
 	If a read or write error occurs, the error indicator (ferror) is set.
 */
 int FileInMemoryManager_fseek (FileInMemoryManager me, FILE *stream, integer offset, int origin) {
-	const integer openFilesIndex = _FileInMemoryManager_getIndexInOpenFiles (me, stream);
+	const FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
 	int errval = EBADF;
-	if (openFilesIndex > 0) {
-		const FileInMemory fim = static_cast<FileInMemory> (my openFiles -> at [openFilesIndex]);
+	if (fim) {
 		integer newPosition = 0;
 		if (origin == SEEK_SET)
 			newPosition = offset;
@@ -375,11 +415,10 @@ int FileInMemoryManager_fseek (FileInMemoryManager me, FILE *stream, integer off
 	On failure, -1L is returned, and errno is set to a system-specific positive value.
 */
 integer FileInMemoryManager_ftell (FileInMemoryManager me, FILE *stream) {
-	const integer openFilesIndex = _FileInMemoryManager_getIndexInOpenFiles (me, stream);
+	const FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
 	/* int errval = EBADF; */
 	integer currentPosition = -1L;
-	if (openFilesIndex > 0) {
-		const FileInMemory fim = static_cast<FileInMemory> (my openFiles -> at [openFilesIndex]);
+	if (fim) {
 		currentPosition = fim -> d_position;
 	}
 	return currentPosition;
@@ -415,13 +454,12 @@ integer FileInMemoryManager_ftell (FileInMemoryManager me, FILE *stream) {
 	If a read error occurs, the error indicator (ferror) is set and a null pointer is also returned (but the contents pointed by str may have changed). 
  */
 char *FileInMemoryManager_fgets (FileInMemoryManager me, char *str, int num, FILE *stream) {
-	const integer openFilesIndex = _FileInMemoryManager_getIndexInOpenFiles (me, stream);
+	const FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
 	char *result = nullptr;
 	
-	Melder_require (openFilesIndex > 0,
+	Melder_require (fim,
 		U": File should be open.");
 
-	FileInMemory fim = static_cast<FileInMemory> (my openFiles -> at [openFilesIndex]);
 	integer startPos = fim -> d_position;
 	if (startPos < fim -> d_numberOfBytes) {
 		integer i = 0, endPos = startPos + num;
@@ -509,12 +547,11 @@ int FileInMemoryManager_fgetc (FileInMemoryManager me, FILE *stream) {
 	size_t is an unsigned integral type. 
 */
 size_t FileInMemoryManager_fread (FileInMemoryManager me, void *ptr, size_t size, size_t count, FILE *stream) {
-	const integer openFilesIndex = _FileInMemoryManager_getIndexInOpenFiles (me, stream);
+	const FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
 	
-	Melder_require (openFilesIndex > 0 && size > 0 && count > 0,
+	Melder_require (fim && size > 0 && count > 0,
 		U": File should be open.");
 	
-	const FileInMemory fim = static_cast<FileInMemory> (my openFiles -> at [openFilesIndex]);
 	size_t result = 0;
 	integer startPos = fim -> d_position;
 	if (startPos < fim -> d_numberOfBytes) {
@@ -572,9 +609,8 @@ size_t FileInMemoryManager_fread (FileInMemoryManager me, void *ptr, size_t size
 int FileInMemoryManager_ungetc (FileInMemoryManager me, int character, FILE * stream) {
 	int result = EOF;
 	if (character != EOF) {
-		const integer openFilesIndex = _FileInMemoryManager_getIndexInOpenFiles (me, stream);
-		if (openFilesIndex > 0) {
-			const FileInMemory fim = static_cast<FileInMemory> (my openFiles -> at [openFilesIndex]);
+		const FileInMemory fim = _FileInMemoryManager_getOpenFile (me, stream);
+		if (fim) {
 			-- (fim -> d_position);
 			result = fim -> ungetChar = character;
 		}
@@ -728,7 +764,7 @@ void test_FileInMemoryManager_io (void) {
 		Create the FileInMemoryManager and test
 	*/
 
-	autoFileInMemoryManager me = FileInMemoryManager_create (fims.get());
+	autoFileInMemoryManager me = FileInMemoryManager_create (fims.move());
 	
 	// fopen test
 	MelderInfo_writeLine (U"\tOpen file ", file1 -> path);
@@ -798,11 +834,46 @@ void test_FileInMemoryManager_io (void) {
 	MelderInfo_writeLine (U"\tEOF ? ", eof0, U" and ", eof1);
 	
 	Melder_assert (eof0 != 0 && eof1 != 0);
+	FileInMemoryManager_fclose (me.get(), f1);
+	
+	// rebuild the index while a stream is open, also in a copy
+	
+	MelderInfo_writeLine (U"\tInvalidate the index while ", file2 -> path, U" is open");
+	f2 = FileInMemoryManager_fopen (me.get(), Melder_peek32to8 (file2 -> path), "r");
+	FileInMemoryManager_invalidateIndex (me.get());
+	Melder_assert (FileInMemoryManager_lookUp (me.get(), file2 -> path) == 2);
+	char *line2 = FileInMemoryManager_fgets (me.get(), buf1, nbuf, f2);
+	Melder_assert (line2 && Melder_equ (Melder_peek8to32 (line2), lines2 [0]));
+	autoFileInMemoryManager copy = Data_copy (me.get());
+	Melder_assert (FileInMemoryManager_lookUp (copy.get(), file2 -> path) == 2);
+	Melder_assert (_FileInMemoryManager_getIndexInOpenFiles (copy.get(), f2) == 1);
+	FileInMemoryManager_fclose (me.get(), f2);
+	
+	// remove a file and add another: the number of files is unchanged, but the paths are not
+	
+	const conststring32 path3 = U"~/kanweg3.txt";
+	structMelderFile s_file3 = {};
+	const MelderFile file3 = & s_file3;
+	Melder_relativePathToFile (path3, file3);
+	f = fopen (Melder_peek32to8 (file3 -> path), "w");
+	fputs ("uvw\n", f);
+	fclose (f);
+	MelderInfo_writeLine (U"\tReplace ", file1 -> path, U" with ", file3 -> path);
+	Melder_assert (FileInMemoryManager_lookUp (me.get(), file1 -> path) == 1);
+	my files -> removeItem (1);
+	FileInMemoryManager_invalidateIndex (me.get());
+	autoFileInMemory fim3 = FileInMemory_create (file3);
+	my files -> addItem_move (fim3.move());
+	FileInMemoryManager_invalidateIndex (me.get());
+	Melder_assert (FileInMemoryManager_lookUp (me.get(), file1 -> path) == 0);
+	Melder_assert (FileInMemoryManager_lookUp (me.get(), file2 -> path) == 1);
+	Melder_assert (FileInMemoryManager_lookUp (me.get(), file3 -> path) == 2);
 	
 	//  clean up
 	
 	MelderFile_delete (file1);
 	MelderFile_delete (file2);
+	MelderFile_delete (file3);
 	
 	MelderInfo_writeLine (U"test_FileInMemoryManager_io: OK");
 }
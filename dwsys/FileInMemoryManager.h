@@ -23,9 +23,13 @@
 #include "Strings_.h"
 #include "Table.h"
 
+#include <unordered_map>
+#include <vector>
+
 #include "FileInMemoryManager_def.h"
 
-autoFileInMemoryManager FileInMemoryManager_create (FileInMemorySet files);
+autoFileInMemoryManager FileInMemoryManager_create (autoFileInMemorySet files);
+/* Takes over the files, so that their data are not copied */
 
 autoFileInMemory FileInMemoryManager_createFile (FileInMemoryManager me, MelderFile file);
 
@@ -38,6 +42,12 @@ autoFileInMemorySet FileInMemoryManager_extractFiles (FileInMemoryManager me, kM
 
 bool FileInMemoryManager_hasDirectory (FileInMemoryManager me, conststring32 name);
 
+integer FileInMemoryManager_lookUp (FileInMemoryManager me, conststring32 path);
+/* Returns the index of the file in my files, or 0 if there is no such file; in constant time, unlike FileInMemorySet_lookUp */
+
+void FileInMemoryManager_invalidateIndex (FileInMemoryManager me);
+/* To be called after every change to my files (adding, removing or replacing a file) */
+
 FILE *FileInMemoryManager_fopen (FileInMemoryManager me, const char *filename, const char *mode);
 
 void FileInMemoryManager_rewind (FileInMemoryManager me, FILE *stream);
@@ -24,6 +24,16 @@ oo_DEFINE_CLASS (FileInMemoryManager, Daata)
 	oo_INTEGER (errorNumber)
 
 	#if oo_DECLARING
+		/*
+			Not saved or copied: built from `files` when first needed (see _FileInMemoryManager_index),
+			and invalidated by FileInMemoryManager_invalidateIndex () after every change to `files`.
+			fileIndexOfPath [path] is the index of the file in `files`;
+			openFileOfStream [index] is the file if the stream with that index is open, otherwise nullptr.
+		*/
+		bool indexIsValid;
+		std::unordered_map <std::u32string, integer> fileIndexOfPath;
+		std::vector <FileInMemory> openFileOfStream;
+
 		void v_info ()
 			override;
 	#endif
@@ -1134,6 +1134,17 @@ void NUMfft_backward (NUMfft_Table table, VEC data);
 	sequence by n.
 */
 
+void NUMfft_forward_many (NUMfft_Table table, MAT const& data);
+void NUMfft_backward_many (NUMfft_Table table, MAT const& data);
+/*
+	Function:
+		Like NUMfft_forward and NUMfft_backward, applied to every row of data.
+		Several rows are transformed at once with vector instructions;
+		the results are identical to those of transforming the rows one by one.
+	Preconditions:
+		data.ncol == table -> n
+*/
+
 /**** Compatibility with NR fft's */
 
 void NUMforwardRealFastFourierTransform (VEC data);
@@ -1377,16 +1388,4 @@ void NUMeigencmp22 (double a, double b, double c, double *out_rt1, double *out_r
 
 void NUMpolynomial_recurrence (VEC const& pn, double a, double b, double c, constVEC const& pnm1, constVEC const& pnm2);
 
-
-/* 20200405 djmw This functions resides here temporarily until MelderThread.h copes with lambda's */
-static inline void NUMgetThreadingInfo (integer numberOfFrames, integer maximumNumberOfThreads, integer *inout_numberOfFramesPerThread, integer * out_numberOfThreads) {
-	if (*inout_numberOfFramesPerThread <= 0)
-		*inout_numberOfFramesPerThread = 25;
-	integer numberOfThreads = (numberOfFrames - 1) / *inout_numberOfFramesPerThread + 1;
-	Melder_clip (1_integer, & numberOfThreads, maximumNumberOfThreads);
-	*inout_numberOfFramesPerThread = (numberOfFrames - 1) / numberOfThreads + 1;
-	if (out_numberOfThreads)
-		*out_numberOfThreads = numberOfThreads;
-}
-
 #endif // _NUM2_h_
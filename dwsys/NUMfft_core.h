@@ -30,7 +30,21 @@
 
 #include "melder.h"   /* for integer */
 
-static void drfti1 (integer n, FFT_DATA_TYPE * wa, integer *ifac)
+/*
+	The includer defines FFT_DATA_TYPE, the type of the data and of the intermediate results.
+	The twiddle factors are stored as FFT_TWIDDLE_TYPE, which is FFT_DATA_TYPE by default;
+	it can differ from FFT_DATA_TYPE if FFT_DATA_TYPE is a vector type that contains
+	a number of independent transforms in its lanes, and FFT_TWIDDLE_TYPE its scalar element type.
+	This file can be included more than once (in different namespaces);
+	define FFT_NO_INITIALIZATION to leave out the computation of the twiddle factors.
+*/
+#ifndef FFT_TWIDDLE_TYPE
+	#define FFT_TWIDDLE_TYPE  FFT_DATA_TYPE
+#endif
+
+#ifndef FFT_NO_INITIALIZATION
+
+static void drfti1 (integer n, FFT_TWIDDLE_TYPE * wa, integer *ifac)
 {
 	static constexpr integer ntryh[4] = { 4, 2, 3, 5 };
 	static constexpr double tpi = 6.28318530717958647692528676655900577;
@@ -106,7 +120,7 @@ static void drfti1 (integer n, FFT_DATA_TYPE * wa, integer *ifac)
 	}
 }
 
-static void NUMrffti (integer n, FFT_DATA_TYPE * wsave, integer *ifac)
+static void NUMrffti (integer n, FFT_TWIDDLE_TYPE * wsave, integer *ifac)
 {
 	if (n == 1)
 		return;
@@ -121,7 +135,9 @@ static void NUMrffti (integer n, FFT_DATA_TYPE * wsave, integer *ifac)
 
    NUMrffti(n, wsave+n,ifac); } */
 
-static void dradf2 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE * ch, FFT_DATA_TYPE * wa1)
+#endif // ! FFT_NO_INITIALIZATION
+
+static void dradf2 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE * ch, FFT_TWIDDLE_TYPE * wa1)
 {
 	integer t1 = 0;
 	integer t2, t0 = (t2 = l1 * ido);
@@ -153,8 +169,8 @@ static void dradf2 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE *
 			t4 -= 2;
 			t5 += 2;
 			t6 += 2;
-			const double tr2 = wa1[i - 2] * cc[t3 - 1] + wa1[i - 1] * cc[t3];
-			const double ti2 = wa1[i - 2] * cc[t3] - wa1[i - 1] * cc[t3 - 1];
+			const FFT_DATA_TYPE tr2 = wa1[i - 2] * cc[t3 - 1] + wa1[i - 1] * cc[t3];
+			const FFT_DATA_TYPE ti2 = wa1[i - 2] * cc[t3] - wa1[i - 1] * cc[t3 - 1];
 			ch[t6] = cc[t5] + ti2;
 			ch[t4] = ti2 - cc[t5];
 			ch[t6 - 1] = cc[t5 - 1] + tr2;
@@ -180,8 +196,8 @@ static void dradf2 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE *
 	}
 }
 
-static void dradf4 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE * ch, FFT_DATA_TYPE * wa1,
-	FFT_DATA_TYPE * wa2, FFT_DATA_TYPE * wa3)
+static void dradf4 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE * ch, FFT_TWIDDLE_TYPE * wa1,
+	FFT_TWIDDLE_TYPE * wa2, FFT_TWIDDLE_TYPE * wa3)
 {
 	static constexpr double hsqt2 = .70710678118654752440084436210485;
 	integer t5, t6;
@@ -195,8 +211,8 @@ static void dradf4 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE *
 
 	for (integer k = 0; k < l1; k++)
 	{
-		const double tr1 = cc[t1] + cc[t2];
-		const double tr2 = cc[t3] + cc[t4];
+		const FFT_DATA_TYPE tr1 = cc[t1] + cc[t2];
+		const FFT_DATA_TYPE tr2 = cc[t3] + cc[t4];
 		ch[t5 = t3 << 2] = tr1 + tr2;
 		ch[(ido << 2) + t5 - 1] = tr2 - tr1;
 		ch[(t5 += (ido << 1)) - 1] = cc[t3] - cc[t4];
@@ -226,23 +242,23 @@ static void dradf4 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE *
 			t5 -= 2;
 
 			t3 += t0;
-			const double cr2 = wa1[i - 2] * cc[t3 - 1] + wa1[i - 1] * cc[t3];
-			const double ci2 = wa1[i - 2] * cc[t3] - wa1[i - 1] * cc[t3 - 1];
+			const FFT_DATA_TYPE cr2 = wa1[i - 2] * cc[t3 - 1] + wa1[i - 1] * cc[t3];
+			const FFT_DATA_TYPE ci2 = wa1[i - 2] * cc[t3] - wa1[i - 1] * cc[t3 - 1];
 			t3 += t0;
-			const double cr3 = wa2[i - 2] * cc[t3 - 1] + wa2[i - 1] * cc[t3];
-			const double ci3 = wa2[i - 2] * cc[t3] - wa2[i - 1] * cc[t3 - 1];
+			const FFT_DATA_TYPE cr3 = wa2[i - 2] * cc[t3 - 1] + wa2[i - 1] * cc[t3];
+			const FFT_DATA_TYPE ci3 = wa2[i - 2] * cc[t3] - wa2[i - 1] * cc[t3 - 1];
 			t3 += t0;
-			const double cr4 = wa3[i - 2] * cc[t3 - 1] + wa3[i - 1] * cc[t3];
-			const double ci4 = wa3[i - 2] * cc[t3] - wa3[i - 1] * cc[t3 - 1];
-
-			const double tr1 = cr2 + cr4;
-			const double tr4 = cr4 - cr2;
-			const double ti1 = ci2 + ci4;
-			const double ti4 = ci2 - ci4;
-			const double ti2 = cc[t2] + ci3;
-			const double ti3 = cc[t2] - ci3;
-			const double tr2 = cc[t2 - 1] + cr3;
-			const double tr3 = cc[t2 - 1] - cr3;
+			const FFT_DATA_TYPE cr4 = wa3[i - 2] * cc[t3 - 1] + wa3[i - 1] * cc[t3];
+			const FFT_DATA_TYPE ci4 = wa3[i - 2] * cc[t3] - wa3[i - 1] * cc[t3 - 1];
+
+			const FFT_DATA_TYPE tr1 = cr2 + cr4;
+			const FFT_DATA_TYPE tr4 = cr4 - cr2;
+			const FFT_DATA_TYPE ti1 = ci2 + ci4;
+			const FFT_DATA_TYPE ti4 = ci2 - ci4;
+			const FFT_DATA_TYPE ti2 = cc[t2] + ci3;
+			const FFT_DATA_TYPE ti3 = cc[t2] - ci3;
+			const FFT_DATA_TYPE tr2 = cc[t2 - 1] + cr3;
+			const FFT_DATA_TYPE tr3 = cc[t2 - 1] - cr3;
 
 			ch[t4 - 1] = tr1 + tr2;
 			ch[t4] = ti1 + ti2;
@@ -271,8 +287,8 @@ static void dradf4 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE *
 
 	for (integer k = 0; k < l1; k++)
 	{
-		const double ti1 = -hsqt2 * (cc[t1] + cc[t2]);
-		const double tr1 = hsqt2 * (cc[t1] - cc[t2]);
+		const FFT_DATA_TYPE ti1 = -hsqt2 * (cc[t1] + cc[t2]);
+		const FFT_DATA_TYPE tr1 = hsqt2 * (cc[t1] - cc[t2]);
 		ch[t4 - 1] = tr1 + cc[t6 - 1];
 		ch[t4 + t5 - 1] = cc[t6 - 1] - tr1;
 		ch[t4] = ti1 - cc[t1 + t0];
@@ -285,7 +301,7 @@ static void dradf4 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE *
 }
 
 static void dradfg (integer ido, integer ip, integer l1, integer idl1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE * c1,
-	FFT_DATA_TYPE * c2, FFT_DATA_TYPE * ch, FFT_DATA_TYPE * ch2, FFT_DATA_TYPE * wa)
+	FFT_DATA_TYPE * c2, FFT_DATA_TYPE * ch, FFT_DATA_TYPE * ch2, FFT_TWIDDLE_TYPE * wa)
 {
 
 	static constexpr double tpi = 6.28318530717958647692528676655900577;
@@ -629,7 +645,7 @@ static void dradfg (integer ido, integer ip, integer l1, integer idl1, FFT_DATA_
 	}
 }
 
-static void drftf1 (integer n, FFT_DATA_TYPE * c, FFT_DATA_TYPE * ch, FFT_DATA_TYPE * wa, integer *ifac)
+static void drftf1 (integer n, FFT_DATA_TYPE * c, FFT_DATA_TYPE * ch, FFT_TWIDDLE_TYPE * wa, integer *ifac)
 {
 	const integer nf = ifac[1];
 	integer na = 1;
@@ -696,7 +712,7 @@ static void drftf1 (integer n, FFT_DATA_TYPE * c, FFT_DATA_TYPE * ch, FFT_DATA_T
 		c[i] = ch[i];
 }
 
-static void dradb2 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE * ch, FFT_DATA_TYPE * wa1)
+static void dradb2 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE * ch, FFT_TWIDDLE_TYPE * wa1)
 {
 	const integer t0 = l1 * ido;
 
@@ -729,9 +745,9 @@ static void dradb2 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE *
 			t5 -= 2;
 			t6 += 2;
 			ch[t3 - 1] = cc[t4 - 1] + cc[t5 - 1];
-			const double tr2 = cc[t4 - 1] - cc[t5 - 1];
+			const FFT_DATA_TYPE tr2 = cc[t4 - 1] - cc[t5 - 1];
 			ch[t3] = cc[t4] - cc[t5];
-			const double ti2 = cc[t4] + cc[t5];
+			const FFT_DATA_TYPE ti2 = cc[t4] + cc[t5];
 			ch[t6 - 1] = wa1[i - 2] * tr2 - wa1[i - 1] * ti2;
 			ch[t6] = wa1[i - 2] * ti2 + wa1[i - 1] * tr2;
 		}
@@ -753,8 +769,8 @@ static void dradb2 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE *
 	}
 }
 
-static void dradb3 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE * ch, FFT_DATA_TYPE * wa1,
-	FFT_DATA_TYPE * wa2)
+static void dradb3 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE * ch, FFT_TWIDDLE_TYPE * wa1,
+	FFT_TWIDDLE_TYPE * wa2)
 {
 	static constexpr double taur = -.5;
 	static constexpr double taui = .86602540378443864676372317075293618;
@@ -768,10 +784,10 @@ static void dradb3 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE *
 	integer t5 = 0;
 	for (integer k = 0; k < l1; k++)
 	{
-		const double tr2 = cc[t3 - 1] + cc[t3 - 1];
-		const double cr2 = cc[t5] + (taur * tr2);
+		const FFT_DATA_TYPE tr2 = cc[t3 - 1] + cc[t3 - 1];
+		const FFT_DATA_TYPE cr2 = cc[t5] + (taur * tr2);
 		ch[t1] = cc[t5] + tr2;
-		const double ci3 = taui * (cc[t3] + cc[t3]);
+		const FFT_DATA_TYPE ci3 = taui * (cc[t3] + cc[t3]);
 		ch[t1 + t0] = cr2 - ci3;
 		ch[t1 + t2] = cr2 + ci3;
 		t1 += ido;
@@ -799,18 +815,18 @@ static void dradb3 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE *
 			t8 += 2;
 			t9 += 2;
 			t10 += 2;
-			const double tr2 = cc[t5 - 1] + cc[t6 - 1];
-			const double cr2 = cc[t7 - 1] + (taur * tr2);
+			const FFT_DATA_TYPE tr2 = cc[t5 - 1] + cc[t6 - 1];
+			const FFT_DATA_TYPE cr2 = cc[t7 - 1] + (taur * tr2);
 			ch[t8 - 1] = cc[t7 - 1] + tr2;
-			const double ti2 = cc[t5] - cc[t6];
-			const double ci2 = cc[t7] + (taur * ti2);
+			const FFT_DATA_TYPE ti2 = cc[t5] - cc[t6];
+			const FFT_DATA_TYPE ci2 = cc[t7] + (taur * ti2);
 			ch[t8] = cc[t7] + ti2;
-			const double cr3 = taui * (cc[t5 - 1] - cc[t6 - 1]);
-			const double ci3 = taui * (cc[t5] + cc[t6]);
-			const double dr2 = cr2 - ci3;
-			const double dr3 = cr2 + ci3;
-			const double di2 = ci2 + cr3;
-			const double di3 = ci2 - cr3;
+			const FFT_DATA_TYPE cr3 = taui * (cc[t5 - 1] - cc[t6 - 1]);
+			const FFT_DATA_TYPE ci3 = taui * (cc[t5] + cc[t6]);
+			const FFT_DATA_TYPE dr2 = cr2 - ci3;
+			const FFT_DATA_TYPE dr3 = cr2 + ci3;
+			const FFT_DATA_TYPE di2 = ci2 + cr3;
+			const FFT_DATA_TYPE di3 = ci2 - cr3;
 			ch[t9 - 1] = wa1[i - 2] * dr2 - wa1[i - 1] * di2;
 			ch[t9] = wa1[i - 2] * di2 + wa1[i - 1] * dr2;
 			ch[t10 - 1] = wa2[i - 2] * dr3 - wa2[i - 1] * di3;
@@ -820,8 +836,8 @@ static void dradb3 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE *
 	}
 }
 
-static void dradb4 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE * ch, FFT_DATA_TYPE * wa1,
-	FFT_DATA_TYPE * wa2, FFT_DATA_TYPE * wa3)
+static void dradb4 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE * ch, FFT_TWIDDLE_TYPE * wa1,
+	FFT_TWIDDLE_TYPE * wa2, FFT_TWIDDLE_TYPE * wa3)
 {
 	static constexpr double sqrt2 = 1.4142135623730950488016887242097;
 
@@ -835,10 +851,10 @@ static void dradb4 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE *
 	{
 		t4 = t3 + t6;
 		t5 = t1;
-		const double tr3 = cc[t4 - 1] + cc[t4 - 1];
-		const double tr4 = cc[t4] + cc[t4];
-		const double tr1 = cc[t3] - cc[(t4 += t6) - 1];
-		const double tr2 = cc[t3] + cc[t4 - 1];
+		const FFT_DATA_TYPE tr3 = cc[t4 - 1] + cc[t4 - 1];
+		const FFT_DATA_TYPE tr4 = cc[t4] + cc[t4];
+		const FFT_DATA_TYPE tr1 = cc[t3] - cc[(t4 += t6) - 1];
+		const FFT_DATA_TYPE tr2 = cc[t3] + cc[t4 - 1];
 		ch[t5] = tr2 + tr3;
 		ch[t5 += t0] = tr1 - tr4;
 		ch[t5 += t0] = tr2 - tr3;
@@ -864,22 +880,22 @@ static void dradb4 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE *
 			t4 -= 2;
 			t5 -= 2;
 			t7 += 2;
-			const double ti1 = cc[t2] + cc[t5];
-			const double ti2 = cc[t2] - cc[t5];
-			const double ti3 = cc[t3] - cc[t4];
-			const double tr4 = cc[t3] + cc[t4];
-			const double tr1 = cc[t2 - 1] - cc[t5 - 1];
-			const double tr2 = cc[t2 - 1] + cc[t5 - 1];
-			const double ti4 = cc[t3 - 1] - cc[t4 - 1];
-			const double tr3 = cc[t3 - 1] + cc[t4 - 1];
+			const FFT_DATA_TYPE ti1 = cc[t2] + cc[t5];
+			const FFT_DATA_TYPE ti2 = cc[t2] - cc[t5];
+			const FFT_DATA_TYPE ti3 = cc[t3] - cc[t4];
+			const FFT_DATA_TYPE tr4 = cc[t3] + cc[t4];
+			const FFT_DATA_TYPE tr1 = cc[t2 - 1] - cc[t5 - 1];
+			const FFT_DATA_TYPE tr2 = cc[t2 - 1] + cc[t5 - 1];
+			const FFT_DATA_TYPE ti4 = cc[t3 - 1] - cc[t4 - 1];
+			const FFT_DATA_TYPE tr3 = cc[t3 - 1] + cc[t4 - 1];
 			ch[t7 - 1] = tr2 + tr3;
-			const double cr3 = tr2 - tr3;
+			const FFT_DATA_TYPE cr3 = tr2 - tr3;
 			ch[t7] = ti2 + ti3;
-			const double ci3 = ti2 - ti3;
-			const double cr2 = tr1 - tr4;
-			const double cr4 = tr1 + tr4;
-			const double ci2 = ti1 + ti4;
-			const double ci4 = ti1 - ti4;
+			const FFT_DATA_TYPE ci3 = ti2 - ti3;
+			const FFT_DATA_TYPE cr2 = tr1 - tr4;
+			const FFT_DATA_TYPE cr4 = tr1 + tr4;
+			const FFT_DATA_TYPE ci2 = ti1 + ti4;
+			const FFT_DATA_TYPE ci4 = ti1 - ti4;
 
 			ch[(t8 = t7 + t0) - 1] = wa1[i - 2] * cr2 - wa1[i - 1] * ci2;
 			ch[t8] = wa1[i - 2] * ci2 + wa1[i - 1] * cr2;
@@ -903,10 +919,10 @@ static void dradb4 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE *
 	for (integer k = 0; k < l1; k++)
 	{
 		t5 = t3;
-		const double ti1 = cc[t1] + cc[t4];
-		const double ti2 = cc[t4] - cc[t1];
-		const double tr1 = cc[t1 - 1] - cc[t4 - 1];
-		const double tr2 = cc[t1 - 1] + cc[t4 - 1];
+		const FFT_DATA_TYPE ti1 = cc[t1] + cc[t4];
+		const FFT_DATA_TYPE ti2 = cc[t4] - cc[t1];
+		const FFT_DATA_TYPE tr1 = cc[t1 - 1] - cc[t4 - 1];
+		const FFT_DATA_TYPE tr2 = cc[t1 - 1] + cc[t4 - 1];
 		ch[t5] = tr2 + tr2;
 		ch[t5 += t0] = sqrt2 * (tr1 - ti1);
 		ch[t5 += t0] = ti2 + ti2;
@@ -919,7 +935,7 @@ static void dradb4 (integer ido, integer l1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE *
 }
 
 static void dradbg (integer ido, integer ip, integer l1, integer idl1, FFT_DATA_TYPE * cc, FFT_DATA_TYPE * c1,
-	FFT_DATA_TYPE * c2, FFT_DATA_TYPE * ch, FFT_DATA_TYPE * ch2, FFT_DATA_TYPE * wa)
+	FFT_DATA_TYPE * c2, FFT_DATA_TYPE * ch, FFT_DATA_TYPE * ch2, FFT_TWIDDLE_TYPE * wa)
 {
 	static constexpr double tpi = 6.28318530717958647692528676655900577;
 	integer is, t1, t2, t3, t4, t5, t6, t7, t8, t9, t11, t12;
@@ -1270,7 +1286,7 @@ static void dradbg (integer ido, integer ip, integer l1, integer idl1, FFT_DATA_
 	}
 }
 
-static void drftb1 (integer n, FFT_DATA_TYPE * c, FFT_DATA_TYPE * ch, FFT_DATA_TYPE * wa, integer *ifac)
+static void drftb1 (integer n, FFT_DATA_TYPE * c, FFT_DATA_TYPE * ch, FFT_TWIDDLE_TYPE * wa, integer *ifac)
 {
 	const integer nf = ifac[1];
 	integer na = 0;
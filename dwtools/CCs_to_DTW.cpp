@@ -44,82 +44,174 @@ static void regression (VEC r, CC me, integer frameNumber, integer numberOfCoeff
 		longdouble ri = 0.0;
 		for (integer j = -numberOfCoefficientsd2; j <= numberOfCoefficientsd2; j ++) {
 			const CC_Frame cf = & my frame [frameNumber + j];
-			const double c = ( i == 1 ? cf -> c0 : cf -> c [i] );
+			const double c = ( i == 1 ? cf -> c0 : cf -> c [i - 1] );   // r [i] is the regression of c [i - 1]
 			ri += c * j;
 		}
 		r [i] = double (ri) / sumsq / my dx;
 	}
 }
 
-autoDTW CCs_to_DTW (CC me, CC thee, double coefficientWeight, double logEnergyWeight, double coefficientRegressionWeight, double logEnergyRegressionWeight, double regressionWindowLength) {
-	try {
-		integer numberOfCoefficients = Melder_ifloor (regressionWindowLength / my dx);
-		
-		Melder_require (my maximumNumberOfCoefficients == thy maximumNumberOfCoefficients,
-			U"The maximum number of coefficients should be equal.");
-		Melder_require (! (coefficientRegressionWeight != 0.0 && numberOfCoefficients < 2),
-			U"Time window for regression is too small.");
-
-		if (numberOfCoefficients % 2 == 0)
-			numberOfCoefficients ++;
-
-		autoDTW him = DTW_create (my xmin, my xmax, my nx, my dx, my x1, thy xmin, thy xmax, thy nx, thy dx, thy x1);
-		autoVEC ri = newVECraw (my maximumNumberOfCoefficients + 1);
-		autoVEC rj = newVECraw (my maximumNumberOfCoefficients + 1);
-
-		/* Calculate distance matrix. */
-
-		autoMelderProgress progess (U"CCs_to_DTW");
-		for (integer iframe = 1; iframe <= my nx; iframe ++) {
-			const CC_Frame fi = & my frame [iframe];
-
-			regression (ri.get(), me, iframe, numberOfCoefficients);
-
-			for (integer jframe = 1; jframe <= thy nx; jframe ++) {
-				const CC_Frame fj = & thy frame [jframe];
-				longdouble dist = 0.0;
-
-				if (coefficientWeight != 0.0) {
-					for (integer k = 1; k <= fj -> numberOfCoefficients; k ++) {
-						const double d = fi -> c [k] - fj -> c [k];
-						dist += d * d;
-					}
-					dist *= coefficientWeight;
-				}
-
-				if (logEnergyWeight != 0.0) {
-					const double d = fi -> c0 - fj -> c0;
-					dist += logEnergyWeight * d * d;
-				}
+/*
+	The regression coefficients of every frame.
+	Near the edges, where the regression window does not fit, `regression` leaves its result as it is,
+	so that the frame-by-frame computation used those of the last frame where the window did fit;
+	we do the same.
+*/
+static autoMAT CC_getRegressions (CC me, integer numberOfCoefficients) {
+	autoMAT regressions = newMATzero (my nx, my maximumNumberOfCoefficients + 1);
+	const integer numberOfCoefficientsd2 = numberOfCoefficients / 2;
+	const integer firstFrame = numberOfCoefficientsd2 + 1, lastFrame = my nx - numberOfCoefficientsd2 - 1;
+	if (firstFrame > lastFrame)
+		return regressions;
+	for (integer iframe = firstFrame; iframe <= lastFrame; iframe ++)
+		regression (regressions.row (iframe), me, iframe, numberOfCoefficients);
+	for (integer iframe = 1; iframe < firstFrame; iframe ++)
+		regressions.row (iframe) <<= regressions.row (lastFrame);
+	for (integer iframe = lastFrame + 1; iframe <= my nx; iframe ++)
+		regressions.row (iframe) <<= regressions.row (lastFrame);
+	return regressions;
+}
 
-				if (coefficientRegressionWeight != 0.0) {
-					longdouble distr = 0.0;
-					regression (rj.get(), thee, jframe, numberOfCoefficients);
-					for (integer k = 2; k <= fj -> numberOfCoefficients + 1; k ++) {
-						const double d = ri [k] - rj [k];
-						distr += d * d;
-					}
-					dist += coefficientRegressionWeight * distr;
+/*
+	The distance between two frames as computed frame by frame before:
+	a sum of squares per group of features (the coefficients, the log energy, the regression coefficients
+	and the log energy regression), over the number of coefficients of the candidate frame,
+	each group weighted once, divided by the sum of the weights.
+	Each row of the feature matrices holds c [1..maximumNumberOfCoefficients], c0,
+	the regression coefficients r [2..maximumNumberOfCoefficients + 1], and r [1].
+*/
+struct CCs_Distances {
+	autoMAT prototype, candidate;
+	autoINTVEC candidateNumberOfCoefficients;
+	integer maximumNumberOfCoefficients;
+	double coefficientWeight, logEnergyWeight, coefficientRegressionWeight, logEnergyRegressionWeight;
+	void getColumn (integer icol, integer fromRow, integer toRow, VEC result) const {
+		constVEC y = candidate.row (icol);
+		const integer numberOfCoefficients = candidateNumberOfCoefficients [icol];
+		const integer c0 = maximumNumberOfCoefficients + 1, r1 = 2 * maximumNumberOfCoefficients + 2;
+		for (integer irow = fromRow; irow <= toRow; irow ++) {
+			constVEC x = prototype.row (irow);
+			longdouble dist = 0.0;
+			if (coefficientWeight != 0.0) {
+				for (integer k = 1; k <= numberOfCoefficients; k ++) {
+					const double d = x [k] - y [k];
+					dist += d * d;
 				}
-
-				if (logEnergyRegressionWeight != 0.0) {
-					if (coefficientRegressionWeight == 0.0)
-						regression (rj.get(), thee, jframe, numberOfCoefficients);
-					const double d = ri [1] - rj [1];
-					dist += logEnergyRegressionWeight * d * d;
+				dist *= coefficientWeight;
+			}
+			if (logEnergyWeight != 0.0) {
+				const double d = x [c0] - y [c0];
+				dist += logEnergyWeight * d * d;
+			}
+			if (coefficientRegressionWeight != 0.0) {
+				longdouble distr = 0.0;
+				for (integer k = c0 + 1; k <= c0 + numberOfCoefficients; k ++) {
+					const double d = x [k] - y [k];
+					distr += d * d;
 				}
+				dist += coefficientRegressionWeight * distr;
+			}
+			if (logEnergyRegressionWeight != 0.0) {
+				const double d = x [r1] - y [r1];
+				dist += logEnergyRegressionWeight * d * d;
+			}
+			dist /= coefficientWeight + logEnergyWeight + coefficientRegressionWeight + logEnergyRegressionWeight;
+			result [irow - fromRow + 1] = sqrt ((double) dist);   // prototype along y-direction
+		}
+	}
+};
+
+static CCs_Distances CCs_getDistances (CC me, CC thee, double coefficientWeight, double logEnergyWeight, double coefficientRegressionWeight, double logEnergyRegressionWeight, double regressionWindowLength) {
+	integer numberOfCoefficients = Melder_ifloor (regressionWindowLength / my dx);
+
+	Melder_require (my maximumNumberOfCoefficients == thy maximumNumberOfCoefficients,
+		U"The maximum number of coefficients should be equal.");
+	Melder_require (! (coefficientRegressionWeight != 0.0 && numberOfCoefficients < 2),
+		U"Time window for regression is too small.");
+
+	if (numberOfCoefficients % 2 == 0)
+		numberOfCoefficients ++;
+
+	const integer maximumNumberOfCoefficients = my maximumNumberOfCoefficients;
+	const bool useRegressions = ( coefficientRegressionWeight != 0.0 || logEnergyRegressionWeight != 0.0 );
+	CCs_Distances distances;
+	distances.maximumNumberOfCoefficients = maximumNumberOfCoefficients;
+	distances.coefficientWeight = coefficientWeight;
+	distances.logEnergyWeight = logEnergyWeight;
+	distances.coefficientRegressionWeight = coefficientRegressionWeight;
+	distances.logEnergyRegressionWeight = logEnergyRegressionWeight;
+
+	auto getFeatures = [&] (CC cc) -> autoMAT {
+		autoMAT regressions;
+		if (useRegressions)
+			regressions = CC_getRegressions (cc, numberOfCoefficients);
+		autoMAT features = newMATzero (cc -> nx, 2 * maximumNumberOfCoefficients + 2);
+		for (integer iframe = 1; iframe <= cc -> nx; iframe ++) {
+			const CC_Frame frame = & cc -> frame [iframe];
+			VEC f = features.row (iframe);
+			f.part (1, frame -> numberOfCoefficients) <<= frame -> c.all();
+			f [maximumNumberOfCoefficients + 1] = frame -> c0;
+			if (useRegressions) {
+				f.part (maximumNumberOfCoefficients + 2, 2 * maximumNumberOfCoefficients + 1) <<=
+						regressions.row (iframe).part (2, maximumNumberOfCoefficients + 1);
+				f [2 * maximumNumberOfCoefficients + 2] = regressions [iframe] [1];
+			}
+		}
+		return features;
+	};
+	distances.prototype = getFeatures (me);
+	distances.candidate = getFeatures (thee);
+	distances.candidateNumberOfCoefficients = newINTVECraw (thy nx);
+	for (integer iframe = 1; iframe <= thy nx; iframe ++)
+		distances.candidateNumberOfCoefficients [iframe] = thy frame [iframe]. numberOfCoefficients;
+	return distances;
+}
 
-				dist /= coefficientWeight + logEnergyWeight + coefficientRegressionWeight + logEnergyRegressionWeight;
-				his z [iframe] [jframe] = sqrt ((double) dist);   // prototype along y-direction
+autoDTW CCs_to_DTW (CC me, CC thee, double coefficientWeight, double logEnergyWeight, double coefficientRegressionWeight, double logEnergyRegressionWeight, double regressionWindowLength) {
+	try {
+		const CCs_Distances distances = CCs_getDistances (me, thee, coefficientWeight, logEnergyWeight,
+				coefficientRegressionWeight, logEnergyRegressionWeight, regressionWindowLength);
+		autoDTW him = DTW_create (my xmin, my xmax, my nx, my dx, my x1, thy xmin, thy xmax, thy nx, thy dx, thy x1);
+		DTW_computeDistances (him.get(),
+			[&] (integer icol, integer fromRow, integer toRow, VEC result) {
+				distances.getColumn (icol, fromRow, toRow, result);
 			}
+		);
+		return him;
+	} catch (MelderError) {
+		Melder_throw (U"DTW not created from CCs.");
+	}
+}
 
-			if (iframe % 10 == 1)
-				Melder_progress (0.999 * iframe / my nx, U"Calculate distances: frame ", iframe, U" from ", my nx, U".");
-		}
+autoDTW CCs_to_DTW_bandAndSlope (CC me, CC thee, double coefficientWeight, double logEnergyWeight, double coefficientRegressionWeight, double logEnergyRegressionWeight, double regressionWindowLength, double sakoeChibaBand, int localSlope) {
+	try {
+		const CCs_Distances distances = CCs_getDistances (me, thee, coefficientWeight, logEnergyWeight,
+				coefficientRegressionWeight, logEnergyRegressionWeight, regressionWindowLength);
+		autoDTW him = DTW_create (my xmin, my xmax, my nx, my dx, my x1, thy xmin, thy xmax, thy nx, thy dx, thy x1);
+		DTW_computeDistances (him.get(),
+			[&] (integer icol, integer fromRow, integer toRow, VEC result) {
+				distances.getColumn (icol, fromRow, toRow, result);
+			}
+		);
+		DTW_findPath_bandAndSlope (him.get(), sakoeChibaBand, localSlope, nullptr);
 		return him;
 	} catch (MelderError) {
 		Melder_throw (U"DTW not created from CCs.");
 	}
 }
 
+double CCs_getDTWDistance_bandAndSlope (CC me, CC thee, double coefficientWeight, double logEnergyWeight, double coefficientRegressionWeight, double logEnergyRegressionWeight, double regressionWindowLength, double sakoeChibaBand, int localSlope, double maximumDistance) {
+	try {
+		const CCs_Distances distances = CCs_getDistances (me, thee, coefficientWeight, logEnergyWeight,
+				coefficientRegressionWeight, logEnergyRegressionWeight, regressionWindowLength);
+		return Sampleds_getDTWDistance_bandAndSlope (me, thee, sakoeChibaBand, localSlope, maximumDistance,
+			[&] (integer icol, integer fromRow, integer toRow, VEC result) {
+				distances.getColumn (icol, fromRow, toRow, result);
+			}
+		);
+	} catch (MelderError) {
+		Melder_throw (me, U" & ", thee, U": DTW distance not computed.");
+	}
+}
+
 /* End of file CCs_to_DTW.cpp */
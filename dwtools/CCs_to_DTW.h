@@ -49,4 +49,15 @@ autoDTW CCs_to_DTW (CC me, CC thee, double coefficientWeight, double logEnergyWe
 	at least one of the four weights != 0
 */
 
+autoDTW CCs_to_DTW_bandAndSlope (CC me, CC thee, double coefficientWeight, double logEnergyWeight, double coefficientRegressionWeight, double logEnergyRegressionWeight, double regressionWindowLength, double sakoeChibaBand, int localSlope);
+/*
+	As CCs_to_DTW followed by DTW_findPath_bandAndSlope.
+*/
+
+double CCs_getDTWDistance_bandAndSlope (CC me, CC thee, double coefficientWeight, double logEnergyWeight, double coefficientRegressionWeight, double logEnergyRegressionWeight, double regressionWindowLength, double sakoeChibaBand, int localSlope, double maximumDistance);
+/*
+	As CCs_to_DTW_bandAndSlope followed by DTW_getDistance_bandAndSlope, but without the distance matrix,
+	so that long sequences take little memory (see Sampleds_getDTWDistance_bandAndSlope).
+*/
+
 #endif /* _CCs_to_DTW_h_ */
@@ -41,6 +41,8 @@
 #include "Sound_extensions.h"
 #include "NUM2.h"
 #include "NUMmachar.h"
+#include "MelderThread.h"
+#include <atomic>
 
 #include "oo_DESTROY.h"
 #include "DTW_def.h"
@@ -486,7 +488,15 @@ static void DTW_paintDistances_raw (DTW me, Graphics g, double xmin, double xmax
 	if (inset)
 		Graphics_setInner (g);
 	Graphics_setWindow (g, xmin, xmax, ymin, ymax);
-	Graphics_cellArray (g, my z.part (iymin, iymax, ixmin, ixmax),
+	/*
+		Distances outside the band of a lazily computed DTW are undefined; they are painted as far away.
+	*/
+	autoMAT distances = newMATcopy (my z.part (iymin, iymax, ixmin, ixmax));
+	for (integer irow = 1; irow <= distances.nrow; irow ++)
+		for (integer icol = 1; icol <= distances.ncol; icol ++)
+			if (isundef (distances [irow] [icol]))
+				distances [irow] [icol] = maximum;
+	Graphics_cellArray (g, distances.get(),
 			Matrix_columnToX (me, ixmin - 0.5), Matrix_columnToX (me, ixmax + 0.5),
 			Matrix_rowToY (me, iymin - 0.5), Matrix_rowToY (me, iymax + 0.5),
 			minimum, maximum);
@@ -767,67 +777,89 @@ void DTW_drawDistancesAlongPath (DTW me, Graphics g, double xmin, double xmax, d
 }
 
 /*
-	metric = 1...n (sum (a_i^n))^(1/n)
+	The distance between two frames, i.e. columns of the matrices: metric = 1...n (sum (a_i^n))^(1/n),
+	divided by the number of components.
 */
+struct Matrices_Distances {
+	autoMAT prototype, candidate;   // one frame per row, so that the components of a frame are contiguous
+	double metric;
+	void getColumn (integer icol, integer fromRow, integer toRow, VEC result) const {
+		const integer numberOfComponents = prototype.ncol;
+		constVEC y = candidate.row (icol);
+		for (integer i = fromRow; i <= toRow; i ++) {
+			constVEC x = prototype.row (i);
+			/*
+				First divide distance by maximum to prevent overflow when metric
+				is a large number.
+				d = (x^n)^(1/n) may overflow if x>1 & n >>1 even if d would not overflow!
+			*/
+			double dmax = 0.0, d = 0.0;
+			for (integer k = 1; k <= numberOfComponents; k ++) {
+				const double dtmp = fabs (x [k] - y [k]);
+				if (dtmp > dmax)
+					dmax = dtmp;
+			}
+			if (dmax > 0) {
+				for (integer k = 1; k <= numberOfComponents; k ++) {
+					const double dtmp = fabs (x [k] - y [k]) / dmax;
+					d +=  pow (dtmp, metric);
+				}
+			}
+			d = dmax * pow (d, 1.0 / metric);
+			result [i - fromRow + 1] = d / numberOfComponents; // == d * dy / ymax
+		}
+	}
+};
+
+static Matrices_Distances Matrices_getDistances (Matrix me, Matrix thee, double metric) {
+	Melder_require (thy ny == my ny,
+		U"Column sizes should be equal.");
+	Matrices_Distances distances;
+	distances.prototype = newMATtranspose (my z.get());
+	distances.candidate = newMATtranspose (thy z.get());
+	distances.metric = metric;
+	return distances;
+}
+
 autoDTW Matrices_to_DTW (Matrix me, Matrix thee, bool matchStart, bool matchEnd, int slope, double metric) {
 	try {
-		Melder_require (thy ny == my ny,
-			U"Column sizes should be equal.");
-
+		const Matrices_Distances distances = Matrices_getDistances (me, thee, metric);
 		autoDTW him = DTW_create (my xmin, my xmax, my nx, my dx, my x1, thy xmin, thy xmax, thy nx, thy dx, thy x1);
-		autoMelderProgress progess (U"Calculate distances");
-		for (integer i = 1; i <= my nx; i ++) {
-			for (integer j = 1; j <= thy nx; j ++) {
-				/*
-					First divide distance by maximum to prevent overflow when metric
-					is a large number.
-					d = (x^n)^(1/n) may overflow if x>1 & n >>1 even if d would not overflow!
-				*/
-				double dmax = 0.0, d = 0.0;
-				for (integer k = 1; k <= my ny; k ++) {
-					const double dtmp = fabs (my z [k] [i] - thy z [k] [j]);
-					if (dtmp > dmax)
-						dmax = dtmp;
-				}
-				if (dmax > 0) {
-					for (integer k = 1; k <= my ny; k ++) {
-						const double dtmp = fabs (my z [k] [i] - thy z [k] [j]) / dmax;
-						d +=  pow (dtmp, metric);
-					}
-				}
-				d = dmax * pow (d, 1.0 / metric);
-				his z [i] [j] = d / my ny; // == d * dy / ymax
-			}
-			if ((i % 10) == 1) {
-				Melder_progress (0.999 * i / my nx, U"Calculate distances: column ", i, U" from ", my nx, U".");
+		DTW_computeDistances (him.get(),
+			[&] (integer icol, integer fromRow, integer toRow, VEC result) {
+				distances.getColumn (icol, fromRow, toRow, result);
 			}
-		}
-		DTW_findPath (him.get(), matchStart, matchEnd, slope);
+		);
+		(void) matchStart;   // as in DTW_findPath
+		(void) matchEnd;
+		DTW_findPath_bandAndSlope (him.get(), 0.0, slope, nullptr);
 		return him;
 	} catch (MelderError) {
 		Melder_throw (U"DTW not created from matrices.");
 	}
 }
 
-autoDTW Spectrograms_to_DTW (Spectrogram me, Spectrogram thee, bool matchStart, bool matchEnd, int slope, double metric) {
-	try {
-		Melder_require (my xmin == thy xmin && my ymax == thy ymax && my ny == thy ny,
-			U"The number of frequencies and/or frequency ranges should be equal.");
-
-		autoMatrix m1 = Spectrogram_to_Matrix (me);
-		autoMatrix m2 = Spectrogram_to_Matrix (thee);
-
-		// Take log10 for dB's (4e-10 scaling not necessary)
+/*
+	The spectrogram in dB's (4e-10 scaling not necessary).
+*/
+static autoMatrix Spectrogram_to_Matrix_dB (Spectrogram me) {
+	autoMatrix thee = Spectrogram_to_Matrix (me);
+	for (integer i = 1; i <= thy ny; i ++)
+		for (integer j = 1; j <= thy nx; j ++)
+			thy z [i] [j] = 10.0 * log10 (thy z [i] [j]);
+	return thee;
+}
 
-		for (integer i = 1; i <= my ny; i ++) {
-			for (integer j = 1; j <= my nx; j ++)
-				m1 -> z [i] [j] = 10.0 * log10 (m1 -> z [i] [j]);
-		}
-		for (integer i = 1; i <= thy ny; i ++) {
-			for (integer j = 1; j <= thy nx; j ++)
-				m2 -> z [i] [j] = 10.0 * log10 (m2 -> z [i] [j]);
-		}
+static void Spectrograms_checkCompatibility (Spectrogram me, Spectrogram thee) {
+	Melder_require (my xmin == thy xmin && my ymax == thy ymax && my ny == thy ny,
+		U"The number of frequencies and/or frequency ranges should be equal.");
+}
 
+autoDTW Spectrograms_to_DTW (Spectrogram me, Spectrogram thee, bool matchStart, bool matchEnd, int slope, double metric) {
+	try {
+		Spectrograms_checkCompatibility (me, thee);
+		autoMatrix m1 = Spectrogram_to_Matrix_dB (me);
+		autoMatrix m2 = Spectrogram_to_Matrix_dB (thee);
 		autoDTW him = Matrices_to_DTW (m1.get(), m2.get(), matchStart, matchEnd, slope, metric);
 		return him;
 	} catch (MelderError) {
@@ -835,6 +867,22 @@ autoDTW Spectrograms_to_DTW (Spectrogram me, Spectrogram thee, bool matchStart,
 	}
 }
 
+double Spectrograms_getDTWDistance_bandAndSlope (Spectrogram me, Spectrogram thee, double metric, double sakoeChibaBand, int localSlope, double maximumDistance) {
+	try {
+		Spectrograms_checkCompatibility (me, thee);
+		autoMatrix m1 = Spectrogram_to_Matrix_dB (me);
+		autoMatrix m2 = Spectrogram_to_Matrix_dB (thee);
+		const Matrices_Distances distances = Matrices_getDistances (m1.get(), m2.get(), metric);
+		return Sampleds_getDTWDistance_bandAndSlope (me, thee, sakoeChibaBand, localSlope, maximumDistance,
+			[&] (integer icol, integer fromRow, integer toRow, VEC result) {
+				distances.getColumn (icol, fromRow, toRow, result);
+			}
+		);
+	} catch (MelderError) {
+		Melder_throw (me, U" & ", thee, U": DTW distance not computed.");
+	}
+}
+
 static int Pitch_findFirstAndLastVoicedFrame (Pitch me, integer *first, integer *last) {
 	*first = 1;
 	while (*first <= my nx && ! Pitch_isVoiced_i (me, *first))
@@ -999,51 +1047,500 @@ static void DTW_checkSlopeConstraints (DTW me, double band, int slope) {
     }
 }
 
-static void DTW_Polygon_setUnreachableParts (DTW me, Polygon thee, INTMAT const& psi) {
-    try {
-        const double eps = my dx / 100.0;   // safe enough
-        const double dtw_slope = (my ymax - my ymin) / (my xmax - my xmin);
+/*
+	The path finder.
+
+	The band is the set of cells that the path may visit: in column `icol`, the rows lowestRow [icol] .. highestRow [icol].
+	Only the cells of the band are stored, column after column, so that a narrow band takes little memory;
+	the number of cell (irow, icol) is firstCell [icol] + irow - lowestRow [icol].
+*/
+struct DTW_Band {
+	integer numberOfColumns, numberOfCells;
+	integer numberOfStartRows, numberOfStartColumns;   // where in the first column and the first row the path may begin
+	integer lastStartColumn;   // no path begins to the right of this column, not even at an isolated cell
+	autoINTVEC lowestRow, highestRow, firstCell;
+	bool contains (integer irow, integer icol) const {
+		return icol >= 1 && icol <= numberOfColumns && irow >= lowestRow [icol] && irow <= highestRow [icol];
+	}
+};
 
-        double xmin, xmax, ymin, ymax;
-        Polygon_getExtrema (thee, & xmin, & xmax, & ymin, & ymax);
-        // if the Polygon and the DTW don't overlap everything is unreachable!
+/*
+	The band consists of the cells inside the polygon, without the first row and column,
+	except for their first cells, where the path may begin.
+	In each column, we search upward and downward from the diagonal until the first cell outside the polygon;
+	everything beyond that cell is unreachable.
+*/
+static DTW_Band DTW_Polygon_getBand (DTW me, Polygon thee, int localSlope) {
+	try {
+		const double slopes [5] = { DTW_BIG, DTW_BIG, 3.0, 2.0, 1.5 };
+		const integer delta_xy = std::min (my nx, my ny) / 10;   // if localSlope == 1 start of path is within 10% of minimum duration
+		const integer numberOfStartCells = ( localSlope != 1 ? Melder_ifloor (slopes [localSlope]) + 1 : delta_xy );
+		const double eps = my dx / 100.0;   // safe enough
+		const double dtw_slope = (my ymax - my ymin) / (my xmax - my xmin);
+
+		double xmin, xmax, ymin, ymax;
+		Polygon_getExtrema (thee, & xmin, & xmax, & ymin, & ymax);
+		// if the Polygon and the DTW don't overlap everything is unreachable!
 		Melder_require (! (xmax <= my xmin || xmin >= my xmax || ymax <= my ymin || ymin >= my ymax),
 			U"DTW and Polygon don't overlap.");
 
-        // find border "above" polygon
-        for (integer ix = 1; ix <= my nx; ix ++) {
-            const double x = my x1 + (ix - 1) * my dx;
-            const integer iystart = Melder_ifloor (dtw_slope * ix * (my dx / my dy)) + 1;
-            for (integer iy = iystart + 1; iy <= my ny; iy ++) {
+		DTW_Band band;
+		band.numberOfColumns = my nx;
+		band.numberOfStartRows = std::min (numberOfStartCells, my ny);
+		band.numberOfStartColumns = std::min (numberOfStartCells, my nx);
+		band.lowestRow = newINTVECraw (my nx);
+		band.highestRow = newINTVECraw (my nx);
+		band.firstCell = newINTVECraw (my nx + 1);
+		band.numberOfCells = 0;
+		for (integer ix = 1; ix <= my nx; ix ++) {
+			integer lowestRow = ( ix == 1 || ix > band.numberOfStartColumns ? 2 : 1 );
+			integer highestRow = ( ix == 1 ? band.numberOfStartRows : my ny );
+			const double x = my x1 + (ix - 1) * my dx;
+			/*
+				Find the border "above" the polygon.
+			*/
+			const integer iystart = Melder_ifloor (dtw_slope * ix * (my dx / my dy)) + 1;
+			for (integer iy = iystart + 1; iy <= my ny; iy ++) {
 				const double y = my y1 + (iy - 1) * my dy;
-                if (Polygon_getLocationOfPoint (thee, x, y, eps) == Polygon_OUTSIDE) {
-                    for (integer k = iy; k <= my ny; k ++)
-                        psi [k] [ix] = DTW_UNREACHABLE;
-                    break;
-                }
-            }
-        }
-        // find border "below" polygon
-        for (integer ix = 2; ix <= my nx; ix ++) {
-            const double x = my x1 + (ix - 1) * my dx;
-            integer iystart = Melder_ifloor (dtw_slope * ix * (my dx / my dy));   // start 1 lower
-            if (iystart > my ny)
-				iystart = my ny;
-            for (integer iy = iystart - 1; iy >= 1; iy --) {
-                const double y = my y1 + (iy - 1) * my dy;
-                if (Polygon_getLocationOfPoint (thee, x, y, eps) == Polygon_OUTSIDE) {
-                    for (integer k = iy; k >= 1; k --)
-                        psi [k] [ix] = DTW_UNREACHABLE;
-                    break;
-                }
-            }
-        }
-    } catch (MelderError) {
-        Melder_throw (me, U" cannot set unreachable parts.");
-    }
+				if (Polygon_getLocationOfPoint (thee, x, y, eps) == Polygon_OUTSIDE) {
+					highestRow = std::min (highestRow, iy - 1);
+					break;
+				}
+			}
+			/*
+				Find the border "below" the polygon.
+			*/
+			if (ix > 1) {
+				const integer iystart_below = std::min (Melder_ifloor (dtw_slope * ix * (my dx / my dy)), my ny);   // start 1 lower
+				for (integer iy = iystart_below - 1; iy >= 1; iy --) {
+					const double y = my y1 + (iy - 1) * my dy;
+					if (Polygon_getLocationOfPoint (thee, x, y, eps) == Polygon_OUTSIDE) {
+						lowestRow = std::max (lowestRow, iy + 1);
+						break;
+					}
+				}
+			}
+			if (highestRow < lowestRow)
+				highestRow = lowestRow - 1;   // an empty column
+			band.lowestRow [ix] = lowestRow;
+			band.highestRow [ix] = highestRow;
+			band.firstCell [ix] = band.numberOfCells + 1;
+			band.numberOfCells += highestRow - lowestRow + 1;
+		}
+		band.firstCell [my nx + 1] = band.numberOfCells + 1;
+		/*
+			A cell without a neighbour to the left, below or diagonally below-left restarts the cost (see DTW_PathSearch_computeColumn).
+			Only the lowest cell of a column can be such a cell.
+		*/
+		band.lastStartColumn = band.numberOfStartColumns;
+		for (integer ix = 2; ix <= my nx; ix ++) {
+			const integer iy = std::max (2_integer, band.lowestRow [ix]);
+			if (iy <= band.highestRow [ix] && ! band.contains (iy - 1, ix - 1) && ! band.contains (iy, ix - 1) && ! band.contains (iy - 1, ix))
+				band.lastStartColumn = ix;
+		}
+		return band;
+	} catch (MelderError) {
+		Melder_throw (me, U": cannot determine the reachable parts.");
+	}
+}
+
+/*
+	The local distances, cumulative costs and directions of the cells of the band in some consecutive columns.
+*/
+struct DTW_BandPart {
+	const DTW_Band *band;
+	integer firstColumn, lastColumn, cellOffset;
+	autoVEC distances, costs;
+	autovector <int8> directions;
+	bool contains (integer irow, integer icol) const {
+		return icol >= firstColumn && icol <= lastColumn && band -> contains (irow, icol);
+	}
+	integer cell (integer irow, integer icol) const {
+		return band -> firstCell [icol] + irow - band -> lowestRow [icol] - cellOffset;
+	}
+	int direction (integer irow, integer icol) const {
+		return ( contains (irow, icol) ? directions [cell (irow, icol)] : DTW_UNREACHABLE );
+	}
+};
+
+static DTW_BandPart DTW_Band_createPart (const DTW_Band *me, integer firstColumn, integer lastColumn) {
+	DTW_BandPart part;
+	part.band = me;
+	part.firstColumn = firstColumn;
+	part.lastColumn = lastColumn;
+	part.cellOffset = my firstCell [firstColumn] - 1;
+	const integer numberOfCells = my firstCell [lastColumn + 1] - my firstCell [firstColumn];
+	part.distances = newVECraw (numberOfCells);
+	part.costs = newVECraw (numberOfCells);
+	part.directions = newvectorzero <int8> (numberOfCells);
+	return part;
+}
+
+static void DTW_BandPart_copyColumns (DTW_BandPart *me, const DTW_BandPart *thee, integer firstColumn, integer lastColumn) {
+	for (integer icell = my band -> firstCell [firstColumn]; icell < my band -> firstCell [lastColumn + 1]; icell ++) {
+		my distances [icell - my cellOffset] = thy distances [icell - thy cellOffset];
+		my costs [icell - my cellOffset] = thy costs [icell - thy cellOffset];
+		my directions [icell - my cellOffset] = thy directions [icell - thy cellOffset];
+	}
+}
+
+struct DTW_PathSearch {
+	const DTW_Band *band;
+	int localSlope;
+	const DTW_ColumnDistances *columnDistances;
+	autoVEC firstColumnCosts, firstRowCosts;   // the cumulative costs along the start of the first column and row, if localSlope != 1
+};
+
+static void DTW_PathSearch_computeColumn (const DTW_PathSearch *me, DTW_BandPart *part, integer j) {
+	const DTW_Band *band = my band;
+	const int localSlope = my localSlope;
+	auto z = [&] (integer irow, integer icol) -> double {
+		return part -> distances [part -> cell (irow, icol)];
+	};
+	auto delta = [&] (integer irow, integer icol) -> double {
+		return part -> costs [part -> cell (irow, icol)];
+	};
+	auto psi = [&] (integer irow, integer icol) -> int {
+		return part -> direction (irow, icol);
+	};
+	auto isReachable = [&] (integer irow, integer icol) -> bool {
+		return part -> contains (irow, icol);
+	};
+	auto set = [&] (integer irow, integer icol, double cost, int direction) {
+		part -> costs [part -> cell (irow, icol)] = cost;
+		part -> directions [part -> cell (irow, icol)] = int8 (direction);
+	};
+	/*
+		The begin parts of the first column and the first row.
+	*/
+	if (j == 1) {
+		for (integer i = band -> lowestRow [1]; i <= band -> highestRow [1]; i ++)
+			if (localSlope != 1)
+				set (i, 1, my firstColumnCosts [i], DTW_Y);
+			else
+				set (i, 1, z (i, 1), DTW_START);
+		return;
+	}
+	if (band -> lowestRow [j] == 1) {
+		if (localSlope != 1)
+			set (1, j, my firstRowCosts [j], DTW_X);
+		else
+			set (1, j, z (1, j), DTW_START);
+	}
+	for (integer i = std::max (2_integer, band -> lowestRow [j]); i <= band -> highestRow [j]; i ++) {
+		double g, gmin = DTW_BIG;
+		int direction = 0;
+		if (isReachable (i - 1, j - 1)) {
+			gmin = delta (i - 1, j - 1) + 2.0 * z (i, j);
+			direction = DTW_XANDY;
+		} else if (isReachable (i, j - 1)) {
+			gmin = delta (i, j - 1) + z (i, j);
+			direction = DTW_X;
+		} else if (isReachable (i - 1, j)) {
+			gmin = delta (i - 1, j) + z (i, j);
+			direction = DTW_Y;
+		} else {
+			set (i, j, z (i, j), 0);   // an isolated point
+			continue;
+		}
+
+		switch (localSlope) {
+		case 1:  {   // no restriction
+			if (isReachable (i, j - 1) && ((g = delta (i, j - 1) + z (i, j)) < gmin)) {
+				gmin = g;
+				direction = DTW_X;
+			}
+			if (isReachable (i - 1, j) && ((g = delta (i - 1, j) + z (i, j)) < gmin)) {
+				gmin = g;
+				direction = DTW_Y;
+			}
+		}
+		break;
+
+		// P = 1/2
+
+		case 2: {
+			if (j >= 4 && isReachable (i - 1, j - 3) && psi (i, j - 1) == DTW_X && psi (i, j - 2) == DTW_XANDY &&
+				(g = delta (i - 1, j - 3) + 2.0 * z (i, j - 2) + z (i, j - 1) + z (i, j)) < gmin) {
+				gmin = g;
+				direction = DTW_X;
+			}
+			if (j >= 3 && isReachable (i - 1, j - 2) && psi (i, j - 1) == DTW_XANDY &&
+				(g = delta (i - 1, j - 2) + 2.0 * z (i, j - 1) + z (i, j)) < gmin) {
+				gmin = g;
+				direction = DTW_X;
+			}
+			if (i >= 3 && isReachable (i - 2, j - 1) && psi (i - 1, j) == DTW_XANDY &&
+				(g = delta (i - 2, j - 1) + 2.0 * z (i - 1, j) + z (i, j)) < gmin) {
+				gmin = g;
+				direction = DTW_Y;
+			}
+			if (i >= 4 && isReachable (i - 3, j - 1) && psi (i - 1, j) == DTW_Y && psi (i - 2, j) == DTW_XANDY &&
+				(g = delta (i - 3, j - 1) + 2.0 * z (i - 2, j) + z (i - 1, j) + z (i, j)) < gmin) {
+				gmin = g;
+				direction = DTW_Y;
+			}
+		}
+		break;
+
+		// P = 1
+
+		case 3: {
+			if (j >= 3 && isReachable (i - 1, j - 2) && psi (i, j - 1) == DTW_XANDY &&
+					(g = delta (i - 1, j - 2) + 2.0 * z (i, j - 1) + z (i, j)) < gmin)
+			{
+				gmin = g;
+				direction = DTW_X;
+			}
+			if (i >= 3 && isReachable (i - 2, j - 1) && psi (i - 1, j) == DTW_XANDY &&
+					(g = delta (i - 2, j - 1) + 2.0 * z (i - 1, j) + z (i, j)) < gmin)
+			{
+				gmin = g;
+				direction = DTW_Y;
+			}
+		}
+		break;
+
+		// P = 2
+
+		case 4: {
+			if (i >= 3 && j >= 4 && isReachable (i - 2, j - 3) && psi (i, j - 1) == DTW_XANDY && psi (i - 1, j - 2) == DTW_XANDY &&
+					(g = delta (i - 2, j - 3) + 2.0 * z (i - 1, j - 2) + 2.0 * z (i, j - 1) + z (i, j)) < gmin)
+			{
+				gmin = g;
+				direction = DTW_X;
+			}
+			if (i >= 4 && j >= 3 && isReachable (i - 3, j - 2) && psi (i - 1, j) == DTW_XANDY && psi (i - 2, j - 1) == DTW_XANDY &&
+					(g = delta (i - 3, j - 2) + 2.0 * z (i - 2, j - 1) + 2.0 * z (i - 1, j) + z (i, j)) < gmin)
+			{
+				gmin = g;
+				direction = DTW_Y;
+			}
+		}
+		break;
+		default:
+		break;
+		}
+		Melder_assert (direction != 0);
+		set (i, j, gmin, direction);
+	}
+}
+
+/*
+	Computes the local distances (in parallel) and then the cumulative costs of the columns firstColumn .. lastColumn,
+	which should be in the part, together with the three columns before them if these exist,
+	because the slope constraints look back that far.
+	Returns false if all the cumulative costs in a column exceed maximumCost (if maximumCost > 0).
+	This is checked only to the right of the last column where a path can begin,
+	because every path that ends in the last column crosses all those columns,
+	and its cost there is not less than the smallest cost in the column if the distances are not negative.
+*/
+static bool DTW_PathSearch_computeColumns (const DTW_PathSearch *me, DTW_BandPart *part, integer firstColumn, integer lastColumn,
+	double maximumCost, bool showProgress)
+{
+	const DTW_Band *band = my band;
+	const integer numberOfColumns = lastColumn - firstColumn + 1;
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfColumns, 10);
+	MelderThread_parallelFor (numberOfColumns, numberOfThreads, [&] (integer /* ithread */, integer firstFrame, integer lastFrame) {
+		for (integer icol = firstColumn + firstFrame - 1; icol <= firstColumn + lastFrame - 1; icol ++) {
+			const integer lowestRow = band -> lowestRow [icol], highestRow = band -> highestRow [icol];
+			if (highestRow >= lowestRow)
+				(*my columnDistances) (icol, lowestRow, highestRow,
+						part -> distances.part (part -> cell (lowestRow, icol), part -> cell (highestRow, icol)));
+		}
+	});
+	for (integer icol = firstColumn; icol <= lastColumn; icol ++) {
+		DTW_PathSearch_computeColumn (me, part, icol);
+		if (maximumCost > 0.0 && icol > band -> lastStartColumn && band -> highestRow [icol] >= band -> lowestRow [icol]) {
+			const double minimumCost = NUMmin (part -> costs.part (
+					part -> cell (band -> lowestRow [icol], icol), part -> cell (band -> highestRow [icol], icol)));
+			if (minimumCost > maximumCost)
+				return false;
+		}
+		if (showProgress && (icol % 10) == 2)
+			Melder_progress (0.999 * icol / band -> numberOfColumns, U"Calculate time warp: frame ", icol, U" from ", band -> numberOfColumns, U".");
+	}
+	return true;
+}
+
+static bool weShouldKeepOnlyCheckpoints (integer numberOfCells) {
+	return numberOfCells > 30'000'000;   // half a gigabyte of distances, costs and directions
+}
+
+/*
+	Returns the weighted distance along the optimal path, or undefined if it exceeds maximumDistance (if maximumDistance > 0);
+	in the latter case, the search may stop early if the distances are not negative.
+	If `storePath`, the path is stored in the DTW.
+
+	The columns are computed in segments. If the band is too large to keep, only the last three columns
+	of every segment are remembered as a checkpoint, and the trace back recomputes the segments one by one from these,
+	so that the memory grows with the square root of the number of columns (times the width of the band)
+	at the cost of computing each column twice; the path is the same.
+	If the path is not needed, no checkpoints are kept at all.
+*/
+static double DTW_findPathInBand (DTW me, const DTW_Band *band, int localSlope, DTW_ColumnDistances const& columnDistances,
+	double maximumDistance, bool storePath, autoMatrix *cumulativeDists)
+{
+	DTW_PathSearch search;
+	search.band = band;
+	search.localSlope = localSlope;
+	search.columnDistances = & columnDistances;
+	if (localSlope != 1) {
+		search.firstColumnCosts = newVECraw (band -> numberOfStartRows);
+		columnDistances (1, 1, band -> numberOfStartRows, search.firstColumnCosts.get());
+		for (integer iy = 2; iy <= band -> numberOfStartRows; iy ++)
+			search.firstColumnCosts [iy] += search.firstColumnCosts [iy - 1];
+		search.firstRowCosts = newVECraw (band -> numberOfStartColumns);
+		search.firstRowCosts [1] = search.firstColumnCosts [1];
+		for (integer ix = 2; ix <= band -> numberOfStartColumns; ix ++) {
+			double distance;
+			columnDistances (ix, 1, 1, VEC (& distance, 1));
+			search.firstRowCosts [ix] = search.firstRowCosts [ix - 1] + distance;
+		}
+	}
+	const double maximumCost = ( maximumDistance > 0.0 ? maximumDistance * (my nx + my ny) : 0.0 );
+	const bool keepAllColumns = storePath && (cumulativeDists || ! weShouldKeepOnlyCheckpoints (band -> numberOfCells));
+	const integer segmentLength = ( keepAllColumns ? my nx : std::max (Melder_iceiling (sqrt (double (my nx))), 16_integer) );
+
+	// Forward pass.
+	std::vector <DTW_BandPart> checkpoints;   // the three columns before the start of each segment except the first
+	DTW_BandPart part;
+	autoMelderProgress progress (U"Find path");
+	for (integer firstColumn = 1; firstColumn <= my nx; firstColumn += segmentLength) {
+		const integer lastColumn = std::min (firstColumn + segmentLength - 1, my nx);
+		DTW_BandPart next = DTW_Band_createPart (band, std::max (firstColumn - 3, 1_integer), lastColumn);
+		if (firstColumn > 1) {
+			DTW_BandPart_copyColumns (& next, & part, next.firstColumn, firstColumn - 1);
+			if (storePath) {
+				DTW_BandPart checkpoint = DTW_Band_createPart (band, next.firstColumn, firstColumn - 1);
+				DTW_BandPart_copyColumns (& checkpoint, & part, next.firstColumn, firstColumn - 1);
+				checkpoints.push_back (std::move (checkpoint));
+			}
+		}
+		part = std::move (next);
+		if (! DTW_PathSearch_computeColumns (& search, & part, firstColumn, lastColumn, maximumCost, true))
+			return undefined;
+	}
+
+	// Find minimum at end of path and trace back.
+
+	const integer lowestRow = band -> lowestRow [my nx], highestRow = band -> highestRow [my nx];
+	Melder_require (highestRow >= lowestRow,
+		U"No path reaches the last column.");
+	integer iy = highestRow;
+	double minimum = part.costs [part.cell (iy, my nx)];
+	for (integer i = highestRow - 1; i >= lowestRow; i --) {
+		if (part.costs [part.cell (i, my nx)] < minimum)
+			minimum = part.costs [part.cell (iy = i, my nx)];
+	}
+	const double weightedDistance = minimum / (my nx + my ny);
+	if (maximumDistance > 0.0 && weightedDistance > maximumDistance)
+		return undefined;
+	if (! storePath)
+		return weightedDistance;
+
+	integer pathIndex = my nx + my ny - 1;   // maximum path length
+	my weightedDistance = weightedDistance;
+	my path [pathIndex]. y = iy;
+	integer ix = my path [pathIndex]. x = my nx;
+
+	// Fill path backwards.
+
+	integer segment = (my nx - 1) / segmentLength;
+	while (ix > 1) {
+		if (ix < part.firstColumn) {
+			/*
+				Recompute the previous segment from its checkpoint.
+			*/
+			segment --;
+			const integer firstColumn = 1 + segment * segmentLength, lastColumn = std::min (firstColumn + segmentLength - 1, my nx);
+			part = DTW_Band_createPart (band, std::max (firstColumn - 3, 1_integer), lastColumn);
+			if (segment > 0)
+				DTW_BandPart_copyColumns (& part, & checkpoints [uinteger (segment - 1)], part.firstColumn, firstColumn - 1);
+			DTW_PathSearch_computeColumns (& search, & part, firstColumn, lastColumn, 0.0, false);
+		}
+		const int direction = part.direction (iy, ix);
+		if (direction == DTW_XANDY) {
+			ix --;
+			iy --;
+		} else if (direction == DTW_X) {
+			ix --;
+		} else if (direction == DTW_Y) {
+			iy --;
+		} else if (direction == DTW_START) {
+			break;
+		}
+		if (pathIndex < 2 || iy < 1)
+			break;
+		my path [-- pathIndex]. x = ix;
+		my path [pathIndex]. y = iy;
+	}
+
+	my pathLength = my nx + my ny - 1 - pathIndex + 1;
+	if (pathIndex > 1)
+		for (integer j = 1; j <= my pathLength; j ++)
+			my path [j] = my path [pathIndex ++];
+
+	DTW_Path_recode (me);
+	if (cumulativeDists) {
+		/*
+			Outside the band, the cumulative distances are the local distances,
+			except at the start of the first row and column.
+		*/
+		autoMatrix him = Matrix_create (my xmin, my xmax, my nx, my dx, my x1,
+			my ymin, my ymax, my ny, my dy, my y1);
+		his z.all() <<= my z.all();
+		if (localSlope != 1) {
+			for (integer i = 2; i <= band -> numberOfStartRows; i ++)
+				his z [i] [1] = search.firstColumnCosts [i];
+			for (integer j = 2; j <= band -> numberOfStartColumns; j ++)
+				his z [1] [j] = search.firstRowCosts [j];
+		}
+		for (integer j = 1; j <= my nx; j ++)
+			for (integer i = band -> lowestRow [j]; i <= band -> highestRow [j]; i ++)
+				his z [i] [j] = part.costs [part.cell (i, j)];
+		*cumulativeDists = him.move();
+	}
+	return weightedDistance;
+}
+
+static DTW_ColumnDistances DTW_getStoredDistances (DTW me) {
+	return [me] (integer icol, integer fromRow, integer toRow, VEC result) {
+		result <<= my z.column (icol).part (fromRow, toRow);
+	};
+}
+
+static void DTW_checkDistancesInBand (DTW me, const DTW_Band *band, int localSlope) {
+	bool allDistancesAreKnown = true;
+	for (integer icol = 1; icol <= my nx; icol ++)
+		for (integer irow = band -> lowestRow [icol]; irow <= band -> highestRow [icol]; irow ++)
+			allDistancesAreKnown &= isdefined (my z [irow] [icol]);
+	if (localSlope != 1) {
+		for (integer irow = 1; irow <= band -> numberOfStartRows; irow ++)
+			allDistancesAreKnown &= isdefined (my z [irow] [1]);
+		for (integer icol = 1; icol <= band -> numberOfStartColumns; icol ++)
+			allDistancesAreKnown &= isdefined (my z [1] [icol]);
+	}
+	Melder_require (allDistancesAreKnown,
+		U"The distances inside the band should be known; this DTW was probably created with a narrower band.");
+}
+
+void DTW_computeDistances (DTW me, DTW_ColumnDistances const& columnDistances) {
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (my nx, 10);
+	std::atomic <integer> numberOfColumnsDone (0);
+	autoMelderProgress progress (U"Calculate distances");
+	MelderThread_parallelFor (my nx, numberOfThreads, [&] (integer ithread, integer firstColumn, integer lastColumn) {
+		autoVEC distances = newVECraw (my ny);
+		for (integer icol = firstColumn; icol <= lastColumn; icol ++) {
+			columnDistances (icol, 1, my ny, distances.get());
+			my z.column (icol) <<= distances.all();
+			const integer columnsDone = ++ numberOfColumnsDone;
+			if (ithread == 1)   // only the calling thread can show progress (and be cancelled)
+				Melder_progress (0.999 * columnsDone / my nx, U"Calculate distances: frame ", columnsDone, U" from ", my nx, U".");
+		}
+	});
 }
 
-#define DTW_ISREACHABLE(y,x) ((psi [y] [x] != DTW_UNREACHABLE) && (psi [y] [x] != DTW_FORBIDDEN))
 static void DTW_findPath_special (DTW me, bool matchStart, bool matchEnd, int slope, autoMatrix *cumulativeDists) {
     (void) matchStart;
     (void) matchEnd;
@@ -1197,212 +1694,54 @@ void DTW_findPath_bandAndSlope (DTW me, double sakoeChibaBand, int localSlope, a
 
 void DTW_Polygon_findPathInside (DTW me, Polygon thee, int localSlope, autoMatrix *cumulativeDists) {
 	try {
-		const double slopes [5] = { DTW_BIG, DTW_BIG, 3.0, 2.0, 1.5 };
-		// if localSlope == 1 start of path is within 10% of minimum duration. Starts farther away
-		integer delta_xy = std::min (my nx, my ny) / 10; // if localSlope == 1 start within 10% of
-
 		Melder_require (localSlope > 0 && localSlope < 5,
 			U"Local slope parameter ", localSlope, U" not supported.");
+		const DTW_Band band = DTW_Polygon_getBand (me, thee, localSlope);
+		DTW_checkDistancesInBand (me, & band, localSlope);
+		DTW_findPathInBand (me, & band, localSlope, DTW_getStoredDistances (me), 0.0, true, cumulativeDists);
+	} catch (MelderError) {
+		Melder_throw (me, U": cannot find path.");
+	}
+}
 
-		autoMAT delta = newMATcopy (my z.get());
-		autoINTMAT psi = newINTMATzero (my ny, my nx);
-		/*
-			Start by making the outside unreachable.
-		*/
-		for (integer j = 1; j <= my nx; j ++)
-			psi [1] [j] = DTW_UNREACHABLE;
-		for (integer i = 1; i <= my ny; i ++)
-			psi [i] [1] = DTW_UNREACHABLE;
-
-        /*
-        	Make begin part of first column reachable.
-		*/
-        const integer rowto = ( localSlope != 1 ? Melder_ifloor (slopes [localSlope]) + 1 : delta_xy );
-        for (integer iy = 2; iy <= rowto; iy ++) {
-            if (localSlope != 1) {
-                delta [iy] [1] = delta [iy - 1] [1] + my z [iy] [1];
-                psi [iy] [1] = DTW_Y;
-            } else {
-                psi [iy] [1] = DTW_START;   // will be adapted by DTW_Polygon_setUnreachableParts
-            }
-        }
-		/*
-			Make begin part of first row reachable.
-		*/
-		const integer colto = ( localSlope != 1 ? Melder_ifloor (slopes [localSlope]) + 1 : delta_xy );
-		for (integer ix = 2; ix <= colto; ix ++) {
-			if (localSlope != 1) {
-				delta [1] [ix] = delta [1] [ix -1] + my z [1] [ix];
-				psi [1] [ix] = DTW_X;
-			} else {
-				psi [1] [ix] = DTW_START;   // will be adapted by DTW_Polygon_setUnreachableParts
-			}
+double DTW_getDistance_bandAndSlope (DTW me, double sakoeChibaBand, int localSlope, double maximumDistance) {
+	try {
+		Melder_require (localSlope > 0 && localSlope < 5,
+			U"Local slope parameter ", localSlope, U" not supported.");
+		autoPolygon thee = DTW_to_Polygon (me, sakoeChibaBand, localSlope);
+		const DTW_Band band = DTW_Polygon_getBand (me, thee.get(), localSlope);
+		DTW_checkDistancesInBand (me, & band, localSlope);
+		if (NUMmin (my z.get()) < 0.0) {
+			/*
+				Negative distances (from a formula) can lower the cost of a path, so no path can be abandoned early.
+			*/
+			const double distance = DTW_findPathInBand (me, & band, localSlope, DTW_getStoredDistances (me), 0.0, false, nullptr);
+			return ( maximumDistance > 0.0 && distance > maximumDistance ? undefined : distance );
 		}
+		return DTW_findPathInBand (me, & band, localSlope, DTW_getStoredDistances (me), maximumDistance, false, nullptr);
+	} catch (MelderError) {
+		Melder_throw (me, U": cannot determine the distance.");
+	}
+}
 
+double Sampleds_getDTWDistance_bandAndSlope (Sampled prototype, Sampled candidate, double sakoeChibaBand, int localSlope,
+	double maximumDistance, DTW_ColumnDistances const& columnDistances)
+{
+	try {
+		Melder_require (localSlope > 0 && localSlope < 5,
+			U"Local slope parameter ", localSlope, U" not supported.");
 		/*
-			Now we can set the unreachable parts from the Polygon.
+			A DTW without distances and path, only for the band.
 		*/
-		DTW_Polygon_setUnreachableParts (me, thee, psi.get());
-
-        // Forward pass.
-        integer numberOfIsolatedPoints = 0;
-        autoMelderProgress progress (U"Find path");
-        for (integer j = 2; j <= my nx; j ++) {
-            for (integer i = 2; i <= my ny; i ++) {
-                if (! DTW_ISREACHABLE (i, j)) continue;
-                double g, gmin = DTW_BIG;
-                integer direction = 0;
-                if (DTW_ISREACHABLE (i - 1, j - 1)) {
-                    gmin = delta [i - 1] [j - 1] + 2.0 * my z [i] [j];
-                    direction = DTW_XANDY;
-                } else if (DTW_ISREACHABLE (i, j - 1)) {
-                    gmin = delta [i] [j - 1] + my z [i] [j];
-                    direction = DTW_X;
-                } else if (DTW_ISREACHABLE (i - 1, j)) {
-                    gmin = delta [i - 1] [j] + my z [i] [j];
-                    direction = DTW_Y;
-                } else {
-                    numberOfIsolatedPoints ++;
-                    continue;
-                }
-
-                switch (localSlope) {
-                case 1:  {   // no restriction
-                    if (DTW_ISREACHABLE (i, j - 1) && ((g = delta [i] [j - 1] + my z [i] [j]) < gmin)) {
-                        gmin = g;
-                        direction = DTW_X;
-                    }
-                    if (DTW_ISREACHABLE (i - 1, j) && ((g = delta [i - 1] [j] + my z [i] [j]) < gmin)) {
-                        gmin = g;
-                        direction = DTW_Y;
-                    }
-                }
-                break;
-
-                // P = 1/2
-
-                case 2: {   // P = 1/2
-                    if (j >= 4 && DTW_ISREACHABLE (i - 1, j - 3) && psi [i] [j - 1] == DTW_X && psi [i] [j - 2] == DTW_XANDY &&
-                        (g = delta [i-1] [j-3] + 2.0 * my z [i] [j-2] + my z [i] [j-1] + my z [i] [j]) < gmin) {
-                        gmin = g;
-                        direction = DTW_X;
-                    }
-                    if (j >= 3 && DTW_ISREACHABLE (i - 1, j - 2) && psi [i] [j - 1] == DTW_XANDY &&
-                        (g = delta [i - 1] [j - 2] + 2.0 * my z [i] [j - 1] + my z [i] [j]) < gmin) {
-                        gmin = g;
-                        direction = DTW_X;
-                    }
-                    if (i >= 3 && DTW_ISREACHABLE (i - 2, j - 1) && psi [i - 1] [j] == DTW_XANDY &&
-                        (g = delta [i - 2] [j - 1] + 2.0 * my z [i - 1] [j] + my z [i] [j]) < gmin) {
-                        gmin = g;
-                        direction = DTW_Y;
-                    }
-                    if (i >= 4 && DTW_ISREACHABLE (i - 3, j - 1) && psi [i - 1] [j] == DTW_Y && psi [i - 2] [j] == DTW_XANDY &&
-                        (g = delta [i-3] [j-1] + 2.0 * my z [i-2] [j] + my z [i-1] [j] + my z [i] [j]) < gmin) {
-                        gmin = g;
-                        direction = DTW_Y;
-                    }
-                }
-                break;
-
-                // P = 1
-
-				case 3: {
-					if (j >= 3 && DTW_ISREACHABLE (i - 1, j - 2) && psi [i] [j - 1] == DTW_XANDY &&
-							(g = delta [i - 1] [j - 2] + 2.0 * my z [i] [j - 1] + my z [i] [j]) < gmin)
-					{
-						gmin = g;
-						direction = DTW_X;
-					}
-					if (i >= 3 && DTW_ISREACHABLE (i - 2, j - 1) && psi [i - 1] [j] == DTW_XANDY &&
-							(g = delta [i - 2] [j - 1] + 2.0 * my z [i - 1] [j] + my z [i] [j]) < gmin)
-					{
-						gmin = g;
-						direction = DTW_Y;
-					}
-				}
-				break;
-
-                // P = 2
-
-				case 4: {
-					if (i >= 3 && j >= 4 && DTW_ISREACHABLE (i - 2, j - 3) && psi [i] [j - 1] == DTW_XANDY && psi [i - 1] [j - 2] == DTW_XANDY &&
-							(g = delta [i-2] [j-3] + 2.0 * my z [i-1] [j-2] + 2.0 * my z [i] [j-1] + my z [i] [j]) < gmin)
-					{
-						gmin = g;
-						direction = DTW_X;
-					}
-					if (i >= 4 && j >= 3 && DTW_ISREACHABLE (i - 3, j - 2) && psi [i - 1] [j] == DTW_XANDY && psi [i - 2] [j - 1] == DTW_XANDY &&
-							(g = delta [i-3] [j-2] + 2.0 * my z [i-2] [j-1] + 2.0 * my z [i-1] [j] + my z [i] [j]) < gmin)
-					{
-						gmin = g;
-						direction = DTW_Y;
-					}
-				}
-                break;
-                default:
-                break;
-                }
-                Melder_assert (direction != 0);
-                psi [i] [j] = direction;
-                delta [i] [j] = gmin;
-            }
-            if ((j % 10) == 2)
-                Melder_progress (0.999 * j / my nx, U"Calculate time warp: frame ", j, U" from ", my nx, U".");
-        }
-
-        // Find minimum at end of path and trace back.
-
-        integer iy = my ny;
-        double minimum = delta [iy] [my nx];
-        for (integer i = my ny - 1; i > 0; i --) {
-            if (! DTW_ISREACHABLE (i, my nx)) {
-                break;   // we're in unreachable places
-            } else if (delta [i] [my nx] < minimum) {
-                minimum = delta [iy = i] [my nx];
-            }
-        }
-
-		integer pathIndex = my nx + my ny - 1;   // maximum path length
-        my weightedDistance = minimum / (my nx + my ny);
-        my path [pathIndex]. y = iy;
-        integer ix = my path [pathIndex]. x = my nx;
-
-        // Fill path backwards.
-
-        while (ix > 1) {
-            if (psi [iy] [ix] == DTW_XANDY) {
-                ix --;
-                iy --;
-            } else if (psi [iy] [ix] == DTW_X) {
-                ix --;
-            } else if (psi [iy] [ix] == DTW_Y) {
-                iy --;
-            } else if (psi [iy] [ix] == DTW_START) {
-                break;
-            }
-            if (pathIndex < 2 || iy < 1)
-            	break;
-            //Melder_assert (pathIndex > 1 && iy > 0);
-            my path [-- pathIndex]. x = ix;
-            my path [pathIndex]. y = iy;
-        }
-
-        my pathLength = my nx + my ny - 1 - pathIndex + 1;
-        if (pathIndex > 1)
-            for (integer j = 1; j <= my pathLength; j ++)
-                my path [j] = my path [pathIndex ++];
-
-        DTW_Path_recode (me);
-        if (cumulativeDists) {
-            autoMatrix him = Matrix_create (my xmin, my xmax, my nx, my dx, my x1,
-                my ymin, my ymax, my ny, my dy, my y1);
-			his z.all() <<= delta.all();
-            *cumulativeDists = him.move();
-        }
-    } catch (MelderError) {
-        Melder_throw (me, U": cannot find path.");
-    }
+		autoDTW geometry = Thing_new (DTW);
+		SampledXY_init (geometry.get(), candidate -> xmin, candidate -> xmax, candidate -> nx, candidate -> dx, candidate -> x1,
+				prototype -> xmin, prototype -> xmax, prototype -> nx, prototype -> dx, prototype -> x1);
+		autoPolygon thee = DTW_to_Polygon (geometry.get(), sakoeChibaBand, localSlope);
+		const DTW_Band band = DTW_Polygon_getBand (geometry.get(), thee.get(), localSlope);
+		return DTW_findPathInBand (geometry.get(), & band, localSlope, columnDistances, maximumDistance, false, nullptr);
+	} catch (MelderError) {
+		Melder_throw (prototype, U" & ", candidate, U": cannot determine the DTW distance.");
+	}
 }
 
 /* End of file DTW.cpp */
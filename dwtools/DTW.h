@@ -28,6 +28,7 @@
 #include "Pitch.h"
 #include "DurationTier.h"
 #include "Sound.h"
+#include <functional>
 
 #include "DTW_def.h"
 
@@ -53,6 +54,31 @@ autoDTW DTW_swapAxes (DTW me);
 
 void DTW_findPath_bandAndSlope (DTW me, double sakoeChibaBand, int localSlope, autoMatrix *cumulativeDists);
 
+/*
+	The local distances of the cells fromRow .. toRow of column `column`,
+	i.e. between the frames fromRow .. toRow of the prototype and frame `column` of the candidate.
+	May be called from several threads at a time.
+*/
+using DTW_ColumnDistances = std::function <void (integer column, integer fromRow, integer toRow, VEC result)>;
+
+void DTW_computeDistances (DTW me, DTW_ColumnDistances const& columnDistances);
+
+double DTW_getDistance_bandAndSlope (DTW me, double sakoeChibaBand, int localSlope, double maximumDistance);
+/*
+	The weighted distance along the optimal path, which is not stored.
+	If maximumDistance > 0, the computation is abandoned (and the result is undefined)
+	as soon as it is clear that the distance will exceed maximumDistance.
+*/
+
+double Sampleds_getDTWDistance_bandAndSlope (Sampled prototype, Sampled candidate, double sakoeChibaBand, int localSlope,
+	double maximumDistance, DTW_ColumnDistances const& columnDistances);
+/*
+	As DTW_getDistance_bandAndSlope for the DTW of the frames of the prototype (along y) and of the candidate (along x),
+	but without creating that DTW: the distances, which should not be negative, are computed only for the cells inside the band
+	and only when the search needs them, so that the memory grows with the width of the band instead of with the size of the DTW,
+	and a search that is abandoned early does not compute the remaining distances.
+*/
+
 void DTW_findPath (DTW me, bool matchStart, bool matchEnd, int slope); // deprecated
 /* Obsolete
 	Function:
@@ -117,6 +143,11 @@ autoDTW Matrices_to_DTW (Matrix me, Matrix thee, bool matchStart, bool matchEnd,
 
 autoDTW Spectrograms_to_DTW (Spectrogram me, Spectrogram thee, bool matchStart, bool matchEnd, int slope, double metric);
 
+double Spectrograms_getDTWDistance_bandAndSlope (Spectrogram me, Spectrogram thee, double metric, double sakoeChibaBand, int localSlope, double maximumDistance);
+/*
+	As Spectrograms_to_DTW followed by DTW_getDistance_bandAndSlope, but without the distance matrix.
+*/
+
 autoDTW Pitches_to_DTW (Pitch me, Pitch thee, double vuv_costs, double time_weight, bool matchStart, bool matchEnd, int slope);
 
 autoDurationTier DTW_to_DurationTier (DTW me);
@@ -2407,10 +2407,10 @@ void KlattGrid_formula_amplitudes (KlattGrid me, kKlattGridFormantType formantTy
 		const OrderedOf<structIntensityTier>* ordered = KlattGrid_getAddressOfAmplitudes (me, formantType);
 		for (integer irow = 1; irow <= ordered->size; irow ++) {
 			const IntensityTier amplitudes = ordered->at [irow];
-			Formula_compile (interpreter, amplitudes, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
+			autoFormulaProgram program = Formula_compile (interpreter, amplitudes, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 			Formula_Result result;
 			for (integer icol = 1; icol <= amplitudes -> points.size; icol ++) {
-				Formula_run (irow, icol, & result);
+				Formula_run (program.get(), irow, icol, & result);
 				Melder_require (isdefined (result. numericResult),
 					U"Cannot put an undefined value into the tier.\nFormula not finished.");
 				amplitudes -> points.at [icol] -> value = result. numericResult;
@@ -31,6 +31,8 @@
 #include "Sound_to_Pitch.h"
 #include "Vector.h"
 #include "NUM2.h"
+#include "MelderThread.h"
+#include <atomic>
 
 autoSound BandFilterSpectrogram_as_Sound (BandFilterSpectrogram me, int to_dB);
 
@@ -83,31 +85,163 @@ static autoSpectrum Sound_to_Spectrum_power (Sound me) {
 	}
 }
 
-static void Sound_into_BarkSpectrogram_frame (Sound me, BarkSpectrogram thee, integer frame) {
-	autoSpectrum him = Sound_to_Spectrum_power (me);
-	integer numberOfFrequencies = his nx;
+/*
+	The frequency sampling of `Sound_to_Spectrum_power (frame)`, without the values,
+	for frames with the length and sampling period of `window`.
+*/
+static autoSpectrum Sound_createFrameSpectrum (Sound window) {
+	integer numberOfSamples = 2;
+	while (numberOfSamples < window -> nx)
+		numberOfSamples *= 2;   // as in Sound_to_Spectrum (fast)
+	autoSpectrum thee = Spectrum_create (0.5 / window -> dx, numberOfSamples / 2 + 1);
+	thy dx = 1.0 / (window -> dx * numberOfSamples);
+	return thee;
+}
+
+/*
+	A filter bank as a sparse band matrix: filter `ifilter` weighs the power in the frequency bins
+	firstBin [ifilter] .. lastBin [ifilter] of a frame spectrum
+	with weights [firstWeight [ifilter]], weights [firstWeight [ifilter] + 1], ...
+	The weights are computed once per analysis rather than once per frame.
+*/
+struct BandFilterWeights {
+	autoINTVEC firstBin, lastBin, firstWeight;
+	autoVEC weights;
+};
+
+static BandFilterWeights BandFilterWeights_create (autoINTVEC firstBin, autoINTVEC lastBin) {
+	BandFilterWeights result;
+	result.firstWeight = newINTVECraw (firstBin.size);
+	integer numberOfWeights = 0;
+	for (integer ifilter = 1; ifilter <= firstBin.size; ifilter ++) {
+		result.firstWeight [ifilter] = numberOfWeights + 1;
+		numberOfWeights += std::max (0_integer, lastBin [ifilter] - firstBin [ifilter] + 1);
+	}
+	result.weights = newVECraw (numberOfWeights);
+	result.firstBin = firstBin.move();
+	result.lastBin = lastBin.move();
+	return result;
+}
 
+static BandFilterWeights BarkSpectrogram_getFilterWeights (BarkSpectrogram me, Spectrum frameSpectrum) {
+	const integer numberOfFrequencies = frameSpectrum -> nx;
 	autoVEC z = newVECraw (numberOfFrequencies);
 	for (integer ifreq = 1; ifreq <= numberOfFrequencies; ifreq ++) {
-		const double frequency_Hz = his x1 + (ifreq - 1) * his dx;
-		z [ifreq] = thy v_hertzToFrequency (frequency_Hz);
+		const double frequency_Hz = frameSpectrum -> x1 + (ifreq - 1) * frameSpectrum -> dx;
+		z [ifreq] = my v_hertzToFrequency (frequency_Hz);
 	}
-
-	for (integer i = 1; i <= thy ny; i ++) {
-		const double z0 = thy y1 + (i - 1) * thy dy;
-		constVEC pow = his z.row (1); // TODO ??
-		longdouble p = 0.0;
-		for (integer ifreq = 1; ifreq <= numberOfFrequencies; ifreq ++) {
+	/*
+		The Sekey & Hanson filter never becomes zero, so every band covers all frequencies.
+	*/
+	autoINTVEC firstBin = newINTVECraw (my ny), lastBin = newINTVECraw (my ny);
+	for (integer ifilter = 1; ifilter <= my ny; ifilter ++) {
+		firstBin [ifilter] = 1;
+		lastBin [ifilter] = numberOfFrequencies;
+	}
+	BandFilterWeights result = BandFilterWeights_create (firstBin.move(), lastBin.move());
+	for (integer ifilter = 1; ifilter <= my ny; ifilter ++) {
+		const double z0 = my y1 + (ifilter - 1) * my dy;
+		for (integer ifreq = 1; ifreq <= numberOfFrequencies; ifreq ++)
 			/*
 				Sekey & Hanson filter is defined in the power domain.
 				We therefore multiply the power with a (and not a^2).
 				integral (F(z),z=0..25) = 1.58/9
 			*/
-			const double a = NUMsekeyhansonfilter_amplitude (z0, z [ifreq]);
-			p += a * pow [ifreq] ;
+			result.weights [result.firstWeight [ifilter] + ifreq - 1] = NUMsekeyhansonfilter_amplitude (z0, z [ifreq]);
+	}
+	return result;
+}
+
+static BandFilterWeights MelSpectrogram_getFilterWeights (MelSpectrogram me, Spectrum frameSpectrum) {
+	autoINTVEC firstBin = newINTVECraw (my ny), lastBin = newINTVECraw (my ny);
+	for (integer ifilter = 1; ifilter <= my ny; ifilter ++) {
+		const double fc_mel = my y1 + (ifilter - 1) * my dy;
+		Sampled_getWindowSamples (frameSpectrum, my v_frequencyToHertz (fc_mel - my dy), my v_frequencyToHertz (fc_mel + my dy),
+				& firstBin [ifilter], & lastBin [ifilter]);
+	}
+	BandFilterWeights result = BandFilterWeights_create (firstBin.move(), lastBin.move());
+	for (integer ifilter = 1; ifilter <= my ny; ifilter ++) {
+		const double fc_mel = my y1 + (ifilter - 1) * my dy;
+		const double fc_hz = my v_frequencyToHertz (fc_mel);
+		const double fl_hz = my v_frequencyToHertz (fc_mel - my dy);
+		const double fh_hz =  my v_frequencyToHertz (fc_mel + my dy);
+		for (integer i = result.firstBin [ifilter]; i <= result.lastBin [ifilter]; i ++) {
+			/*
+				Bin with a triangular filter the power (= amplitude-squared)
+			*/
+			const double f = frameSpectrum -> x1 + (i - 1) * frameSpectrum -> dx;
+			result.weights [result.firstWeight [ifilter] + i - result.firstBin [ifilter]] = NUMtriangularfilter_amplitude (fl_hz, fc_hz, fh_hz, f);
 		}
-		thy z [i] [frame] = double (p);
 	}
+	return result;
+}
+
+/*
+	Fill the frames of a BarkSpectrogram or MelSpectrogram from the first channel of `me`,
+	computing exactly what Sound_to_Spectrum_power () followed by the filter sums would compute per frame.
+	The frames are analysed in parallel; every thread has its own FFT table and buffers.
+*/
+static void Sound_into_BandFilterSpectrogram (Sound me, BandFilterSpectrogram thee, Sound window, Spectrum frameSpectrum,
+	BandFilterWeights const& filters, conststring32 analysisName)
+{
+	const double windowDuration = window -> xmax - window -> xmin;
+	const integer numberOfSamples_window = window -> nx, numberOfFrequencies = frameSpectrum -> nx;
+	const integer numberOfSamples_fft = 2 * (numberOfFrequencies - 1);
+	const double amplitudeScaling = window -> dx;
+	const double powerScaling = 2.0 * frameSpectrum -> dx / windowDuration;
+	/*
+		factor '2' because we combine positive and negative frequencies
+		frameSpectrum -> dx : width of frequency bin
+		windowDuration : duration of sound
+	*/
+	const integer numberOfFrames = thy nx;
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfFrames, 20);
+	autoMAT dataBuffers = newMATraw (numberOfThreads, numberOfSamples_fft);
+	autoMAT powerBuffers = newMATraw (numberOfThreads, numberOfFrequencies);
+	std::vector <autoNUMfft_Table> fftTables (uinteger (numberOfThreads + 1));   // base 1
+	for (integer ithread = 1; ithread <= numberOfThreads; ithread ++)
+		NUMfft_Table_init (& fftTables [ithread], numberOfSamples_fft);
+	std::atomic <integer> numberOfFramesDone (0);
+
+	autoMelderProgress progress (analysisName);
+
+	MelderThread_parallelFor (numberOfFrames, numberOfThreads, [&] (integer ithread, integer firstFrame, integer lastFrame) {
+		VEC data = dataBuffers.row (ithread), power = powerBuffers.row (ithread);
+		for (integer iframe = firstFrame; iframe <= lastFrame; iframe ++) {
+			const double t = Sampled_indexToX (thee, iframe);
+			const integer index = Sampled_xToNearestIndex (me, t - windowDuration / 2.0);   // as in Sound_into_Sound
+			for (integer i = 1; i <= numberOfSamples_window; i ++) {
+				const integer j = index - 1 + i;
+				data [i] = ( j < 1 || j > my nx ? 0.0 : my z [1] [j] ) * window -> z [1] [i];
+			}
+			data.part (numberOfSamples_window + 1, numberOfSamples_fft)  <<=  0.0;
+			NUMfft_forward (& fftTables [ithread], data);
+
+			power [1] = powerScaling * ((data [1] * amplitudeScaling) * (data [1] * amplitudeScaling));
+			for (integer i = 2; i < numberOfFrequencies; i ++) {
+				const double re = data [i + i - 2] * amplitudeScaling, im = data [i + i - 1] * amplitudeScaling;
+				power [i] = powerScaling * (re * re + im * im);
+			}
+			const double re_nyquist = data [numberOfSamples_fft] * amplitudeScaling;
+			power [numberOfFrequencies] = powerScaling * (re_nyquist * re_nyquist);
+			/*
+				Correction of frequency bins at 0 Hz and nyquist: don't count for two.
+			*/
+			power [1] *= 0.5;
+			power [numberOfFrequencies] *= 0.5;
+
+			for (integer ifilter = 1; ifilter <= thy ny; ifilter ++) {
+				longdouble sum = 0.0;
+				for (integer i = filters.firstBin [ifilter], iweight = filters.firstWeight [ifilter]; i <= filters.lastBin [ifilter]; i ++)
+					sum += filters.weights [iweight ++] * power [i];
+				thy z [ifilter] [iframe] = double (sum);
+			}
+		}
+		numberOfFramesDone += lastFrame - firstFrame + 1;
+		if (ithread == 1)   // only the calling thread can show progress (and be cancelled)
+			Melder_progress (numberOfFramesDone / (numberOfFrames + 1.0),
+				analysisName, U": frame ", numberOfFramesDone.load (), U" out of ", numberOfFrames, U".");
+	});
 }
 
 autoBarkSpectrogram Sound_to_BarkSpectrogram (Sound me, double analysisWidth, double dt, double f1_bark, double fmax_bark, double df_bark) {
@@ -134,23 +268,12 @@ autoBarkSpectrogram Sound_to_BarkSpectrogram (Sound me, double analysisWidth, do
 		integer numberOfFrames;
 		double t1;
 		Sampled_shortTermAnalysis (me, windowDuration, dt, & numberOfFrames, & t1);
-		autoSound sframe = Sound_createSimple (1, windowDuration, samplingFrequency);
 		autoSound window = Sound_createGaussian (windowDuration, samplingFrequency);
 		autoBarkSpectrogram thee = BarkSpectrogram_create (my xmin, my xmax, numberOfFrames, dt, t1, fmin_bark, fmax_bark, numberOfFilters, df_bark, f1_bark);
 
-		autoMelderProgress progess (U"BarkSpectrogram analysis");
-
-		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
-			const double t = Sampled_indexToX (thee.get(), iframe);
-
-			Sound_into_Sound (me, sframe.get(), t - windowDuration / 2.0);
-			Sounds_multiply (sframe.get(), window.get());
-			Sound_into_BarkSpectrogram_frame (sframe.get(), thee.get(), iframe);
-
-			if (iframe % 10 == 1)
-				Melder_progress ( (double) iframe / numberOfFrames,  U"BarkSpectrogram analysis: frame ",
-					iframe, U" from ", numberOfFrames, U".");
-		}
+		autoSpectrum frameSpectrum = Sound_createFrameSpectrum (window.get());
+		const BandFilterWeights filters = BarkSpectrogram_getFilterWeights (thee.get(), frameSpectrum.get());
+		Sound_into_BandFilterSpectrogram (me, thee.get(), window.get(), frameSpectrum.get(), filters, U"BarkSpectrogram analysis");
 		
 		_Spectrogram_windowCorrection ((Spectrogram) thee.get(), window -> nx);
 
@@ -160,29 +283,6 @@ autoBarkSpectrogram Sound_to_BarkSpectrogram (Sound me, double analysisWidth, do
 	}
 }
 
-static void Sound_into_MelSpectrogram_frame (Sound me, MelSpectrogram thee, integer frame) {
-	autoSpectrum him = Sound_to_Spectrum_power (me);
-
-	for (integer ifilter = 1; ifilter <= thy ny; ifilter ++) {
-		longdouble power = 0.0;
-		const double fc_mel = thy y1 + (ifilter - 1) * thy dy;
-		const double fc_hz = thy v_frequencyToHertz (fc_mel);
-		const double fl_hz = thy v_frequencyToHertz (fc_mel - thy dy);
-		const double fh_hz =  thy v_frequencyToHertz (fc_mel + thy dy);
-		integer ifrom, ito;
-		Sampled_getWindowSamples (him.get(), fl_hz, fh_hz, & ifrom, & ito);
-		for (integer i = ifrom; i <= ito; i ++) {
-			/*
-				Bin with a triangular filter the power (= amplitude-squared)
-			*/
-			const double f = his x1 + (i - 1) * his dx;
-			const double a = NUMtriangularfilter_amplitude (fl_hz, fc_hz, fh_hz, f);
-			power += a * his z [1] [i];
-		}
-		thy z [ifilter] [frame] = double (power);
-	}
-}
-
 autoMelSpectrogram Sound_to_MelSpectrogram (Sound me, double analysisWidth, double dt, double f1_mel, double fmax_mel, double df_mel) {
 	try {
 		const double samplingFrequency = 1.0 / my dx, nyquist = 0.5 * samplingFrequency;
@@ -211,21 +311,12 @@ autoMelSpectrogram Sound_to_MelSpectrogram (Sound me, double analysisWidth, doub
 		integer numberOfFrames;
 		double t1;
 		Sampled_shortTermAnalysis (me, windowDuration, dt, & numberOfFrames, & t1);
-		autoSound sframe = Sound_createSimple (1, windowDuration, samplingFrequency);
 		autoSound window = Sound_createGaussian (windowDuration, samplingFrequency);
 		autoMelSpectrogram thee = MelSpectrogram_create (my xmin, my xmax, numberOfFrames, dt, t1, fmin_mel, fmax_mel, numberOfFilters, df_mel, f1_mel);
 
-		autoMelderProgress progress (U"MelSpectrograms analysis");
-
-		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
-			const double t = Sampled_indexToX (thee.get(), iframe);
-			Sound_into_Sound (me, sframe.get(), t - windowDuration / 2.0);
-			Sounds_multiply (sframe.get(), window.get());
-			Sound_into_MelSpectrogram_frame (sframe.get(), thee.get(), iframe);
-			
-			if (iframe % 10 == 1)
-				Melder_progress ((double) iframe / numberOfFrames, U"Frame ", iframe, U" out of ", numberOfFrames, U".");
-		}
+		autoSpectrum frameSpectrum = Sound_createFrameSpectrum (window.get());
+		const BandFilterWeights filters = MelSpectrogram_getFilterWeights (thee.get(), frameSpectrum.get());
+		Sound_into_BandFilterSpectrogram (me, thee.get(), window.get(), frameSpectrum.get(), filters, U"MelSpectrogram analysis");
 		
 		_Spectrogram_windowCorrection ((Spectrogram) thee.get(), window -> nx);
 
@@ -1880,6 +1880,7 @@ static void Sound_findIntermediatePoint_bs (Sound me, integer ichannel, integer
 		thy z [channel] [1] = my z [channel] [ileft];
 		thy z [channel] [3] = my z [channel] [ileft + 1];
 	}
+	autoFormulaProgram program = Formula_compile (interpreter, thee.get(), formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 	integer istep = 1;
 	double xright = xleft + my dx, xmid; // !!
 	do {
@@ -1887,9 +1888,8 @@ static void Sound_findIntermediatePoint_bs (Sound me, integer ichannel, integer
 
 		for (integer channel = 1; channel <= my ny; channel ++)
 			thy z [channel] [2] = Vector_getValueAtX (me, xmid, channel, Vector_VALUE_INTERPOLATION_LINEAR);
-		Formula_compile (interpreter, thee.get(), formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 		Formula_Result result;
-		Formula_run (ichannel, 2, & result);
+		Formula_run (program.get(), ichannel, 2, & result);
 		const bool mid = ( result. numericResult != 0.0 );
 
 		thy dx *= 0.5;
@@ -1913,7 +1913,7 @@ static void Sound_findIntermediatePoint_bs (Sound me, integer ichannel, integer
 void Sound_drawWhere (Sound me, Graphics g, double tmin, double tmax, double minimum, double maximum,
 	bool garnish, conststring32 method, integer numberOfBisections, conststring32 formula, Interpreter interpreter) {
 	
-	Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
+	autoFormulaProgram program = Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 	Formula_Result result;
 
 	integer ixmin, ixmax;
@@ -1926,7 +1926,7 @@ void Sound_drawWhere (Sound me, Graphics g, double tmin, double tmax, double min
 		Graphics_setWindow (g, tmin, tmax, minimum - (my ny - channel) * (maximum - minimum), maximum + (channel - 1) * (maximum - minimum));
 		if (str32str (method, U"bars") || str32str (method, U"Bars")) {
 			for (integer ix = ixmin; ix <= ixmax; ix ++) {
-				Formula_run (channel, ix, & result);
+				Formula_run (program.get(), channel, ix, & result);
 				if (result. numericResult != 0.0) {
 					const double x = Sampled_indexToX (me, ix);
 					double y = my z [channel] [ix];
@@ -1944,7 +1944,7 @@ void Sound_drawWhere (Sound me, Graphics g, double tmin, double tmax, double min
 			}
 		} else if (str32str (method, U"poles") || str32str (method, U"Poles")) {
 			for (integer ix = ixmin; ix <= ixmax; ix ++) {
-				Formula_run (channel, ix, & result);
+				Formula_run (program.get(), channel, ix, & result);
 				if (result. numericResult != 0.0) {
 					const double x = Sampled_indexToX (me, ix);
 					double y = my z [channel] [ix];
@@ -1957,7 +1957,7 @@ void Sound_drawWhere (Sound me, Graphics g, double tmin, double tmax, double min
 			}
 		} else if (str32str (method, U"speckles") || str32str (method, U"Speckles")) {
 			for (integer ix = ixmin; ix <= ixmax; ix ++) {
-				Formula_run (channel, ix, & result);
+				Formula_run (program.get(), channel, ix, & result);
 				if (result. numericResult != 0.0) {
 					const double x = Sampled_indexToX (me, ix);
 					Graphics_speckle (g, x, my z [channel] [ix]);
@@ -1967,12 +1967,12 @@ void Sound_drawWhere (Sound me, Graphics g, double tmin, double tmax, double min
 			/*
 				The default: draw as a curve.
 			*/
-			Formula_run (channel, 1, & result);
+			Formula_run (program.get(), channel, 1, & result);
 			bool previous = (result. numericResult != 0.0); // numericResult == 0.0 means false!
 			integer istart = ixmin; // first sample of segment to be drawn
 			double xb, yb, xe, ye;
 			for (integer ix = ixmin + 1; ix <= ixmax; ix ++) {
-				Formula_run (channel, ix, & result);
+				Formula_run (program.get(), channel, ix, & result);
 				const bool current = (result. numericResult != 0.0); // numericResult == 0.0 means false!
 				if (previous && not current) {
 					/*
@@ -1980,7 +1980,6 @@ void Sound_drawWhere (Sound me, Graphics g, double tmin, double tmax, double min
 						1. Draw the curve between the sample numbers from istart to ix-1 (previous). 
 						2. Find the (x,y) in the interval between sample numbers ix-1 and ix (current) where the change from
 							T to F occurs and draw the line between the previous point and (x,y).
-						3. Compile the formula again because it has been changed during the interpolation
 					*/
 					xb = Matrix_columnToX (me, ix - 1);
 					yb = my z [channel] [ix - 1];
@@ -1990,19 +1989,16 @@ void Sound_drawWhere (Sound me, Graphics g, double tmin, double tmax, double min
 					}
 					Sound_findIntermediatePoint_bs (me, channel, ix - 1, previous, current, formula, interpreter, numberOfBisections, & xe, & ye);
 					Graphics_line (g, xb, yb, xe, ye);
-					Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 				} else if (not previous && current ) {
 					/*
 						F to T change: we are entering a segment to be drawn.
 						1. Find the (x,y) where the F changes to T and then draw the line from that (x,y) to the current point.
-						2. Compile the formula again
 					*/
 					istart = ix;
 					Sound_findIntermediatePoint_bs (me, channel, ix - 1, previous, current, formula, interpreter, numberOfBisections, & xb, & yb);
 					xe = Sampled_indexToX (me, ix);
 					ye = my z [channel] [ix];
 					Graphics_line (g, xb, yb, xe, ye);
-					Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 				}
 				previous = current;
 			}
@@ -2028,7 +2024,7 @@ void Sound_paintWhere (Sound me, Graphics g, MelderColour colour, double tmin, d
 	integer numberOfBisections, conststring32 formula, Interpreter interpreter)
 {
 	try {
-		Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
+		autoFormulaProgram program = Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 		Formula_Result result;
 
 		integer ixmin, ixmax;
@@ -2042,7 +2038,7 @@ void Sound_paintWhere (Sound me, Graphics g, MelderColour colour, double tmin, d
 			double tmini = tmin, tmaxi = tmax, xe, ye;
 			integer ix = ixmin;
 			do {
-				Formula_run (channel, ix, & result);
+				Formula_run (program.get(), channel, ix, & result);
 				current = ( result. numericResult != 0.0 );
 				if (ix == ixmin)
 					previous = current;
@@ -2054,7 +2050,6 @@ void Sound_paintWhere (Sound me, Graphics g, MelderColour colour, double tmin, d
 						tmaxi = xe;
 						fill = true;
 					}
-					Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 				}
 				if (ix == ixmax && current) {
 					tmaxi = tmax;
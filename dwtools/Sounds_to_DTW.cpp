@@ -31,9 +31,7 @@ autoDTW Sounds_to_DTW (Sound me, Sound thee, double analysisWidth, double dt, do
 		autoMFCC mfcc_me = Sound_to_MFCC (me, numberOfCoefficients, analysisWidth, dt, fmin_mel, fmax_mel, df_mel);
 		autoMFCC mfcc_thee = Sound_to_MFCC (thee, numberOfCoefficients, analysisWidth, dt, fmin_mel, fmax_mel, df_mel);
         constexpr double wc = 1.0, wle = 0.0, wr = 0.0, wer = 0.0, dtr = 0.0;
-        autoDTW him = CCs_to_DTW (mfcc_me.get(), mfcc_thee.get(), wc, wle, wr, wer, dtr);
-        autoPolygon p = DTW_to_Polygon (him.get(), band, slope);
-        DTW_Polygon_findPathInside (him.get(), p.get(), slope, 0);
+        autoDTW him = CCs_to_DTW_bandAndSlope (mfcc_me.get(), mfcc_thee.get(), wc, wle, wr, wer, dtr, band, slope);
 		return him;
 	} catch (MelderError) {
 		Melder_throw (me, U": no DTW created.");
@@ -247,10 +247,10 @@ static int synthCallback (short *wav, int numsamples, espeak_EVENT *events)
 
 conststring32 SpeechSynthesizer_getLanguageCode (SpeechSynthesizer me) {
 	try {
-		const integer irow = Table_searchColumn (espeakdata_languages_propertiesTable.get(), 2, my d_languageName.get());
+		const integer irow = Table_searchColumn (espeakdata_getLanguagesPropertiesTable (), 2, my d_languageName.get());
 		Melder_require (irow != 0,
 			U"Cannot find language \"", my d_languageName.get(), U"\".");
-		return Table_getStringValue_Assert (espeakdata_languages_propertiesTable.get(), irow, 1);
+		return Table_getStringValue_Assert (espeakdata_getLanguagesPropertiesTable (), irow, 1);
 	} catch (MelderError) {
 		Melder_throw (me, U": Cannot find language code.");
 	}
@@ -258,10 +258,10 @@ conststring32 SpeechSynthesizer_getLanguageCode (SpeechSynthesizer me) {
 
 conststring32 SpeechSynthesizer_getPhonemeCode (SpeechSynthesizer me) {
 	try {
-		const integer irow = Table_searchColumn (espeakdata_languages_propertiesTable.get(), 2, my d_phonemeSet.get());
+		const integer irow = Table_searchColumn (espeakdata_getLanguagesPropertiesTable (), 2, my d_phonemeSet.get());
 		Melder_require (irow != 0,
 			U"Cannot find phoneme set \"", my d_phonemeSet.get(), U"\".");
-		return Table_getStringValue_Assert (espeakdata_languages_propertiesTable.get(), irow, 1);
+		return Table_getStringValue_Assert (espeakdata_getLanguagesPropertiesTable (), irow, 1);
 	} catch (MelderError) {
 		Melder_throw (me, U": Cannot find phoneme code.");
 	}
@@ -269,10 +269,10 @@ conststring32 SpeechSynthesizer_getPhonemeCode (SpeechSynthesizer me) {
 
 conststring32 SpeechSynthesizer_getVoiceCode (SpeechSynthesizer me) {
 	try {
-		const integer irow = Table_searchColumn (espeakdata_voices_propertiesTable.get(), 2, my d_voiceName.get());
+		const integer irow = Table_searchColumn (espeakdata_getVoicesPropertiesTable (), 2, my d_voiceName.get());
 		Melder_require (irow != 0,
 			U": Cannot find voice variant \"", my d_voiceName.get(), U"\".");
-		return Table_getStringValue_Assert (espeakdata_voices_propertiesTable.get(), irow, 1);
+		return Table_getStringValue_Assert (espeakdata_getVoicesPropertiesTable (), irow, 1);
 	} catch (MelderError) {
 		Melder_throw (me, U": Cannot find voice code.");
 	}
@@ -615,88 +615,158 @@ static void espeakdata_SetVoiceByName (conststring32 languageName, conststring32
 	}
 }
 
-autoSound SpeechSynthesizer_to_Sound (SpeechSynthesizer me, conststring32 text, autoTextGrid *tg, autoTable *events) {
-	try {
+/*
+	espeak-ng keeps its state (phoneme data, voice, dictionary) in global variables,
+	so there is only one engine, which all SpeechSynthesizers share.
+	Initializing it and loading a voice with its dictionary takes much more time than synthesizing a short text,
+	so the engine stays initialized between texts, and the voice is loaded again only if
+	the settings of the SpeechSynthesizer differ from those with which the engine was last prepared.
+*/
+static bool theEngineIsInitialized = false;
+static MelderString theEngineSettings;   // empty if the voice has to be (re)loaded
+
+static void SpeechSynthesizer_releaseEngine () {
+	espeak_ng_Terminate ();
+	theEngineIsInitialized = false;
+	MelderString_empty (& theEngineSettings);
+}
+
+static void SpeechSynthesizer_prepareEngine (SpeechSynthesizer me) {
+	/*
+		pitchAdjustment_0_99 = a * log10 (my d_pitchAdjustment) + b,
+		where 0.5 <= my d_pitchAdjustment <= 2
+		pitchRange_0_99 = my d_pitchRange * 49.5,
+		where 0 <= my d_pitchRange <= 2
+	*/
+	const int pitchAdjustment_0_99 = (int) ((49.5 / log10(2.0)) * log10 (my d_pitchAdjustment) + 49.5);   // rounded towards zero
+	const int pitchRange_0_99 = (int) (my d_pitchRange * 49.5);   // rounded towards zero
+	const int wordgap_10ms = my d_wordgap * 100; // espeak wordgap is in units of 10 ms
+	const conststring32 languageCode = SpeechSynthesizer_getLanguageCode (me);
+	const conststring32 voiceCode = SpeechSynthesizer_getVoiceCode (me);
+	const bool phonemeSetDiffers = ! Melder_equ (my d_phonemeSet.get(), my d_languageName.get());
+	const conststring32 phonemeCode = ( phonemeSetDiffers ? SpeechSynthesizer_getPhonemeCode (me) : U"" );
+	autoMelderString settings;
+	MelderString_append (& settings, languageCode, U"+", voiceCode, U" ", phonemeCode, U" ", my d_wordsPerMinute, U" ",
+			pitchAdjustment_0_99, U" ", pitchRange_0_99, U" ", wordgap_10ms);
+
+	if (theEngineIsInitialized && Melder_equ (settings.string, theEngineSettings.string)) {
+		/*
+			The voice and its dictionary are still loaded.
+			Bring the wave generator into the state in which a new initialization would leave it,
+			so that the same text always gives the same sound.
+		*/
+		WavegenInit (samplerate_native, 0);
+		SynthesizeInit ();
+		DoVoiceChange (voice);
+		return;
+	}
+	if (! theEngineIsInitialized) {
 		espeak_ng_InitializePath (nullptr); // PATH_ESPEAK_DATA
 		espeak_ng_ERROR_CONTEXT context = { 0 };
 		espeak_ng_STATUS status = espeak_ng_Initialize (& context);
 		Melder_require (status == ENS_OK,
 			U"Internal espeak error.", status);
-		int synth_flags = espeakCHARS_WCHAR;
-		if (my d_inputTextFormat == SpeechSynthesizer_INPUT_TAGGEDTEXT)
-			synth_flags |= espeakSSML;
-		if (my d_inputTextFormat != SpeechSynthesizer_INPUT_TEXTONLY)
-			synth_flags |= espeakPHONEMES;
-		option_phoneme_events = espeakINITIALIZE_PHONEME_EVENTS; // extern int option_phoneme_events;
-		if (my d_outputPhonemeCoding == SpeechSynthesizer_PHONEMECODINGS_IPA)
-			option_phoneme_events |= espeakINITIALIZE_PHONEME_IPA;
-
-		espeak_ng_SetParameter (espeakRATE, my d_wordsPerMinute, 0);
-		/*
-			pitchAdjustment_0_99 = a * log10 (my d_pitchAdjustment) + b,
-			where 0.5 <= my d_pitchAdjustment <= 2
-			pitchRange_0_99 = my d_pitchRange * 49.5,
-			where 0 <= my d_pitchRange <= 2
-		*/
-		const int pitchAdjustment_0_99 = (int) ((49.5 / log10(2.0)) * log10 (my d_pitchAdjustment) + 49.5);   // rounded towards zero
-		espeak_ng_SetParameter (espeakPITCH, pitchAdjustment_0_99, 0);
-		const int pitchRange_0_99 = (int) (my d_pitchRange * 49.5);   // rounded towards zero
-		espeak_ng_SetParameter (espeakRANGE, pitchRange_0_99, 0);
-		const conststring32 languageCode = SpeechSynthesizer_getLanguageCode (me);
-		const conststring32 voiceCode = SpeechSynthesizer_getVoiceCode (me);
-		
-		espeak_ng_SetVoiceByName (Melder_peek32to8 (Melder_cat (languageCode, U"+", voiceCode)));
-		const int wordgap_10ms = my d_wordgap * 100; // espeak wordgap is in units of 10 ms
-		espeak_ng_SetParameter (espeakWORDGAP, wordgap_10ms, 0);
-		espeak_ng_SetParameter (espeakCAPITALS, 0, 0);
-		espeak_ng_SetParameter (espeakPUNCTUATION, espeakPUNCT_NONE, 0);
-		
 		status = espeak_ng_InitializeOutput (ENOUTPUT_MODE_SYNCHRONOUS, 2048, nullptr);
 		espeak_SetSynthCallback (synthCallback);
-		if (! Melder_equ (my d_phonemeSet.get(), my d_languageName.get())) {
-			const conststring32 phonemeCode = SpeechSynthesizer_getPhonemeCode (me);
-			const int index_phon_table_list = LookupPhonemeTable (Melder_peek32to8 (phonemeCode));
-			if (index_phon_table_list > 0) {
-				voice -> phoneme_tab_ix = index_phon_table_list;
-				DoVoiceChange(voice);
-			}
-		}
+		theEngineIsInitialized = true;
+	} else {
+		WavegenInit (samplerate_native, 0);
+		SynthesizeInit ();
+	}
+	MelderString_empty (& theEngineSettings);
 
-		my d_events = Table_createWithColumnNames (0, U"time type type-t t-pos length a-pos sample id uniq");
-
-		#ifdef _WIN32
-			conststringW textW = Melder_peek32toW (text);
-			espeak_ng_Synthesize (textW, wcslen (textW) + 1, 0, POS_CHARACTER, 0, synth_flags, nullptr, me);
-		#else
-			espeak_ng_Synthesize (text, str32len (text) + 1, 0, POS_CHARACTER, 0, synth_flags, nullptr, me);
-		#endif
-				
-		espeak_ng_Terminate ();
-		autoSound thee = buffer_to_Sound (my d_wav.get(), my d_internalSamplingFrequency);
-
-		if (my d_samplingFrequency != my d_internalSamplingFrequency)
-			thee = Sound_resample (thee.get(), my d_samplingFrequency, 50);
-		my d_numberOfSamples = 0; // re-use the wav-buffer
-		if (tg) {
-			double xmin = Table_getNumericValue_Assert (my d_events.get(), 1, 1);
-			if (xmin > thy xmin)
-				xmin = thy xmin;
-			double xmax = Table_getNumericValue_Assert (my d_events.get(), my d_events -> rows.size, 1);
-			if (xmax < thy xmax)
-				xmax = thy xmax;
-			autoTextGrid tg1 = Table_to_TextGrid (my d_events.get(), text, xmin, xmax);
-			*tg = TextGrid_extractPart (tg1.get(), thy xmin, thy xmax, 0);
-		}
-		if (events) {
-			Table_setEventTypeString (my d_events.get());
-			*events = my d_events.move();
+	espeak_ng_SetParameter (espeakRATE, my d_wordsPerMinute, 0);
+	espeak_ng_SetParameter (espeakPITCH, pitchAdjustment_0_99, 0);
+	espeak_ng_SetParameter (espeakRANGE, pitchRange_0_99, 0);
+	
+	espeak_ng_SetVoiceByName (Melder_peek32to8 (Melder_cat (languageCode, U"+", voiceCode)));
+	espeak_ng_SetParameter (espeakWORDGAP, wordgap_10ms, 0);
+	espeak_ng_SetParameter (espeakCAPITALS, 0, 0);
+	espeak_ng_SetParameter (espeakPUNCTUATION, espeakPUNCT_NONE, 0);
+	
+	if (phonemeSetDiffers) {
+		const int index_phon_table_list = LookupPhonemeTable (Melder_peek32to8 (phonemeCode));
+		if (index_phon_table_list > 0) {
+			voice -> phoneme_tab_ix = index_phon_table_list;
+			DoVoiceChange(voice);
 		}
-		my d_events.reset();
-		return thee;
+	}
+	MelderString_copy (& theEngineSettings, settings.string);
+}
+
+/*
+	The engine has to be prepared.
+*/
+static autoSound SpeechSynthesizer_synthesize (SpeechSynthesizer me, conststring32 text, autoTextGrid *tg, autoTable *events) {
+	int synth_flags = espeakCHARS_WCHAR;
+	if (my d_inputTextFormat == SpeechSynthesizer_INPUT_TAGGEDTEXT)
+		synth_flags |= espeakSSML;
+	if (my d_inputTextFormat != SpeechSynthesizer_INPUT_TEXTONLY)
+		synth_flags |= espeakPHONEMES;
+	option_phoneme_events = espeakINITIALIZE_PHONEME_EVENTS; // extern int option_phoneme_events;
+	if (my d_outputPhonemeCoding == SpeechSynthesizer_PHONEMECODINGS_IPA)
+		option_phoneme_events |= espeakINITIALIZE_PHONEME_IPA;
+
+	my d_events = Table_createWithColumnNames (0, U"time type type-t t-pos length a-pos sample id uniq");
+	my d_numberOfSamples = 0;
+
+	#ifdef _WIN32
+		conststringW textW = Melder_peek32toW (text);
+		espeak_ng_Synthesize (textW, wcslen (textW) + 1, 0, POS_CHARACTER, 0, synth_flags, nullptr, me);
+	#else
+		espeak_ng_Synthesize (text, str32len (text) + 1, 0, POS_CHARACTER, 0, synth_flags, nullptr, me);
+	#endif
+	if (my d_inputTextFormat == SpeechSynthesizer_INPUT_TAGGEDTEXT)
+		MelderString_empty (& theEngineSettings);   // a <voice> tag may have changed the voice
+
+	autoSound thee = buffer_to_Sound (my d_wav.get(), my d_internalSamplingFrequency);
+
+	if (my d_samplingFrequency != my d_internalSamplingFrequency)
+		thee = Sound_resample (thee.get(), my d_samplingFrequency, 50);
+	my d_numberOfSamples = 0; // re-use the wav-buffer
+	if (tg) {
+		double xmin = Table_getNumericValue_Assert (my d_events.get(), 1, 1);
+		if (xmin > thy xmin)
+			xmin = thy xmin;
+		double xmax = Table_getNumericValue_Assert (my d_events.get(), my d_events -> rows.size, 1);
+		if (xmax < thy xmax)
+			xmax = thy xmax;
+		autoTextGrid tg1 = Table_to_TextGrid (my d_events.get(), text, xmin, xmax);
+		*tg = TextGrid_extractPart (tg1.get(), thy xmin, thy xmax, 0);
+	}
+	if (events) {
+		Table_setEventTypeString (my d_events.get());
+		*events = my d_events.move();
+	}
+	my d_events.reset();
+	return thee;
+}
+
+autoSound SpeechSynthesizer_to_Sound (SpeechSynthesizer me, conststring32 text, autoTextGrid *tg, autoTable *events) {
+	try {
+		SpeechSynthesizer_prepareEngine (me);
+		return SpeechSynthesizer_synthesize (me, text, tg, events);
 	} catch (MelderError) {
-		espeak_Terminate ();
+		SpeechSynthesizer_releaseEngine ();
 		Melder_throw (U"SpeechSynthesizer: text not converted to Sound.");
 	}
 }
 
+autoSoundList SpeechSynthesizer_Strings_to_Sounds (SpeechSynthesizer me, Strings thee) {
+	try {
+		autoSoundList list = SoundList_create ();
+		for (integer istring = 1; istring <= thy numberOfStrings; istring ++) {
+			const conststring32 text = thy strings [istring].get();
+			SpeechSynthesizer_prepareEngine (me);   // loads the voice only the first time
+			autoSound sound = SpeechSynthesizer_synthesize (me, text ? text : U"", nullptr, nullptr);
+			Thing_setName (sound.get(), text && text [0] != U'\0' ? text : U"untitled");
+			list -> addItem_move (sound.move());
+		}
+		return list;
+	} catch (MelderError) {
+		SpeechSynthesizer_releaseEngine ();
+		Melder_throw (me, U" & ", thee, U": texts not converted to Sounds.");
+	}
+}
+
 /* End of file SpeechSynthesizer.cpp */
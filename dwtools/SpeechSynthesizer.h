@@ -24,6 +24,7 @@
 
 #include "Sound.h"
 #include "TextGrid.h"
+#include "Strings_.h"
 #include "espeak_ng.h"
 #include "FileInMemoryManager.h"
 #include "speech.h"
@@ -63,6 +64,9 @@ void SpeechSynthesizer_setSpeechOutputSettings (SpeechSynthesizer me, double sam
 
 autoSound SpeechSynthesizer_to_Sound (SpeechSynthesizer me, conststring32 text, autoTextGrid *tg, autoTable *events);
 
+autoSoundList SpeechSynthesizer_Strings_to_Sounds (SpeechSynthesizer me, Strings thee);
+/* One Sound per string, named after the string; the voice is loaded only once. */
+
 void SpeechSynthesizer_playText (SpeechSynthesizer me, conststring32 text);
 
 /* End of file SpeechSynthesizer.h */
@@ -4159,7 +4159,7 @@ void Table_boxPlotsWhere (Table me, Graphics g, conststring32 dataColumns_string
 		if (factorColumn < 1 || factorColumn > my numberOfColumns)
 			return;
 		const integer numberOfSelectedColumns = dataColumns.size;
-		Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
+		autoFormulaProgram program = Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 		Formula_Result result;
 		const integer numberOfData = my rows.size;
 		autoStringsIndex si = Table_to_StringsIndex_column (me, factorColumn);
@@ -4191,7 +4191,7 @@ void Table_boxPlotsWhere (Table me, Graphics g, conststring32 dataColumns_string
 				integer numberOfDataInLevelColumn = 0;
 				for (integer irow = 1; irow <= numberOfData; irow ++) {
 					if (si -> classIndex [irow] == ilevel) {
-						Formula_run (irow, dataColumns [icol], & result);
+						Formula_run (program.get(), irow, dataColumns [icol], & result);
 						if (result. numericResult != 0.0)
 							data [++ numberOfDataInLevelColumn] = Table_getNumericValue_Assert (me, irow, dataColumns [icol]);
 					}
@@ -4223,14 +4223,14 @@ void Table_distributionPlotWhere (Table me, Graphics g, integer dataColumn, doub
 	try {
 		if (dataColumn < 1 || dataColumn > my numberOfColumns)
 			return;
-		Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
+		autoFormulaProgram program = Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 		Formula_Result result;
 
 		Table_numericize_Assert (me, dataColumn);
 		integer mrow = 0;
 		autoMatrix thee = Matrix_create (1.0, 1.0, 1, 1.0, 1.0, 0.0, my rows.size + 1.0, my rows.size, 1.0, 1.0);
 		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			Formula_run (irow, dataColumn, & result);
+			Formula_run (program.get(), irow, dataColumn, & result);
 			if (result. numericResult != 0.0)
 				thy z [1] [++ mrow] = Table_getNumericValue_Assert (me, irow, dataColumn);
 		}
@@ -4271,10 +4271,10 @@ static MelderColour Strings_colourToValue  (Strings me, integer index) {
 
 integer Table_getNumberOfRowsWhere (Table me, conststring32 formula, Interpreter interpreter) {
 	integer numberOfRows = 0;
-	Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
+	autoFormulaProgram program = Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 	Formula_Result result;
 	for (integer irow = 1; irow <= my rows.size; irow ++) {
-		Formula_run (irow, 1, & result);
+		Formula_run (program.get(), irow, 1, & result);
 		if (result. numericResult != 0.0)
 			numberOfRows ++;
 	}
@@ -4286,12 +4286,12 @@ autoINTVEC Table_findRowsMatchingCriterion (Table me, conststring32 formula, Int
 		const integer numberOfMatches = Table_getNumberOfRowsWhere (me, formula, interpreter);
 		Melder_require (numberOfMatches > 0,
 			U"No rows selected.");
-		Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
+		autoFormulaProgram program = Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 		Formula_Result result;
 		autoINTVEC selectedRows = newINTVECzero (numberOfMatches);
 		integer n = 0;
 		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			Formula_run (irow, 1, & result);
+			Formula_run (program.get(), irow, 1, & result);
 			if (result. numericResult != 0.0)
 				selectedRows [ ++ n] = irow;
 		}
@@ -4539,13 +4539,13 @@ void Table_lagPlotWhere (Table me, Graphics g, integer column, integer lag, doub
 
 autoTable Table_extractRowsWhere (Table me, conststring32 formula, Interpreter interpreter) {
 	try {
-		Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
+		autoFormulaProgram program = Formula_compile (interpreter, me, formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 		Formula_Result result;
 		autoTable thee = Table_create (0, my numberOfColumns);
 		for (integer icol = 1; icol <= my numberOfColumns; icol ++)
 			thy columnHeaders [icol]. label = Melder_dup (my columnHeaders [icol]. label.get());
 		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			Formula_run (irow, 1, & result);
+			Formula_run (program.get(), irow, 1, & result);
 			if (result. numericResult != 0.0) {
 				const TableRow row = my rows.at [irow];
 				autoTableRow newRow = Data_copy (row);
@@ -31,11 +31,11 @@
 
 #include "espeakdata_FileInMemory.h"
 
-autoFileInMemoryManager espeak_ng_FileInMemoryManager;
-autoTable espeakdata_languages_propertiesTable;
-autoTable espeakdata_voices_propertiesTable;
-autoStrings espeakdata_voices_names;
-autoStrings espeakdata_languages_names;
+static autoFileInMemoryManager espeak_ng_FileInMemoryManager;
+static autoTable espeakdata_languages_propertiesTable;
+static autoTable espeakdata_voices_propertiesTable;
+static autoStrings espeakdata_voices_names;
+static autoStrings espeakdata_languages_names;
 
 #if 0
 static integer Table_getRownumberOfStringInColumn (Table me, conststring32 string, integer icol) {
@@ -51,22 +51,59 @@ static integer Table_getRownumberOfStringInColumn (Table me, conststring32 strin
 	return row;
 }
 #endif
-void espeakdata_praat_init () {
+FileInMemoryManager espeakdata_getFileInMemoryManager () {
+	if (! espeak_ng_FileInMemoryManager) {
+		try {
+			espeak_ng_FileInMemoryManager = create_espeak_ng_FileInMemoryManager ();
+			const int test = 1;
+			if (* ((char *) & test) != 1) { // (too?) simple endian test
+				espeak_ng_data_to_bigendian ();
+			}
+		} catch (MelderError) {
+			espeak_ng_FileInMemoryManager. reset ();
+			Melder_throw (U"Espeakdata initialization not performed.");
+		}
+	}
+	return espeak_ng_FileInMemoryManager.get();
+}
+
+static void espeakdata_createNamesAndProperties () {
+	if (espeakdata_voices_names)
+		return;   // already created
 	try {
-		espeak_ng_FileInMemoryManager = create_espeak_ng_FileInMemoryManager ();
 		espeakdata_languages_propertiesTable = Table_createAsEspeakLanguagesProperties ();
 		espeakdata_voices_propertiesTable = Table_createAsEspeakVoicesProperties ();
 		espeakdata_languages_names = Table_column_to_Strings (espeakdata_languages_propertiesTable.get(), 2);
 		espeakdata_voices_names = Table_column_to_Strings (espeakdata_voices_propertiesTable.get(), 2);
-		const int test = 1;
-		if (* ((char *) & test) != 1) { // (too?) simple endian test
-			espeak_ng_data_to_bigendian ();
-		}
 	} catch (MelderError) {
+		espeakdata_languages_propertiesTable. reset ();
+		espeakdata_voices_propertiesTable. reset ();
+		espeakdata_languages_names. reset ();
+		espeakdata_voices_names. reset ();
 		Melder_throw (U"Espeakdata initialization not performed.");
 	}
 }
 
+Strings espeakdata_getLanguageNames () {
+	espeakdata_createNamesAndProperties ();
+	return espeakdata_languages_names.get();
+}
+
+Strings espeakdata_getVoiceNames () {
+	espeakdata_createNamesAndProperties ();
+	return espeakdata_voices_names.get();
+}
+
+Table espeakdata_getLanguagesPropertiesTable () {
+	espeakdata_createNamesAndProperties ();
+	return espeakdata_languages_propertiesTable.get();
+}
+
+Table espeakdata_getVoicesPropertiesTable () {
+	espeakdata_createNamesAndProperties ();
+	return espeakdata_voices_propertiesTable.get();
+}
+
 #define ESPEAK_ISSPACE(c) (c == ' ' || c == '\t' || c == '\r' || c == '\n')
 
 // imitates fgets_strip for file in memory
@@ -149,7 +186,7 @@ static conststring32 get_stringAfterPrecursor_u8 (constvector<unsigned char> con
 autoTable Table_createAsEspeakVoicesProperties () {
 	try {
 		constexpr conststring32 criterion = U"/voices/!v/";
-		FileInMemorySet me = espeak_ng_FileInMemoryManager -> files.get();
+		FileInMemorySet me = espeakdata_getFileInMemoryManager () -> files.get();
 		const integer numberOfMatches = FileInMemorySet_findNumberOfMatches_path (me, kMelder_string :: CONTAINS, criterion);
 		autoTable thee = Table_createWithColumnNames (numberOfMatches, U"id name index gender age variant");
 		integer irow = 0;
@@ -189,7 +226,7 @@ autoTable Table_createAsEspeakVoicesProperties () {
 autoTable Table_createAsEspeakLanguagesProperties () {
 	try {
 		constexpr conststring32 criterion = U"/lang/";
-		FileInMemorySet me = espeak_ng_FileInMemoryManager -> files.get();
+		FileInMemorySet me = espeakdata_getFileInMemoryManager () -> files.get();
 		const integer numberOfMatches = FileInMemorySet_findNumberOfMatches_path (me, kMelder_string :: CONTAINS, criterion);
 		autoTable thee = Table_createWithColumnNames (numberOfMatches, U"id name index"); // old: Default English
 		integer irow = 0;
@@ -213,14 +250,15 @@ autoTable Table_createAsEspeakLanguagesProperties () {
 
 void espeakdata_getIndices (conststring32 language_string, conststring32 voice_string, int *p_languageIndex, int *p_voiceIndex) {
 	if (p_languageIndex) {
-		integer languageIndex = Strings_findString (espeakdata_languages_names.get(), language_string);
+		const Strings languageNames = espeakdata_getLanguageNames ();
+		integer languageIndex = Strings_findString (languageNames, language_string);
 		if (languageIndex == 0) {
 			if (Melder_equ (language_string, U"Default") || Melder_equ (language_string, U"English")) {
-				languageIndex = Strings_findString (espeakdata_languages_names.get(), U"English (Great Britain)");
+				languageIndex = Strings_findString (languageNames, U"English (Great Britain)");
 				Melder_casual (U"Language \"", language_string, U"\" is deprecated. Please use \"",
-					espeakdata_languages_names -> strings [languageIndex].get(), U"\".");
+					languageNames -> strings [languageIndex].get(), U"\".");
 			} else {
-				languageIndex = Table_searchColumn (espeakdata_languages_propertiesTable.get(), 1, language_string);
+				languageIndex = Table_searchColumn (espeakdata_getLanguagesPropertiesTable (), 1, language_string);
 				if (languageIndex == 0) {
 					Melder_throw (U"Language \"", language_string, U" is not a valid option.");
 				}
@@ -229,16 +267,17 @@ void espeakdata_getIndices (conststring32 language_string, conststring32 voice_s
 		*p_languageIndex = languageIndex;
 	}
 	if (p_voiceIndex) {
-		integer voiceIndex = Strings_findString (espeakdata_voices_names.get(), voice_string);
+		const Strings voiceNames = espeakdata_getVoiceNames ();
+		integer voiceIndex = Strings_findString (voiceNames, voice_string);
 		*p_voiceIndex = voiceIndex;
 		if (voiceIndex == 0) {
 			if (Melder_equ (voice_string, U"default")) {
-				voiceIndex = Strings_findString (espeakdata_voices_names.get(), U"Male1");
+				voiceIndex = Strings_findString (voiceNames, U"Male1");
 			} else if (Melder_equ (voice_string, U"f1")) {
-				voiceIndex = Strings_findString (espeakdata_voices_names.get(), U"Female1");
+				voiceIndex = Strings_findString (voiceNames, U"Female1");
 			} else {
 				// Try the bare file names
-				voiceIndex = Table_searchColumn (espeakdata_voices_propertiesTable.get(), 1, voice_string);
+				voiceIndex = Table_searchColumn (espeakdata_getVoicesPropertiesTable (), 1, voice_string);
 				if (voiceIndex == 0) {
 					Melder_throw (U"Voice variant ", voice_string, U" is not a valid option.");
 				}
@@ -247,7 +286,7 @@ void espeakdata_getIndices (conststring32 language_string, conststring32 voice_s
 		if (voiceIndex != *p_voiceIndex) {
 			*p_voiceIndex = voiceIndex;
 			Melder_casual (U"Voice \"", voice_string, U"\" is deprecated. Please use \"",
-				espeakdata_voices_names -> strings [*p_voiceIndex].get(), U"\".");
+				voiceNames -> strings [*p_voiceIndex].get(), U"\".");
 		} else {
 			// unknown voice, handled by interface
 		}
@@ -25,17 +25,21 @@
 autoFileInMemorySet create_espeak_ng_FileInMemorySet ();
 
 autoFileInMemoryManager create_espeak_ng_FileInMemoryManager ();
-extern autoFileInMemoryManager espeak_ng_FileInMemoryManager;
 
-extern autoStrings espeakdata_languages_names;
-extern autoStrings espeakdata_voices_names;
-extern autoTable espeakdata_languages_propertiesTable;
-extern autoTable espeakdata_voices_propertiesTable;
+FileInMemoryManager espeakdata_getFileInMemoryManager ();
+/*
+	The FileInMemoryManager with all the espeak-ng data files.
+	It is created on first use rather than at start-up,
+	because most sessions (and most scripts) never synthesize speech.
+*/
 
-void espeakdata_praat_init ();
+Strings espeakdata_getLanguageNames ();
+Strings espeakdata_getVoiceNames ();
+Table espeakdata_getLanguagesPropertiesTable ();
+Table espeakdata_getVoicesPropertiesTable ();
 /*
-	Creates the FileInMemoryManager espeak_ng_FileInMemoryManager ;
-	Creates Strings espeakdata_languages_names & espeakdata_voices_names
+	The names and properties of the espeak-ng languages and voice variants,
+	also created on first use.
 */
 
 autoTable Table_createAsEspeakLanguagesProperties ();
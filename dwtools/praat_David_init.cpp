@@ -490,6 +490,49 @@ DO
 	CONVERT_COUPLE_END (my name.get(), U"_", your name.get());
 }
 
+FORM (NEW1_CCs_to_DTW_bandAndSlope, U"CC: To DTW (band & slope)", nullptr) {
+	LABEL (U"Distance  between cepstral coefficients")
+	REAL (cepstralWeight, U"Cepstral weight", U"1.0")
+	REAL (logEnergyWeight, U"Log energy weight", U"0.0")
+	REAL (regressionWeight, U"Regression weight", U"0.0")
+	REAL (regressionLogEnergyWeight, U"Regression log energy weight", U"0.0")
+	REAL (regressionWindowLength, U"Regression window length (s)", U"0.056")
+	REAL (sakoeChibaBand, U"Sakoe-Chiba band (s)", U"0.1")
+	RADIO (slopeConstraint, U"Slope constraint", 1)
+		RADIOBUTTON (U"no restriction")
+		RADIOBUTTON (U"1/3 < slope < 3")
+		RADIOBUTTON (U"1/2 < slope < 2")
+		RADIOBUTTON (U"2/3 < slope < 3/2")
+	OK
+DO
+	CONVERT_COUPLE (CC)
+		autoDTW result = CCs_to_DTW_bandAndSlope (me, you, cepstralWeight, logEnergyWeight, regressionWeight, regressionLogEnergyWeight,
+				regressionWindowLength, sakoeChibaBand, slopeConstraint);
+	CONVERT_COUPLE_END (my name.get(), U"_", your name.get());
+}
+
+FORM (REAL_CCs_getDTWDistance_bandAndSlope, U"CC: Get DTW distance (band & slope)", nullptr) {
+	LABEL (U"Distance  between cepstral coefficients")
+	REAL (cepstralWeight, U"Cepstral weight", U"1.0")
+	REAL (logEnergyWeight, U"Log energy weight", U"0.0")
+	REAL (regressionWeight, U"Regression weight", U"0.0")
+	REAL (regressionLogEnergyWeight, U"Regression log energy weight", U"0.0")
+	REAL (regressionWindowLength, U"Regression window length (s)", U"0.056")
+	REAL (sakoeChibaBand, U"Sakoe-Chiba band (s)", U"0.1")
+	RADIO (slopeConstraint, U"Slope constraint", 1)
+		RADIOBUTTON (U"no restriction")
+		RADIOBUTTON (U"1/3 < slope < 3")
+		RADIOBUTTON (U"1/2 < slope < 2")
+		RADIOBUTTON (U"2/3 < slope < 3/2")
+	REAL (maximumDistance, U"Maximum distance (0 = none)", U"0.0")
+	OK
+DO
+	NUMBER_COUPLE (CC)
+		double result = CCs_getDTWDistance_bandAndSlope (me, you, cepstralWeight, logEnergyWeight, regressionWeight, regressionLogEnergyWeight,
+				regressionWindowLength, sakoeChibaBand, slopeConstraint, maximumDistance);
+	NUMBER_COUPLE_END (U" (weighted distance)")
+}
+
 DIRECT (NEW_CC_to_Matrix) {
 	CONVERT_EACH (CC)
 		autoMatrix result = CC_to_Matrix (me);
@@ -1843,6 +1886,21 @@ DIRECT (REAL_DTW_getDistance_weighted) {
 	NUMBER_ONE_END (U" (weighted distance)")
 }
 
+FORM (REAL_DTW_getDistance_bandAndSlope, U"DTW: Get distance (band & slope)", nullptr) {
+	REAL (sakoeChibaBand, U"Sakoe-Chiba band (s)", U"0.05")
+	RADIO (slopeConstraint, U"Slope constraint", 1)
+		RADIOBUTTON (U"no restriction")
+		RADIOBUTTON (U"1/3 < slope < 3")
+		RADIOBUTTON (U"1/2 < slope < 2")
+		RADIOBUTTON (U"2/3 < slope < 3/2")
+	REAL (maximumDistance, U"Maximum distance (0 = none)", U"0.0")
+	OK
+DO
+	NUMBER_ONE (DTW)
+		double result = DTW_getDistance_bandAndSlope (me, sakoeChibaBand, slopeConstraint, maximumDistance);
+	NUMBER_ONE_END (U" (weighted distance)")
+}
+
 FORM (REAL_DTW_getDistanceValue, U"DTW: Get distance value", nullptr) {
 	REAL (xTime, U"Time at x (s)", U"0.1")
 	REAL (yTime, U"Time at y (s)", U"0.1")
@@ -2605,7 +2663,7 @@ DO
 
 DIRECT (NEW1_FileInMemoryManager_create) {
 	CREATE_ONE
-		autoFileInMemoryManager result = Data_copy (espeak_ng_FileInMemoryManager.get());
+		autoFileInMemoryManager result = Data_copy (espeakdata_getFileInMemoryManager ());
 	CREATE_ONE_END (U"filesInMemory")
 }
 
@@ -5962,6 +6020,21 @@ DO
 	CONVERT_COUPLE_END (my name.get(), U"_", your name.get())
 }
 
+FORM (REAL_Spectrograms_getDTWDistance_bandAndSlope, U"Spectrograms: Get DTW distance (band & slope)", nullptr) {
+	REAL (sakoeChibaBand, U"Sakoe-Chiba band (s)", U"0.1")
+	RADIO (slopeConstraint, U"Slope constraint", 1)
+		RADIOBUTTON (U"no restriction")
+		RADIOBUTTON (U"1/3 < slope < 3")
+		RADIOBUTTON (U"1/2 < slope < 2")
+		RADIOBUTTON (U"2/3 < slope < 3/2")
+	REAL (maximumDistance, U"Maximum distance (0 = none)", U"0.0")
+	OK
+DO
+	NUMBER_COUPLE (Spectrogram)
+		double result = Spectrograms_getDTWDistance_bandAndSlope (me, you, 1.0, sakoeChibaBand, slopeConstraint, maximumDistance);
+	NUMBER_COUPLE_END (U" (weighted distance)")
+}
+
 /**************** Spectrum *******************************************/
 
 FORM (GRAPHICS_Spectrum_drawPhases, U"Spectrum: Draw phases", U"Spectrum: Draw phases...") {
@@ -6079,39 +6152,38 @@ DO
 		autoTable result;
 		conststring32 name = U"languages";
 		if (which == 1) {
-			result = Data_copy (espeakdata_languages_propertiesTable.get());
+			result = Data_copy (espeakdata_getLanguagesPropertiesTable ());
 		} else if (which == 2) {
-			result = Data_copy (espeakdata_voices_propertiesTable.get());
+			result = Data_copy (espeakdata_getVoicesPropertiesTable ());
 			name = U"voices";
 		}
 	CREATE_ONE_END (name)
 }
 
 FORM (NEW1_SpeechSynthesizer_create, U"Create SpeechSynthesizer", U"Create SpeechSynthesizer...") {
-	OPTIONMENUSTR (language_string, U"Language", (int) Strings_findString (espeakdata_languages_names.get(), U"English (Great Britain)"))
-	for (integer i = 1; i <= espeakdata_languages_names -> numberOfStrings; i ++) {
-		OPTION (espeakdata_languages_names -> strings [i].get());
+	OPTIONMENUSTR (language_string, U"Language", (int) Strings_findString (espeakdata_getLanguageNames (), U"English (Great Britain)"))
+	for (integer i = 1; i <= espeakdata_getLanguageNames () -> numberOfStrings; i ++) {
+		OPTION (espeakdata_getLanguageNames () -> strings [i].get());
 	}
-	OPTIONMENUSTR (voice_string, U"Voice variant", (int) Strings_findString (espeakdata_voices_names.get(), U"Female1"))
-	for (integer i = 1; i <= espeakdata_voices_names -> numberOfStrings; i ++) {
-		OPTION (espeakdata_voices_names -> strings [i].get());
+	OPTIONMENUSTR (voice_string, U"Voice variant", (int) Strings_findString (espeakdata_getVoiceNames (), U"Female1"))
+	for (integer i = 1; i <= espeakdata_getVoiceNames () -> numberOfStrings; i ++) {
+		OPTION (espeakdata_getVoiceNames () -> strings [i].get());
 	}
 	OK
 DO
 	CREATE_ONE
 		int languageIndex, voiceIndex;
 		espeakdata_getIndices (language_string, voice_string, & languageIndex, & voiceIndex);
-		autoSpeechSynthesizer result = SpeechSynthesizer_create (
-			espeakdata_languages_names -> strings [languageIndex].get(),
-			espeakdata_voices_names -> strings [voiceIndex].get()
-		);
-    CREATE_ONE_END (espeakdata_languages_names -> strings [languageIndex].get(), U"_", espeakdata_voices_names -> strings [voiceIndex].get())
+		conststring32 languageName = espeakdata_getLanguageNames () -> strings [languageIndex].get();
+		conststring32 voiceName = espeakdata_getVoiceNames () -> strings [voiceIndex].get();
+		autoSpeechSynthesizer result = SpeechSynthesizer_create (languageName, voiceName);
+    CREATE_ONE_END (languageName, U"_", voiceName)
 }
 
 FORM (MODIFY_SpeechSynthesizer_modifyPhonemeSet, U"SpeechSynthesizer: Modify phoneme set", nullptr) {
-	OPTIONMENU (phoneneSetIndex, U"Language", (int) Strings_findString (espeakdata_languages_names.get(), U"English (Great Britain)"))
-	for (integer i = 1; i <= espeakdata_languages_names -> numberOfStrings; i ++) {
-			OPTION (espeakdata_languages_names -> strings [i].get());
+	OPTIONMENU (phoneneSetIndex, U"Language", (int) Strings_findString (espeakdata_getLanguageNames (), U"English (Great Britain)"))
+	for (integer i = 1; i <= espeakdata_getLanguageNames () -> numberOfStrings; i ++) {
+			OPTION (espeakdata_getLanguageNames () -> strings [i].get());
 	}
 	OK
 /*	Does not work because me is not defined here.
@@ -6122,7 +6194,7 @@ FORM (MODIFY_SpeechSynthesizer_modifyPhonemeSet, U"SpeechSynthesizer: Modify pho
 	SET_OPTION (phoneneSetIndex, prefPhonemeSet)*/
 DO
 	MODIFY_EACH (SpeechSynthesizer)
-		my d_phonemeSet = Melder_dup (espeakdata_languages_names -> strings [phoneneSetIndex].get());
+		my d_phonemeSet = Melder_dup (espeakdata_getLanguageNames () -> strings [phoneneSetIndex].get());
 	MODIFY_EACH_END
 }
 
@@ -6245,6 +6317,15 @@ DO
 	MODIFY_EACH_END
 }
 
+/************* SpeechSynthesizer and Strings ************************/
+
+DIRECT (NEWMANY_SpeechSynthesizer_Strings_to_Sounds) {
+	CONVERT_TWO (SpeechSynthesizer, Strings)
+		autoSoundList result = SpeechSynthesizer_Strings_to_Sounds (me, you);
+		result -> classInfo = classCollection;   // YUCK, in order to force automatic unpacking
+	CONVERT_TWO_END (U"dummy")
+}
+
 /************* SpeechSynthesizer and TextGrid ************************/
 
 FORM (NEWMANY_SpeechSynthesizer_TextGrid_to_Sound, U"SpeechSynthesizer & TextGrid: To Sound", nullptr) {
@@ -7736,6 +7817,8 @@ void praat_CC_init (ClassInfo klas) {
 	praat_addAction1 (klas, 1, U"Get value...", nullptr, praat_HIDDEN + praat_DEPTH_1, REAL_CC_getValue);
 	praat_addAction1 (klas, 0, U"To Matrix", nullptr, 0, NEW_CC_to_Matrix);
 	praat_addAction1 (klas, 2, U"To DTW...", nullptr, 0, NEW1_CCs_to_DTW);
+	praat_addAction1 (klas, 2, U"To DTW (band & slope)...", nullptr, 0, NEW1_CCs_to_DTW_bandAndSlope);
+	praat_addAction1 (klas, 2, U"Get DTW distance (band & slope)...", nullptr, 0, REAL_CCs_getDTWDistance_bandAndSlope);
 }
 
 static void praat_Eigen_Matrix_project (ClassInfo klase, ClassInfo klasm); // deprecated 2014
@@ -7969,8 +8052,6 @@ void praat_uvafon_David_init () {
 	Thing_recognizeClassByOtherName (classFileInMemorySet, U"FilesInMemory");
 
 	structVowelEditor  :: f_preferences ();
-	
-	espeakdata_praat_init ();
 
 	praat_addMenuCommand (U"Objects", U"Technical", U"Report floating point properties", U"Report integer properties", 0, INFO_Praat_ReportFloatingPointProperties);
 	praat_addMenuCommand (U"Objects", U"Goodies", U"Get TukeyQ...", 0, praat_HIDDEN, REAL_Praat_getTukeyQ);
@@ -8276,6 +8357,7 @@ void praat_uvafon_David_init () {
 	praat_addAction1 (classDTW, 1, U"Get minimum distance", nullptr, 1, REAL_DTW_getMinimumDistance);
 	praat_addAction1 (classDTW, 1, U"Get maximum distance", nullptr, 1, REAL_DTW_getMaximumDistance);
 	praat_addAction1 (classDTW, 1, U"Get distance (weighted)", nullptr, 1, REAL_DTW_getDistance_weighted);
+	praat_addAction1 (classDTW, 1, U"Get distance (band & slope)...", nullptr, 1, REAL_DTW_getDistance_bandAndSlope);
 	praat_addAction1 (classDTW, 0, MODIFY_BUTTON, nullptr, 0, 0);
 	praat_addAction1 (classDTW, 0, U"Formula (distances)...", nullptr, 1, MODIFY_DTW_formula_distances);
 	praat_addAction1 (classDTW, 0, U"Set distance value...", nullptr, 1, MODIFY_DTW_setDistanceValue);
@@ -8704,6 +8786,7 @@ void praat_uvafon_David_init () {
 	praat_addAction2 (classSound, 1, classIntervalTier, 1, U"Cut parts matching label...", nullptr, 0, NEW1_Sound_IntervalTier_cutPartsMatchingLabel);
 
 	praat_addAction1 (classSpectrogram, 2, U"To DTW...", U"To Spectrum (slice)...", 1, NEW1_Spectrograms_to_DTW);
+	praat_addAction1 (classSpectrogram, 2, U"Get DTW distance (band & slope)...", U"To DTW...", 1, REAL_Spectrograms_getDTWDistance_bandAndSlope);
 
 	praat_addAction1 (classSpectrum, 0, U"Draw phases...", U"Draw (log freq)...", praat_DEPTH_1 | praat_HIDDEN, GRAPHICS_Spectrum_drawPhases);
 	praat_addAction1 (classSpectrum, 0, U"Set real value in bin...", U"Formula...", praat_HIDDEN | praat_DEPTH_1, MODIFY_Spectrum_setRealValueInBin);
@@ -8732,6 +8815,7 @@ void praat_uvafon_David_init () {
 		praat_addAction1 (classSpeechSynthesizer, 0, U"Estimate speech rate from speech...", nullptr, 1, MODIFY_SpeechSynthesizer_estimateSpeechRateFromSpeech);
 		praat_addAction1 (classSpeechSynthesizer, 0, U"Set speech output settings...", nullptr, praat_DEPTH_1 |praat_DEPRECATED_2017, MODIFY_SpeechSynthesizer_setSpeechOutputSettings);
 
+	praat_addAction2 (classSpeechSynthesizer, 1, classStrings, 1, U"To Sounds", nullptr, 0, NEWMANY_SpeechSynthesizer_Strings_to_Sounds);
 	praat_addAction2 (classSpeechSynthesizer, 1, classTextGrid, 1, U"To Sound...", nullptr, 0, NEWMANY_SpeechSynthesizer_TextGrid_to_Sound);
 	praat_addAction3 (classSpeechSynthesizer, 1, classSound, 1, classTextGrid, 1, U"To TextGrid (align)...", nullptr, 0, NEW1_SpeechSynthesizer_Sound_TextGrid_align);
     praat_addAction3 (classSpeechSynthesizer, 1, classSound, 1, classTextGrid, 1, U"To TextGrid (align,trim)...", nullptr, 0, NEW1_SpeechSynthesizer_Sound_TextGrid_align2);
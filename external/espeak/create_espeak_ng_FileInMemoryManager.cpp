@@ -21,7 +21,7 @@
 autoFileInMemoryManager create_espeak_ng_FileInMemoryManager () {
 	try{
 		autoFileInMemorySet espeak_ng = create_espeak_ng_FileInMemorySet ();
-		autoFileInMemoryManager me = FileInMemoryManager_create (espeak_ng.get());
+		autoFileInMemoryManager me = FileInMemoryManager_create (espeak_ng.move());
 		return me;
 	} catch (MelderError) {
 		Melder_throw (U"FileInMemoryManager for espeak-ng not created.");
@@ -26,8 +26,7 @@
 #include "synthesize.h"
 #include <errno.h>
 
-extern autoFileInMemoryManager espeak_ng_FileInMemoryManager;
-#define ESPEAK_FILEINMEMORYMANAGER espeak_ng_FileInMemoryManager.get()
+#define ESPEAK_FILEINMEMORYMANAGER espeakdata_getFileInMemoryManager ()
 
 FILE *espeak_io_fopen (const char * filename, const char * mode) {
 	return FileInMemoryManager_fopen (ESPEAK_FILEINMEMORYMANAGER, filename, mode);
@@ -79,7 +78,7 @@ int espeak_io_ungetc (int character, FILE * stream) {
 }
 /* This mimics GetFileLength of espeak-ng */
 int FileInMemoryManager_GetFileLength (FileInMemoryManager me, const char *filename) {
-		integer index = FileInMemorySet_lookUp (my files.get(), Melder_peek8to32(filename));
+		integer index = FileInMemoryManager_lookUp (me, Melder_peek8to32(filename));
 		if (index > 0) {
 			FileInMemory fim = static_cast<FileInMemory> (my files -> at [index]);
 			return fim -> d_numberOfBytes;
@@ -97,17 +96,7 @@ int FileInMemoryManager_GetFileLength (FileInMemoryManager me, const char *filen
 	If the filename is a directory it return -EISDIR
 */
 int espeak_io_GetFileLength (const char *filename) {
-	FileInMemorySet me = ESPEAK_FILEINMEMORYMANAGER -> files.get();
-	integer index = FileInMemorySet_lookUp (me, Melder_peek8to32(filename));
-	if (index > 0) {
-		FileInMemory fim = static_cast<FileInMemory> (my at [index]);
-		return fim -> d_numberOfBytes;
-	}
-	// Directory ??
-	if (FileInMemorySet_hasDirectory (me, Melder_peek8to32(filename))) {
-		return -EISDIR;
-	}
-	return -1;
+	return FileInMemoryManager_GetFileLength (ESPEAK_FILEINMEMORYMANAGER, filename);
 }
 
 /* 
@@ -341,36 +330,39 @@ void espeak_ng_data_to_bigendian () {
 	autoMelderString file;
 
 	MelderString_append (& file, Melder_peek8to32 (PATH_ESPEAK_DATA), U"/phondata-manifest");
-	integer index = FileInMemorySet_lookUp (my files.get(), file.string);
+	integer index = FileInMemoryManager_lookUp (me, file.string);
 	Melder_require (index > 0, U"phondata-manifest not present.");
 	FileInMemory manifest = (FileInMemory) my files -> at [index];
 
 	MelderString_empty (& file);
 	MelderString_append (& file, Melder_peek8to32 (PATH_ESPEAK_DATA), U"/phondata");
-	index = FileInMemorySet_lookUp (my files.get(), file.string);
+	index = FileInMemoryManager_lookUp (me, file.string);
 	Melder_require (index > 0, U"phondata not present.");
 	FileInMemory phondata = (FileInMemory) my files -> at [index];
 
 	autoFileInMemory phondata_new = phondata_to_bigendian (phondata, manifest);
 	my files -> replaceItem_move (phondata_new.move(), index);
+	FileInMemoryManager_invalidateIndex (me);
 
 	MelderString_empty (& file);
 	MelderString_append (& file, Melder_peek8to32 (PATH_ESPEAK_DATA), U"/phontab");
-	index = FileInMemorySet_lookUp (my files.get(), file.string);
+	index = FileInMemoryManager_lookUp (me, file.string);
 	Melder_require (index > 0, U"phonindex not present.");
 	FileInMemory phontab = (FileInMemory) my files -> at [index];
 
 	autoFileInMemory phontab_new = phontab_to_bigendian (phontab);	
 	my files -> replaceItem_move (phontab_new.move(), index);
+	FileInMemoryManager_invalidateIndex (me);
 
 	MelderString_empty (& file);
 	MelderString_append (& file, Melder_peek8to32 (PATH_ESPEAK_DATA), U"/phonindex");
-	index = FileInMemorySet_lookUp (my files.get(), file.string);
+	index = FileInMemoryManager_lookUp (me, file.string);
 	Melder_require (index > 0, U"phonindex not present.");
 	FileInMemory phonindex = (FileInMemory) my files -> at [index];
 
 	autoFileInMemory phonindex_new = phonindex_to_bigendian (phonindex);	
 	my files -> replaceItem_move (phonindex_new.move(), index);
+	FileInMemoryManager_invalidateIndex (me);
 }
 
 /* End of file espeak_io.cpp */
@@ -135,7 +135,7 @@ static double Sound_getPeak (Sound me, double tmin, double tmax, integer channel
 	return maximum - minimum;
 }
 */
-static double Sound_getHannWindowedRms (Sound me, double tmid, double widthLeft, double widthRight) {
+double Sound_getHannWindowedRms (Sound me, double tmid, double widthLeft, double widthRight) {
 	integer imin, imax;
 	if (Sampled_getWindowSamples (me, tmid - widthLeft, tmid + widthRight, & imin, & imax) < 3) return undefined;
 	longdouble sumOfSquares = 0.0, windowSumOfSquares = 0.0;
@@ -42,6 +42,11 @@ void Sound_AmplitudeTier_multiply_inplace (Sound me, AmplitudeTier intensity);
 autoSound Sound_AmplitudeTier_multiply (Sound me, AmplitudeTier intensity);
 
 autoAmplitudeTier PointProcess_Sound_to_AmplitudeTier_point (PointProcess me, Sound thee);
+double Sound_getHannWindowedRms (Sound me, double tmid, double widthLeft, double widthRight);
+/*
+	The root-mean-square of the sound around `tmid`, under a Hann window that is asymmetric if the widths differ.
+	This is the peak amplitude of a period in PointProcess_Sound_to_AmplitudeTier_period ().
+*/
 autoAmplitudeTier PointProcess_Sound_to_AmplitudeTier_period (PointProcess me, Sound thee,
 	double tmin, double tmax, double shortestPeriod, double longestPeriod, double maximumPeriodFactor);
 double AmplitudeTier_getShimmer_local (AmplitudeTier me, double shortestPeriod, double longestPeriod, double maximumAmplitudeFactor);
@@ -251,14 +251,14 @@ void FormantGrid_playPart (FormantGrid me, double tmin, double tmax, double samp
 
 void FormantGrid_formula_bandwidths (FormantGrid me, conststring32 expression, Interpreter interpreter, FormantGrid thee) {
 	try {
-		Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
+		autoFormulaProgram program = Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 		Formula_Result result;
 		if (! thee)
 			thee = me;
 		for (integer irow = 1; irow <= my formants.size; irow ++) {
 			const RealTier bandwidth = thy bandwidths.at [irow];
 			for (integer icol = 1; icol <= bandwidth -> points.size; icol ++) {
-				Formula_run (irow, icol, & result);
+				Formula_run (program.get(), irow, icol, & result);
 				if (isundef (result. numericResult))
 					Melder_throw (U"Cannot put an undefined value into the tier.\nFormula not finished.");
 				bandwidth -> points.at [icol] -> value = result. numericResult;
@@ -271,14 +271,14 @@ void FormantGrid_formula_bandwidths (FormantGrid me, conststring32 expression, I
 
 void FormantGrid_formula_frequencies (FormantGrid me, conststring32 expression, Interpreter interpreter, FormantGrid thee) {
 	try {
-		Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
+		autoFormulaProgram program = Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 		Formula_Result result;
 		if (! thee)
 			thee = me;
 		for (integer irow = 1; irow <= my formants.size; irow ++) {
 			const RealTier formant = thy formants.at [irow];
 			for (integer icol = 1; icol <= formant -> points.size; icol ++) {
-				Formula_run (irow, icol, & result);
+				Formula_run (program.get(), irow, icol, & result);
 				if (isundef (result. numericResult))
 					Melder_throw (U"Cannot put an undefined value into the tier.\nFormula not finished.");
 				formant -> points.at [icol] -> value = result. numericResult;
@@ -1,6 +1,6 @@
 /* LongSound.cpp
  *
- * Copyright (C) 1992-2008,2010-2019 Paul Boersma, 2007 Erez Volk (for FLAC and MP3)
+ * Copyright (C) 1992-2008,2010-2020 Paul Boersma, 2007 Erez Volk (for FLAC and MP3)
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -41,10 +41,23 @@
  * pb 2014/06/16 more support for more than 2 channels
  */
 
+#if defined (UNIX) || defined (macintosh)
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
 #include "LongSound.h"
 #include "Preferences.h"
 #include "flac_FLAC_stream_decoder.h"
 #include "mp3.h"
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
+#include "enums_getText.h"
+#include "LongSound_enums.h"
+#include "enums_getValue.h"
+#include "LongSound_enums.h"
 
 Thing_implement (LongSound, Sampled, 0);
 Thing_implement (SoundAndLongSoundList, Ordered, 0);
@@ -56,10 +69,17 @@ constexpr integer minimumBufferDuration = 10;   // seconds
 constexpr integer defaultBufferDuration = 60;   // seconds
 constexpr integer maximumBufferDuration = 10000;   // seconds
 
-static integer prefs_bufferLength;
+constexpr integer minimumCacheDuration = 10;   // seconds
+constexpr integer defaultCacheDuration = 300;   // seconds
+constexpr integer maximumCacheDuration = 100000;   // seconds
+
+static integer prefs_bufferLength, prefs_cacheLength;
+static kLongSound_cacheFormat prefs_cacheFormat;
 
 void LongSound_preferences () {
 	Preferences_addInteger (U"LongSound.bufferLength", & prefs_bufferLength, defaultBufferDuration);
+	Preferences_addInteger (U"LongSound.cacheLength", & prefs_cacheLength, defaultCacheDuration);
+	Preferences_addEnum (U"LongSound.cacheFormat", & prefs_cacheFormat, kLongSound_cacheFormat, kLongSound_cacheFormat::DEFAULT);
 }
 
 integer LongSound_getBufferSizePref_seconds () {
@@ -70,12 +90,100 @@ void LongSound_setBufferSizePref_seconds (integer size) {
 	prefs_bufferLength = Melder_clipped (minimumBufferDuration, size, maximumBufferDuration);
 }
 
+integer LongSound_getCacheSizePref_seconds () {
+	return prefs_cacheLength;
+}
+
+void LongSound_setCacheSizePref_seconds (integer size) {
+	prefs_cacheLength = Melder_clipped (minimumCacheDuration, size, maximumCacheDuration);
+}
+
+kLongSound_cacheFormat LongSound_getCacheFormatPref () {
+	return prefs_cacheFormat;
+}
+
+void LongSound_setCacheFormatPref (kLongSound_cacheFormat format) {
+	prefs_cacheFormat = format;
+}
+
+static void LongSound_unmapFile (LongSound me) noexcept {
+	#if defined (UNIX) || defined (macintosh)
+		if (my mappedFile)
+			munmap (my mappedFile, size_t (my mappedFileSize));
+	#endif
+	my mappedFile = nullptr;
+	my mappedFileSize = 0;
+	my mappedSamples = nullptr;
+}
+
+/*
+	Map the file into memory if its samples can be used as they are, i.e. as 16-bit integers in the byte order of this machine.
+	If anything is not as expected, the file is simply not mapped, and will be read in blocks instead.
+*/
+static void LongSound_mapFile (LongSound me) {
+	#if defined (UNIX) || defined (macintosh)
+		static const uint16 byteOrderTest = 1;
+		const bool machineIsLittleEndian = ( * (const uint8 *) & byteOrderTest == 1 );
+		const int nativeEncoding = ( machineIsLittleEndian ? Melder_LINEAR_16_LITTLE_ENDIAN : Melder_LINEAR_16_BIG_ENDIAN );
+		if (my encoding != nativeEncoding || my startOfData % 2 != 0)
+			return;
+		struct stat fileStatus;
+		if (fstat (fileno (my f), & fileStatus) != 0)
+			return;
+		const integer fileSize = integer (fileStatus. st_size);
+		if (fileSize < my startOfData + my nx * my numberOfChannels * integer (sizeof (int16)))
+			return;   // the file is shorter than its header says; reading it will give an error message at the right time
+		void *mappedFile = mmap (nullptr, size_t (fileSize), PROT_READ, MAP_SHARED, fileno (my f), 0);
+		if (mappedFile == MAP_FAILED)
+			return;
+		my mappedFile = mappedFile;
+		my mappedFileSize = fileSize;
+		my mappedSamples = reinterpret_cast <const int16 *> (static_cast <const uint8 *> (mappedFile) + my startOfData);
+	#else
+		(void) me;
+	#endif
+}
+
+struct structLongSoundPrefetcher {
+	std::thread thread;
+	std::mutex mutex;   // protects the decoder, the file position and the cache, as well as the members below
+	std::condition_variable requestsChanged;
+	std::vector <integer> requestedBlocks;   // in the order in which they will be needed
+	bool stopRequested = false, failed = false;
+	autoMAT samples;   // room for one block, so that the thread never has to allocate
+	autovector <uint8> bytes;
+};
+typedef struct structLongSoundPrefetcher *LongSoundPrefetcher;
+
+/*
+	Anything that uses the decoder or the cache holds the lock, but only if a prefetcher exists,
+	which can only have been started from the thread that uses the LongSound.
+*/
+static std::unique_lock <std::mutex> LongSound_lockDecoder (LongSound me) {
+	return my prefetcher ? std::unique_lock <std::mutex> (my prefetcher -> mutex) : std::unique_lock <std::mutex> ();
+}
+
+static void LongSound_stopPrefetching (LongSound me) noexcept {
+	if (! my prefetcher)
+		return;
+	{// scope
+		std::lock_guard <std::mutex> lock (my prefetcher -> mutex);
+		my prefetcher -> stopRequested = true;
+	}
+	my prefetcher -> requestsChanged. notify_one ();
+	my prefetcher -> thread. join ();
+	delete my prefetcher;
+	my prefetcher = nullptr;
+}
+
 void structLongSound :: v_destroy () noexcept {
 	/*
 		The play callback may contain a pointer to my buffer.
 		That pointer is about to dangle, so kill the playback.
 	*/
 	MelderAudio_stopPlaying (MelderAudio_IMPLICIT);
+	LongSound_stopPrefetching (this);   // before the decoder goes away
+	LongSound_unmapFile (this);
 	if (mp3f)
 		mp3f_delete (mp3f);
 	if (flacDecoder) {
@@ -117,13 +225,12 @@ static void _LongSound_FLAC_convertFloats (LongSound me, const int32 * const sam
 		case 32: multiplier = (1.0 / 32768.0 / 65536.0); break;
 		default: multiplier = 0.0;
 	}
-	for (integer i = 0; i < 2; ++i) {
-		const int32 *input = samples [i];
-		double *output = my compressedFloats [i];
-		if (! output ) continue;
+	for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++) {
+		const int32 *input = samples [ichan - 1];
+		double *output = my compressedFloats [ichan];
 		for (integer j = 0; j < numberOfSamples; ++j)
 			output [j] = (double) input [j] * multiplier;
-		my compressedFloats [i] += numberOfSamples;
+		my compressedFloats [ichan] += numberOfSamples;
 	}
 }
 
@@ -168,13 +275,12 @@ static void _LongSound_FLAC_error (const FLAC__StreamDecoder * /* decoder */, FL
 }
 
 static void _LongSound_MP3_convertFloats (LongSound me, const MP3F_SAMPLE *channels [MP3F_MAX_CHANNELS], integer numberOfSamples) {
-	for (integer i = 0; i < 2; ++i) {
-		const MP3F_SAMPLE *input = channels [i];
-		double *output = my compressedFloats [i];
-		if (! output ) continue;
+	for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++) {
+		const MP3F_SAMPLE *input = channels [ichan - 1];
+		double *output = my compressedFloats [ichan];
 		for (integer j = 0; j < numberOfSamples; ++j)
 			output [j] = mp3f_sample_to_float (input [j]);
-		my compressedFloats [i] += numberOfSamples;
+		my compressedFloats [ichan] += numberOfSamples;
 	}
 }
 
@@ -203,6 +309,45 @@ static void _LongSound_MP3_convert (const MP3F_SAMPLE *channels [MP3F_MAX_CHANNE
 	my compressedSamplesLeft -= numberOfSamples;
 }
 
+static void LongSound_initCache (LongSound me, integer numberOfFlacBitsPerSample) {
+	const bool isFlac = ( my encoding == Melder_FLAC_COMPRESSION_16 );
+	const bool is16bit = ( my encoding == Melder_LINEAR_16_BIG_ENDIAN || my encoding == Melder_LINEAR_16_LITTLE_ENDIAN ||
+			isFlac && numberOfFlacBitsPerSample <= 16 );
+	const bool is24bit = ( my encoding == Melder_LINEAR_24_BIG_ENDIAN || my encoding == Melder_LINEAR_24_LITTLE_ENDIAN ||
+			isFlac && numberOfFlacBitsPerSample <= 24 );
+	const bool is32bit = ( my encoding == Melder_LINEAR_32_BIG_ENDIAN || my encoding == Melder_LINEAR_32_LITTLE_ENDIAN || isFlac );
+	const bool isFloat = ( my encoding == Melder_IEEE_FLOAT_32_BIG_ENDIAN || my encoding == Melder_IEEE_FLOAT_32_LITTLE_ENDIAN );
+	my cacheFormat = prefs_cacheFormat;
+	if (my cacheFormat == kLongSound_cacheFormat::AUTOMATIC)
+		my cacheFormat =
+			is16bit ? kLongSound_cacheFormat::INT16 :
+			is24bit || is32bit ? kLongSound_cacheFormat::INT32 :
+			isFloat || my encoding == Melder_IEEE_FLOAT_64_BIG_ENDIAN || my encoding == Melder_IEEE_FLOAT_64_LITTLE_ENDIAN ?
+				kLongSound_cacheFormat::FLOAT32 :
+			kLongSound_cacheFormat::INT16;   // 8-bit, mu-law, A-law, MP3
+	/*
+		All sample values are converted to 16 bits and to floats with scale factors that are powers of two,
+		so that e.g. a 24-bit sample survives the trip through a 32-bit integer or a 32-bit float intact.
+	*/
+	my cacheIsExact =
+		my cacheFormat == kLongSound_cacheFormat::INT16 ? is16bit :
+		my cacheFormat == kLongSound_cacheFormat::INT32 ? is16bit || is24bit || is32bit :
+		is16bit || is24bit || isFloat;
+	const integer numberOfBlocksInFile = (my nx - 1) / LongSound_CACHE_BLOCK_SIZE + 1;
+	const integer numberOfCacheBlocks = Melder_iroundUp (prefs_cacheLength * my sampleRate / LongSound_CACHE_BLOCK_SIZE);
+	my numberOfCacheBlocks = std::min (std::max (integer (2), numberOfCacheBlocks), numberOfBlocksInFile);   // a short file has only one block
+	const integer cacheSize = my numberOfCacheBlocks * LongSound_CACHE_BLOCK_SIZE * my numberOfChannels;
+	if (my cacheFormat == kLongSound_cacheFormat::INT16)
+		my cache = newvectorraw <int16> (cacheSize);
+	else if (my cacheFormat == kLongSound_cacheFormat::INT32)
+		my cache32 = newvectorraw <int32> (cacheSize);
+	else
+		my cacheFloats = newvectorraw <float> (cacheSize);
+	my cachedBlockNumbers = newINTVECzero (my numberOfCacheBlocks);
+	my cacheBlockLastUse = newINTVECzero (my numberOfCacheBlocks);
+	my cacheUseCount = 0;
+}
+
 static void LongSound_init (LongSound me, MelderFile file) {
 	MelderFile_copy (file, & my file);
 	MelderFile_open (file);   // BUG: should be auto, but that requires an implemented .transfer()
@@ -234,10 +379,17 @@ static void LongSound_init (LongSound me, MelderFile file) {
 	}
 	my imin = 1;
 	my imax = 0;
+	my previousWindowFirstSample = 1;
+	my previousWindowLastSample = 0;
+	LongSound_mapFile (me);
+	my compressedFloats = newvectorzero <double *> (my numberOfChannels);
 	my flacDecoder = nullptr;
+	integer numberOfFlacBitsPerSample = 16;
 	if (my audioFileType == Melder_FLAC) {
 		my flacDecoder = FLAC__stream_decoder_new ();
 		FLAC__stream_decoder_init_FILE (my flacDecoder, my f, _LongSound_FLAC_write, nullptr, _LongSound_FLAC_error, me);
+		if (FLAC__stream_decoder_process_until_end_of_metadata (my flacDecoder))
+			numberOfFlacBitsPerSample = integer (FLAC__stream_decoder_get_bits_per_sample (my flacDecoder));
 	}
 	my mp3f = nullptr;
 	if (my audioFileType == Melder_MP3) {
@@ -249,13 +401,26 @@ static void LongSound_init (LongSound me, MelderFile file) {
 		Melder_warning (U"Time measurements in MP3 files can be off by several tens of milliseconds. "
 			U"Please convert to WAV file if you need time precision or annotation.");
 	}
+	if (! my mappedSamples)
+		LongSound_initCache (me, numberOfFlacBitsPerSample);
 }
 
 void structLongSound :: v_copy (Daata thee_Daata) {
 	LongSound thee = static_cast <LongSound> (thee_Daata);
 	thy f = nullptr;
 	thy buffer.releaseToAmbiguousOwner();   // this may have been shallow-copied, so undangle and nullify
-	LongSound_init (thee, & our file);   // this recreates a new buffer
+	thy cache.releaseToAmbiguousOwner();   // the same
+	thy cache32.releaseToAmbiguousOwner();
+	thy cacheFloats.releaseToAmbiguousOwner();
+	thy cachedBlockNumbers.releaseToAmbiguousOwner();
+	thy cacheBlockLastUse.releaseToAmbiguousOwner();
+	thy compressedFloats.releaseToAmbiguousOwner();
+	thy mappedFile = nullptr;
+	thy mappedFileSize = 0;
+	thy mappedSamples = nullptr;
+	thy windowSamples = nullptr;
+	thy prefetcher = nullptr;   // a copy starts without a prefetcher of its own
+	LongSound_init (thee, & our file);   // this recreates a new buffer and cache, and maps the file anew
 }
 
 autoLongSound LongSound_open (MelderFile file) {
@@ -287,8 +452,8 @@ static void _LongSound_FILE_seekSample (LongSound me, integer firstSample) {
 
 static void _LongSound_FLAC_readAudioToShort (LongSound me, int16 *buffer, integer firstSample, integer numberOfSamples) {
 	my compressedMode = COMPRESSED_MODE_READ_SHORT;
-	my compressedShorts = buffer + 1;
-	_LongSound_FLAC_process (me, firstSample, numberOfSamples);
+	my compressedShorts = buffer;
+	_LongSound_FLAC_process (me, firstSample - 1, numberOfSamples + 1);   // the decoder counts samples from 0
 }
 
 static void _LongSound_MP3_process (LongSound me, integer firstSample, integer numberOfSamples) {
@@ -299,43 +464,266 @@ static void _LongSound_MP3_process (LongSound me, integer firstSample, integer n
 		Melder_throw (U"Error decoding MP3 file ", & my file, U".");
 }
 
+/*
+	The prefetching thread cannot throw or warn, because Melder's error and warning administration
+	belongs to the interface thread; it decodes with the following functions,
+	which report failure by returning false.
+*/
+static bool _LongSound_FLAC_tryToProcess (LongSound me, integer firstSample, integer numberOfSamples) noexcept {
+	my compressedSamplesLeft = numberOfSamples - 1;
+	if (! FLAC__stream_decoder_seek_absolute (my flacDecoder, firstSample))
+		return false;
+	while (my compressedSamplesLeft > 0)
+		if (FLAC__stream_decoder_get_state (my flacDecoder) == FLAC__STREAM_DECODER_END_OF_STREAM ||
+				! FLAC__stream_decoder_process_single (my flacDecoder))
+			return false;
+	return true;
+}
+
+static bool _LongSound_MP3_tryToProcess (LongSound me, integer firstSample, integer numberOfSamples) noexcept {
+	if (! mp3f_seek (my mp3f, firstSample))
+		return false;
+	my compressedSamplesLeft = numberOfSamples;
+	return mp3f_read (my mp3f, numberOfSamples);
+}
+
 static void _LongSound_MP3_readAudioToShort (LongSound me, int16 *buffer, integer firstSample, integer numberOfSamples) {
 	my compressedMode = COMPRESSED_MODE_READ_SHORT;
-	my compressedShorts = buffer + 1;
-	_LongSound_MP3_process (me, firstSample, numberOfSamples - 1);
+	my compressedShorts = buffer;
+	_LongSound_MP3_process (me, firstSample - 1, numberOfSamples);   // the decoder counts samples from 0
 }
 
-void LongSound_readAudioToFloat (LongSound me, MAT buffer, integer firstSample) {
+static void _LongSound_readAudioToFloat (LongSound me, MAT buffer, integer firstSample) {
 	Melder_assert (buffer.nrow == my numberOfChannels);
 	if (my encoding == Melder_FLAC_COMPRESSION_16) {
 		my compressedMode = COMPRESSED_MODE_READ_FLOAT;
 		for (int ichan = 1; ichan <= my numberOfChannels; ichan ++) {
-			my compressedFloats [ichan - 1] = & buffer [ichan] [1];
+			my compressedFloats [ichan] = & buffer [ichan] [1];
 		}
-		_LongSound_FLAC_process (me, firstSample, buffer.ncol);
+		_LongSound_FLAC_process (me, firstSample - 1, buffer.ncol + 1);   // the decoder counts samples from 0
 	} else if (my encoding == Melder_MPEG_COMPRESSION_16) {
 		my compressedMode = COMPRESSED_MODE_READ_FLOAT;
 		for (int ichan = 1; ichan <= my numberOfChannels; ichan ++) {
-			my compressedFloats [ichan - 1] = & buffer [ichan] [1];
+			my compressedFloats [ichan] = & buffer [ichan] [1];
 		}
-		_LongSound_MP3_process (me, firstSample, buffer.ncol);
+		_LongSound_MP3_process (me, firstSample - 1, buffer.ncol);   // the decoder counts samples from 0
+	} else if (my mappedSamples) {
+		const int16 *from = my mappedSamples + (firstSample - 1) * my numberOfChannels;
+		for (integer isamp = 1; isamp <= buffer.ncol; isamp ++)
+			for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++)
+				buffer [ichan] [isamp] = * from ++ * (1.0 / 32768.0);
 	} else {
 		_LongSound_FILE_seekSample (me, firstSample);
 		Melder_readAudioToFloat (my f, my encoding, buffer);
 	}
 }
 
-void LongSound_readAudioToShort (LongSound me, int16 *buffer, integer firstSample, integer numberOfSamples) {
+static void _LongSound_readAudioToShort (LongSound me, int16 *buffer, integer firstSample, integer numberOfSamples) {
 	if (my encoding == Melder_FLAC_COMPRESSION_16) {
 		_LongSound_FLAC_readAudioToShort (me, buffer, firstSample, numberOfSamples);
 	} else if (my encoding == Melder_MPEG_COMPRESSION_16) {
 		_LongSound_MP3_readAudioToShort (me, buffer, firstSample, numberOfSamples);
+	} else if (my mappedSamples) {
+		memcpy (buffer, my mappedSamples + (firstSample - 1) * my numberOfChannels,
+				size_t (numberOfSamples * my numberOfChannels) * sizeof (int16));
 	} else {
 		_LongSound_FILE_seekSample (me, firstSample);
 		Melder_readAudioToShort (my f, my numberOfChannels, my encoding, buffer, numberOfSamples);
 	}
 }
 
+static bool _LongSound_tryToReadAudioToFloat (LongSound me, MAT buffer, integer firstSample, autovector <uint8> const& bytes) noexcept {
+	if (my encoding == Melder_FLAC_COMPRESSION_16) {
+		my compressedMode = COMPRESSED_MODE_READ_FLOAT;
+		for (int ichan = 1; ichan <= my numberOfChannels; ichan ++)
+			my compressedFloats [ichan] = & buffer [ichan] [1];
+		return _LongSound_FLAC_tryToProcess (me, firstSample - 1, buffer.ncol + 1);
+	}
+	if (my encoding == Melder_MPEG_COMPRESSION_16) {
+		my compressedMode = COMPRESSED_MODE_READ_FLOAT;
+		for (int ichan = 1; ichan <= my numberOfChannels; ichan ++)
+			my compressedFloats [ichan] = & buffer [ichan] [1];
+		return _LongSound_MP3_tryToProcess (me, firstSample - 1, buffer.ncol);
+	}
+	const integer numberOfBytes = buffer.ncol * my numberOfChannels * my numberOfBytesPerSamplePoint;
+	Melder_assert (numberOfBytes <= bytes.size);
+	if (fseek (my f, my startOfData + (firstSample - 1) * my numberOfChannels * my numberOfBytesPerSamplePoint, SEEK_SET) ||
+			integer (fread (& bytes [1], 1, size_t (numberOfBytes), my f)) < numberOfBytes)
+		return false;   // including a truncated file, which the interface thread will warn about
+	return Melder_decodeAudioToFloat (& bytes [1], my encoding, buffer);
+}
+
+void LongSound_readAudioToFloat (LongSound me, MAT buffer, integer firstSample) {
+	std::unique_lock <std::mutex> lock = LongSound_lockDecoder (me);
+	_LongSound_readAudioToFloat (me, buffer, firstSample);
+}
+
+void LongSound_readAudioToShort (LongSound me, int16 *buffer, integer firstSample, integer numberOfSamples) {
+	std::unique_lock <std::mutex> lock = LongSound_lockDecoder (me);
+	_LongSound_readAudioToShort (me, buffer, firstSample, numberOfSamples);
+}
+
+/*
+	The cache functions should be called with the decoder locked.
+*/
+static integer _LongSound_findCachedBlock (LongSound me, integer blockNumber) {
+	for (integer icache = 1; icache <= my numberOfCacheBlocks; icache ++)
+		if (my cachedBlockNumbers [icache] == blockNumber)
+			return icache;
+	return 0;
+}
+
+static void _LongSound_storeBlock (LongSound me, integer icache, constMAT samples) noexcept {
+	const integer offset = 1 + (icache - 1) * LongSound_CACHE_BLOCK_SIZE * my numberOfChannels;
+	if (my cacheFormat == kLongSound_cacheFormat::INT16) {
+		/*
+			Truncate, as Melder_readAudioToShort () does for samples with more than 16 bits,
+			but clip at full scale, where Melder_readAudioToShort () would let a floating-point sample of +1.0 wrap around.
+		*/
+		int16 *to = & my cache [offset];
+		for (integer isamp = 1; isamp <= samples.ncol; isamp ++)
+			for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++)
+				* to ++ = int16 (Melder_clipped (-32768.0, samples [ichan] [isamp] * 32768.0, 32767.0));
+	} else if (my cacheFormat == kLongSound_cacheFormat::INT32) {
+		int32 *to = & my cache32 [offset];
+		for (integer isamp = 1; isamp <= samples.ncol; isamp ++)
+			for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++)
+				* to ++ = int32 (Melder_clipped (-2147483648.0, round (samples [ichan] [isamp] * 2147483648.0), 2147483647.0));
+	} else {
+		float *to = & my cacheFloats [offset];
+		for (integer isamp = 1; isamp <= samples.ncol; isamp ++)
+			for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++)
+				* to ++ = float (samples [ichan] [isamp]);
+	}
+}
+
+/*
+	Whether a 16-bit cache is filled with 16-bit samples as they are decoded, rather than via floats;
+	for the other encodings, the 16-bit values come from _LongSound_storeBlock (),
+	so that a block has the same values whether it is read when needed or by the prefetcher.
+*/
+static bool _LongSound_cachesDecodedShorts (LongSound me) noexcept {
+	return my cacheFormat == kLongSound_cacheFormat::INT16 && (
+		my encoding == Melder_LINEAR_16_BIG_ENDIAN || my encoding == Melder_LINEAR_16_LITTLE_ENDIAN ||
+		my encoding == Melder_FLAC_COMPRESSION_16 || my encoding == Melder_MPEG_COMPRESSION_16
+	);
+}
+
+static void _LongSound_readBlock (LongSound me, integer icache, integer firstSample, integer numberOfSamples) {
+	const integer offset = 1 + (icache - 1) * LongSound_CACHE_BLOCK_SIZE * my numberOfChannels;
+	if (_LongSound_cachesDecodedShorts (me)) {
+		_LongSound_readAudioToShort (me, & my cache [offset], firstSample, numberOfSamples);
+		return;
+	}
+	autoMAT samples = newMATraw (my numberOfChannels, numberOfSamples);
+	_LongSound_readAudioToFloat (me, samples.get(), firstSample);
+	_LongSound_storeBlock (me, icache, samples.get());
+}
+
+/*
+	The same, without throwing, into the buffers of the prefetcher.
+*/
+static bool _LongSound_tryToReadBlock (LongSound me, integer icache, integer firstSample, integer numberOfSamples) noexcept {
+	const integer offset = 1 + (icache - 1) * LongSound_CACHE_BLOCK_SIZE * my numberOfChannels;
+	if (my cacheFormat == kLongSound_cacheFormat::INT16 && (my encoding == Melder_FLAC_COMPRESSION_16 || my encoding == Melder_MPEG_COMPRESSION_16)) {
+		my compressedMode = COMPRESSED_MODE_READ_SHORT;
+		my compressedShorts = & my cache [offset];
+		return my encoding == Melder_FLAC_COMPRESSION_16 ?
+			_LongSound_FLAC_tryToProcess (me, firstSample - 1, numberOfSamples + 1) :
+			_LongSound_MP3_tryToProcess (me, firstSample - 1, numberOfSamples);
+	}
+	/*
+		Uncompressed 16-bit samples go through floats here, which is exact.
+	*/
+	MAT samples (my prefetcher -> samples.cells, my numberOfChannels, numberOfSamples);
+	if (! _LongSound_tryToReadAudioToFloat (me, samples, firstSample, my prefetcher -> bytes))
+		return false;
+	_LongSound_storeBlock (me, icache, samples);
+	return true;
+}
+
+static integer _LongSound_findLeastRecentlyUsedCacheBlock (LongSound me) {
+	integer leastRecentlyUsedCacheBlock = 1;
+	for (integer icache = 2; icache <= my numberOfCacheBlocks; icache ++)
+		if (my cacheBlockLastUse [icache] < my cacheBlockLastUse [leastRecentlyUsedCacheBlock])
+			leastRecentlyUsedCacheBlock = icache;
+	return leastRecentlyUsedCacheBlock;
+}
+
+/*
+	Returns the position of the block in the cache, after reading it into the least recently used place if it was not there yet.
+*/
+static integer _LongSound_getCachedBlock (LongSound me, integer blockNumber) {
+	integer icache = _LongSound_findCachedBlock (me, blockNumber);
+	if (icache != 0) {
+		my cacheBlockLastUse [icache] = ++ my cacheUseCount;
+		return icache;
+	}
+	icache = _LongSound_findLeastRecentlyUsedCacheBlock (me);
+	const integer firstSample = (blockNumber - 1) * LongSound_CACHE_BLOCK_SIZE + 1;
+	const integer lastSample = std::min (blockNumber * LongSound_CACHE_BLOCK_SIZE, my nx);
+	my cachedBlockNumbers [icache] = 0;   // in case reading fails
+	_LongSound_readBlock (me, icache, firstSample, lastSample - firstSample + 1);
+	my cachedBlockNumbers [icache] = blockNumber;
+	my cacheBlockLastUse [icache] = ++ my cacheUseCount;
+	return icache;
+}
+
+/*
+	Call `copy (cacheOffset, numberOfSamples)` for every cache block that overlaps imin..imax,
+	where cacheOffset is the (1-based) index of the first of the samples in the cache vector.
+*/
+template <typename CopyFunction>
+static void _LongSound_copyFromCache (LongSound me, integer imin, integer imax, CopyFunction copy) {
+	for (integer isample = imin; isample <= imax; ) {
+		const integer blockNumber = (isample - 1) / LongSound_CACHE_BLOCK_SIZE + 1;
+		const integer lastSampleInBlock = std::min (blockNumber * LongSound_CACHE_BLOCK_SIZE, imax);
+		std::unique_lock <std::mutex> lock = LongSound_lockDecoder (me);   // per block, so that the prefetcher can interleave
+		const integer icache = _LongSound_getCachedBlock (me, blockNumber);
+		const integer offsetInBlock = isample - 1 - (blockNumber - 1) * LongSound_CACHE_BLOCK_SIZE;
+		const integer numberOfSamples = lastSampleInBlock - isample + 1;
+		copy (1 + ((icache - 1) * LongSound_CACHE_BLOCK_SIZE + offsetInBlock) * my numberOfChannels, numberOfSamples);
+		isample += numberOfSamples;
+	}
+}
+
+static void _LongSound_readSamples (LongSound me, int16 *buffer, integer imin, integer imax) {
+	/*
+		Copy the samples from the blocks in the cache, reading the blocks that are not there yet.
+		The conversion to 16 bits truncates and clips, as _LongSound_storeBlock () does for a 16-bit cache.
+	*/
+	_LongSound_copyFromCache (me, imin, imax, [&] (integer cacheOffset, integer numberOfSamples) {
+		const integer numberOfValues = numberOfSamples * my numberOfChannels;
+		if (my cacheFormat == kLongSound_cacheFormat::INT16) {
+			memcpy (buffer, & my cache [cacheOffset], size_t (numberOfValues) * sizeof (int16));
+		} else if (my cacheFormat == kLongSound_cacheFormat::INT32) {
+			const int32 *from = & my cache32 [cacheOffset];
+			for (integer i = 0; i < numberOfValues; i ++)
+				buffer [i] = int16 (from [i] / 65536);
+		} else {
+			const float *from = & my cacheFloats [cacheOffset];
+			for (integer i = 0; i < numberOfValues; i ++)
+				buffer [i] = int16 (Melder_clipped (-32768.0, from [i] * 32768.0, 32767.0));
+		}
+		buffer += numberOfValues;
+	});
+}
+
+static void _LongSound_readSamplesToFloat (LongSound me, MAT buffer, integer firstSample) {
+	Melder_assert (my cacheIsExact);
+	integer column = 1;
+	_LongSound_copyFromCache (me, firstSample, firstSample + buffer.ncol - 1, [&] (integer cacheOffset, integer numberOfSamples) {
+		for (integer isamp = 0; isamp < numberOfSamples; isamp ++, column ++) {
+			for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++, cacheOffset ++) {
+				buffer [ichan] [column] =
+					my cacheFormat == kLongSound_cacheFormat::INT16 ? my cache [cacheOffset] * (1.0 / 32768.0) :
+					my cacheFormat == kLongSound_cacheFormat::INT32 ? my cache32 [cacheOffset] * (1.0 / 32768.0 / 65536.0) :
+					double (my cacheFloats [cacheOffset]);
+			}
+		}
+	});
+}
+
 autoSound LongSound_extractPart (LongSound me, double tmin, double tmax, bool preserveTimes) {
 	try {
 		Function_unidirectionalAutowindow (me, & tmin, & tmax);
@@ -354,15 +742,123 @@ autoSound LongSound_extractPart (LongSound me, double tmin, double tmax, bool pr
 			thy xmax -= tmin;
 			thy x1 -= tmin;
 		}
-		LongSound_readAudioToFloat (me, thy z.get(), firstSample);
+		/*
+			If the cache holds the samples at full precision, it can serve parts that fit in it;
+			larger parts are read from the file directly, so that they do not flush the cache.
+		*/
+		const integer numberOfBlocks = (lastSample - 1) / LongSound_CACHE_BLOCK_SIZE - (firstSample - 1) / LongSound_CACHE_BLOCK_SIZE + 1;
+		if (my cacheIsExact && ! my mappedSamples && numberOfBlocks < my numberOfCacheBlocks)
+			_LongSound_readSamplesToFloat (me, thy z.get(), firstSample);
+		else
+			LongSound_readAudioToFloat (me, thy z.get(), firstSample);
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": Sound not extracted.");
 	}
 }
 
-static void _LongSound_readSamples (LongSound me, int16 *buffer, integer imin, integer imax) {
-	LongSound_readAudioToShort (me, buffer, imin, imax - imin + 1);
+/*
+	Prefetching.
+*/
+static void LongSound_prefetchThread (LongSound me) {
+	LongSoundPrefetcher prefetcher = my prefetcher;
+	std::unique_lock <std::mutex> lock (prefetcher -> mutex);
+	for (;;) {
+		prefetcher -> requestsChanged. wait (lock,
+			[prefetcher] { return prefetcher -> stopRequested || prefetcher -> requestedBlocks. size () > 0; });
+		if (prefetcher -> stopRequested)
+			return;
+		const integer blockNumber = prefetcher -> requestedBlocks. front ();
+		prefetcher -> requestedBlocks. erase (prefetcher -> requestedBlocks. begin ());
+		if (_LongSound_findCachedBlock (me, blockNumber) != 0)
+			continue;
+		const integer icache = _LongSound_findLeastRecentlyUsedCacheBlock (me);
+		const integer firstSample = (blockNumber - 1) * LongSound_CACHE_BLOCK_SIZE + 1;
+		const integer lastSample = std::min (blockNumber * LongSound_CACHE_BLOCK_SIZE, my nx);
+		my cachedBlockNumbers [icache] = 0;
+		if (_LongSound_tryToReadBlock (me, icache, firstSample, lastSample - firstSample + 1)) {
+			my cachedBlockNumbers [icache] = blockNumber;
+			my cacheBlockLastUse [icache] = ++ my cacheUseCount;
+		} else {
+			/*
+				Any error will come up again when the block is really needed,
+				at which time it can be reported from the interface thread.
+			*/
+			prefetcher -> requestedBlocks. clear ();
+			prefetcher -> failed = true;
+		}
+		/*
+			Unlock before the next block, so that a reader that is waiting for the lock can get it.
+		*/
+		lock. unlock ();
+		std::this_thread::yield ();
+		lock. lock ();
+	}
+}
+
+/*
+	Ask for the samples imin..imax to be read in the background.
+*/
+static void LongSound_prefetchSamples (LongSound me, integer imin, integer imax, bool backward) {
+	Melder_clip (integer (1), & imin, my nx);
+	Melder_clip (integer (1), & imax, my nx);
+	if (imax < imin)
+		return;
+	if (my mappedSamples) {
+		/*
+			The kernel does the reading for us; we just tell it what to read.
+		*/
+		#if defined (UNIX) || defined (macintosh)
+			const integer pageSize = integer (sysconf (_SC_PAGESIZE));
+			const integer numberOfBytesPerFrame = my numberOfChannels * integer (sizeof (int16));
+			integer firstByte = my startOfData + (imin - 1) * numberOfBytesPerFrame;
+			const integer endByte = my startOfData + imax * numberOfBytesPerFrame;
+			firstByte -= firstByte % pageSize;
+			(void) posix_madvise (static_cast <uint8 *> (my mappedFile) + firstByte, size_t (endByte - firstByte), POSIX_MADV_WILLNEED);
+		#endif
+		return;
+	}
+	if (my numberOfCacheBlocks == 0)
+		return;
+	if (! my prefetcher) {
+		try {
+			my prefetcher = new structLongSoundPrefetcher;
+		} catch (...) {
+			return;
+		}
+		try {
+			my prefetcher -> samples = newMATraw (my numberOfChannels, LongSound_CACHE_BLOCK_SIZE);
+			my prefetcher -> bytes = newvectorraw <uint8> (LongSound_CACHE_BLOCK_SIZE * my numberOfChannels * my numberOfBytesPerSamplePoint);
+		} catch (MelderError) {
+			Melder_clearError ();   // no room: no prefetching
+			delete my prefetcher;
+			my prefetcher = nullptr;
+			return;
+		}
+		try {
+			my prefetcher -> thread = std::thread (LongSound_prefetchThread, me);
+		} catch (...) {
+			delete my prefetcher;   // no threads available: no prefetching
+			my prefetcher = nullptr;
+			return;
+		}
+	}
+	std::lock_guard <std::mutex> lock (my prefetcher -> mutex);
+	if (my prefetcher -> failed)
+		return;
+	/*
+		Replace any earlier requests, which are no longer needed now that the window has moved.
+		The window itself is in the cache (we just read it), and it should stay there,
+		so we ask for fewer blocks than the cache can hold besides the window.
+	*/
+	const integer firstBlock = (imin - 1) / LongSound_CACHE_BLOCK_SIZE + 1;
+	const integer lastBlock = (imax - 1) / LongSound_CACHE_BLOCK_SIZE + 1;
+	const integer numberOfWindowBlocks = (my nmax - 1) / LongSound_CACHE_BLOCK_SIZE + 2;
+	const integer maximumNumberOfRequests = my numberOfCacheBlocks - numberOfWindowBlocks - 1;
+	my prefetcher -> requestedBlocks. clear ();
+	for (integer i = 0; i <= lastBlock - firstBlock && i < maximumNumberOfRequests; i ++)
+		my prefetcher -> requestedBlocks. push_back (backward ? lastBlock - i : firstBlock + i);
+	my prefetcher -> requestsChanged. notify_one ();
 }
 
 static void writePartToOpenFile (LongSound me, int audioFileType, integer imin, integer n, MelderFile file, int numberOfChannels_override, int numberOfBitsPerSamplePoint) {
@@ -418,6 +914,16 @@ void LongSound_saveChannelAsAudioFile (LongSound me, int audioFileType, integer
 static void _LongSound_haveSamples (LongSound me, integer imin, integer imax) {
 	integer n = imax - imin + 1;
 	Melder_assert (n <= my nmax);
+	/*
+		Mapped? Then all samples are always there.
+	*/
+	if (my mappedSamples) {
+		my windowSamples = my mappedSamples;
+		my imin = 1;
+		my imax = my nx;
+		return;
+	}
+	my windowSamples = my buffer.asArgumentToFunctionThatExpectsZeroBasedArray();
 	/*
 		Included?
 	*/
@@ -506,6 +1012,19 @@ bool LongSound_haveWindow (LongSound me, double tmin, double tmax) {
 	if ((1.0 + 2 * MARGIN) * n + 1 > my nmax)
 		return false;
 	_LongSound_haveSamples (me, imin, imax);
+	/*
+		A window that is not part of the previous one means that the user is scrolling, zooming out, or playing on;
+		the next window in the same direction will probably be asked for soon.
+	*/
+	if (imin < my previousWindowFirstSample || imax > my previousWindowLastSample) {
+		const bool backward = ( imin < my previousWindowFirstSample && imax < my previousWindowLastSample );
+		if (backward)
+			LongSound_prefetchSamples (me, imin - n, imin - 1, true);
+		else
+			LongSound_prefetchSamples (me, imax + 1, imax + n, false);
+		my previousWindowFirstSample = imin;
+		my previousWindowLastSample = imax;
+	}
 	return true;
 }
 
@@ -515,14 +1034,15 @@ void LongSound_getWindowExtrema (LongSound me, double tmin, double tmax, integer
 	*minimum = 1.0;
 	*maximum = -1.0;
 	try {
-		LongSound_haveWindow (me, tmin, tmax);
+		if (! LongSound_haveWindow (me, tmin, tmax))
+			return;
 	} catch (MelderError) {
 		Melder_clearError ();
 		return;
 	}
 	integer minimum_int = 32767, maximum_int = -32768;
 	for (integer i = imin; i <= imax; i ++) {
-		const integer value = my buffer [(i - my imin) * my numberOfChannels + channel];
+		const integer value = my windowSamples [(i - my imin) * my numberOfChannels + channel - 1];
 		if (value < minimum_int)
 			minimum_int = value;
 		if (value > maximum_int)
@@ -587,12 +1107,12 @@ void LongSound_playPart (LongSound me, double tmin, double tmax,
 			if (thy silenceBefore > 0 || thy silenceAfter > 0 || 1) {
 				thy resampledBuffer = Melder_calloc (int16, (thy silenceBefore + thy numberOfSamples + thy silenceAfter) * my numberOfChannels);
 				memcpy (& thy resampledBuffer [thy silenceBefore * my numberOfChannels],
-						my buffer.asArgumentToFunctionThatExpectsZeroBasedArray() + (i1 - my imin) * my numberOfChannels,
+						my windowSamples + (i1 - my imin) * my numberOfChannels,
 						thy numberOfSamples * sizeof (int16) * my numberOfChannels);
 				MelderAudio_play16 (thy resampledBuffer, my sampleRate, thy silenceBefore + thy numberOfSamples + thy silenceAfter,
 						my numberOfChannels, melderPlayCallback, thee);
 			} else {
-				MelderAudio_play16 (my buffer.asArgumentToFunctionThatExpectsZeroBasedArray() + (i1 - my imin) * my numberOfChannels, my sampleRate,
+				MelderAudio_play16 (const_cast <int16 *> (my windowSamples) + (i1 - my imin) * my numberOfChannels, my sampleRate,
 				   thy numberOfSamples, my numberOfChannels, melderPlayCallback, thee);
 			}
 		} else {
@@ -601,7 +1121,7 @@ void LongSound_playPart (LongSound me, double tmin, double tmax,
 			const integer silenceBefore = Melder_iroundTowardsZero (newSampleRate * MelderAudio_getOutputSilenceBefore ());
 			const integer silenceAfter = Melder_iroundTowardsZero (newSampleRate * MelderAudio_getOutputSilenceAfter ());
 			int16 *resampledBuffer = Melder_calloc (int16, (silenceBefore + newN + silenceAfter) * my numberOfChannels);
-			int16 *from = my buffer.asArgumentToFunctionThatExpectsZeroBasedArray() + (i1 - my imin) * my numberOfChannels;   // guaranteed: from [0 .. (my imax - my imin + 1) * nchan]
+			const int16 *from = my windowSamples + (i1 - my imin) * my numberOfChannels;   // guaranteed: from [0 .. (my imax - my imin + 1) * nchan]
 			const double t1 = my x1, dt = 1.0 / newSampleRate;
 			thy numberOfSamples = newN;
 			thy dt = dt;
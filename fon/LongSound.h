@@ -2,7 +2,7 @@
 #define _LongSound_h_
 /* LongSound.h
  *
- * Copyright (C) 1992-2005,2007,2008,2010-2012,2015-2019 Paul Boersma, 2007 Erez Volk (for FLAC, MP3)
+ * Copyright (C) 1992-2005,2007,2008,2010-2012,2015-2020 Paul Boersma, 2007 Erez Volk (for FLAC, MP3)
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,13 +20,23 @@
 
 #include "Sound.h"
 #include "Collection.h"
+#include "LongSound_enums.h"
 
 #define COMPRESSED_MODE_READ_FLOAT 0
 #define COMPRESSED_MODE_READ_SHORT 1
 
+#define LongSound_CACHE_BLOCK_SIZE  65536
+
+/*
+	The analyses of a LongSound (pitch, intensity, formants) read the samples
+	in overlapping blocks of at most this many sample frames (but at least one analysis window).
+*/
+#define LongSound_ANALYSIS_BLOCK_SIZE  (16 * LongSound_CACHE_BLOCK_SIZE)
+
 struct FLAC__StreamDecoder;
 struct FLAC__StreamEncoder;
 struct _MP3_FILE;
+struct structLongSoundPrefetcher;
 
 Thing_define (LongSound, Sampled) {
 	structMelderFile file;
@@ -40,13 +50,47 @@ Thing_define (LongSound, Sampled) {
 	integer nmax;
 	autovector <int16> buffer;   // this is always 16-bit, because we will always play sounds in 16-bit, even those from 24-bit files
 	integer imin, imax;
+	const int16 *windowSamples;   // the samples imin..imax, interleaved: either in `buffer` or in the mapped file
 	void invalidateBuffer () noexcept { our imin = 1; our imax = 0; }
 
+	/*
+		Uncompressed 16-bit files whose byte order is that of the machine
+		are mapped into memory, so that their samples can be used without being copied.
+	*/
+	void *mappedFile;
+	integer mappedFileSize;
+	const int16 *mappedSamples;   // points into mappedFile, or null if the file is not mapped
+
+	/*
+		All other files are read (and decoded) in blocks, the most recently used of which are kept in memory,
+		so that moving back and forth between distant parts of the file does not require reading the file again.
+		The blocks hold numberOfCacheBlocks * LongSound_CACHE_BLOCK_SIZE interleaved sample frames,
+		in only one of the three formats; 24-bit and floating-point files can be kept at their full precision,
+		in which case parts can be extracted from the cache (cacheIsExact).
+	*/
+	integer numberOfCacheBlocks;
+	kLongSound_cacheFormat cacheFormat;   // never AUTOMATIC
+	bool cacheIsExact;   // does the cache contain the same values that reading the file as floats would give?
+	autovector <int16> cache;   // if cacheFormat is INT16
+	autovector <int32> cache32;   // if cacheFormat is INT32: the samples scaled to the range of 32-bit integers
+	autovector <float> cacheFloats;   // if cacheFormat is FLOAT32: the samples between -1.0 and +1.0
+	autoINTVEC cachedBlockNumbers;   // for each cache block, the number of the file block that it contains, or 0
+	autoINTVEC cacheBlockLastUse;
+	integer cacheUseCount;
+
+	/*
+		While a window is being viewed or played, the next window (in the direction of scrolling)
+		is read into the cache by a background thread, which is started when it is first needed.
+		The thread and the rest of the LongSound share the decoder and the cache under a mutex.
+	*/
+	struct structLongSoundPrefetcher *prefetcher;
+	integer previousWindowFirstSample, previousWindowLastSample;
+
 	struct FLAC__StreamDecoder *flacDecoder;
 	struct _MP3_FILE *mp3f;
 	int compressedMode;
 	integer compressedSamplesLeft;
-	double *compressedFloats [2];
+	autovector <double *> compressedFloats;   // one per channel
 	int16 *compressedShorts;
 
 	void v_destroy () noexcept
@@ -70,6 +114,14 @@ bool LongSound_haveWindow (LongSound me, double tmin, double tmax);
  * Returns 0 if error or if window exceeds buffer, otherwise 1;
  */
 
+inline const int16 *LongSound_getWindowSamplesOfChannel (LongSound me, integer channel) {
+	return my windowSamples - my imin * my numberOfChannels + (channel - 1);
+}
+/*
+	After LongSound_haveWindow: sample i (imin <= i <= imax) of the channel is at [i * my numberOfChannels],
+	whether the samples are in the buffer or in the mapped file.
+*/
+
 void LongSound_getWindowExtrema (LongSound me, double tmin, double tmax, integer channel, double *minimum, double *maximum);
 
 void LongSound_playPart (LongSound me, double tmin, double tmax,
@@ -89,6 +141,10 @@ void LongSound_concatenate (SoundAndLongSoundList collection, MelderFile file, i
 void LongSound_preferences ();
 integer LongSound_getBufferSizePref_seconds ();
 void LongSound_setBufferSizePref_seconds (integer size);
+integer LongSound_getCacheSizePref_seconds ();
+void LongSound_setCacheSizePref_seconds (integer size);
+kLongSound_cacheFormat LongSound_getCacheFormatPref ();
+void LongSound_setCacheFormatPref (kLongSound_cacheFormat format);
 
 /* End of file LongSound.h */
 #endif
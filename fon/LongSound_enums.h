@@ -0,0 +1,26 @@
+/* LongSound_enums.h
+ *
+ * Copyright (C) 2020 Paul Boersma
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This code is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this work. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+enums_begin (kLongSound_cacheFormat, 0)
+	enums_add (kLongSound_cacheFormat, 0, AUTOMATIC, U"automatic")
+	enums_add (kLongSound_cacheFormat, 1, INT16, U"16-bit integer")
+	enums_add (kLongSound_cacheFormat, 2, INT32, U"32-bit integer")
+	enums_add (kLongSound_cacheFormat, 3, FLOAT32, U"32-bit floating point")
+enums_end (kLongSound_cacheFormat, 3, AUTOMATIC)
+
+/* End of file LongSound_enums.h */
@@ -20,6 +20,7 @@
 #include "NUM2.h"
 #include "Formula.h"
 #include "Eigen.h"
+#include "MelderThread.h"
 
 #include "oo_DESTROY.h"
 #include "Matrix_def.h"
@@ -656,18 +657,67 @@ void Matrix_writeToHeaderlessSpreadsheetFile (Matrix me, MelderFile file) {
 	}
 }
 
+static void Matrix_runFormula (Matrix me, FormulaProgram program, conststring32 expression, Interpreter interpreter,
+	integer fromRow, integer toRow, integer fromColumn, integer toColumn, Matrix target)
+{
+	const integer numberOfColumns = toColumn - fromColumn + 1;
+	const integer numberOfCells = (toRow - fromRow + 1) * numberOfColumns;
+	Formula_Result result;
+	const integer numberOfThreads = ( Formula_isCellwise (program) ?
+			MelderThread_computeNumberOfThreads (numberOfCells - 1, 10000) : 1 );
+	if (numberOfThreads <= 1 && ! Formula_isVectorizable (program)) {
+		for (integer irow = fromRow; irow <= toRow; irow ++) {
+			for (integer icol = fromColumn; icol <= toColumn; icol ++) {
+				Formula_run (program, irow, icol, & result);
+				target -> z [irow] [icol] = result. numericResult;
+			}
+		}
+		return;
+	}
+	/*
+		The value of a cell depends on nothing but the cell itself,
+		so the cells can be computed in any order, and in blocks.
+		We compute the first cell in this thread, so that any error is reported from here.
+	*/
+	Formula_run (program, fromRow, fromColumn, & result);
+	target -> z [fromRow] [fromColumn] = result. numericResult;
+	if (Formula_isVectorizable (program)) {
+		/*
+			Bulk evaluation leaves the program alone, so all threads can share it.
+		*/
+		MelderThread_parallelFor (numberOfCells - 1, numberOfThreads, [&] (integer /* ithread */, integer firstCell, integer lastCell) {
+			for (integer icell = firstCell; icell <= lastCell; ) {   // one piece of a row at a time
+				const integer irow = fromRow + icell / numberOfColumns, icol = fromColumn + icell % numberOfColumns;
+				const integer lastColumn = std::min (toColumn, icol + (lastCell - icell));
+				Formula_runForCells (program, fromRow, fromColumn, numberOfColumns, icell, target -> z [irow]. part (icol, lastColumn));
+				icell += lastColumn - icol + 1;
+			}
+		});
+		return;
+	}
+	/*
+		Cell by cell, every other thread runs its own copy of the program.
+	*/
+	std::vector <autoFormulaProgram> threadPrograms;
+	for (integer ithread = 2; ithread <= numberOfThreads; ithread ++)
+		threadPrograms. push_back (Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true));
+	MelderThread_parallelFor (numberOfCells - 1, numberOfThreads, [&] (integer ithread, integer firstCell, integer lastCell) {
+		const FormulaProgram threadProgram = ( ithread == 1 ? program : threadPrograms [uinteger (ithread - 2)].get() );
+		Formula_Result threadResult;
+		for (integer icell = firstCell; icell <= lastCell; icell ++) {   // cell 0 is the first cell
+			const integer irow = fromRow + icell / numberOfColumns, icol = fromColumn + icell % numberOfColumns;
+			Formula_run (threadProgram, irow, icol, & threadResult);
+			target -> z [irow] [icol] = threadResult. numericResult;
+		}
+	});
+}
+
 void Matrix_formula (Matrix me, conststring32 expression, Interpreter interpreter, Matrix target) {
 	try {
-		Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
-		Formula_Result result;
+		autoFormulaProgram program = Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 		if (! target)
 			target = me;
-		for (integer irow = 1; irow <= my ny; irow ++) {
-			for (integer icol = 1; icol <= my nx; icol ++) {
-				Formula_run (irow, icol, & result);
-				target -> z [irow] [icol] = result. numericResult;
-			}
-		}
+		Matrix_runFormula (me, program.get(), expression, interpreter, 1, my ny, 1, my nx, target);
 	} catch (MelderError) {
 		Melder_throw (me, U": formula not completed.");
 	}
@@ -685,16 +735,11 @@ void Matrix_formula_part (Matrix me, double xmin, double xmax, double ymin, doub
 		integer ixmin, ixmax, iymin, iymax;
 		(void) Matrix_getWindowSamplesX (me, xmin, xmax, & ixmin, & ixmax);
 		(void) Matrix_getWindowSamplesY (me, ymin, ymax, & iymin, & iymax);
-		Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
-		Formula_Result result;
+		autoFormulaProgram program = Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 		if (! target)
 			target = me;
-		for (integer irow = iymin; irow <= iymax; irow ++) {
-			for (integer icol = ixmin; icol <= ixmax; icol ++) {
-				Formula_run (irow, icol, & result);
-				target -> z [irow] [icol] = result. numericResult;
-			}
-		}
+		if (ixmax >= ixmin && iymax >= iymin)
+			Matrix_runFormula (me, program.get(), expression, interpreter, iymin, iymax, ixmin, ixmax, target);
 	} catch (MelderError) {
 		Melder_throw (me, U": formula not completed.");
 	}
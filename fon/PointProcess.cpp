@@ -358,7 +358,7 @@ integer PointProcess_getWindowPoints (PointProcess me, double tmin, double tmax,
 	return imax - imin + 1;
 }
 
-static bool PointProcess_isPeriod (PointProcess me, integer ileft, double minimumPeriod, double maximumPeriod, double maximumPeriodFactor) {
+bool PointProcess_isPeriod (PointProcess me, integer ileft, double minimumPeriod, double maximumPeriod, double maximumPeriodFactor) {
 	/*
 	 * This function answers the question: is the interval from point 'ileft' to point 'ileft+1' a period?
 	 */
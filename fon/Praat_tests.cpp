@@ -29,12 +29,14 @@
 #include "praat.h"
 #include "NUM2.h"
 #include "Sound.h"
+#include "LongSound.h"
 
 #include "enums_getText.h"
 #include "Praat_tests_enums.h"
 #include "enums_getValue.h"
 #include "Praat_tests_enums.h"
 #include <string>
+#include <thread>
 
 static void testAutoData (autoDaata data) {
 	fprintf (stderr, "testAutoData: %p %p\n", data.get(), data -> name.get());
@@ -61,6 +63,378 @@ static autoMAT constantHH (integer nrow, integer ncol, double value) {
 	return result;
 }
 
+/*
+	Melder_readAudioToFloat () decodes in blocks; it should give exactly the values
+	that the sample-by-sample readers give, also across block boundaries and in truncated files.
+*/
+static double readAudioValue (FILE *f, int encoding) {
+	switch (encoding) {
+		case Melder_LINEAR_8_SIGNED: return bingeti8 (f) * (1.0 / 128);
+		case Melder_LINEAR_8_UNSIGNED: return bingetu8 (f) * (1.0 / 128) - 1.0;
+		case Melder_LINEAR_16_BIG_ENDIAN: return bingeti16 (f) * (1.0 / 32768);
+		case Melder_LINEAR_16_LITTLE_ENDIAN: return bingeti16LE (f) * (1.0 / 32768);
+		case Melder_LINEAR_24_BIG_ENDIAN: return bingeti24 (f) * (1.0 / 8388608);
+		case Melder_LINEAR_24_LITTLE_ENDIAN: return bingeti24LE (f) * (1.0 / 8388608);
+		case Melder_LINEAR_32_BIG_ENDIAN: return bingeti32 (f) * (1.0 / 32768 / 65536);
+		case Melder_LINEAR_32_LITTLE_ENDIAN: return bingeti32LE (f) * (1.0 / 32768 / 65536);
+		case Melder_IEEE_FLOAT_32_BIG_ENDIAN: return bingetr32 (f);
+		case Melder_IEEE_FLOAT_32_LITTLE_ENDIAN: return bingetr32LE (f);
+		case Melder_IEEE_FLOAT_64_BIG_ENDIAN: return bingetr64 (f);
+		case Melder_IEEE_FLOAT_64_LITTLE_ENDIAN: return bingetr64LE (f);
+		default: {   // mu-law and A-law
+			short value;
+			Melder_readAudioToShort (f, 1, encoding, & value, 1);
+			return value * (1.0 / 32768);
+		}
+	}
+}
+
+static void checkReadAudioToFloat () {
+	const int encodings [] = { Melder_LINEAR_8_SIGNED, Melder_LINEAR_8_UNSIGNED,
+		Melder_LINEAR_16_BIG_ENDIAN, Melder_LINEAR_16_LITTLE_ENDIAN, Melder_LINEAR_24_BIG_ENDIAN, Melder_LINEAR_24_LITTLE_ENDIAN,
+		Melder_LINEAR_32_BIG_ENDIAN, Melder_LINEAR_32_LITTLE_ENDIAN, Melder_IEEE_FLOAT_32_BIG_ENDIAN, Melder_IEEE_FLOAT_32_LITTLE_ENDIAN,
+		Melder_IEEE_FLOAT_64_BIG_ENDIAN, Melder_IEEE_FLOAT_64_LITTLE_ENDIAN, Melder_MULAW, Melder_ALAW };
+	const integer numbersOfSamples [] = { 1, 7, 70001 };   // the last one crosses block boundaries for every encoding
+	const int savedDebug = Melder_debug;
+	try {
+		for (int debug = 0; debug <= 18; debug += 18) {   // 18 means: decode floats by hand rather than as native floats
+			Melder_debug = debug;
+			for (int encoding : encodings) {
+				const integer numberOfBytesPerValue = Melder_bytesPerSamplePoint (encoding);
+				for (integer numberOfChannels = 1; numberOfChannels <= 3; numberOfChannels ++) {
+					for (integer numberOfSamples : numbersOfSamples) {
+						const integer numberOfValues = numberOfSamples * numberOfChannels;
+						for (int truncated = 0; truncated <= 1; truncated ++) {
+							const integer numberOfBytes = numberOfValues * numberOfBytesPerValue - truncated;
+							FILE *f = tmpfile ();
+							Melder_require (f, U"Cannot create a temporary file.");
+							for (integer ibyte = 1; ibyte <= numberOfBytes; ibyte ++)
+								fputc (int (NUMrandomInteger (0, 255)), f);
+							rewind (f);
+							autoMAT bulk = newMATraw (numberOfChannels, numberOfSamples);
+							{// scope
+								autoMelderWarningOff nowarn;
+								Melder_readAudioToFloat (f, encoding, bulk.get());
+							}
+							rewind (f);
+							const integer numberOfCompleteValues = numberOfBytes / numberOfBytesPerValue;
+							for (integer ivalue = 0; ivalue < numberOfValues; ivalue ++) {
+								const integer isamp = ivalue / numberOfChannels + 1, ichan = ivalue % numberOfChannels + 1;
+								const double value = bulk [ichan] [isamp];
+								if (ivalue < numberOfCompleteValues) {
+									const double expectedValue = readAudioValue (f, encoding);
+									Melder_require (value == expectedValue || isundef (value) && isundef (expectedValue),
+										U"Encoding ", encoding, U", ", numberOfChannels, U" channels, ", numberOfSamples, U" samples: value ",
+										ivalue + 1, U" is ", value, U" instead of ", expectedValue, U".");
+								} else if (ivalue > numberOfCompleteValues) {
+									Melder_require (value == 0.0,
+										U"Encoding ", encoding, U": missing value ", ivalue + 1, U" is ", value, U" instead of zero.");
+								}
+							}
+							fclose (f);
+						}
+					}
+				}
+			}
+		}
+		Melder_debug = savedDebug;
+	} catch (MelderError) {
+		Melder_debug = savedDebug;
+		throw;
+	}
+	MelderInfo_writeLine (U"Melder_readAudioToFloat: OK");
+}
+
+/*
+	The window samples of a LongSound that the editor draws should be those in the file,
+	also far beyond the length of the buffer, where a mapped file has no samples in the buffer.
+*/
+static void checkLongSoundWindow () {
+	const double samplingFrequency = 1000.0;
+	const double duration = 4.0 * LongSound_getBufferSizePref_seconds () + 1.0;
+	const integer numberOfChannels = 2, numberOfSamples = Melder_iround (duration * samplingFrequency);
+	autoSound sound = Sound_create (numberOfChannels, 0.0, duration, numberOfSamples, 1.0 / samplingFrequency, 0.5 / samplingFrequency);
+	for (integer ichan = 1; ichan <= numberOfChannels; ichan ++)
+		for (integer isamp = 1; isamp <= numberOfSamples; isamp ++)
+			sound -> z [ichan] [isamp] = NUMrandomInteger (-32768, 32767) / 32768.0;   // exact in 16 bits
+	structMelderFile file { };
+	Melder_relativePathToFile (U"kanweg_longSoundWindow.wav", & file);
+	Sound_saveAsAudioFile (sound.get(), & file, Melder_WAV, 16);
+	try {
+		autoLongSound longSound = LongSound_open (& file);
+		const double windowDuration = 0.4 * LongSound_getBufferSizePref_seconds ();
+		for (double tmin = 0.0; tmin < duration; tmin += 0.7 * windowDuration) {
+			const double tmax = std::min (tmin + windowDuration, duration);
+			Melder_require (LongSound_haveWindow (longSound.get(), tmin, tmax),
+				U"The window from ", tmin, U" to ", tmax, U" seconds should fit.");
+			integer first, last;
+			Sampled_getWindowSamples (longSound.get(), tmin, tmax, & first, & last);
+			for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
+				const int16 *samples = LongSound_getWindowSamplesOfChannel (longSound.get(), ichan);
+				for (integer isamp = first; isamp <= last; isamp ++)
+					Melder_require (samples [isamp * numberOfChannels] == Melder_iround (sound -> z [ichan] [isamp] * 32768.0),
+						U"Channel ", ichan, U", sample ", isamp, U" (buffer length ", longSound -> nmax, U"): wrong value.");
+			}
+		}
+		MelderInfo_writeLine (U"LongSound windows (", ( longSound -> mappedSamples ? U"mapped" : U"buffered" ), U"): OK");
+	} catch (MelderError) {
+		MelderFile_delete (& file);
+		throw;
+	}
+	MelderFile_delete (& file);
+}
+
+/*
+	With a 16-bit cache, floating-point samples should be truncated and clipped at full scale,
+	whether their block is read when it is needed or in advance by the prefetcher.
+*/
+static void checkLongSoundFullScale () {
+	const double samplingFrequency = 44100.0, windowDuration = 1.0;
+	const integer numberOfChannels = 2, numberOfSamples = 6 * LongSound_CACHE_BLOCK_SIZE;
+	const double specialValues [] = { 1.0, -1.0, 1.25, -1.25, 32767.5 / 32768.0, -32768.5 / 32768.0, -1e-6, 0.5 / 32768.0 };
+	autoMAT z = newMATraw (numberOfChannels, numberOfSamples);
+	for (integer ichan = 1; ichan <= numberOfChannels; ichan ++)
+		for (integer isamp = 1; isamp <= numberOfSamples; isamp ++)
+			z [ichan] [isamp] = float (isamp % 5 == 0 ? NUMrandomUniform (-1.0, 1.0) : specialValues [(isamp + ichan) % 8]);
+	structMelderFile file { };
+	Melder_relativePathToFile (U"kanweg_longSoundFullScale.wav", & file);
+	{
+		/*
+			A WAV file with 32-bit floating-point samples.
+		*/
+		autofile f = Melder_fopen (& file, "wb");
+		const integer numberOfDataBytes = numberOfSamples * numberOfChannels * 4;
+		fwrite ("RIFF", 1, 4, f);
+		binputi32LE (int32 (36 + numberOfDataBytes), f);
+		fwrite ("WAVEfmt ", 1, 8, f);
+		binputi32LE (16, f);
+		binputi16LE (3, f);   // WAVE_FORMAT_IEEE_FLOAT
+		binputi16LE (numberOfChannels, f);
+		binputi32LE (int32 (samplingFrequency), f);
+		binputi32LE (int32 (samplingFrequency) * numberOfChannels * 4, f);
+		binputi16LE (int16 (numberOfChannels * 4), f);
+		binputi16LE (32, f);
+		fwrite ("data", 1, 4, f);
+		binputi32LE (int32 (numberOfDataBytes), f);
+		for (integer isamp = 1; isamp <= numberOfSamples; isamp ++)
+			for (integer ichan = 1; ichan <= numberOfChannels; ichan ++)
+				binputr32LE (z [ichan] [isamp], f);
+		f.close (& file);
+	}
+	const kLongSound_cacheFormat savedCacheFormat = LongSound_getCacheFormatPref ();
+	LongSound_setCacheFormatPref (kLongSound_cacheFormat::INT16);
+	try {
+		autoLongSound longSound = LongSound_open (& file);
+		Melder_require (longSound -> cacheFormat == kLongSound_cacheFormat::INT16,
+			U"The cache should have 16-bit samples.");
+		for (double tmin = 0.0; tmin + windowDuration < longSound -> xmax; tmin += windowDuration) {
+			Melder_require (LongSound_haveWindow (longSound.get(), tmin, tmin + windowDuration),
+				U"The window from ", tmin, U" seconds should fit.");
+			integer first, last;
+			Sampled_getWindowSamples (longSound.get(), tmin, tmin + windowDuration, & first, & last);
+			for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
+				const int16 *samples = LongSound_getWindowSamplesOfChannel (longSound.get(), ichan);
+				for (integer isamp = first; isamp <= last; isamp ++) {
+					const double expected = Melder_clipped (-32768.0, trunc (z [ichan] [isamp] * 32768.0), 32767.0);
+					Melder_require (samples [isamp * numberOfChannels] == expected,
+						U"Channel ", ichan, U", sample ", isamp, U" (value ", z [ichan] [isamp], U"): ",
+						samples [isamp * numberOfChannels], U" instead of ", expected, U".");
+				}
+			}
+			std::this_thread::sleep_for (std::chrono::milliseconds (100));   // give the prefetcher time to read the next window
+		}
+	} catch (MelderError) {
+		LongSound_setCacheFormatPref (savedCacheFormat);
+		MelderFile_delete (& file);
+		throw;
+	}
+	LongSound_setCacheFormatPref (savedCacheFormat);
+	MelderFile_delete (& file);
+	MelderInfo_writeLine (U"LongSound full-scale samples in a 16-bit cache: OK");
+}
+
+/*
+	Melder_atof () and Melder_a8tof () should give the same values as strtod (), which they used for every number before;
+	the ones that their fast path does not handle still go through strtod ().
+*/
+static double strtodWithPercent (conststring8 string) {
+	char *end;
+	const double value = strtod (string, & end);
+	return *end == '%' ? 0.01 * value : value;
+}
+
+static void checkAtof () {
+	const conststring32 wellFormed [] = { U"0", U"-0", U"+0.0", U"1", U"-1", U"  3.14", U"\t7\n", U"3.14e-3", U"15.6%", U"-15.6%", U"1%%",
+		U"1e22", U"1e23", U"-1e-22", U"1e-23", U"9007199254740992", U"9007199254740993", U"1234567890123456789", U"12345678901234567890",
+		U"0.000000000000000000000000001", U"123456789012345678901234567890e-10", U"00000000000000000000000001.5",
+		U"2.2250738585072014e-308", U"2.2250738585072011e-308", U"4.9406564584124654e-324", U"2.4703282292062328e-324",
+		U"1e-400", U"-1e-400", U"1e400", U"-1e400", U"1e+5", U"1E5", U"1.e5", U"1.", U"1e-0", U"1e0001", U"1e99999999999",
+		U"0x1A", U"1e5x", U"1.2.3", U"1,5", U"5 6" };
+	for (conststring32 string : wellFormed) {
+		const double expected = strtodWithPercent (Melder_peek32to8 (string));
+		const double value32 = Melder_atof (string), value8 = Melder_a8tof (Melder_peek32to8 (string));
+		Melder_require (memcmp (& value32, & expected, sizeof (double)) == 0 && memcmp (& value8, & expected, sizeof (double)) == 0,
+			U"Melder_atof (\"", string, U"\") gives ", value32, U" and Melder_a8tof gives ", value8, U" instead of ", expected, U".");
+	}
+	const conststring32 malformed [] = { U"", U" ", U"-", U"+", U".5", U"-.5", U"e5", U"1e", U"1e+", U"1e-", U"abc", U"--1", U"+-1", U"%", U"inf", U"nan", U"\u00B35" };
+	for (conststring32 string : malformed)
+		Melder_require (isundef (Melder_atof (string)) && isundef (Melder_a8tof (Melder_peek32to8 (string))),
+			U"Melder_atof (\"", string, U"\") should be undefined.");
+	Melder_require (isundef (Melder_atof (nullptr)) && isundef (Melder_a8tof (nullptr)),
+		U"Melder_atof (nullptr) should be undefined.");
+	/*
+		Random numbers with up to 25 digits and exponents from -350 to +350,
+		which include denormals, overflows, and many numbers just within and just outside the fast path.
+	*/
+	autoMelderString string;
+	for (integer itest = 1; itest <= 300000; itest ++) {
+		MelderString_empty (& string);
+		const integer sign = NUMrandomInteger (0, 2);
+		if (sign > 0)
+			MelderString_appendCharacter (& string, sign == 1 ? U'-' : U'+');
+		const integer numberOfIntegerDigits = NUMrandomInteger (1, 25), numberOfFractionDigits = NUMrandomInteger (-1, 25);
+		for (integer idigit = 1; idigit <= numberOfIntegerDigits; idigit ++)
+			MelderString_appendCharacter (& string, U'0' + char32 (NUMrandomInteger (0, 9)));
+		if (numberOfFractionDigits >= 0) {
+			MelderString_appendCharacter (& string, U'.');
+			for (integer idigit = 1; idigit <= numberOfFractionDigits; idigit ++)
+				MelderString_appendCharacter (& string, U'0' + char32 (NUMrandomInteger (0, 9)));
+		}
+		if (NUMrandomInteger (0, 2) > 0)
+			MelderString_append (& string, NUMrandomInteger (0, 1) ? U"e" : U"E", NUMrandomInteger (-350, 350));
+		if (NUMrandomInteger (1, 10) == 1)
+			MelderString_appendCharacter (& string, U'%');
+		const double expected = strtodWithPercent (Melder_peek32to8 (string.string));
+		const double value32 = Melder_atof (string.string), value8 = Melder_a8tof (Melder_peek32to8 (string.string));
+		Melder_require (memcmp (& value32, & expected, sizeof (double)) == 0 && memcmp (& value8, & expected, sizeof (double)) == 0,
+			U"Melder_atof (\"", string.string, U"\") gives ", value32, U" and Melder_a8tof gives ", value8, U" instead of ", expected, U".");
+	}
+	MelderInfo_writeLine (U"Melder_atof: OK");
+}
+
+/*
+	The block readers and writers of real-valued arrays should give the same bytes and values
+	as the element-by-element ones, for any length, at any position in the file.
+*/
+static void checkBinaryArrays () {
+	const double specialValues [] = { 0.0, -0.0, undefined, INFINITY, -INFINITY, 1e-310, 1e-40, 1e39, -1.5, 1.0 };
+	const integer numbersOfValues [] = { 0, 1, 3, 4095, 4096, 4097, 8191, 8193, 20001 };   // around 32-kilobyte blocks
+	for (integer numberOfValues : numbersOfValues) {
+		autoVEC x = newVECraw (numberOfValues);
+		for (integer i = 1; i <= numberOfValues; i ++)
+			x [i] = ( i % 7 == 0 ? specialValues [(i / 7) % 10] : NUMrandomGauss (0.0, 1.0) * pow (10.0, NUMrandomInteger (-40, 40)) );
+		for (int numberOfBitsPerValue = 32; numberOfBitsPerValue <= 64; numberOfBitsPerValue += 32) {
+			FILE *blockwise = tmpfile (), *elementwise = tmpfile ();
+			Melder_require (blockwise && elementwise, U"Cannot create a temporary file.");
+			binputu8 (17, blockwise);   // start at an odd position
+			binputu8 (17, elementwise);
+			if (numberOfBitsPerValue == 32) {
+				binputr32array (x.cells, numberOfValues, blockwise);
+				for (integer i = 1; i <= numberOfValues; i ++)
+					binputr32 (x [i], elementwise);
+			} else {
+				binputr64array (x.cells, numberOfValues, blockwise);
+				for (integer i = 1; i <= numberOfValues; i ++)
+					binputr64 (x [i], elementwise);
+			}
+			const integer numberOfBytes = 1 + numberOfValues * numberOfBitsPerValue / 8;
+			Melder_require (ftell (blockwise) == numberOfBytes && ftell (elementwise) == numberOfBytes,
+				U"r", numberOfBitsPerValue, U", ", numberOfValues, U" values: wrong file length.");
+			rewind (blockwise);
+			rewind (elementwise);
+			for (integer ibyte = 1; ibyte <= numberOfBytes; ibyte ++)
+				Melder_require (fgetc (blockwise) == fgetc (elementwise),
+					U"r", numberOfBitsPerValue, U", ", numberOfValues, U" values: byte ", ibyte, U" differs.");
+			rewind (blockwise);
+			rewind (elementwise);
+			(void) bingetu8 (blockwise);
+			(void) bingetu8 (elementwise);
+			autoVEC y = newVECraw (numberOfValues);
+			if (numberOfBitsPerValue == 32)
+				bingetr32array (y.cells, numberOfValues, blockwise);
+			else
+				bingetr64array (y.cells, numberOfValues, blockwise);
+			for (integer i = 1; i <= numberOfValues; i ++) {
+				const double expectedValue = ( numberOfBitsPerValue == 32 ? bingetr32 (elementwise) : bingetr64 (elementwise) );
+				Melder_require (memcmp (& y [i], & expectedValue, sizeof (double)) == 0,
+					U"r", numberOfBitsPerValue, U", ", numberOfValues, U" values: value ", i, U" is ", y [i], U" instead of ", expectedValue, U".");
+			}
+			fclose (blockwise);
+			fclose (elementwise);
+		}
+	}
+	MelderInfo_writeLine (U"Binary arrays: OK");
+}
+
+/*
+	UTF-16 files are decoded in memory; check both byte orders, surrogate pairs, and bad surrogates.
+*/
+static void checkUtf16File (conststring32 caseName, const std::vector <char16>& codes, bool isBigEndian, conststring32 expectedText) {
+	structMelderFile file { };
+	Melder_relativePathToFile (U"kanweg_utf16.txt", & file);
+	FILE *f = Melder_fopen (& file, "wb");
+	if (isBigEndian) {
+		binputu16 (0xFEFF, f);   // the byte-order mark
+		for (char16 code : codes)
+			binputu16 (code, f);
+	} else {
+		binputu16LE (0xFEFF, f);
+		for (char16 code : codes)
+			binputu16LE (code, f);
+	}
+	fclose (f);
+	if (! expectedText) {
+		try {
+			MelderFile_readText (& file);
+		} catch (MelderError) {
+			Melder_clearError ();
+			MelderFile_delete (& file);
+			return;
+		}
+		Melder_throw (U"UTF-16 file (", caseName, U"): should have been refused.");
+	}
+	autostring32 text = MelderFile_readText (& file);
+	MelderFile_delete (& file);
+	Melder_require (Melder_equ (text.get(), expectedText),
+		U"UTF-16 file (", caseName, U", ", isBigEndian ? U"big" : U"little", U"-endian): read \"", text.get(), U"\" instead of \"", expectedText, U"\".");
+}
+
+static void checkUtf16Files () {
+	for (int isBigEndian = 0; isBigEndian <= 1; isBigEndian ++) {
+		checkUtf16File (U"empty", { }, isBigEndian, U"");
+		checkUtf16File (U"odd length", { U'a', U'b', U'c' }, isBigEndian, U"abc");
+		checkUtf16File (U"BMP", { 0x00E9, 0x4E2D, 0xE000, 0xFFFD }, isBigEndian, U"\u00E9\u4E2D\uE000\uFFFD");
+		checkUtf16File (U"surrogate pairs", { U'x', 0xD83D, 0xDE00, 0xDBFF, 0xDFFF, U'y' }, isBigEndian, U"x\U0001F600\U0010FFFFy");
+		checkUtf16File (U"lone low surrogate", { U'x', 0xDC00, U'y' }, isBigEndian, U"x\uFFFDy");
+		checkUtf16File (U"high surrogate without low surrogate", { U'x', 0xD800, U'y', U'z' }, isBigEndian, U"x\uFFFDz");   // the `y` is swallowed
+		checkUtf16File (U"high surrogate at the end", { U'x', 0xD800 }, isBigEndian, nullptr);
+		/*
+			A long text with a random mix of characters, in which the surrogate pairs
+			make the text shorter than the number of codes
+			(no line separators such as U+2028, which MelderFile_readText () turns into newlines).
+		*/
+		std::vector <char16> codes;
+		autoMelderString expectedText;
+		for (integer i = 1; i <= 10001; i ++) {
+			const char32 kar = char32 (
+				i % 3 == 0 ? NUMrandomInteger (0x01'0000, 0x10'FFFF) :
+				i % 3 == 1 ? NUMrandomInteger (0x0020, 0x007E) :
+				NUMrandomInteger (0x3000, 0xD7FF)
+			);
+			if (kar >= 0x01'0000) {
+				codes.push_back (char16 (0xD800 + ((kar - 0x01'0000) >> 10)));
+				codes.push_back (char16 (0xDC00 + ((kar - 0x01'0000) & 0x00'03FF)));
+			} else {
+				codes.push_back (char16 (kar));
+			}
+			const char32 string [2] = { kar, U'\0' };
+			MelderString_append (& expectedText, string);
+		}
+		checkUtf16File (U"long text", codes, isBigEndian, expectedText.string);
+	}
+	MelderInfo_writeLine (U"UTF-16 files: OK");
+}
+
 int Praat_tests (kPraatTests itest, conststring32 arg1, conststring32 arg2, conststring32 arg3, conststring32 arg4) {
 	int64 n = Melder_atoi (arg1);
 	double t = 0.0;
@@ -646,6 +1020,24 @@ int Praat_tests (kPraatTests itest, conststring32 arg1, conststring32 arg2, cons
 		case kPraatTests::FILEINMEMORYMANAGER_IO: {
 			test_FileInMemoryManager_io ();
 		} break;
+		case kPraatTests::CHECK_READ_AUDIO_TO_FLOAT: {
+			checkReadAudioToFloat ();
+		} break;
+		case kPraatTests::CHECK_BINARY_ARRAYS: {
+			checkBinaryArrays ();
+		} break;
+		case kPraatTests::CHECK_UTF16_FILES: {
+			checkUtf16Files ();
+		} break;
+		case kPraatTests::CHECK_LONGSOUND_WINDOW: {
+			checkLongSoundWindow ();
+		} break;
+		case kPraatTests::CHECK_LONGSOUND_FULL_SCALE: {
+			checkLongSoundFullScale ();
+		} break;
+		case kPraatTests::CHECK_ATOF: {
+			checkAtof ();
+		} break;
 	}
 	MelderInfo_writeLine (Melder_single (n / t * 1e-9), U" Gflop/s");
 	MelderInfo_close ();
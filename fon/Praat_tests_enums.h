@@ -62,6 +62,12 @@ enums_begin (kPraatTests, 0)
 	enums_add (kPraatTests, 42, TIME_MATMUL, U"TimeMatMul")
 	enums_add (kPraatTests, 43, THING_AUTO, U"ThingAuto")
 	enums_add (kPraatTests, 44, FILEINMEMORYMANAGER_IO, U"FileInMemoryManager_io")
-enums_end (kPraatTests, 44, CHECK_RANDOM_1009_2009)
+	enums_add (kPraatTests, 45, CHECK_READ_AUDIO_TO_FLOAT, U"CheckReadAudioToFloat")
+	enums_add (kPraatTests, 46, CHECK_BINARY_ARRAYS, U"CheckBinaryArrays")
+	enums_add (kPraatTests, 47, CHECK_UTF16_FILES, U"CheckUtf16Files")
+	enums_add (kPraatTests, 48, CHECK_LONGSOUND_WINDOW, U"CheckLongSoundWindow")
+	enums_add (kPraatTests, 49, CHECK_LONGSOUND_FULL_SCALE, U"CheckLongSoundFullScale")
+	enums_add (kPraatTests, 50, CHECK_ATOF, U"CheckAtof")
+enums_end (kPraatTests, 50, CHECK_RANDOM_1009_2009)
 
 /* End of file Praat_tests_enums.h */
@@ -489,12 +489,12 @@ autoRealTier PointProcess_upto_RealTier (PointProcess me, double value, ClassInf
 
 void RealTier_formula (RealTier me, conststring32 expression, Interpreter interpreter, RealTier thee) {
 	try {
-		Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
+		autoFormulaProgram program = Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 		Formula_Result result;
 		if (! thee)
 			thee = me;
 		for (integer icol = 1; icol <= my points.size; icol ++) {
-			Formula_run (0, icol, & result);
+			Formula_run (program.get(), 0, icol, & result);
 			if (isundef (result. numericResult))
 				Melder_throw (U"Cannot put an undefined value into the tier.");
 			thy points.at [icol] -> value = result. numericResult;
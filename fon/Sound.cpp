@@ -25,6 +25,7 @@
 #include "Sound.h"
 #include "Sound_extensions.h"
 #include "NUM2.h"
+#include "MelderThread.h"
 
 #include "enums_getText.h"
 #include "Sound_enums.h"
@@ -391,59 +392,258 @@ autoSound Sound_upsample (Sound me) {
 	}
 }
 
-autoSound Sound_resample (Sound me, double samplingFrequency, integer precision) {
-	double upfactor = samplingFrequency * my dx;
-	if (fabs (upfactor - 2.0) < 1e-6) return Sound_upsample (me);
-	if (fabs (upfactor - 1.0) < 1e-6) return Data_copy (me);
-	try {
-		integer numberOfSamples = Melder_iround ((my xmax - my xmin) * samplingFrequency);
-		if (numberOfSamples < 1)
-			Melder_throw (U"The resampled Sound would have no samples.");
-		autoSound filtered;
-		bool weNeedAnAntiAliasingFilter = ( upfactor < 1.0 );
+/*
+	Polyphase resampling.
+	If the new sampling frequency is L/M times the old one, with not too large integers L and M,
+	the positions of the output samples between the input samples repeat after L output samples,
+	so the filter weights have to be computed for only L "phases",
+	and every output sample is a single inner product of one row of weights with a stretch of the input.
+	This takes no memory beyond the table of weights, and the output samples can be computed in any order.
+*/
+static bool getRationalRatio (double ratio, integer maximumNumerator, integer maximumDenominator,
+	integer *out_numerator, integer *out_denominator)
+{
+	integer previousNumerator = 0, previousDenominator = 1, numerator = 1, denominator = 0;
+	double remainder = ratio;
+	for (integer iteration = 1; iteration <= 40; iteration ++) {   // continued fraction
+		const double wholePart = floor (remainder);
+		if (wholePart > double (maximumNumerator))
+			return false;
+		const integer term = integer (wholePart);
+		const integer nextNumerator = term * numerator + previousNumerator;
+		const integer nextDenominator = term * denominator + previousDenominator;
+		if (nextNumerator > maximumNumerator || nextDenominator > maximumDenominator)
+			return false;
+		previousNumerator = numerator;
+		previousDenominator = denominator;
+		numerator = nextNumerator;
+		denominator = nextDenominator;
+		if (fabs (double (numerator) / double (denominator) - ratio) <= 1e-12 * ratio) {
+			*out_numerator = numerator;
+			*out_denominator = denominator;
+			return true;
+		}
+		const double fraction = remainder - wholePart;
+		if (fraction <= 0.0)
+			return false;
+		remainder = 1.0 / fraction;
+	}
+	return false;
+}
+
+/*
+	Upsampling interpolates exactly like NUM_interpolate_sinc, with a depth of `precision` input samples.
+	Downsampling uses a Hann-windowed sinc that reaches 4 * `precision` output samples to either side,
+	with its cut-off just below the new Nyquist frequency, so that, like the FFT filter of the general case,
+	it is flat almost up to the new Nyquist frequency and leaves next to nothing above it.
+*/
+static double antiAliasingReach (integer precision) {
+	return 4.0 * precision;   // in output samples
+}
+
+static integer Sound_resample_polyphaseHalfWidth (double upfactor, integer precision) {
+	return ( upfactor < 1.0 ? Melder_iceiling (antiAliasingReach (precision) / upfactor) : precision );   // in input samples
+}
+
+void SoundResampler :: init (Sampled input, double samplingFrequency, integer interpolationDepth) {
+	our inputNx = input -> nx;
+	our inputX1 = input -> x1;
+	our inputDx = input -> dx;
+	our outputNx = Melder_iround ((input -> xmax - input -> xmin) * samplingFrequency);
+	if (our outputNx < 1)
+		Melder_throw (U"The resampled Sound would have no samples.");
+	our outputDx = 1.0 / samplingFrequency;
+	our outputX1 = 0.5 * (input -> xmin + input -> xmax - (our outputNx - 1) / samplingFrequency);
+	our upfactor = samplingFrequency * input -> dx;
+	our precision = interpolationDepth;
+	integer upNumerator, upDenominator;
+	our isExact = (
+		fabs (our upfactor - 2.0) >= 1e-6 &&   // otherwise, Sound_resample () upsamples with an FFT
+		our precision > NUM_VALUE_INTERPOLATE_CUBIC &&
+		getRationalRatio (our upfactor, 1000, 1000000, & upNumerator, & upDenominator) &&
+		upNumerator * 2 * Sound_resample_polyphaseHalfWidth (our upfactor, our precision) <= 10000000   // not too many weights
+	);
+	if (! our isExact)
+		return;
+	const bool weNeedAnAntiAliasingFilter = ( our upfactor < 1.0 );
+	our halfWidth = Sound_resample_polyphaseHalfWidth (our upfactor, our precision);
+	const double reach = antiAliasingReach (our precision), cutoff = 1.0 - 1.0 / reach;   // relative to the new Nyquist frequency
+	our numberOfPhases = upNumerator;
+	our step = upDenominator;
+	/*
+		Output sample i lies at input index firstIndex + (i - 1) * step / numberOfPhases;
+		write (i - 1) * step = quotient * numberOfPhases + phase.
+	*/
+	const double firstIndex = our inputIndex (1);
+	our firstLeftSample = Melder_ifloor (firstIndex);
+	const double firstFraction = firstIndex - our firstLeftSample;
+	our leftSampleOffsetOfPhase = newINTVECraw (our numberOfPhases);
+	our fractionOfPhase = newVECraw (our numberOfPhases);
+	our weights = newMATzero (our numberOfPhases, 2 * our halfWidth);   // column halfWidth belongs to the left sample
+	for (integer iphase = 1; iphase <= our numberOfPhases; iphase ++) {
+		const double position = firstFraction + double (iphase - 1) / our numberOfPhases;
+		integer offset = Melder_ifloor (position);
+		double fraction = position - offset;
+		if (fraction < 1e-9) {
+			fraction = 0.0;
+		} else if (fraction > 1.0 - 1e-9) {
+			offset += 1;
+			fraction = 0.0;
+		}
+		our leftSampleOffsetOfPhase [iphase] = offset;
+		our fractionOfPhase [iphase] = fraction;
+		VEC row = our weights.row (iphase);
 		if (weNeedAnAntiAliasingFilter) {
-			constexpr integer antiTurnAround = 1000;
-			constexpr integer numberOfPaddingSides = 2;   // namely beginning and end
-			integer nfft = 1;
-			while (nfft < my nx + antiTurnAround * numberOfPaddingSides) nfft *= 2;
-			autoVEC data = newVECraw (nfft);   // will be zeroed in every turn of the loop
-			filtered = Sound_create (my ny, my xmin, my xmax, my nx, my dx, my x1);
-			for (integer ichan = 1; ichan <= my ny; ichan ++) {
-				for (integer i = 1; i <= nfft; i ++)
-					data [i] = 0.0;
-				data.part (antiTurnAround + 1, antiTurnAround + my nx) <<= my z.row (ichan);
-				NUMrealft (data.get(), 1);   // go to the frequency domain
-				for (integer i = Melder_ifloor (upfactor * nfft); i <= nfft; i ++)
-					data [i] = 0.0;   // filter away high frequencies
-				data [2] = 0.0;
-				NUMrealft (data.get(), -1);   // return to the time domain
-				double factor = 1.0 / nfft;
-				VEC to = filtered -> z.row (ichan);
-				for (integer i = 1; i <= my nx; i ++)
-					to [i] = data [i + antiTurnAround] * factor;
+			double sum = 0.0;
+			for (integer icol = 1; icol <= 2 * our halfWidth; icol ++) {
+				const double u = (icol - our halfWidth - fraction) * our upfactor;   // distance in output samples
+				if (fabs (u) >= reach)
+					continue;
+				const double sinc = ( u == 0.0 ? 1.0 : sin (NUMpi * cutoff * u) / (NUMpi * cutoff * u) );
+				row [icol] = sinc * 0.5 * (1.0 + cos (NUMpi * u / reach));
+				sum += row [icol];
+			}
+			row  *=  1.0 / sum;   // no ripple in the DC gain
+		} else if (fraction == 0.0) {
+			row [our halfWidth] = 1.0;
+		} else {
+			for (integer k = 0; k < our halfWidth; k ++) {
+				const double left = fraction + k, right = 1.0 - fraction + k;
+				row [our halfWidth - k] = 0.5 * sin (NUMpi * left) / (NUMpi * left) * (1.0 + cos (NUMpi * left / (fraction + our halfWidth)));
+				row [our halfWidth + 1 + k] = 0.5 * sin (NUMpi * right) / (NUMpi * right) * (1.0 + cos (NUMpi * right / (1.0 - fraction + our halfWidth)));
 			}
-			me = filtered.get();   // reference copy; remove at end
 		}
-		autoSound thee = Sound_create (my ny, my xmin, my xmax, numberOfSamples, 1.0 / samplingFrequency,
-				0.5 * (my xmin + my xmax - (numberOfSamples - 1) / samplingFrequency));
-		for (integer ichan = 1; ichan <= my ny; ichan ++) {
-			if (precision <= 1) {
-				for (integer i = 1; i <= numberOfSamples; i ++) {
-					double x = Sampled_indexToX (thee.get(), i);
-					double index = Sampled_xToIndex (me, x);
-					integer leftSample = Melder_ifloor (index);
-					double fraction = index - leftSample;
-					thy z [ichan] [i] = ( leftSample < 1 || leftSample >= my nx ? 0.0 :
-							(1 - fraction) * my z [ichan] [leftSample] + fraction * my z [ichan] [leftSample + 1] );
-				}
+	}
+}
+
+integer SoundResampler :: leftSample (integer outputSample, integer *out_phase) const {
+	const int64 numerator = int64 (outputSample - 1) * our step;
+	const integer phase = integer (numerator % our numberOfPhases) + 1;
+	if (out_phase)
+		*out_phase = phase;
+	return our firstLeftSample + integer (numerator / our numberOfPhases) + our leftSampleOffsetOfPhase [phase];
+}
+
+/*
+	Without the polyphase filter, the anti-aliasing filter needs a margin around the input samples it is applied to.
+*/
+static constexpr integer SoundResampler_ANTI_ALIASING_MARGIN = 10000;
+
+void SoundResampler :: getInputRange (integer firstOutputSample, integer lastOutputSample,
+	integer *out_firstInputSample, integer *out_lastInputSample) const
+{
+	Melder_assert (firstOutputSample >= 1 && lastOutputSample <= our outputNx && lastOutputSample >= firstOutputSample);
+	if (our isExact) {
+		*out_firstInputSample = std::max (1_integer, our leftSample (firstOutputSample, nullptr) - our halfWidth + 1);
+		*out_lastInputSample = std::min (our inputNx, our leftSample (lastOutputSample, nullptr) + our halfWidth);
+	} else {
+		const integer margin = std::max (1_integer, our precision) + ( our upfactor < 1.0 ? SoundResampler_ANTI_ALIASING_MARGIN : 0 );
+		*out_firstInputSample = std::max (1_integer, Melder_ifloor (our inputIndex (firstOutputSample)) - margin);
+		*out_lastInputSample = std::min (our inputNx, Melder_iceiling (our inputIndex (lastOutputSample)) + margin);
+	}
+	Melder_assert (*out_lastInputSample >= *out_firstInputSample);
+}
+
+void SoundResampler :: resample (constMAT const& input, integer firstInputSample, integer firstOutputSample, MATVU const& output) const {
+	Melder_assert (output.nrow == input.nrow);
+	const integer inputOffset = firstInputSample - 1;
+	if (our isExact) {
+		const bool weNeedAnAntiAliasingFilter = ( our upfactor < 1.0 );
+		for (integer i = 1; i <= output.ncol; i ++) {
+			integer phase;
+			const integer leftSample = our leftSample (firstOutputSample - 1 + i, & phase);
+			const integer firstTap = leftSample - our halfWidth + 1, lastTap = leftSample + our halfWidth;
+			if (weNeedAnAntiAliasingFilter) {
+				/*
+					Zero outside the signal.
+				*/
+				const integer from = std::max (firstTap, 1_integer), to = std::min (lastTap, our inputNx);
+				Melder_assert (from > to || from > inputOffset && to <= inputOffset + input.ncol);
+				for (integer ichan = 1; ichan <= output.nrow; ichan ++)
+					output [ichan] [i] = ( from > to ? 0.0 :
+							NUMinner (our weights.row (phase).part (from - firstTap + 1, to - firstTap + 1),
+									input.row (ichan).part (from - inputOffset, to - inputOffset)) );
+			} else if (firstTap < 1 || lastTap > our inputNx) {
+				/*
+					Near the edges NUM_interpolate_sinc reduces its depth;
+					the input then starts at the first sample or ends at the last sample of the signal.
+				*/
+				const double index = leftSample + our fractionOfPhase [phase];
+				for (integer ichan = 1; ichan <= output.nrow; ichan ++)
+					output [ichan] [i] = NUM_interpolate_sinc (input.row (ichan), index - inputOffset, our precision);
+			} else if (our fractionOfPhase [phase] == 0.0) {
+				for (integer ichan = 1; ichan <= output.nrow; ichan ++)
+					output [ichan] [i] = input [ichan] [leftSample - inputOffset];
 			} else {
-				for (integer i = 1; i <= numberOfSamples; i ++) {
-					double x = Sampled_indexToX (thee.get(), i);
-					double index = Sampled_xToIndex (me, x);
-					thy z [ichan] [i] = NUM_interpolate_sinc (my z.row (ichan), index, precision);
-				}
+				for (integer ichan = 1; ichan <= output.nrow; ichan ++)
+					output [ichan] [i] = NUMinner (our weights.row (phase), input.row (ichan).part (firstTap - inputOffset, lastTap - inputOffset));
 			}
 		}
+		return;
+	}
+	constMAT from = input;
+	autoMAT filtered;
+	if (our upfactor < 1.0) {
+		constexpr integer antiTurnAround = 1000;
+		constexpr integer numberOfPaddingSides = 2;   // namely beginning and end
+		integer nfft = 1;
+		while (nfft < input.ncol + antiTurnAround * numberOfPaddingSides)
+			nfft *= 2;
+		autoVEC data = newVECraw (nfft);   // will be zeroed in every turn of the loop
+		filtered = newMATraw (input.nrow, input.ncol);
+		for (integer ichan = 1; ichan <= input.nrow; ichan ++) {
+			for (integer i = 1; i <= nfft; i ++)
+				data [i] = 0.0;
+			data.part (antiTurnAround + 1, antiTurnAround + input.ncol) <<= input.row (ichan);
+			NUMrealft (data.get(), 1);   // go to the frequency domain
+			for (integer i = Melder_ifloor (our upfactor * nfft); i <= nfft; i ++)
+				data [i] = 0.0;   // filter away high frequencies
+			data [2] = 0.0;
+			NUMrealft (data.get(), -1);   // return to the time domain
+			const double factor = 1.0 / nfft;
+			VEC to = filtered.row (ichan);
+			for (integer i = 1; i <= input.ncol; i ++)
+				to [i] = data [i + antiTurnAround] * factor;
+		}
+		from = filtered.get();
+	}
+	for (integer ichan = 1; ichan <= output.nrow; ichan ++) {
+		if (our precision <= 1) {
+			for (integer i = 1; i <= output.ncol; i ++) {
+				const double index = our inputIndex (firstOutputSample - 1 + i);
+				const integer leftSample = Melder_ifloor (index);
+				const double fraction = index - leftSample;
+				output [ichan] [i] = ( leftSample < 1 || leftSample >= our inputNx ? 0.0 :
+						(1 - fraction) * from [ichan] [leftSample - inputOffset] + fraction * from [ichan] [leftSample + 1 - inputOffset] );
+			}
+		} else {
+			for (integer i = 1; i <= output.ncol; i ++) {
+				const double index = our inputIndex (firstOutputSample - 1 + i);
+				output [ichan] [i] = NUM_interpolate_sinc (from.row (ichan), index - inputOffset, our precision);
+			}
+		}
+	}
+}
+
+autoSound Sound_resample (Sound me, double samplingFrequency, integer precision) {
+	double upfactor = samplingFrequency * my dx;
+	if (fabs (upfactor - 2.0) < 1e-6) return Sound_upsample (me);
+	if (fabs (upfactor - 1.0) < 1e-6) return Data_copy (me);
+	try {
+		SoundResampler resampler;
+		resampler.init (me, samplingFrequency, precision);
+		autoSound thee = Sound_create (my ny, my xmin, my xmax, resampler.outputNx, resampler.outputDx, resampler.outputX1);
+		if (resampler.isExact) {
+			/*
+				The output samples can be computed in any order.
+			*/
+			const integer numberOfThreads = MelderThread_computeNumberOfThreads (thy nx, 10000);
+			MelderThread_parallelFor (thy nx, numberOfThreads, [&] (integer /* ithread */, integer firstSample, integer lastSample) {
+				resampler.resample (my z.get(), 1, firstSample, thy z.verticalBand (firstSample, lastSample));
+			});
+		} else {
+			resampler.resample (my z.get(), 1, 1, thy z.all());
+		}
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": not resampled.");
@@ -534,6 +734,81 @@ autoSound Sounds_concatenate (OrderedOf<structSound>& list, double overlapTime)
 	}
 }
 
+/*
+	Convolution of a long signal with a much shorter kernel, block by block ("overlap-save").
+	Every block of the output needs a stretch of the signal that is only nkernel - 1 samples longer than the block,
+	so a block costs one FFT that is a few times longer than the kernel,
+	instead of all of the output costing one FFT that is longer than the whole signal.
+	The blocks do not overlap in the output, so they can be computed in parallel.
+	Like the unnormalized inverse FFT of the single-FFT method, the result is multiplied by `nfft`
+	(a power of two), so that the caller can scale both results in the same way.
+*/
+static bool weShouldConvolveInBlocks (integer n1, integer n2) {
+	const integer shorter = std::min (n1, n2), longer = std::max (n1, n2);
+	return longer >= 8 * shorter && longer + shorter > 65536;
+}
+
+static void convolveInBlocks (constMAT signal, constMAT kernel, integer nfft, MAT out) {
+	const integer nsignal = signal.ncol, nkernel = kernel.ncol, nout = nsignal + nkernel - 1;
+	Melder_assert (out.ncol == nout);
+	integer nfftBlock = 1024;
+	while (nfftBlock < 4 * nkernel)
+		nfftBlock *= 2;
+	const integer blockSize = nfftBlock - nkernel + 1;   // the number of output samples per block
+	const integer numberOfBlocks = (nout - 1) / blockSize + 1;
+	/*
+		The spectra of the kernel channels, scaled by nfft / nfftBlock (exactly, because both are powers of two).
+	*/
+	autoMAT kernelSpectra = newMATzero (kernel.nrow, nfftBlock);
+	for (integer ichan = 1; ichan <= kernel.nrow; ichan ++) {
+		VEC spectrum = kernelSpectra.row (ichan);
+		spectrum.part (1, nkernel) <<= kernel.row (ichan);
+		NUMrealft (spectrum, 1);
+		spectrum  *=  double (nfft) / double (nfftBlock);
+	}
+	const integer numberOfFrames = out.nrow * numberOfBlocks;
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfFrames, 1);
+	autoMAT buffers = newMATraw (numberOfThreads, nfftBlock);
+	MelderThread_parallelFor (numberOfFrames, numberOfThreads, [&] (integer ithread, integer firstFrame, integer lastFrame) {
+		VEC data = buffers.row (ithread);
+		for (integer iframe = firstFrame; iframe <= lastFrame; iframe ++) {
+			const integer channel = (iframe - 1) / numberOfBlocks + 1, iblock = (iframe - 1) % numberOfBlocks + 1;
+			constVEC x = signal.row (signal.nrow == 1 ? 1 : channel);
+			constVEC spectrum = kernelSpectra.row (kernel.nrow == 1 ? 1 : channel);
+			/*
+				data [i] = x [firstOut - nkernel + i], zero outside the signal.
+			*/
+			const integer firstOut = 1 + (iblock - 1) * blockSize, lastOut = std::min (firstOut + blockSize - 1, nout);
+			const integer offset = firstOut - nkernel;
+			const integer from = std::max (1_integer, 1 - offset), to = std::min (nfftBlock, nsignal - offset);
+			data.part (1, nfftBlock)  <<=  0.0;
+			if (from <= to)
+				data.part (from, to) <<= x.part (from + offset, to + offset);
+			NUMrealft (data, 1);
+			data [1] *= spectrum [1];
+			data [2] *= spectrum [2];
+			for (integer i = 3; i <= nfftBlock; i += 2) {
+				const double temp = data [i] * spectrum [i] - data [i + 1] * spectrum [i + 1];
+				data [i + 1] = data [i] * spectrum [i + 1] + data [i + 1] * spectrum [i];
+				data [i] = temp;
+			}
+			NUMrealft (data, -1);
+			/*
+				The first nkernel - 1 values have wrapped around; the rest is the linear convolution.
+			*/
+			out.row (channel).part (firstOut, lastOut) <<= data.part (nkernel, nkernel + lastOut - firstOut);
+		}
+	});
+}
+
+static autoMAT reversedCopy (constMAT z) {
+	autoMAT result = newMATraw (z.nrow, z.ncol);
+	for (integer irow = 1; irow <= z.nrow; irow ++)
+		for (integer icol = 1; icol <= z.ncol; icol ++)
+			result [irow] [icol] = z [irow] [z.ncol + 1 - icol];
+	return result;
+}
+
 autoSound Sounds_convolve (Sound me, Sound thee, kSounds_convolve_scaling scaling, kSounds_convolve_signalOutsideTimeDomain signalOutsideTimeDomain) {
 	try {
 		if (my ny > 1 && thy ny > 1 && my ny != thy ny)
@@ -544,34 +819,41 @@ autoSound Sounds_convolve (Sound me, Sound thee, kSounds_convolve_scaling scalin
 		integer n3 = n1 + n2 - 1, nfft = 1;
 		while (nfft < n3)
 			nfft *= 2;
-		autoVEC data1 = newVECraw (nfft);
-		autoVEC data2 = newVECraw (nfft);
 		integer numberOfChannels = std::max (my ny, thy ny);
 		autoSound him = Sound_create (numberOfChannels, my xmin + thy xmin, my xmax + thy xmax, n3, my dx, my x1 + thy x1);
-		for (integer channel = 1; channel <= numberOfChannels; channel ++) {
-			double *a = & my z [my ny == 1 ? 1 : channel] [0];
-			for (integer i = n1; i > 0; i --)
-				data1 [i] = a [i];
-			for (integer i = n1 + 1; i <= nfft; i ++)
-				data1 [i] = 0.0;
-			a = & thy z [thy ny == 1 ? 1 : channel] [0];
-			for (integer i = n2; i > 0; i --)
-				data2 [i] = a [i];
-			for (integer i = n2 + 1; i <= nfft; i ++)
-				data2 [i] = 0.0;
-			NUMrealft (data1.get(), 1);
-			NUMrealft (data2.get(), 1);
-			data2 [1] *= data1 [1];
-			data2 [2] *= data1 [2];
-			for (integer i = 3; i <= nfft; i += 2) {
-				double temp = data1 [i] * data2 [i] - data1 [i + 1] * data2 [i + 1];
-				data2 [i + 1] = data1 [i] * data2 [i + 1] + data1 [i + 1] * data2 [i];
-				data2 [i] = temp;
+		if (weShouldConvolveInBlocks (n1, n2)) {
+			if (n1 >= n2)
+				convolveInBlocks (my z.get(), thy z.get(), nfft, his z.get());
+			else
+				convolveInBlocks (thy z.get(), my z.get(), nfft, his z.get());
+		} else {
+			autoVEC data1 = newVECraw (nfft);
+			autoVEC data2 = newVECraw (nfft);
+			for (integer channel = 1; channel <= numberOfChannels; channel ++) {
+				double *a = & my z [my ny == 1 ? 1 : channel] [0];
+				for (integer i = n1; i > 0; i --)
+					data1 [i] = a [i];
+				for (integer i = n1 + 1; i <= nfft; i ++)
+					data1 [i] = 0.0;
+				a = & thy z [thy ny == 1 ? 1 : channel] [0];
+				for (integer i = n2; i > 0; i --)
+					data2 [i] = a [i];
+				for (integer i = n2 + 1; i <= nfft; i ++)
+					data2 [i] = 0.0;
+				NUMrealft (data1.get(), 1);
+				NUMrealft (data2.get(), 1);
+				data2 [1] *= data1 [1];
+				data2 [2] *= data1 [2];
+				for (integer i = 3; i <= nfft; i += 2) {
+					double temp = data1 [i] * data2 [i] - data1 [i + 1] * data2 [i + 1];
+					data2 [i + 1] = data1 [i] * data2 [i + 1] + data1 [i + 1] * data2 [i];
+					data2 [i] = temp;
+				}
+				NUMrealft (data2.get(), -1);
+				a = & him -> z [channel] [0];
+				for (integer i = 1; i <= n3; i ++)
+					a [i] = data2 [i];
 			}
-			NUMrealft (data2.get(), -1);
-			a = & him -> z [channel] [0];
-			for (integer i = 1; i <= n3; i ++)
-				a [i] = data2 [i];
 		}
 		switch (signalOutsideTimeDomain) {
 			case kSounds_convolve_signalOutsideTimeDomain::ZERO: {
@@ -627,36 +909,47 @@ autoSound Sounds_crossCorrelate (Sound me, Sound thee, kSounds_convolve_scaling
 		integer n3 = n1 + n2 - 1, nfft = 1;
 		while (nfft < n3)
 			nfft *= 2;
-		autoVEC data1 = newVECraw (nfft);
-		autoVEC data2 = newVECraw (nfft);
 		double my_xlast = my x1 + (n1 - 1) * my dx;
 		autoSound him = Sound_create (numberOfChannels, thy xmin - my xmax, thy xmax - my xmin, n3, my dx, thy x1 - my_xlast);
-		for (integer channel = 1; channel <= numberOfChannels; channel ++) {
-			double *a = & my z [my ny == 1 ? 1 : channel] [0];
-			for (integer i = n1; i > 0; i --)
-				data1 [i] = a [i];
-			for (integer i = n1 + 1; i <= nfft; i ++)
-				data1 [i] = 0.0;
-			a = & thy z [thy ny == 1 ? 1 : channel] [0];
-			for (integer i = n2; i > 0; i --)
-				data2 [i] = a [i];
-			for (integer i = n2 + 1; i <= nfft; i ++)
-				data2 [i] = 0.0;
-			NUMrealft (data1.get(), 1);
-			NUMrealft (data2.get(), 1);
-			data2 [1] *= data1 [1];
-			data2 [2] *= data1 [2];
-			for (integer i = 3; i <= nfft; i += 2) {
-				double temp = data1 [i] * data2 [i] + data1 [i + 1] * data2 [i + 1];   // reverse me by taking the conjugate of data1
-				data2 [i + 1] = data1 [i] * data2 [i + 1] - data1 [i + 1] * data2 [i];   // reverse me by taking the conjugate of data1
-				data2 [i] = temp;
+		if (weShouldConvolveInBlocks (n1, n2)) {
+			/*
+				Cross-correlating with me is convolving with me reversed.
+			*/
+			autoMAT myReversedSamples = reversedCopy (my z.get());
+			if (n1 >= n2)
+				convolveInBlocks (myReversedSamples.get(), thy z.get(), nfft, his z.get());
+			else
+				convolveInBlocks (thy z.get(), myReversedSamples.get(), nfft, his z.get());
+		} else {
+			autoVEC data1 = newVECraw (nfft);
+			autoVEC data2 = newVECraw (nfft);
+			for (integer channel = 1; channel <= numberOfChannels; channel ++) {
+				double *a = & my z [my ny == 1 ? 1 : channel] [0];
+				for (integer i = n1; i > 0; i --)
+					data1 [i] = a [i];
+				for (integer i = n1 + 1; i <= nfft; i ++)
+					data1 [i] = 0.0;
+				a = & thy z [thy ny == 1 ? 1 : channel] [0];
+				for (integer i = n2; i > 0; i --)
+					data2 [i] = a [i];
+				for (integer i = n2 + 1; i <= nfft; i ++)
+					data2 [i] = 0.0;
+				NUMrealft (data1.get(), 1);
+				NUMrealft (data2.get(), 1);
+				data2 [1] *= data1 [1];
+				data2 [2] *= data1 [2];
+				for (integer i = 3; i <= nfft; i += 2) {
+					double temp = data1 [i] * data2 [i] + data1 [i + 1] * data2 [i + 1];   // reverse me by taking the conjugate of data1
+					data2 [i + 1] = data1 [i] * data2 [i + 1] - data1 [i + 1] * data2 [i];   // reverse me by taking the conjugate of data1
+					data2 [i] = temp;
+				}
+				NUMrealft (data2.get(), -1);
+				a = & him -> z [channel] [0];
+				for (integer i = 1; i < n1; i ++)
+					a [i] = data2 [i + (nfft - (n1 - 1))];   // data for the first part ("negative lags") is at the end of data2
+				for (integer i = 1; i <= n2; i ++)
+					a [i + (n1 - 1)] = data2 [i];   // data for the second part ("positive lags") is at the beginning of data2
 			}
-			NUMrealft (data2.get(), -1);
-			a = & him -> z [channel] [0];
-			for (integer i = 1; i < n1; i ++)
-				a [i] = data2 [i + (nfft - (n1 - 1))];   // data for the first part ("negative lags") is at the end of data2
-			for (integer i = 1; i <= n2; i ++)
-				a [i + (n1 - 1)] = data2 [i];   // data for the second part ("positive lags") is at the beginning of data2
 		}
 		switch (signalOutsideTimeDomain) {
 			case kSounds_convolve_signalOutsideTimeDomain::ZERO: {
@@ -117,6 +117,38 @@ autoSound Sound_resample (Sound me, double samplingFrequency, integer precision)
 		precision >= 2: sinx/x interpolation with maximum depth equal to 'precision'.
 */
 
+/*
+	Sound_resample () piece by piece, for a sound that is not in memory as a whole (e.g. a LongSound).
+	The output samples firstOutputSample .. firstOutputSample + output.ncol - 1 are computed
+	from the input samples that getInputRange () asks for, which start at firstInputSample.
+	If the ratio of the sampling frequencies allows Sound_resample () to use its polyphase filter (isExact),
+	the output samples are exactly those that Sound_resample () computes from the whole sound;
+	otherwise, the anti-aliasing filter works on each piece of input separately, so that the samples can differ slightly.
+*/
+struct SoundResampler {
+	integer inputNx, outputNx;
+	double inputX1, inputDx, outputX1, outputDx;
+	double upfactor;
+	integer precision;
+	bool isExact;
+	void init (Sampled input, double samplingFrequency, integer precision);
+	void getInputRange (integer firstOutputSample, integer lastOutputSample,
+		integer *out_firstInputSample, integer *out_lastInputSample) const;
+	void resample (constMAT const& input, integer firstInputSample, integer firstOutputSample, MATVU const& output) const;
+private:
+	/*
+		The polyphase filter.
+	*/
+	integer halfWidth, numberOfPhases, step, firstLeftSample;
+	autoINTVEC leftSampleOffsetOfPhase;
+	autoVEC fractionOfPhase;
+	autoMAT weights;
+	integer leftSample (integer outputSample, integer *out_phase) const;
+	double inputIndex (integer outputSample) const {
+		return (our outputX1 + (outputSample - 1) * our outputDx - our inputX1) / our inputDx + 1.0;   // as Sampled_xToIndex (Sampled_indexToX ())
+	}
+};
+
 autoSound Sounds_append (Sound me, double silenceDuration, Sound thee);
 /*
 	Function:
@@ -18,6 +18,8 @@
 
 #include "Sound_and_Spectrogram.h"
 #include "NUM2.h"
+#include "MelderThread.h"
+#include <atomic>
 
 #include "enums_getText.h"
 #include "Sound_and_Spectrogram_enums.h"
@@ -118,69 +120,97 @@ autoSpectrogram Sound_to_Spectrogram (Sound me, double effectiveAnalysisWidth, d
 		}
 		const double oneByBinWidth = 1.0 / double (windowssq) / binWidth_samples;
 
-		autoVEC data = newVECzero (nsampFFT);
-		autoVEC spectrum = newVECzero (half_nsampFFT + 1);
-		autoNUMfft_Table fftTable;
-		NUMfft_Table_init (& fftTable, nsampFFT);
+		/*
+			The frames are analysed in parallel. Every thread has its own FFT table and buffers,
+			and writes its frames directly into the columns of the spectrogram.
+			A thread transforms its frames in batches, so that NUMfft_forward_many
+			can handle several frames at once.
+		*/
+		constexpr integer maximumNumberOfFramesPerBatch = 8;
+		const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfTimes, 20);
+		std::vector <autoMAT> dataBuffers (uinteger (numberOfThreads + 1)), spectrumBuffers (uinteger (numberOfThreads + 1));   // base 1
+		std::vector <autoNUMfft_Table> fftTables (uinteger (numberOfThreads + 1));
+		for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
+			dataBuffers [ithread] = newMATzero (maximumNumberOfFramesPerBatch, nsampFFT);
+			spectrumBuffers [ithread] = newMATzero (maximumNumberOfFramesPerBatch, half_nsampFFT + 1);
+			NUMfft_Table_init (& fftTables [ithread], nsampFFT);
+		}
+		std::atomic <integer> numberOfFramesDone (0);
 
 		autoMelderProgress progress (U"Sound to Spectrogram...");
 
-		for (integer iframe = 1; iframe <= numberOfTimes; iframe ++) {
-			const double t = Sampled_indexToX (thee.get(), iframe);
-			const integer leftSample = Sampled_xToLowIndex (me, t), rightSample = leftSample + 1;
-			const integer startSample = rightSample - halfnsamp_window;
-			const integer endSample = leftSample + halfnsamp_window;
-			Melder_assert (startSample >= 1);
-			Melder_assert (endSample <= my nx);
-
-			spectrum.all() <<= 0.0;
-			/*
-				For multichannel sounds, the power spectrogram should represent the
-				average power in the channels,
-				so that the result for a stereo sound in which the
-				left channel has the same waveform as the right channel,
-				is identical to the result for the corresponding mono (= averaged) sound.
-				Averaging starts by adding up the powers of the channels.
-			*/
-			for (integer channel = 1; channel <= my ny; channel ++) {
-				for (integer j = 1, i = startSample; j <= nsamp_window; j ++)
-					data [j] = my z [channel] [i ++] * window [j];
-				for (integer j = nsamp_window + 1; j <= nsampFFT; j ++)
-					data [j] = 0.0f;
-
-				Melder_progress (iframe / (numberOfTimes + 1.0),
-					U"Sound to Spectrogram: analysis of frame ", iframe, U" out of ", numberOfTimes);
+		MelderThread_parallelFor (numberOfTimes, numberOfThreads, [&] (integer ithread, integer firstFrame, integer lastFrame) {
+			NUMfft_Table fftTable = & fftTables [ithread];
+			for (integer firstFrameOfBatch = firstFrame; firstFrameOfBatch <= lastFrame; firstFrameOfBatch += maximumNumberOfFramesPerBatch) {
+				const integer numberOfFramesInBatch = std::min (maximumNumberOfFramesPerBatch, lastFrame - firstFrameOfBatch + 1);
+				MAT data (& dataBuffers [ithread] [1] [1], numberOfFramesInBatch, nsampFFT);   // the first rows of the buffer
+				MAT spectrum (& spectrumBuffers [ithread] [1] [1], numberOfFramesInBatch, half_nsampFFT + 1);
 
+				spectrum <<= 0.0;
 				/*
-					Compute the Fast Fourier Transform of the frame.
+					For multichannel sounds, the power spectrogram should represent the
+					average power in the channels,
+					so that the result for a stereo sound in which the
+					left channel has the same waveform as the right channel,
+					is identical to the result for the corresponding mono (= averaged) sound.
+					Averaging starts by adding up the powers of the channels.
 				*/
-				NUMfft_forward (& fftTable, data.get());   // data := complex spectrum
+				for (integer channel = 1; channel <= my ny; channel ++) {
+					for (integer iframeInBatch = 1; iframeInBatch <= numberOfFramesInBatch; iframeInBatch ++) {
+						const double t = Sampled_indexToX (thee.get(), firstFrameOfBatch + iframeInBatch - 1);
+						const integer leftSample = Sampled_xToLowIndex (me, t), rightSample = leftSample + 1;
+						const integer startSample = rightSample - halfnsamp_window;
+						const integer endSample = leftSample + halfnsamp_window;
+						Melder_assert (startSample >= 1);
+						Melder_assert (endSample <= my nx);
+						for (integer j = 1, i = startSample; j <= nsamp_window; j ++)
+							data [iframeInBatch] [j] = my z [channel] [i ++] * window [j];
+						for (integer j = nsamp_window + 1; j <= nsampFFT; j ++)
+							data [iframeInBatch] [j] = 0.0f;
+					}
+
+					/*
+						Compute the Fast Fourier Transforms of the frames.
+					*/
+					NUMfft_forward_many (fftTable, data);   // data := complex spectra
+
+					/*
+						Convert from complex to power spectrum,
+						accumulating the power spectra of the channels.
+					*/
+					for (integer iframeInBatch = 1; iframeInBatch <= numberOfFramesInBatch; iframeInBatch ++) {
+						constVEC frame = data.row (iframeInBatch);
+						VEC power = spectrum.row (iframeInBatch);
+						power [1] += frame [1] * frame [1];   // DC component
+						for (integer i = 2; i <= half_nsampFFT; i ++)
+							power [i] += frame [i + i - 2] * frame [i + i - 2] + frame [i + i - 1] * frame [i + i - 1];
+						power [half_nsampFFT + 1] += frame [nsampFFT] * frame [nsampFFT];   // Nyquist frequency. Correct??
+					}
+				}
+				/*
+					Power averaging ends by dividing the summed power by the number of channels,
+				*/
+				if (my ny > 1 )
+					spectrum  /=  my ny;
 
 				/*
-					Convert from complex to power spectrum,
-					accumulating the power spectra of the channels.
+					Binning.
 				*/
-				spectrum [1] += data [1] * data [1];   // DC component
-				for (integer i = 2; i <= half_nsampFFT; i ++)
-					spectrum [i] += data [i + i - 2] * data [i + i - 2] + data [i + i - 1] * data [i + i - 1];
-				spectrum [half_nsampFFT + 1] += data [nsampFFT] * data [nsampFFT];   // Nyquist frequency. Correct??
-			}
-			/*
-				Power averaging ends by dividing the summed power by the number of channels,
-			*/
-			if (my ny > 1 )
-				spectrum.all()  /=  my ny;
-
-			/*
-				Binning.
-			*/
-			for (integer iband = 1; iband <= numberOfFreqs; iband ++) {
-				const integer lowerSample = (iband - 1) * binWidth_samples + 1;
-				const integer higherSample = lowerSample + binWidth_samples;
-				const double power = NUMsum (spectrum.part (lowerSample, higherSample - 1));
-				thy z [iband] [iframe] = power * oneByBinWidth;
+				for (integer iframeInBatch = 1; iframeInBatch <= numberOfFramesInBatch; iframeInBatch ++) {
+					const integer iframe = firstFrameOfBatch + iframeInBatch - 1;
+					for (integer iband = 1; iband <= numberOfFreqs; iband ++) {
+						const integer lowerSample = (iband - 1) * binWidth_samples + 1;
+						const integer higherSample = lowerSample + binWidth_samples;
+						const double power = NUMsum (spectrum.row (iframeInBatch).part (lowerSample, higherSample - 1));
+						thy z [iband] [iframe] = power * oneByBinWidth;
+					}
+				}
 			}
-		}
+			numberOfFramesDone += lastFrame - firstFrame + 1;
+			if (ithread == 1)   // only the calling thread can show progress (and be cancelled)
+				Melder_progress (numberOfFramesDone / (numberOfTimes + 1.0),
+					U"Sound to Spectrogram: analysis of frame ", numberOfFramesDone.load (), U" out of ", numberOfTimes);
+		});
 		return thee;
 	} catch (MelderError) {
 		Melder_throw (me, U": spectrogram analysis not performed.");
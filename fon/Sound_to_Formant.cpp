@@ -32,16 +32,19 @@
 #include "NUM2.h"
 #include "Polynomial.h"
 #include "Roots.h"
+#include "MelderThread.h"
+#include <atomic>
 
 static void burg (constVEC samples, VEC coefficients,
-	Formant_Frame frame, double nyquistFrequency, double safetyMargin)
+	Formant_Frame frame, double nyquistFrequency, double safetyMargin,
+	Polynomial polynomial, Roots roots, VEC const& rootsWorkspace)
 {
 	double a0 = VECburg (coefficients, samples);
 	(void) a0;
 	/*
 		Convert LP coefficients to polynomial.
 	 */
-	autoPolynomial polynomial = Polynomial_create (-1, 1, coefficients.size);
+	Melder_assert (polynomial -> numberOfCoefficients == coefficients.size + 1);
 	for (integer i = 1; i <= coefficients.size; i ++)
 		polynomial -> coefficients [i] = - coefficients [coefficients.size - i + 1];
 	polynomial -> coefficients [coefficients.size + 1] = 1.0;
@@ -49,8 +52,8 @@ static void burg (constVEC samples, VEC coefficients,
 	/*
 		Find the roots of the polynomial.
 	 */
-	autoRoots roots = Polynomial_to_Roots (polynomial.get());
-	Roots_fixIntoUnitCircle (roots.get());
+	Polynomial_into_Roots (polynomial, roots, rootsWorkspace);
+	Roots_fixIntoUnitCircle (roots);
 
 	Melder_assert (frame -> numberOfFormants == 0 && NUMisEmpty (frame -> formant.get()));
 
@@ -94,16 +97,8 @@ static int findOneZero (integer ijt, double vcx [], double a, double b, double *
 		fa = vcx [k] + a * fa;
 		fb = vcx [k] + b * fb;
 	}
-	if (fa * fb >= 0.0) {   // there should be a zero between a and b
-		Melder_casual (
-			U"There is no zero between ,", Melder_single (a),
-			U" and ", Melder_single (b),
-			U".\n    The function values are ", Melder_single (fa),
-			U" and ", Melder_single (fb),
-			U", respectively."
-		);
-		return 0;
-	}
+	if (fa * fb >= 0.0)   // there should be a zero between a and b
+		return 0;   // not reported here, because we may be in a worker thread; the caller reports the frame
 	do {
 		fx = 0.0;
 		/*x = fa == fb ? 0.5 * (a + b) : a + fa * (a - b) / (fb - fa);*/
@@ -148,13 +143,8 @@ static int findNewZeroes (integer ijt, double ppORIG [], integer degree,
 	/* Fill an array with the new zeroes, which lie between the old zeroes. */
 	newZeroes [0] = 1.0;
 	for (integer i = 1; i <= half_degree; i ++) {
-		if (! findOneZero (ijt, px, zeroes [i - 1], zeroes [i], & newZeroes [i])) {
-			Melder_casual (
-				U"Degree ", degree,
-				U" not completed."
-			);
+		if (! findOneZero (ijt, px, zeroes [i - 1], zeroes [i], & newZeroes [i]))
 			return 0;
-		}
 	}
 	newZeroes [half_degree + 1] = -1.0;
 	/*
@@ -293,8 +283,35 @@ void Formant_sort (Formant me) {
 	}
 }
 
-static autoFormant Sound_to_Formant_any_inplace (Sound me, double dt_in, integer numberOfPoles,
-	double halfdt_window, int which, double preemphasisFrequency, double safetyMargin)
+/*
+	The value of Sampled_getValueAtSample (sound, isamp, Sound_LEVEL_MONO, 0),
+	where the channels of `sound` at sample `isamp` are in column `column` of `samples`.
+*/
+static double getMonoValue (constMAT const& samples, integer column) {
+	double value;
+	if (samples.nrow == 1) {
+		value = samples [1] [column];
+	} else if (samples.nrow == 2) {
+		value = 0.5 * (samples [1] [column] + samples [2] [column]);
+	} else {
+		longdouble sum = 0.0;
+		for (integer channel = 1; channel <= samples.nrow; channel ++)
+			sum += samples [channel] [column];
+		value = double (sum / samples.nrow);
+	}
+	return value;
+}
+
+/*
+	The analysis works on any Sampled with the time domain and sampling of the (resampled) sound.
+	The pre-emphasized samples are read in blocks by `readSamples (firstSample, lastSample, & sampleOffset)`,
+	which returns a matrix (channel x sample) in which sample `isamp` is found in column `isamp - sampleOffset`;
+	each block contains the samples of as many frames as fit in `maximumNumberOfSamplesPerBlock` (but at least one frame).
+*/
+template <typename ReadSamples>
+static autoFormant Sampled_to_Formant_any (Sampled me, double dt_in, integer numberOfPoles,
+	double halfdt_window, int which, double safetyMargin,
+	ReadSamples readSamples, integer maximumNumberOfSamplesPerBlock)
 {
 	const double dt = ( dt_in > 0.0 ? dt_in : halfdt_window / 4.0 );
 	const double physicalDuration = my nx * my dx;
@@ -315,9 +332,6 @@ static autoFormant Sound_to_Formant_any_inplace (Sound me, double dt_in, integer
 
 	autoMelderProgress progress (U"Formant analysis...");
 
-	/* Pre-emphasis. */
-	Sound_preEmphasis (me, preemphasisFrequency);
-
 	/* Gaussian window. */
 	autoVEC window = newVECraw (nsamp_window);
 	for (integer i = 1; i <= nsamp_window; i ++) {
@@ -325,51 +339,109 @@ static autoFormant Sound_to_Formant_any_inplace (Sound me, double dt_in, integer
 		window [i] = (exp (-48.0 * (i - imid) * (i - imid) / (nsamp_window + 1) / (nsamp_window + 1)) - edge) / (1.0 - edge);
 	}
 
-	integer maximumFrameLength = nsamp_window;
-	auto frameBuffer = newVECraw (maximumFrameLength);
-	auto coefficients = newVECraw (numberOfPoles);   // superfluous if which==2, but nobody uses that anyway
-	for (integer iframe = 1; iframe <= nFrames; iframe ++) {
-		const double t = Sampled_indexToX (thee.get(), iframe);
-		const integer leftSample = Sampled_xToLowIndex (me, t);
-		const integer rightSample = leftSample + 1;
-		integer startSample = rightSample - halfnsamp_window;
-		integer endSample = leftSample + halfnsamp_window;
-		double maximumIntensity = 0.0;
-		Melder_clipLeft (1_integer, & startSample);   // this should not be more than a rounding problem
-		Melder_clipRight (& endSample, my nx);   // this should not be more than a rounding problem
-		for (integer i = startSample; i <= endSample; i ++) {
-			const double value = Sampled_getValueAtSample (me, i, Sound_LEVEL_MONO, 0);
-			if (value * value > maximumIntensity)
-				maximumIntensity = value * value;
-		}
-		thy frames [iframe]. intensity = maximumIntensity;
-		if (maximumIntensity == 0.0)
-			continue;   // Burg cannot stand all zeroes
-
-		/* Copy a pre-emphasized window to a frame. */
-		const integer actualFrameLength = endSample - startSample + 1;   // should rarely be less than nsamp_window
-		VEC frame = frameBuffer.part (1, actualFrameLength);
-		const integer offset = startSample - 1;
-		for (integer isamp = 1; isamp <= actualFrameLength; isamp ++)
-			frame [isamp] = Sampled_getValueAtSample (me, offset + isamp, Sound_LEVEL_MONO, 0) * window [isamp];
-
-		if (which == 1) {
-			burg (frame, coefficients.get(), & thy frames [iframe], 0.5 / my dx, safetyMargin);
-		} else if (which == 2) {
-			if (! splitLevinson (frame, numberOfPoles, & thy frames [iframe], 0.5 / my dx)) {
-				Melder_clearError ();
-				Melder_casual (U"(Sound_to_Formant:)"
-					U" Analysis results of frame ", iframe,
-					U" will be wrong."
-				);
+	/*
+		The frames are independent, so we can analyse them in parallel.
+		Each thread gets its own scratch memory; apart from that, the computation
+		for a frame is the same as in the single-threaded case, so the result
+		does not depend on the number of threads.
+	*/
+	const integer maximumFrameLength = nsamp_window;
+	const integer numberOfThreads = MelderThread_computeNumberOfThreads (nFrames, 10);
+	autoMAT frameBuffers = newMATraw (numberOfThreads, maximumFrameLength);
+	autoMAT coefficientBuffers = newMATraw (numberOfThreads, numberOfPoles);   // superfluous if which==2, but nobody uses that anyway
+	const integer numberOfPolynomialCoefficients = numberOfPoles + 1;
+	autoMAT rootsWorkspaces = newMATraw (numberOfThreads, numberOfPolynomialCoefficients * (numberOfPolynomialCoefficients + 9));
+	std::vector <autoPolynomial> polynomials (uinteger (numberOfThreads + 1));   // base 1
+	std::vector <autoRoots> roots (uinteger (numberOfThreads + 1));
+	for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
+		polynomials [ithread] = Polynomial_create (-1.0, 1.0, numberOfPoles);
+		roots [ithread] = Roots_create (numberOfPoles);
+	}
+	auto getLeftSample = [&] (integer iframe) -> integer {
+		return Sampled_xToLowIndex (me, Sampled_indexToX (thee.get(), iframe));
+	};
+	std::atomic <integer> numberOfFramesDone (0);
+	std::vector <std::vector <integer>> failedFrames (uinteger (numberOfThreads + 1));   // base 1
+
+	for (integer firstFrameOfBlock = 1; firstFrameOfBlock <= nFrames; ) {
+		const integer firstSampleOfBlock = std::max (1_integer, getLeftSample (firstFrameOfBlock) + 1 - halfnsamp_window);
+		integer lastFrameOfBlock = firstFrameOfBlock;
+		while (lastFrameOfBlock < nFrames &&
+			getLeftSample (lastFrameOfBlock + 1) + halfnsamp_window - firstSampleOfBlock < maximumNumberOfSamplesPerBlock)
+			lastFrameOfBlock ++;
+		const integer lastSampleOfBlock = std::min (my nx, getLeftSample (lastFrameOfBlock) + halfnsamp_window);
+		integer sampleOffset;
+		constMAT samples = readSamples (firstSampleOfBlock, lastSampleOfBlock, & sampleOffset);
+
+		MelderThread_parallelFor (lastFrameOfBlock - firstFrameOfBlock + 1, numberOfThreads, [&] (integer ithread, integer firstFrame, integer lastFrame) {
+			for (integer iframe = firstFrameOfBlock - 1 + firstFrame; iframe <= firstFrameOfBlock - 1 + lastFrame; iframe ++) {
+				const integer leftSample = getLeftSample (iframe);
+				const integer rightSample = leftSample + 1;
+				integer startSample = rightSample - halfnsamp_window;
+				integer endSample = leftSample + halfnsamp_window;
+				double maximumIntensity = 0.0;
+				Melder_clipLeft (1_integer, & startSample);   // this should not be more than a rounding problem
+				Melder_clipRight (& endSample, my nx);   // this should not be more than a rounding problem
+				for (integer i = startSample; i <= endSample; i ++) {
+					const double value = getMonoValue (samples, i - sampleOffset);
+					if (value * value > maximumIntensity)
+						maximumIntensity = value * value;
+				}
+				thy frames [iframe]. intensity = maximumIntensity;
+				if (maximumIntensity == 0.0)
+					continue;   // Burg cannot stand all zeroes
+
+				/* Copy a pre-emphasized window to a frame. */
+				const integer actualFrameLength = endSample - startSample + 1;   // should rarely be less than nsamp_window
+				VEC frame = frameBuffers.row (ithread).part (1, actualFrameLength);
+				const integer offset = startSample - 1 - sampleOffset;
+				for (integer isamp = 1; isamp <= actualFrameLength; isamp ++)
+					frame [isamp] = getMonoValue (samples, offset + isamp) * window [isamp];
+
+				if (which == 1) {
+					burg (frame, coefficientBuffers.row (ithread), & thy frames [iframe], 0.5 / my dx, safetyMargin,
+						polynomials [ithread].get(), roots [ithread].get(), rootsWorkspaces.row (ithread));
+				} else if (which == 2) {
+					if (! splitLevinson (frame, numberOfPoles, & thy frames [iframe], 0.5 / my dx))
+						failedFrames [ithread]. push_back (iframe);   // reported by the calling thread, after the analysis
+				}
 			}
-		}
-		Melder_progress ((double) iframe / (double) nFrames, U"Formant analysis: frame ", iframe);
+			numberOfFramesDone += lastFrame - firstFrame + 1;
+			if (ithread == 1)   // only the calling thread can show progress (and be cancelled)
+				Melder_progress ((double) numberOfFramesDone / (double) nFrames, U"Formant analysis: frame ", numberOfFramesDone.load ());
+		});
+		firstFrameOfBlock = lastFrameOfBlock + 1;
+	}
+	std::vector <integer> allFailedFrames;
+	for (integer ithread = 1; ithread <= numberOfThreads; ithread ++)
+		allFailedFrames.insert (allFailedFrames.end(), failedFrames [ithread].begin(), failedFrames [ithread].end());
+	if (allFailedFrames.size() > 0) {
+		std::sort (allFailedFrames.begin(), allFailedFrames.end());
+		autoMelderString frameNumbers;
+		for (const integer iframe : allFailedFrames)
+			MelderString_append (& frameNumbers, frameNumbers.length == 0 ? U"" : U", ", iframe);
+		Melder_casual (U"(Sound_to_Formant:)"
+			U" Analysis results of frame(s) ", frameNumbers.string,
+			U" will be wrong."
+		);
 	}
 	Formant_sort (thee.get());
 	return thee;
 }
 
+static autoFormant Sound_to_Formant_any_inplace (Sound me, double dt_in, integer numberOfPoles,
+	double halfdt_window, int which, double preemphasisFrequency, double safetyMargin)
+{
+	Sound_preEmphasis (me, preemphasisFrequency);
+	return Sampled_to_Formant_any (me, dt_in, numberOfPoles, halfdt_window, which, safetyMargin,
+		[me] (integer /* firstSample */, integer /* lastSample */, integer *sampleOffset) -> constMAT {
+			*sampleOffset = 0;
+			return my z.get();
+		},
+		INTEGER_MAX
+	);
+}
+
 autoFormant Sound_to_Formant_any (Sound me, double dt, integer numberOfPoles, double maximumFrequency,
 	double halfdt_window, int which, double preemphasisFrequency, double safetyMargin)
 {
@@ -407,4 +479,63 @@ autoFormant Sound_to_Formant_willems (Sound me, double dt, double nFormants, dou
 	}
 }
 
+/*
+	Read the samples firstSample .. firstSample + result.ncol - 1 of the LongSound resampled as Sound_resample () does it.
+*/
+static void LongSound_readResampled (LongSound me, SoundResampler const& resampler, integer firstSample, MAT const& result) {
+	integer firstOriginalSample, lastOriginalSample;
+	resampler.getInputRange (firstSample, firstSample + result.ncol - 1, & firstOriginalSample, & lastOriginalSample);
+	autoMAT original = newMATraw (my numberOfChannels, lastOriginalSample - firstOriginalSample + 1);
+	LongSound_readAudioToFloat (me, original.get(), firstOriginalSample);
+	resampler.resample (original.get(), firstOriginalSample, firstSample, result);
+}
+
+autoFormant LongSound_to_Formant_any (LongSound me, double dt, integer numberOfPoles, double maximumFrequency,
+	double halfdt_window, int which, double preemphasisFrequency, double safetyMargin)
+{
+	/*
+		The time sampling of the sound that Sound_to_Formant_any () would analyse.
+	*/
+	const double nyquist = 0.5 / my dx;
+	const bool weNeedToResample = ( maximumFrequency > 0.0 && fabs (maximumFrequency / nyquist - 1) >= 1e-6 );   // otherwise, Sound_resample () would merely copy
+	autoSampled grid = Thing_new (Sampled);
+	SoundResampler resampler;
+	if (weNeedToResample) {
+		resampler.init (me, maximumFrequency * 2, 50);
+		Sampled_init (grid.get(), my xmin, my xmax, resampler.outputNx, resampler.outputDx, resampler.outputX1);
+	} else {
+		Sampled_init (grid.get(), my xmin, my xmax, my nx, my dx, my x1);
+	}
+	const double preEmphasis = exp (-2.0 * NUMpi * preemphasisFrequency * grid -> dx);
+	autoMAT buffer;
+	return Sampled_to_Formant_any (grid.get(), dt, numberOfPoles, halfdt_window, which, safetyMargin,
+		[&] (integer firstSample, integer lastSample, integer *sampleOffset) -> constMAT {
+			const integer firstSampleRead = std::max (1_integer, firstSample - 1);   // one more, for the pre-emphasis
+			buffer = newMATraw (my numberOfChannels, lastSample - firstSampleRead + 1);
+			if (weNeedToResample)
+				LongSound_readResampled (me, resampler, firstSampleRead, buffer.get());
+			else
+				LongSound_readAudioToFloat (me, buffer.get(), firstSampleRead);
+			/*
+				The same pre-emphasis as Sound_preEmphasis (), except for the first sample read,
+				which is sample 1 (and stays as it is) or is not part of any frame.
+			*/
+			for (integer channel = 1; channel <= buffer.nrow; channel ++)
+				for (integer i = buffer.ncol; i >= 2; i --)
+					buffer [channel] [i] -= preEmphasis * buffer [channel] [i - 1];
+			*sampleOffset = firstSampleRead - 1;
+			return buffer.get();
+		},
+		LongSound_ANALYSIS_BLOCK_SIZE
+	);
+}
+
+autoFormant LongSound_to_Formant_burg (LongSound me, double dt, double nFormants, double maximumFrequency, double halfdt_window, double preemphasisFrequency) {
+	try {
+		return LongSound_to_Formant_any (me, dt, Melder_iround (2.0 * nFormants), maximumFrequency, halfdt_window, 1, preemphasisFrequency, 50.0);
+	} catch (MelderError) {
+		Melder_throw (me, U": formant analysis (Burg) not performed.");
+	}
+}
+
 /* End of file Sound_to_Formant.cpp */
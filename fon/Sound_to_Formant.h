@@ -17,6 +17,7 @@
  */
 
 #include "Sound.h"
+#include "LongSound.h"
 #include "Formant.h"
 
 autoFormant Sound_to_Formant_any (Sound me, double timeStep, integer numberOfPoles, double maximumFrequency,
@@ -37,4 +38,19 @@ autoFormant Sound_to_Formant_keepAll (Sound me, double timeStep, double maximumN
 autoFormant Sound_to_Formant_willems (Sound me, double timeStep, double numberOfFormants,
 	double maximumFormantFrequency, double windowLength, double preemphasisFrequency);
 
+autoFormant LongSound_to_Formant_any (LongSound me, double timeStep, integer numberOfPoles, double maximumFrequency,
+	double halfdt_window, int which, double preemphasisFrequency, double safetyMargin);
+autoFormant LongSound_to_Formant_burg (LongSound me, double timeStep, double maximumNumberOfFormants,
+	double maximumFormantFrequency, double windowLength, double preemphasisFrequency);
+/*
+	Same as Sound_to_Formant_any and Sound_to_Formant_burg,
+	but the samples are read from the file (and resampled) in blocks of LongSound_ANALYSIS_BLOCK_SIZE sample frames,
+	so that the whole sound never has to be in memory.
+	The resampling is done by a SoundResampler, i.e. with the same polyphase filter as Sound_resample (),
+	so the result is the same as for the Sound if the maximum formant frequency is half the sampling frequency,
+	or if the ratio of the sampling frequencies is a simple fraction other than 2 (SoundResampler::isExact);
+	otherwise, each block is resampled separately (with a margin) rather than the whole sound,
+	so that the formants can differ slightly from those of the Sound.
+*/
+
 /* End of file Sound_to_Formant.h */
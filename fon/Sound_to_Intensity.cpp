@@ -33,7 +33,16 @@
 
 #include "Sound_to_Intensity.h"
 
-static autoIntensity Sound_to_Intensity_ (Sound me, double minimumPitch, double timeStep, bool subtractMeanPressure) {
+/*
+	The analysis works on any Sampled with the time domain and sampling of a sound,
+	whose samples are read in blocks by `readSamples (firstSample, lastSample, & sampleOffset)`,
+	which returns a matrix (channel x sample) in which sample `isamp` is found in column `isamp - sampleOffset`.
+	Each block contains the samples of as many frames as fit in `maximumNumberOfSamplesPerBlock` (but at least one frame).
+*/
+template <typename ReadSamples>
+static autoIntensity Sampled_to_Intensity (Sampled me, double minimumPitch, double timeStep, bool subtractMeanPressure,
+	ReadSamples readSamples, integer maximumNumberOfSamplesPerBlock)
+{
 	try {
 		/*
 			Preconditions.
@@ -85,40 +94,54 @@ static autoIntensity Sound_to_Intensity_ (Sound me, double minimumPitch, double
 				U"i.e. at least ", physicalWindowDuration, U" s, instead of ", physicalSoundDuration, U" s.");
 		}
 		autoIntensity thee = Intensity_create (my xmin, my xmax, numberOfFrames, timeStep, thyFirstTime);
-		for (integer iframe = 1; iframe <= numberOfFrames; iframe ++) {
+		auto getCentreSampleNumber = [&] (integer iframe) -> integer {
 			const double midTime = Sampled_indexToX (thee.get(), iframe);
-			const integer soundCentreSampleNumber = Sampled_xToNearestIndex (me, midTime);   // time accuracy is half a sampling period
+			return Sampled_xToNearestIndex (me, midTime);   // time accuracy is half a sampling period
+		};
+		for (integer firstFrame = 1; firstFrame <= numberOfFrames; ) {
+			const integer firstSampleOfBlock = std::max (1_integer, getCentreSampleNumber (firstFrame) - halfWindowSamples);
+			integer lastFrame = firstFrame;
+			while (lastFrame < numberOfFrames &&
+				getCentreSampleNumber (lastFrame + 1) + halfWindowSamples - firstSampleOfBlock < maximumNumberOfSamplesPerBlock)
+				lastFrame ++;
+			const integer lastSampleOfBlock = std::min (my nx, getCentreSampleNumber (lastFrame) + halfWindowSamples);
+			integer sampleOffset;
+			constMAT samples = readSamples (firstSampleOfBlock, lastSampleOfBlock, & sampleOffset);
+			for (integer iframe = firstFrame; iframe <= lastFrame; iframe ++) {
+				const integer soundCentreSampleNumber = getCentreSampleNumber (iframe);
 
-			integer leftSample = soundCentreSampleNumber - halfWindowSamples;
-			integer rightSample = soundCentreSampleNumber + halfWindowSamples;
-			/*
-				Catch some edge cases, which are uncommon because Sampled_shortTermAnalysis() filtered out most problems.
-			*/
-			Melder_clipLeft (1_integer, & leftSample);
-			Melder_clipRight (& rightSample, my nx);
-			Melder_require (rightSample >= leftSample,
-				U"Unexpected edge case: right sample (", rightSample, U") less than left sample (", leftSample, U").");
+				integer leftSample = soundCentreSampleNumber - halfWindowSamples;
+				integer rightSample = soundCentreSampleNumber + halfWindowSamples;
+				/*
+					Catch some edge cases, which are uncommon because Sampled_shortTermAnalysis() filtered out most problems.
+				*/
+				Melder_clipLeft (1_integer, & leftSample);
+				Melder_clipRight (& rightSample, my nx);
+				Melder_require (rightSample >= leftSample,
+					U"Unexpected edge case: right sample (", rightSample, U") less than left sample (", leftSample, U").");
 
-			const integer windowFromSoundOffset = windowCentreSampleNumber - soundCentreSampleNumber;
-			VEC amplitudePart = amplitude.part (windowFromSoundOffset + leftSample, windowFromSoundOffset + rightSample);
-			constVEC windowPart = window.part (windowFromSoundOffset + leftSample, windowFromSoundOffset + rightSample);
-			longdouble sumxw = 0.0, sumw = 0.0;
-			for (integer ichan = 1; ichan <= my ny; ichan ++) {
-				amplitudePart <<= my z [ichan].part (leftSample, rightSample);
-				if (subtractMeanPressure)
-					VECcentre_inplace (amplitudePart);
-				for (integer isamp = 1; isamp <= amplitudePart.size; isamp ++) {
-					sumxw += sqr (amplitudePart [isamp]) * windowPart [isamp];
-					sumw += windowPart [isamp];
+				const integer windowFromSoundOffset = windowCentreSampleNumber - soundCentreSampleNumber;
+				VEC amplitudePart = amplitude.part (windowFromSoundOffset + leftSample, windowFromSoundOffset + rightSample);
+				constVEC windowPart = window.part (windowFromSoundOffset + leftSample, windowFromSoundOffset + rightSample);
+				longdouble sumxw = 0.0, sumw = 0.0;
+				for (integer ichan = 1; ichan <= samples.nrow; ichan ++) {
+					amplitudePart <<= samples [ichan].part (leftSample - sampleOffset, rightSample - sampleOffset);
+					if (subtractMeanPressure)
+						VECcentre_inplace (amplitudePart);
+					for (integer isamp = 1; isamp <= amplitudePart.size; isamp ++) {
+						sumxw += sqr (amplitudePart [isamp]) * windowPart [isamp];
+						sumw += windowPart [isamp];
+					}
 				}
+				const double intensity_in_Pa2 = double (sumxw / sumw);
+				constexpr double hearingThreshold_in_Pa = 2.0e-5;
+				constexpr double hearingThreshold_in_Pa2 = sqr (hearingThreshold_in_Pa);
+				const double intensity_re_hearingThreshold = intensity_in_Pa2 / hearingThreshold_in_Pa2;
+				const double intensity_in_dB_re_hearingThreshold = ( intensity_re_hearingThreshold < 1.0e-30 ? -300.0 :
+						10.0 * log10 (intensity_re_hearingThreshold) );
+				thy z [1] [iframe] = intensity_in_dB_re_hearingThreshold;
 			}
-			const double intensity_in_Pa2 = double (sumxw / sumw);
-			constexpr double hearingThreshold_in_Pa = 2.0e-5;
-			constexpr double hearingThreshold_in_Pa2 = sqr (hearingThreshold_in_Pa);
-			const double intensity_re_hearingThreshold = intensity_in_Pa2 / hearingThreshold_in_Pa2;
-			const double intensity_in_dB_re_hearingThreshold = ( intensity_re_hearingThreshold < 1.0e-30 ? -300.0 :
-					10.0 * log10 (intensity_re_hearingThreshold) );
-			thy z [1] [iframe] = intensity_in_dB_re_hearingThreshold;
+			firstFrame = lastFrame + 1;
 		}
 		return thee;
 	} catch (MelderError) {
@@ -126,6 +149,16 @@ static autoIntensity Sound_to_Intensity_ (Sound me, double minimumPitch, double
 	}
 }
 
+static autoIntensity Sound_to_Intensity_ (Sound me, double minimumPitch, double timeStep, bool subtractMeanPressure) {
+	return Sampled_to_Intensity (me, minimumPitch, timeStep, subtractMeanPressure,
+		[me] (integer /* firstSample */, integer /* lastSample */, integer *sampleOffset) -> constMAT {
+			*sampleOffset = 0;
+			return my z.get();
+		},
+		INTEGER_MAX
+	);
+}
+
 autoIntensity Sound_to_Intensity (Sound me, double minimumPitch, double timeStep, bool subtractMeanPressure) {
 	const bool veryAccurate = false;
 	if (veryAccurate) {
@@ -145,4 +178,17 @@ autoIntensityTier Sound_to_IntensityTier (Sound me, double minimumPitch, double
 	}
 }
 
+autoIntensity LongSound_to_Intensity (LongSound me, double minimumPitch, double timeStep, bool subtractMeanPressure) {
+	autoMAT buffer;
+	return Sampled_to_Intensity (me, minimumPitch, timeStep, subtractMeanPressure,
+		[me, & buffer] (integer firstSample, integer lastSample, integer *sampleOffset) -> constMAT {
+			buffer = newMATraw (my numberOfChannels, lastSample - firstSample + 1);
+			LongSound_readAudioToFloat (me, buffer.get(), firstSample);
+			*sampleOffset = firstSample - 1;
+			return buffer.get();
+		},
+		LongSound_ANALYSIS_BLOCK_SIZE
+	);
+}
+
 /* End of file Sound_to_Intensity.cpp */
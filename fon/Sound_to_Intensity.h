@@ -17,6 +17,7 @@
  */
 
 #include "Sound.h"
+#include "LongSound.h"
 #include "Intensity.h"
 #include "IntensityTier.h"
 
@@ -47,4 +48,11 @@ autoIntensity Sound_to_Intensity (Sound me, double minimumPitch, double timeStep
 
 autoIntensityTier Sound_to_IntensityTier (Sound me, double minimumPitch, double timeStep, bool subtractMean);
 
+autoIntensity LongSound_to_Intensity (LongSound me, double minimumPitch, double timeStep, bool subtractMean);
+/*
+	Same as Sound_to_Intensity, with the same result,
+	but the samples are read from the file in blocks of LongSound_ANALYSIS_BLOCK_SIZE sample frames,
+	so that the whole sound never has to be in memory.
+*/
+
 /* End of file Sound_to_Intensity.h */
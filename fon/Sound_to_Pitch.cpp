@@ -35,13 +35,18 @@
 #include "Sound_to_Pitch.h"
 #include "NUM2.h"
 #include "MelderThread.h"
+#include <atomic>
 
 #define AC_HANNING  0
 #define AC_GAUSS  1
 #define FCC_NORMAL  2
 #define FCC_ACCURATE  3
 
-static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
+/*
+	The frame is analysed with the time sampling of `me`,
+	and with the samples `samples [channel] [isamp - sampleOffset]`.
+*/
+static void Sampled_into_PitchFrame (Sampled me, constMAT const& samples, integer sampleOffset, Pitch_Frame pitchFrame, double t,
 	double minimumPitch, int maxnCandidates, int method, double voicingThreshold, double octaveCost,
 	NUMfft_Table fftTable, double dt_window, integer nsamp_window, integer halfnsamp_window,
 	integer maximumLag, integer nsampFFT, integer nsamp_period, integer halfnsamp_period,
@@ -52,7 +57,7 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 	integer leftSample = Sampled_xToLowIndex (me, t), rightSample = leftSample + 1;
 	integer startSample, endSample;
 
-	for (integer channel = 1; channel <= my ny; channel ++) {
+	for (integer channel = 1; channel <= samples.nrow; channel ++) {
 		/*
 			Compute the local mean; look one longest period to both sides.
 		*/
@@ -62,7 +67,7 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 		Melder_assert (endSample <= my nx);
 		localMean [channel] = 0.0;
 		for (integer i = startSample; i <= endSample; i ++)
-			localMean [channel] += my z [channel] [i];
+			localMean [channel] += samples [channel] [i - sampleOffset];
 		localMean [channel] /= 2 * nsamp_period;
 
 		/*
@@ -75,12 +80,12 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 		Melder_assert (endSample <= my nx);
 		if (method < FCC_NORMAL) {
 			for (integer j = 1, i = startSample; j <= nsamp_window; j ++)
-				frame [channel] [j] = (my z [channel] [i ++] - localMean [channel]) * window [j];
+				frame [channel] [j] = (samples [channel] [i ++ - sampleOffset] - localMean [channel]) * window [j];
 			for (integer j = nsamp_window + 1; j <= nsampFFT; j ++)
 				frame [channel] [j] = 0.0;
 		} else {
 			for (integer j = 1, i = startSample; j <= nsamp_window; j ++)
-				frame [channel] [j] = my z [channel] [i ++] - localMean [channel];
+				frame [channel] [j] = samples [channel] [i ++ - sampleOffset] - localMean [channel];
 		}
 	}
 
@@ -92,7 +97,7 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 		startSample = 1;
 	if ((endSample = halfnsamp_window + halfnsamp_period) > nsamp_window)
 		endSample = nsamp_window;
-	for (integer channel = 1; channel <= my ny; channel ++) {
+	for (integer channel = 1; channel <= samples.nrow; channel ++) {
 		for (integer j = startSample; j <= endSample; j ++) {
 			double value = fabs (frame [channel] [j]);
 			if (value > localPeak)
@@ -114,8 +119,8 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 		localMaximumLag = localSpan - nsamp_window;
 		offset = startSample - 1;
 		longdouble sumx2 = 0.0;   // sum of squares
-		for (integer channel = 1; channel <= my ny; channel ++) {
-			double *amp = & my z [channel] [0] + offset;
+		for (integer channel = 1; channel <= samples.nrow; channel ++) {
+			const double *amp = & samples [channel] [0] + offset - sampleOffset;
 			for (integer i = 1; i <= nsamp_window; i ++) {
 				const double x = amp [i] - localMean [channel];
 				sumx2 += x * x;
@@ -125,8 +130,8 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 		r [0] = 1.0;
 		for (integer i = 1; i <= localMaximumLag; i ++) {
 			longdouble product = 0.0;
-			for (integer channel = 1; channel <= my ny; channel ++) {
-				double *amp = & my z [channel] [0] + offset;
+			for (integer channel = 1; channel <= samples.nrow; channel ++) {
+				const double *amp = & samples [channel] [0] + offset - sampleOffset;
 				double y0 = amp [i] - localMean [channel];
 				double yZ = amp [i + nsamp_window] - localMean [channel];
 				sumy2 += yZ * yZ - y0 * y0;
@@ -145,7 +150,7 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 		*/
 		for (integer i = 1; i <= nsampFFT; i ++)
 			ac [i] = 0.0;
-		for (integer channel = 1; channel <= my ny; channel ++) {
+		for (integer channel = 1; channel <= samples.nrow; channel ++) {
 			NUMfft_forward (fftTable, VEC (& frame [channel] [1], fftTable->n));   // complex spectrum
 			ac [1] += frame [channel] [1] * frame [channel] [1];   // DC component
 			for (integer i = 2; i < nsampFFT; i += 2)
@@ -258,18 +263,17 @@ static void Sound_into_PitchFrame (Sound me, Pitch_Frame pitchFrame, double t,
 	}
 }
 
-Thing_define (Sound_into_Pitch_Args, Thing) { public:
-	Sound sound;
+Thing_define (Sampled_into_Pitch_Args, Thing) { public:
+	Sampled sampled;
+	constMAT samples;   // the current block
+	integer sampleOffset;
 	Pitch pitch;
-	integer firstFrame, lastFrame;
 	double minimumPitch;
 	int maxnCandidates, method;
 	double voicingThreshold, octaveCost, dt_window;
 	integer nsamp_window, halfnsamp_window, maximumLag, nsampFFT, nsamp_period, halfnsamp_period, brent_ixmax, brent_depth;
 	double globalPeak;
 	VEC window, windowR;
-	bool isMainThread;
-	volatile int *cancelled;
 	autoNUMfft_Table fftTable;
 	autoMAT frame;
 	autoVEC ac, rbuffer, localMean;
@@ -277,25 +281,14 @@ Thing_define (Sound_into_Pitch_Args, Thing) { public:
 	autoINTVEC imax;
 };
 
-Thing_implement (Sound_into_Pitch_Args, Thing, 0);
+Thing_implement (Sampled_into_Pitch_Args, Thing, 0);
 
-static void Sound_into_Pitch (Sound_into_Pitch_Args me)
+static void Sampled_into_Pitch (Sampled_into_Pitch_Args me, integer firstFrame, integer lastFrame)
 {
-	for (integer iframe = my firstFrame; iframe <= my lastFrame; iframe ++) {
+	for (integer iframe = firstFrame; iframe <= lastFrame; iframe ++) {
 		const Pitch_Frame pitchFrame = & my pitch -> frames [iframe];
 		const double t = Sampled_indexToX (my pitch, iframe);
-		if (my isMainThread) {
-			try {
-				Melder_progress (0.1 + 0.8 * (iframe - my firstFrame) / (my lastFrame - my firstFrame),
-					U"Sound to Pitch: analysing ", my lastFrame, U" frames");
-			} catch (MelderError) {
-				*my cancelled = 1;
-				throw;
-			}
-		} else if (*my cancelled) {
-			return;
-		}
-		Sound_into_PitchFrame (my sound, pitchFrame, t,
+		Sampled_into_PitchFrame (my sampled, my samples, my sampleOffset, pitchFrame, t,
 			my minimumPitch, my maxnCandidates, my method, my voicingThreshold, my octaveCost,
 			& my fftTable, my dt_window, my nsamp_window, my halfnsamp_window,
 			my maximumLag, my nsampFFT, my nsamp_period, my halfnsamp_period,
@@ -306,11 +299,20 @@ static void Sound_into_Pitch (Sound_into_Pitch_Args me)
 	}
 }
 
-autoPitch Sound_to_Pitch_any (Sound me,
+/*
+	The analysis works on any Sampled with the time domain and sampling of a sound with `numberOfChannels` channels.
+	The samples are read in blocks by `readSamples (firstSample, lastSample, & sampleOffset)`,
+	which returns a matrix (channel x sample) in which sample `isamp` is found in column `isamp - sampleOffset`;
+	each block contains the samples of as many frames as fit in `maximumNumberOfSamplesPerBlock` (but at least one frame).
+	The silence threshold is relative to `getGlobalPeak ()`, the largest absolute deviation from the mean in any channel.
+*/
+template <typename ReadSamples, typename GetGlobalPeak>
+static autoPitch Sampled_to_Pitch_any (Sampled me, integer numberOfChannels,
 	double dt, double minimumPitch, double periodsPerWindow, integer maxnCandidates,
 	int method,
 	double silenceThreshold, double voicingThreshold,
-	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost, double ceiling)
+	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost, double ceiling,
+	ReadSamples readSamples, integer maximumNumberOfSamplesPerBlock, GetGlobalPeak getGlobalPeak)
 {
 	try {
 		autoNUMfft_Table fftTable;
@@ -407,15 +409,7 @@ autoPitch Sound_to_Pitch_any (Sound me,
 		/*
 			Compute the global absolute peak for determination of silence threshold.
 		*/
-		globalPeak = 0.0;
-		for (integer ichan = 1; ichan <= my ny; ichan ++) {
-			const double mean = NUMmean (my z.row (ichan));
-			for (integer i = 1; i <= my nx; i ++) {
-				double value = fabs (my z [ichan] [i] - mean);
-				if (value > globalPeak)
-					globalPeak = value;
-			}
-		}
+		globalPeak = getGlobalPeak ();
 		if (globalPeak == 0.0)
 			return thee;
 
@@ -481,25 +475,13 @@ autoPitch Sound_to_Pitch_any (Sound me,
 
 		autoMelderProgress progress (U"Sound to Pitch...");
 
-		integer numberOfFramesPerThread = 20;
-		integer numberOfThreads = (numberOfFrames - 1) / numberOfFramesPerThread + 1;
-		const integer numberOfProcessors = MelderThread_getNumberOfProcessors ();
-		trace (numberOfProcessors, U" processors");
-		Melder_clipRight (& numberOfThreads, numberOfProcessors);
-		Melder_clip (1_integer, & numberOfThreads, 16_integer);
-		numberOfFramesPerThread = (numberOfFrames - 1) / numberOfThreads + 1;
-
-		autoSound_into_Pitch_Args args [16];
-		integer firstFrame = 1, lastFrame = numberOfFramesPerThread;
-		volatile int cancelled = 0;
-		for (int ithread = 1; ithread <= numberOfThreads; ithread ++) {
-			if (ithread == numberOfThreads)
-				lastFrame = numberOfFrames;
-			autoSound_into_Pitch_Args arg = Thing_new (Sound_into_Pitch_Args);
-			arg -> sound = me;
+		const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfFrames, 20);
+
+		std::vector <autoSampled_into_Pitch_Args> args (uinteger (numberOfThreads + 1));   // scratch memory per thread; base 1
+		for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
+			autoSampled_into_Pitch_Args arg = Thing_new (Sampled_into_Pitch_Args);
+			arg -> sampled = me;
 			arg -> pitch = thee.get();
-			arg -> firstFrame = firstFrame;
-			arg -> lastFrame = lastFrame;
 			arg -> minimumPitch = minimumPitch;
 			arg -> maxnCandidates = maxnCandidates;
 			arg -> method = method;
@@ -517,24 +499,54 @@ autoPitch Sound_to_Pitch_any (Sound me,
 			arg -> globalPeak = globalPeak;
 			arg -> window = window.get();
 			arg -> windowR = windowR.get();
-			arg -> isMainThread = ( ithread == numberOfThreads );
-			arg -> cancelled = & cancelled;
 			if (method >= FCC_NORMAL) {   // cross-correlation
-				arg -> frame = newMATzero (my ny, nsamp_window);
+				arg -> frame = newMATzero (numberOfChannels, nsamp_window);
 			} else {   // autocorrelation
 				NUMfft_Table_init (& arg -> fftTable, nsampFFT);
-				arg -> frame = newMATzero (my ny, nsampFFT);
+				arg -> frame = newMATzero (numberOfChannels, nsampFFT);
 				arg -> ac = newVECzero (nsampFFT);
 			}
 			arg -> rbuffer = newVECzero (2 * nsamp_window + 1);
 			arg -> r = & arg -> rbuffer [1 + nsamp_window];
 			arg -> imax = newINTVECzero (maxnCandidates);
-			arg -> localMean = newVECzero (my ny);
-			args [ithread - 1] = std::move (arg);
-			firstFrame = lastFrame + 1;
-			lastFrame += numberOfFramesPerThread;
+			arg -> localMean = newVECzero (numberOfChannels);
+			args [ithread] = std::move (arg);
+		}
+
+		/*
+			Every frame looks at most this many samples to the left and right of its centre
+			(for the local mean, the window, and the forward cross-correlation).
+		*/
+		const integer frameMargin = nsamp_period + nsamp_window + maximumLag + 2;
+		auto getCentreSampleNumber = [&] (integer iframe) -> integer {
+			return Sampled_xToLowIndex (me, Sampled_indexToX (thee.get(), iframe));
+		};
+		std::atomic <integer> numberOfFramesDone (0);
+		for (integer firstFrameOfBlock = 1; firstFrameOfBlock <= numberOfFrames; ) {
+			const integer firstSampleOfBlock = std::max (1_integer, getCentreSampleNumber (firstFrameOfBlock) - frameMargin);
+			integer lastFrameOfBlock = firstFrameOfBlock;
+			while (lastFrameOfBlock < numberOfFrames &&
+				getCentreSampleNumber (lastFrameOfBlock + 1) + frameMargin - firstSampleOfBlock < maximumNumberOfSamplesPerBlock)
+				lastFrameOfBlock ++;
+			const integer lastSampleOfBlock = std::min (my nx, getCentreSampleNumber (lastFrameOfBlock) + frameMargin);
+			integer sampleOffset;
+			constMAT samples = readSamples (firstSampleOfBlock, lastSampleOfBlock, & sampleOffset);
+			for (integer ithread = 1; ithread <= numberOfThreads; ithread ++) {
+				args [ithread] -> samples = samples;
+				args [ithread] -> sampleOffset = sampleOffset;
+			}
+			const integer numberOfFramesInBlock = lastFrameOfBlock - firstFrameOfBlock + 1;
+			MelderThread_parallelFor (numberOfFramesInBlock, numberOfThreads,
+				[&] (integer ithread, integer firstFrame, integer lastFrame) {
+					Sampled_into_Pitch (args [ithread].get(), firstFrameOfBlock - 1 + firstFrame, firstFrameOfBlock - 1 + lastFrame);
+					numberOfFramesDone += lastFrame - firstFrame + 1;
+					if (ithread == 1)   // only the calling thread can show progress (and be cancelled)
+						Melder_progress (0.1 + 0.8 * numberOfFramesDone / numberOfFrames,
+							U"Sound to Pitch: analysing ", numberOfFrames, U" frames");
+				}
+			);
+			firstFrameOfBlock = lastFrameOfBlock + 1;
 		}
-		MelderThread_run (Sound_into_Pitch, args, numberOfThreads);
 
 		Melder_progress (0.95, U"Sound to Pitch: path finder");
 		Pitch_pathFinder (thee.get(), silenceThreshold, voicingThreshold,
@@ -546,6 +558,34 @@ autoPitch Sound_to_Pitch_any (Sound me,
 	}
 }
 
+autoPitch Sound_to_Pitch_any (Sound me,
+	double dt, double minimumPitch, double periodsPerWindow, integer maxnCandidates,
+	int method,
+	double silenceThreshold, double voicingThreshold,
+	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost, double ceiling)
+{
+	return Sampled_to_Pitch_any (me, my ny, dt, minimumPitch, periodsPerWindow, maxnCandidates, method,
+		silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost, ceiling,
+		[me] (integer /* firstSample */, integer /* lastSample */, integer *sampleOffset) -> constMAT {
+			*sampleOffset = 0;
+			return my z.get();
+		},
+		INTEGER_MAX,
+		[me] () -> double {
+			double globalPeak = 0.0;
+			for (integer ichan = 1; ichan <= my ny; ichan ++) {
+				const double mean = NUMmean (my z.row (ichan));
+				for (integer i = 1; i <= my nx; i ++) {
+					double value = fabs (my z [ichan] [i] - mean);
+					if (value > globalPeak)
+						globalPeak = value;
+				}
+			}
+			return globalPeak;
+		}
+	);
+}
+
 autoPitch Sound_to_Pitch (Sound me, double timeStep, double minimumPitch, double maximumPitch) {
 	return Sound_to_Pitch_ac (me, timeStep, minimumPitch,
 		3.0, 15, false, 0.03, 0.45, 0.01, 0.35, 0.14, maximumPitch);
@@ -569,4 +609,101 @@ autoPitch Sound_to_Pitch_cc (Sound me,
 		silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost, ceiling);
 }
 
+/*
+	The global peak of a LongSound is found in a single pass through the file.
+	The largest distance of a sample from the mean of its channel is that of the minimum or the maximum of the channel.
+	The mean should be the same as NUMmean () of the whole channel, so that a LongSound gets the same global peak,
+	and therefore the same pitch contour, as the Sound read from the same file.
+	So the channel is summed in the pieces that the pairwise summation of NUMsum_longdouble () consists of:
+	first the leading numberOfSamples mod 64 samples, then pieces whose lengths are a power of two times 64 samples,
+	which are combined on a stack as in PAIRWISE_SUM (): blocks of LongSound_ANALYSIS_BLOCK_SIZE samples,
+	and in the last block pieces of decreasing lengths.
+*/
+static double LongSound_getGlobalPeak (LongSound me) {
+	constexpr integer baseCaseSize = 64;
+	static_assert (LongSound_ANALYSIS_BLOCK_SIZE % baseCaseSize == 0);
+	const integer numberOfLeadingSamples = my nx % baseCaseSize;
+	std::vector <std::vector <longdouble>> partialSums (uinteger (my numberOfChannels));   // a stack per channel
+	std::vector <integer> partialSumSizes;   // the same for all channels
+	std::vector <longdouble> leadingSums (uinteger (my numberOfChannels), 0.0);
+	autoVEC minimum = newVECraw (my numberOfChannels), maximum = newVECraw (my numberOfChannels);
+	minimum.all() <<= INFINITY;
+	maximum.all() <<= - INFINITY;
+	for (integer firstSample = 1; firstSample <= my nx; ) {
+		const integer lastSample = std::min (my nx, firstSample + ( firstSample == 1 ? numberOfLeadingSamples : 0 ) + LongSound_ANALYSIS_BLOCK_SIZE - 1);
+		autoMAT block = newMATraw (my numberOfChannels, lastSample - firstSample + 1);
+		LongSound_readAudioToFloat (me, block.get(), firstSample);
+		for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++) {
+			minimum [ichan] = std::min (minimum [ichan], NUMmin (block.row (ichan)));
+			maximum [ichan] = std::max (maximum [ichan], NUMmax (block.row (ichan)));
+		}
+		integer isamp = 1;
+		if (firstSample == 1) {
+			for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++)
+				leadingSums [uinteger (ichan - 1)] = NUMsum_longdouble (block.row (ichan).part (1, numberOfLeadingSamples));
+			isamp += numberOfLeadingSamples;
+		}
+		while (isamp <= block.ncol) {
+			integer pieceSize = baseCaseSize;
+			while (2 * pieceSize <= block.ncol - isamp + 1)
+				pieceSize *= 2;
+			for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++)
+				partialSums [uinteger (ichan - 1)]. push_back (NUMsum_longdouble (block.row (ichan).part (isamp, isamp + pieceSize - 1)));
+			partialSumSizes. push_back (pieceSize);
+			while (partialSumSizes. size () >= 2 && partialSumSizes. back () == partialSumSizes [partialSumSizes. size () - 2]) {
+				for (std::vector <longdouble> & stack : partialSums) {
+					const longdouble top = stack. back ();
+					stack. pop_back ();
+					stack. back () += top;
+				}
+				partialSumSizes. pop_back ();
+				partialSumSizes. back () *= 2;
+			}
+			isamp += pieceSize;
+		}
+		firstSample = lastSample + 1;
+	}
+	double globalPeak = 0.0;
+	for (integer ichan = 1; ichan <= my numberOfChannels; ichan ++) {
+		const std::vector <longdouble> & stack = partialSums [uinteger (ichan - 1)];
+		longdouble sum = leadingSums [uinteger (ichan - 1)];
+		for (auto partialSum = stack. rbegin (); partialSum != stack. rend (); ++ partialSum)
+			sum += *partialSum;
+		const double mean = double (sum / my nx);
+		globalPeak = std::max ({ globalPeak, fabs (maximum [ichan] - mean), fabs (minimum [ichan] - mean) });
+	}
+	return globalPeak;
+}
+
+autoPitch LongSound_to_Pitch_any (LongSound me,
+	double dt, double minimumPitch, double periodsPerWindow, integer maxnCandidates,
+	int method,
+	double silenceThreshold, double voicingThreshold,
+	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost, double ceiling)
+{
+	autoMAT buffer;
+	return Sampled_to_Pitch_any (me, my numberOfChannels, dt, minimumPitch, periodsPerWindow, maxnCandidates, method,
+		silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost, ceiling,
+		[me, & buffer] (integer firstSample, integer lastSample, integer *sampleOffset) -> constMAT {
+			buffer = newMATraw (my numberOfChannels, lastSample - firstSample + 1);
+			LongSound_readAudioToFloat (me, buffer.get(), firstSample);
+			*sampleOffset = firstSample - 1;
+			return buffer.get();
+		},
+		LongSound_ANALYSIS_BLOCK_SIZE,
+		[me] () -> double {
+			return LongSound_getGlobalPeak (me);
+		}
+	);
+}
+
+autoPitch LongSound_to_Pitch_ac (LongSound me,
+	double dt, double minimumPitch, double periodsPerWindow, integer maxnCandidates, int accurate,
+	double silenceThreshold, double voicingThreshold,
+	double octaveCost, double octaveJumpCost, double voicedUnvoicedCost, double ceiling)
+{
+	return LongSound_to_Pitch_any (me, dt, minimumPitch, periodsPerWindow, maxnCandidates, accurate,
+		silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost, ceiling);
+}
+
 /* End of file Sound_to_Pitch.cpp */
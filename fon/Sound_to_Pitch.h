@@ -17,6 +17,7 @@
  */
 
 #include "Sound.h"
+#include "LongSound.h"
 #include "Pitch.h"
 
 autoPitch Sound_to_Pitch (Sound me, double timeStep,
@@ -84,4 +85,19 @@ autoPitch Sound_to_Pitch_any (Sound me,
 		pitches above a certain value "voiceless".
 */
 
+autoPitch LongSound_to_Pitch_any (LongSound me, double dt, double minimumPitch,
+	double periodsPerWindow, integer maxnCandidates, int method,
+	double silenceThreshold, double voicingThreshold, double octaveCost,
+	double octaveJumpCost, double voicedUnvoicedCost, double maximumPitch);
+autoPitch LongSound_to_Pitch_ac (LongSound me, double timeStep, double minimumPitch,
+	double periodsPerWindow, integer maxnCandidates, int accurate,
+	double silenceThreshold, double voicingThreshold, double octaveCost,
+	double octaveJumpCost, double voicedUnvoicedCost, double maximumPitch);
+/*
+	Same as Sound_to_Pitch_any and Sound_to_Pitch_ac, with the same result,
+	but the samples are read from the file in blocks of LongSound_ANALYSIS_BLOCK_SIZE sample frames,
+	so that the whole sound never has to be in memory.
+	The file is read twice: once for the global peak, and once for the frames.
+*/
+
 /* End of file Sound_to_Pitch.h */
@@ -621,9 +621,8 @@ void TimeSoundEditor_drawSound (TimeSoundEditor me, double globalMinimum, double
 					Sampled_indexToX (sound, first), Sampled_indexToX (sound, last));
 		} else {
 			Graphics_setWindow (my graphics.get(), my startWindow, my endWindow, minimum * 32768, maximum * 32768);
-			Graphics_function16 (my graphics.get(),
-					longSound -> buffer.asArgumentToFunctionThatExpectsZeroBasedArray() - longSound -> imin * numberOfChannels + (ichan - 1),
-					numberOfChannels, first, last, Sampled_indexToX (longSound, first), Sampled_indexToX (longSound, last));
+			Graphics_function16 (my graphics.get(), LongSound_getWindowSamplesOfChannel (longSound, ichan), numberOfChannels,
+					first, last, Sampled_indexToX (longSound, first), Sampled_indexToX (longSound, last));
 		}
 		Graphics_resetViewport (my graphics.get(), vp);
 	}
@@ -18,6 +18,7 @@
 
 #include "VoiceAnalysis.h"
 #include "AmplitudeTier.h"
+#include "MelderThread.h"
 
 double PointProcess_getJitter_local (PointProcess me, double tmin, double tmax,
 	double pmin, double pmax, double maximumPeriodFactor)
@@ -256,11 +257,238 @@ void PointProcess_Sound_getShimmer_multi (PointProcess me, Sound thee, double tm
 	}
 }
 
+VoiceReport Sound_Pitch_PointProcess_getVoiceReport (Sound sound, Pitch pitch, PointProcess pulses, double tmin, double tmax,
+	double floor, double ceiling, double maximumPeriodFactor, double maximumAmplitudeFactor, double silenceThreshold, double voicingThreshold)
+{
+	Function_unidirectionalAutowindow (sound, & tmin, & tmax);
+	VoiceReport report;
+	report. startTime = tmin;
+	report. endTime = tmax;
+	/*
+		Pitch statistics.
+	*/
+	report. medianPitch = Pitch_getQuantile (pitch, tmin, tmax, 0.50, kPitch_unit::HERTZ);
+	report. meanPitch = Pitch_getMean (pitch, tmin, tmax, kPitch_unit::HERTZ);
+	report. standardDeviationOfPitch = Pitch_getStandardDeviation (pitch, tmin, tmax, kPitch_unit::HERTZ);
+	report. minimumPitch = Pitch_getMinimum (pitch, tmin, tmax, kPitch_unit::HERTZ, 1);
+	report. maximumPitch = Pitch_getMaximum (pitch, tmin, tmax, kPitch_unit::HERTZ, 1);
+	/*
+		Pulses statistics, as in PointProcess_getNumberOfPeriods (), PointProcess_getMeanPeriod () and PointProcess_getStdevPeriod ().
+	*/
+	const double pmin = 0.8 / ceiling, pmax = 1.25 / floor;
+	integer imin, imax;
+	const integer numberOfPulses = PointProcess_getWindowPoints (pulses, tmin, tmax, & imin, & imax);
+	const integer numberOfIntervals = numberOfPulses - 1;
+	report. numberOfPulses = numberOfPulses;
+	autoBOOLVEC isPeriod = newBOOLVECzero (std::max (numberOfIntervals, 0_integer));
+	integer numberOfPeriods = 0;
+	longdouble sumOfPeriods = 0.0;
+	for (integer i = imin; i < imax; i ++) {
+		if ((isPeriod [i - imin + 1] = PointProcess_isPeriod (pulses, i, pmin, pmax, maximumPeriodFactor))) {
+			sumOfPeriods += pulses -> t [i + 1] - pulses -> t [i];
+			numberOfPeriods ++;
+		}
+	}
+	report. numberOfPeriods = ( numberOfIntervals < 1 ? 0 : numberOfPeriods );
+	report. meanPeriod = ( numberOfIntervals >= 1 && numberOfPeriods > 0 ? double (sumOfPeriods / numberOfPeriods) : undefined );
+	report. standardDeviationOfPeriod = undefined;
+	if (numberOfIntervals >= 2 && numberOfPeriods >= 2) {
+		longdouble sumOfSquares = 0.0;
+		for (integer i = imin; i < imax; i ++) {
+			if (isPeriod [i - imin + 1]) {
+				const double dperiod = pulses -> t [i + 1] - pulses -> t [i] - report. meanPeriod;
+				sumOfSquares += dperiod * dperiod;
+			}
+		}
+		report. standardDeviationOfPeriod = sqrt (double (sumOfSquares / (numberOfPeriods - 1)));
+	}
+	/*
+		Voicing.
+	*/
+	integer ifmin, ifmax;
+	report. numberOfFrames = Sampled_getWindowSamples (pitch, tmin, tmax, & ifmin, & ifmax);
+	report. numberOfUnvoicedFrames = report. numberOfFrames;
+	for (integer i = ifmin; i <= ifmax; i ++) {
+		const Pitch_Frame frame = & pitch -> frames [i];
+		if (frame -> intensity >= silenceThreshold) {
+			for (integer icand = 1; icand <= frame -> nCandidates; icand ++) {
+				const Pitch_Candidate cand = & frame -> candidates [icand];
+				if (cand -> frequency > 0.0 && cand -> frequency < ceiling && cand -> strength >= voicingThreshold) {
+					report. numberOfUnvoicedFrames --;
+					break;   // next frame
+				}
+			}
+		}
+	}
+	report. numberOfVoiceBreaks = 0;
+	report. durationOfVoiceBreaks = 0.0;
+	if (numberOfPulses > 1) {
+		bool previousPeriodVoiced = true;
+		for (integer i = imin + 1; i < imax; i ++) {
+			double period = pulses -> t [i] - pulses -> t [i - 1];
+			if (period > pmax) {
+				report. durationOfVoiceBreaks += period;
+				if (previousPeriodVoiced) {
+					report. numberOfVoiceBreaks ++;
+					previousPeriodVoiced = false;
+				}
+			} else {
+				previousPeriodVoiced = true;
+			}
+		}
+	}
+	/*
+		Jitter, in one pass over the pulses.
+		The pulses that are in the middle of two acceptable periods are also the ones whose peaks are measured for shimmer,
+		as in PointProcess_Sound_to_AmplitudeTier_period ().
+	*/
+	integer numberOfLocalPeriods = numberOfIntervals, numberOfRapPeriods = numberOfIntervals, numberOfPpq5Periods = numberOfIntervals;
+	longdouble localSum = 0.0, rapSum = 0.0, ppq5Sum = 0.0;
+	autoVEC peakTimes = newVECraw (std::max (numberOfPulses, 0_integer)), peakValues = newVECraw (std::max (numberOfPulses, 0_integer));
+	integer numberOfPeaks = 0;
+	for (integer i = imin + 1; i <= imax; i ++) {
+		if (i < imax) {
+			const double p1 = pulses -> t [i] - pulses -> t [i - 1], p2 = pulses -> t [i + 1] - pulses -> t [i];
+			const double intervalFactor = p1 > p2 ? p1 / p2 : p2 / p1;
+			if (pmin == pmax || (p1 >= pmin && p1 <= pmax && p2 >= pmin && p2 <= pmax && intervalFactor <= maximumPeriodFactor)) {
+				localSum += fabs (p1 - p2);
+				const double peak = Sound_getHannWindowedRms (sound, pulses -> t [i], 0.2 * p1, 0.2 * p2);
+				if (isdefined (peak) && peak > 0.0) {
+					numberOfPeaks ++;
+					peakTimes [numberOfPeaks] = pulses -> t [i];
+					peakValues [numberOfPeaks] = peak;
+				}
+			} else {
+				numberOfLocalPeriods --;
+			}
+		}
+		if (i < imax && i >= imin + 2) {
+			const double p1 = pulses -> t [i - 1] - pulses -> t [i - 2], p2 = pulses -> t [i] - pulses -> t [i - 1], p3 = pulses -> t [i + 1] - pulses -> t [i];
+			const double intervalFactor1 = p1 > p2 ? p1 / p2 : p2 / p1, intervalFactor2 = p2 > p3 ? p2 / p3 : p3 / p2;
+			if (pmin == pmax || (p1 >= pmin && p1 <= pmax && p2 >= pmin && p2 <= pmax && p3 >= pmin && p3 <= pmax
+				&& intervalFactor1 <= maximumPeriodFactor && intervalFactor2 <= maximumPeriodFactor))
+			{
+				rapSum += fabs (p2 - (p1 + p2 + p3) / 3.0);
+			} else {
+				numberOfRapPeriods --;
+			}
+		}
+		if (i >= imin + 5) {
+			const double
+				p1 = pulses -> t [i - 4] - pulses -> t [i - 5],
+				p2 = pulses -> t [i - 3] - pulses -> t [i - 4],
+				p3 = pulses -> t [i - 2] - pulses -> t [i - 3],
+				p4 = pulses -> t [i - 1] - pulses -> t [i - 2],
+				p5 = pulses -> t [i] - pulses -> t [i - 1];
+			const double
+				f1 = p1 > p2 ? p1 / p2 : p2 / p1,
+				f2 = p2 > p3 ? p2 / p3 : p3 / p2,
+				f3 = p3 > p4 ? p3 / p4 : p4 / p3,
+				f4 = p4 > p5 ? p4 / p5 : p5 / p4;
+			if (pmin == pmax || (p1 >= pmin && p1 <= pmax && p2 >= pmin && p2 <= pmax && p3 >= pmin && p3 <= pmax &&
+				p4 >= pmin && p4 <= pmax && p5 >= pmin && p5 <= pmax &&
+				f1 <= maximumPeriodFactor && f2 <= maximumPeriodFactor && f3 <= maximumPeriodFactor && f4 <= maximumPeriodFactor))
+			{
+				ppq5Sum += fabs (p3 - (p1 + p2 + p3 + p4 + p5) / 5.0);
+			} else {
+				numberOfPpq5Periods --;
+			}
+		}
+	}
+	report. jitter_local = ( numberOfLocalPeriods < 2 ? undefined : double (localSum / (numberOfLocalPeriods - 1)) / report. meanPeriod );
+	report. jitter_local_absolute = ( numberOfLocalPeriods < 2 ? undefined : double (localSum / (numberOfLocalPeriods - 1)) );
+	report. jitter_rap = ( numberOfRapPeriods < 3 ? undefined : double (rapSum / (numberOfRapPeriods - 2)) / report. meanPeriod );
+	report. jitter_ppq5 = ( numberOfPpq5Periods < 5 ? undefined : double (ppq5Sum / (numberOfPpq5Periods - 4)) / report. meanPeriod );
+	report. jitter_ddp = ( isdefined (report. jitter_rap) ? 3.0 * report. jitter_rap : undefined );
+	/*
+		Shimmer, in one pass over the peaks, as in AmplitudeTier_getShimmer_xxx ().
+	*/
+	report. shimmer_local = report. shimmer_local_dB = report. shimmer_apq3 = report. shimmer_apq5 = report. shimmer_apq11 = report. shimmer_dda = undefined;
+	if (numberOfPulses >= 3) {
+		const constVEC t = peakTimes.part (1, numberOfPeaks), a = peakValues.part (1, numberOfPeaks);
+		const integer n = numberOfPeaks;
+		auto isPeriodRange = [&] (integer ifirst, integer ilast) {   // are the intervals between the peaks ifirst .. ilast all within range?
+			if (pmin == pmax)
+				return true;
+			for (integer k = ifirst + 1; k <= ilast; k ++) {
+				const double p = t [k] - t [k - 1];
+				if (p < pmin || p > pmax)
+					return false;
+			}
+			return true;
+		};
+		auto isAmplitudeRange = [&] (integer ifirst, integer ilast) {   // do neighbouring peaks ifirst .. ilast differ little enough?
+			for (integer k = ifirst + 1; k <= ilast; k ++) {
+				const double amplitudeFactor = a [k - 1] > a [k] ? a [k - 1] / a [k] : a [k] / a [k - 1];
+				if (! (amplitudeFactor <= maximumAmplitudeFactor))
+					return false;
+			}
+			return true;
+		};
+		integer numberOfLocalPeaks = 0, numberOfApq3Peaks = 0, numberOfApq5Peaks = 0, numberOfApq11Peaks = 0;
+		longdouble localNumerator = 0.0, local_dB = 0.0, apq3Numerator = 0.0, apq5Numerator = 0.0, apq11Numerator = 0.0;
+		for (integer i = 2; i <= n; i ++) {
+			if (isPeriodRange (i - 1, i) && isAmplitudeRange (i - 1, i)) {
+				localNumerator += fabs (a [i - 1] - a [i]);
+				local_dB += fabs (log10 (a [i - 1] / a [i]));
+				numberOfLocalPeaks ++;
+			}
+			if (i <= n - 1 && isPeriodRange (i - 1, i + 1) && isAmplitudeRange (i - 1, i + 1)) {
+				const double threePointAverage = (a [i - 1] + a [i] + a [i + 1]) / 3.0;
+				apq3Numerator += fabs (a [i] - threePointAverage);
+				numberOfApq3Peaks ++;
+			}
+			if (i >= 3 && i <= n - 2 && isPeriodRange (i - 2, i + 2) && isAmplitudeRange (i - 2, i + 2)) {
+				const double fivePointAverage = ((a [i - 2] + a [i - 1] + a [i]) + (a [i + 1] + a [i + 2])) / 5.0;
+				apq5Numerator += fabs (a [i] - fivePointAverage);
+				numberOfApq5Peaks ++;
+			}
+			if (i >= 6 && i <= n - 5 && isPeriodRange (i - 5, i + 5) && isAmplitudeRange (i - 5, i + 5)) {
+				const double elevenPointAverage = (((a [i - 5] + a [i - 4] + a [i - 3]) + (a [i - 2] + a [i - 1] + a [i])) +
+						((a [i + 1] + a [i + 2] + a [i + 3]) + (a [i + 4] + a [i + 5]))) / 11.0;
+				apq11Numerator += fabs (a [i] - elevenPointAverage);
+				numberOfApq11Peaks ++;
+			}
+		}
+		longdouble denominator = 0.0;
+		for (integer i = 1; i < n; i ++)
+			denominator += a [i];
+		denominator /= n - 1;
+		auto relativeShimmer = [&] (longdouble numerator, integer numberOfPeaksUsed) -> double {
+			if (numberOfPeaksUsed < 1)
+				return undefined;
+			numerator /= numberOfPeaksUsed;
+			if (denominator == 0.0)
+				return undefined;
+			return double (numerator / denominator);
+		};
+		report. shimmer_local = relativeShimmer (localNumerator, numberOfLocalPeaks);
+		if (numberOfLocalPeaks >= 1) {
+			local_dB /= numberOfLocalPeaks;
+			report. shimmer_local_dB = double (20.0 * local_dB);
+		}
+		report. shimmer_apq3 = relativeShimmer (apq3Numerator, numberOfApq3Peaks);
+		report. shimmer_apq5 = relativeShimmer (apq5Numerator, numberOfApq5Peaks);
+		report. shimmer_apq11 = relativeShimmer (apq11Numerator, numberOfApq11Peaks);
+		report. shimmer_dda = 3.0 * report. shimmer_apq3;
+	}
+	/*
+		Harmonicity.
+	*/
+	report. meanAutocorrelation = Pitch_getMeanStrength (pitch, tmin, tmax, Pitch_STRENGTH_UNIT_AUTOCORRELATION);
+	report. meanNoiseToHarmonicsRatio = Pitch_getMeanStrength (pitch, tmin, tmax, Pitch_STRENGTH_UNIT_NOISE_HARMONICS_RATIO);
+	report. meanHarmonicsToNoiseRatio_dB = Pitch_getMeanStrength (pitch, tmin, tmax, Pitch_STRENGTH_UNIT_HARMONICS_NOISE_DB);
+	return report;
+}
+
 void Sound_Pitch_PointProcess_voiceReport (Sound sound, Pitch pitch, PointProcess pulses, double tmin, double tmax,
 	double floor, double ceiling, double maximumPeriodFactor, double maximumAmplitudeFactor, double silenceThreshold, double voicingThreshold)
 {
 	try {
-		Function_unidirectionalAutowindow (sound, & tmin, & tmax);
+		const VoiceReport report = Sound_Pitch_PointProcess_getVoiceReport (sound, pitch, pulses, tmin, tmax,
+				floor, ceiling, maximumPeriodFactor, maximumAmplitudeFactor, silenceThreshold, voicingThreshold);
+		tmin = report. startTime;
+		tmax = report. endTime;
 		/*
 			Time domain. Should be preceded by something like "Time range of SELECTION:" or so.
 		*/
@@ -270,92 +498,129 @@ void Sound_Pitch_PointProcess_voiceReport (Sound sound, Pitch pitch, PointProces
 			Pitch statistics.
 		*/
 		MelderInfo_writeLine (U"Pitch:");
-		MelderInfo_writeLine (U"   Median pitch: ", Melder_fixed (Pitch_getQuantile (pitch, tmin, tmax, 0.50, kPitch_unit::HERTZ), 3), U" Hz");
-		MelderInfo_writeLine (U"   Mean pitch: ", Melder_fixed (Pitch_getMean (pitch, tmin, tmax, kPitch_unit::HERTZ), 3), U" Hz");
-		MelderInfo_writeLine (U"   Standard deviation: ", Melder_fixed (Pitch_getStandardDeviation (pitch, tmin, tmax, kPitch_unit::HERTZ), 3), U" Hz");
-		MelderInfo_writeLine (U"   Minimum pitch: ", Melder_fixed (Pitch_getMinimum (pitch, tmin, tmax, kPitch_unit::HERTZ, 1), 3), U" Hz");
-		MelderInfo_writeLine (U"   Maximum pitch: ", Melder_fixed (Pitch_getMaximum (pitch, tmin, tmax, kPitch_unit::HERTZ, 1), 3), U" Hz");
+		MelderInfo_writeLine (U"   Median pitch: ", Melder_fixed (report. medianPitch, 3), U" Hz");
+		MelderInfo_writeLine (U"   Mean pitch: ", Melder_fixed (report. meanPitch, 3), U" Hz");
+		MelderInfo_writeLine (U"   Standard deviation: ", Melder_fixed (report. standardDeviationOfPitch, 3), U" Hz");
+		MelderInfo_writeLine (U"   Minimum pitch: ", Melder_fixed (report. minimumPitch, 3), U" Hz");
+		MelderInfo_writeLine (U"   Maximum pitch: ", Melder_fixed (report. maximumPitch, 3), U" Hz");
 		/*
 			Pulses statistics.
 		*/
-		double pmin = 0.8 / ceiling, pmax = 1.25 / floor;
 		MelderInfo_writeLine (U"Pulses:");
-		MelderInfo_writeLine (U"   Number of pulses: ", PointProcess_getWindowPoints (pulses, tmin, tmax, nullptr, nullptr));
-		MelderInfo_writeLine (U"   Number of periods: ", PointProcess_getNumberOfPeriods (pulses, tmin, tmax, pmin, pmax, maximumPeriodFactor));
-		MelderInfo_writeLine (U"   Mean period: ", Melder_fixedExponent (PointProcess_getMeanPeriod (pulses, tmin, tmax, pmin, pmax, maximumPeriodFactor), -3, 6), U" seconds");
-		MelderInfo_writeLine (U"   Standard deviation of period: ", Melder_fixedExponent (PointProcess_getStdevPeriod (pulses, tmin, tmax, pmin, pmax, maximumPeriodFactor), -3, 6), U" seconds");
+		MelderInfo_writeLine (U"   Number of pulses: ", report. numberOfPulses);
+		MelderInfo_writeLine (U"   Number of periods: ", report. numberOfPeriods);
+		MelderInfo_writeLine (U"   Mean period: ", Melder_fixedExponent (report. meanPeriod, -3, 6), U" seconds");
+		MelderInfo_writeLine (U"   Standard deviation of period: ", Melder_fixedExponent (report. standardDeviationOfPeriod, -3, 6), U" seconds");
 		/*
 			Voicing.
 		*/
-		integer imin, imax, n = Sampled_getWindowSamples (pitch, tmin, tmax, & imin, & imax), nunvoiced = n;
-		for (integer i = imin; i <= imax; i ++) {
-			const Pitch_Frame frame = & pitch -> frames [i];
-			if (frame -> intensity >= silenceThreshold) {
-				for (integer icand = 1; icand <= frame -> nCandidates; icand ++) {
-					const Pitch_Candidate cand = & frame -> candidates [icand];
-					if (cand -> frequency > 0.0 && cand -> frequency < ceiling && cand -> strength >= voicingThreshold) {
-						nunvoiced --;
-						break;   // next frame
-					}
-				}
-			}
-		}
+		const integer n = report. numberOfFrames, nunvoiced = report. numberOfUnvoicedFrames;
 		MelderInfo_writeLine (U"Voicing:");
 		MelderInfo_write (U"   Fraction of locally unvoiced frames: ", Melder_percent (n <= 0 ? undefined : (double) nunvoiced / n, 3));
 		MelderInfo_writeLine (U"   (", nunvoiced, U" / ", n, U")");
-		n = PointProcess_getWindowPoints (pulses, tmin, tmax, & imin, & imax);
-		integer numberOfVoiceBreaks = 0;
-		double durationOfVoiceBreaks = 0.0;
-		if (n > 1) {
-			bool previousPeriodVoiced = true;
-			for (integer i = imin + 1; i < imax; i ++) {
-				double period = pulses -> t [i] - pulses -> t [i - 1];
-				if (period > pmax) {
-					durationOfVoiceBreaks += period;
-					if (previousPeriodVoiced) {
-						numberOfVoiceBreaks ++;
-						previousPeriodVoiced = false;
-					}
-				} else {
-					previousPeriodVoiced = true;
-				}
-			}
-		}
-		MelderInfo_writeLine (U"   Number of voice breaks: ", numberOfVoiceBreaks);
-		MelderInfo_write (U"   Degree of voice breaks: ", Melder_percent (durationOfVoiceBreaks / (tmax - tmin), 3));
-		MelderInfo_writeLine (U"   (", Melder_fixed (durationOfVoiceBreaks, 6), U" seconds / ", Melder_fixed (tmax - tmin, 6), U" seconds)");
+		MelderInfo_writeLine (U"   Number of voice breaks: ", report. numberOfVoiceBreaks);
+		MelderInfo_write (U"   Degree of voice breaks: ", Melder_percent (report. durationOfVoiceBreaks / (tmax - tmin), 3));
+		MelderInfo_writeLine (U"   (", Melder_fixed (report. durationOfVoiceBreaks, 6), U" seconds / ", Melder_fixed (tmax - tmin, 6), U" seconds)");
 		/*
 			Jitter.
 		*/
-		double shimmerLocal, shimmerLocal_dB, apq3, apq5, apq11, dda;
 		MelderInfo_writeLine (U"Jitter:");
-		MelderInfo_writeLine (U"   Jitter (local): ", Melder_percent (PointProcess_getJitter_local (pulses, tmin, tmax, pmin, pmax, maximumPeriodFactor), 3));
-		MelderInfo_writeLine (U"   Jitter (local, absolute): ", Melder_fixedExponent (PointProcess_getJitter_local_absolute (pulses, tmin, tmax, pmin, pmax, maximumPeriodFactor), -6, 3), U" seconds");
-		MelderInfo_writeLine (U"   Jitter (rap): ", Melder_percent (PointProcess_getJitter_rap (pulses, tmin, tmax, pmin, pmax, maximumPeriodFactor), 3));
-		MelderInfo_writeLine (U"   Jitter (ppq5): ", Melder_percent (PointProcess_getJitter_ppq5 (pulses, tmin, tmax, pmin, pmax, maximumPeriodFactor), 3));
-		MelderInfo_writeLine (U"   Jitter (ddp): ", Melder_percent (PointProcess_getJitter_ddp (pulses, tmin, tmax, pmin, pmax, maximumPeriodFactor), 3));
+		MelderInfo_writeLine (U"   Jitter (local): ", Melder_percent (report. jitter_local, 3));
+		MelderInfo_writeLine (U"   Jitter (local, absolute): ", Melder_fixedExponent (report. jitter_local_absolute, -6, 3), U" seconds");
+		MelderInfo_writeLine (U"   Jitter (rap): ", Melder_percent (report. jitter_rap, 3));
+		MelderInfo_writeLine (U"   Jitter (ppq5): ", Melder_percent (report. jitter_ppq5, 3));
+		MelderInfo_writeLine (U"   Jitter (ddp): ", Melder_percent (report. jitter_ddp, 3));
 		/*
 			Shimmer.
 		*/
-		PointProcess_Sound_getShimmer_multi (pulses, sound, tmin, tmax, pmin, pmax, maximumPeriodFactor, maximumAmplitudeFactor,
-			& shimmerLocal, & shimmerLocal_dB, & apq3, & apq5, & apq11, & dda);
 		MelderInfo_writeLine (U"Shimmer:");
-		MelderInfo_writeLine (U"   Shimmer (local): ", Melder_percent (shimmerLocal, 3));
-		MelderInfo_writeLine (U"   Shimmer (local, dB): ", Melder_fixed (shimmerLocal_dB, 3), U" dB");
-		MelderInfo_writeLine (U"   Shimmer (apq3): ", Melder_percent (apq3, 3));
-		MelderInfo_writeLine (U"   Shimmer (apq5): ", Melder_percent (apq5, 3));
-		MelderInfo_writeLine (U"   Shimmer (apq11): ", Melder_percent (apq11, 3));
-		MelderInfo_writeLine (U"   Shimmer (dda): ", Melder_percent (dda, 3));
+		MelderInfo_writeLine (U"   Shimmer (local): ", Melder_percent (report. shimmer_local, 3));
+		MelderInfo_writeLine (U"   Shimmer (local, dB): ", Melder_fixed (report. shimmer_local_dB, 3), U" dB");
+		MelderInfo_writeLine (U"   Shimmer (apq3): ", Melder_percent (report. shimmer_apq3, 3));
+		MelderInfo_writeLine (U"   Shimmer (apq5): ", Melder_percent (report. shimmer_apq5, 3));
+		MelderInfo_writeLine (U"   Shimmer (apq11): ", Melder_percent (report. shimmer_apq11, 3));
+		MelderInfo_writeLine (U"   Shimmer (dda): ", Melder_percent (report. shimmer_dda, 3));
 		/*
 			Harmonicity.
 		*/
 		MelderInfo_writeLine (U"Harmonicity of the voiced parts only:");
-		MelderInfo_writeLine (U"   Mean autocorrelation: ", Melder_fixed (Pitch_getMeanStrength (pitch, tmin, tmax, Pitch_STRENGTH_UNIT_AUTOCORRELATION), 6));
-		MelderInfo_writeLine (U"   Mean noise-to-harmonics ratio: ", Melder_fixed (Pitch_getMeanStrength (pitch, tmin, tmax, Pitch_STRENGTH_UNIT_NOISE_HARMONICS_RATIO), 6));
-		MelderInfo_writeLine (U"   Mean harmonics-to-noise ratio: ", Melder_fixed (Pitch_getMeanStrength (pitch, tmin, tmax, Pitch_STRENGTH_UNIT_HARMONICS_NOISE_DB), 3), U" dB");
+		MelderInfo_writeLine (U"   Mean autocorrelation: ", Melder_fixed (report. meanAutocorrelation, 6));
+		MelderInfo_writeLine (U"   Mean noise-to-harmonics ratio: ", Melder_fixed (report. meanNoiseToHarmonicsRatio, 6));
+		MelderInfo_writeLine (U"   Mean harmonics-to-noise ratio: ", Melder_fixed (report. meanHarmonicsToNoiseRatio_dB, 3), U" dB");
 	} catch (MelderError) {
 		Melder_throw (sound, U" & ", pitch, U" & ", pulses, U": voice report not computed.");
 	}
 }
 
+static conststring32 theVoiceReportColumnNames =
+	U"tmin tmax medianPitch meanPitch stdevPitch minimumPitch maximumPitch "
+	"numberOfPulses numberOfPeriods meanPeriod stdevPeriod "
+	"fractionOfUnvoicedFrames numberOfVoiceBreaks degreeOfVoiceBreaks "
+	"jitter_local jitter_local_absolute jitter_rap jitter_ppq5 jitter_ddp "
+	"shimmer_local shimmer_local_dB shimmer_apq3 shimmer_apq5 shimmer_apq11 shimmer_dda "
+	"meanAutocorrelation meanNHR meanHNR";
+
+static void Table_setVoiceReport (Table me, integer rowNumber, integer firstColumn, VoiceReport const& report) {
+	const double values [] = {
+		report. startTime, report. endTime,
+		report. medianPitch, report. meanPitch, report. standardDeviationOfPitch, report. minimumPitch, report. maximumPitch,
+		double (report. numberOfPulses), double (report. numberOfPeriods), report. meanPeriod, report. standardDeviationOfPeriod,
+		report. numberOfFrames <= 0 ? undefined : (double) report. numberOfUnvoicedFrames / report. numberOfFrames,
+		double (report. numberOfVoiceBreaks), report. durationOfVoiceBreaks / (report. endTime - report. startTime),
+		report. jitter_local, report. jitter_local_absolute, report. jitter_rap, report. jitter_ppq5, report. jitter_ddp,
+		report. shimmer_local, report. shimmer_local_dB, report. shimmer_apq3, report. shimmer_apq5, report. shimmer_apq11, report. shimmer_dda,
+		report. meanAutocorrelation, report. meanNoiseToHarmonicsRatio, report. meanHarmonicsToNoiseRatio_dB
+	};
+	const integer numberOfValues = integer (sizeof values / sizeof values [0]);
+	Melder_assert (my numberOfColumns == firstColumn - 1 + numberOfValues);
+	for (integer ivalue = 1; ivalue <= numberOfValues; ivalue ++)
+		Table_setNumericValue (me, rowNumber, firstColumn - 1 + ivalue, values [ivalue - 1]);
+}
+
+autoTable Sound_Pitch_PointProcess_to_Table_voiceReport (Sound sound, Pitch pitch, PointProcess pulses, double tmin, double tmax,
+	double floor, double ceiling, double maximumPeriodFactor, double maximumAmplitudeFactor, double silenceThreshold, double voicingThreshold)
+{
+	try {
+		const VoiceReport report = Sound_Pitch_PointProcess_getVoiceReport (sound, pitch, pulses, tmin, tmax,
+				floor, ceiling, maximumPeriodFactor, maximumAmplitudeFactor, silenceThreshold, voicingThreshold);
+		autoTable thee = Table_createWithColumnNames (1, theVoiceReportColumnNames);
+		Table_setVoiceReport (thee.get(), 1, 1, report);
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (sound, U" & ", pitch, U" & ", pulses, U": voice report not computed.");
+	}
+}
+
+autoTable Sound_Pitch_PointProcess_TextGrid_to_Table_voiceReport (Sound sound, Pitch pitch, PointProcess pulses, TextGrid textgrid, integer tierNumber,
+	double floor, double ceiling, double maximumPeriodFactor, double maximumAmplitudeFactor, double silenceThreshold, double voicingThreshold)
+{
+	try {
+		const IntervalTier tier = TextGrid_checkSpecifiedTierIsIntervalTier (textgrid, tierNumber);
+		std::vector <TextInterval> intervals;
+		for (integer iinterval = 1; iinterval <= tier -> intervals.size; iinterval ++) {
+			const TextInterval interval = tier -> intervals.at [iinterval];
+			if (interval -> text && interval -> text [0] != U'\0')
+				intervals. push_back (interval);
+		}
+		const integer numberOfIntervals = integer (intervals. size ());
+		std::vector <VoiceReport> reports (intervals. size ());
+		const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfIntervals, 4);
+		MelderThread_parallelFor (numberOfIntervals, numberOfThreads, [&] (integer /* ithread */, integer firstInterval, integer lastInterval) {
+			for (integer iinterval = firstInterval; iinterval <= lastInterval; iinterval ++) {
+				const TextInterval interval = intervals [uinteger (iinterval - 1)];
+				reports [uinteger (iinterval - 1)] = Sound_Pitch_PointProcess_getVoiceReport (sound, pitch, pulses, interval -> xmin, interval -> xmax,
+						floor, ceiling, maximumPeriodFactor, maximumAmplitudeFactor, silenceThreshold, voicingThreshold);
+			}
+		});
+		autoTable thee = Table_createWithColumnNames (numberOfIntervals, Melder_cat (U"label ", theVoiceReportColumnNames));
+		for (integer irow = 1; irow <= numberOfIntervals; irow ++) {
+			Table_setStringValue (thee.get(), irow, 1, intervals [uinteger (irow - 1)] -> text.get());
+			Table_setVoiceReport (thee.get(), irow, 2, reports [uinteger (irow - 1)]);
+		}
+		return thee;
+	} catch (MelderError) {
+		Melder_throw (sound, U" & ", pitch, U" & ", pulses, U" & ", textgrid, U": voice reports not computed.");
+	}
+}
+
 /* End of file VoiceAnalysis.cpp */
@@ -19,6 +19,8 @@
 #include "Sound.h"
 #include "PointProcess.h"
 #include "Pitch.h"
+#include "TextGrid.h"
+#include "Table.h"
 
 double PointProcess_getJitter_local (PointProcess me, double tmin, double tmax,
 	double minimumPeriod, double maximumPeriod, double maximumPeriodFactor);
@@ -47,9 +49,55 @@ void PointProcess_Sound_getShimmer_multi (PointProcess me, Sound thee, double tm
 	double minimumPeriod, double maximumPeriod, double maximumPeriodFactor, double maximumAmplitudeFactor,
 	double *local, double *local_dB, double *apq3, double *apq5, double *apq11, double *dda);
 
+/*
+	All the measures of a voice report for the time range from `startTime` to `endTime`.
+	Jitter, shimmer and the fractions are relative (not in percent); periods are in seconds, pitches in hertz.
+*/
+struct VoiceReport {
+	double startTime, endTime;
+	double medianPitch, meanPitch, standardDeviationOfPitch, minimumPitch, maximumPitch;
+	integer numberOfPulses, numberOfPeriods;
+	double meanPeriod, standardDeviationOfPeriod;
+	integer numberOfFrames, numberOfUnvoicedFrames;
+	integer numberOfVoiceBreaks;
+	double durationOfVoiceBreaks;
+	double jitter_local, jitter_local_absolute, jitter_rap, jitter_ppq5, jitter_ddp;
+	double shimmer_local, shimmer_local_dB, shimmer_apq3, shimmer_apq5, shimmer_apq11, shimmer_dda;
+	double meanAutocorrelation, meanNoiseToHarmonicsRatio, meanHarmonicsToNoiseRatio_dB;
+};
+
+VoiceReport Sound_Pitch_PointProcess_getVoiceReport (Sound sound, Pitch pitch, PointProcess pulses,
+	double tmin, double tmax,
+	double floor, double ceiling, double maximumPeriodFactor, double maximumAmplitudeFactor,
+	double silenceThreshold, double voicingThreshold);
+/*
+	The periods and the peak amplitudes of the pulses are computed once,
+	and all jitter and shimmer measures are derived from them in a single pass;
+	the results are identical to those of the separate PointProcess_getJitter_xxx ()
+	and PointProcess_Sound_getShimmer_xxx () functions.
+*/
+
 void Sound_Pitch_PointProcess_voiceReport (Sound sound, Pitch pitch, PointProcess pulses,
 	double tmin, double tmax,
 	double floor, double ceiling, double maximumPeriodFactor, double maximumAmplitudeFactor,
 	double silenceThreshold, double voicingThreshold);
 
+autoTable Sound_Pitch_PointProcess_to_Table_voiceReport (Sound sound, Pitch pitch, PointProcess pulses,
+	double tmin, double tmax,
+	double floor, double ceiling, double maximumPeriodFactor, double maximumAmplitudeFactor,
+	double silenceThreshold, double voicingThreshold);
+/*
+	A Table with one row, in which the columns are the measures of the voice report.
+*/
+
+autoTable Sound_Pitch_PointProcess_TextGrid_to_Table_voiceReport (Sound sound, Pitch pitch, PointProcess pulses,
+	TextGrid textgrid, integer tierNumber,
+	double floor, double ceiling, double maximumPeriodFactor, double maximumAmplitudeFactor,
+	double silenceThreshold, double voicingThreshold);
+/*
+	A Table with one row for every interval with a non-empty label in the specified interval tier;
+	the first column contains the label, and the other columns are as in Sound_Pitch_PointProcess_to_Table_voiceReport ().
+	The intervals are analysed in parallel.
+*/
+
 /* End of file VoiceAnalysis.h */
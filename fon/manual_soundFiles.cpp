@@ -342,7 +342,7 @@ LIST_ITEM (U"• @@Save as NIST file...@ (little-endian)")
 LIST_ITEM (U"• @@Save as FLAC file...@")
 MAN_END
 
-MAN_BEGIN (U"LongSound", U"ppgb", 20110131)
+MAN_BEGIN (U"LongSound", U"ppgb", 20261018)
 INTRO (U"One of the @@types of objects@ in Praat. See the @@Sound files@ tutorial.")
 NORMAL (U"A LongSound object gives you the ability to view and label "
 	"a sound file that resides on disk. You will want to use it for sounds "
@@ -365,6 +365,15 @@ LIST_ITEM (U"1. Select the LongSound object.")
 LIST_ITEM (U"2. Choose @@LongSound: To TextGrid...@ and specify your tiers.")
 LIST_ITEM (U"3. Select the resulting @TextGrid object together with the LongSound object, and click ##View & Edit#.")
 NORMAL (U"A @TextGridEditor will appear on the screen, with a copy of the LongSound object in it.")
+ENTRY (U"How to analyse a LongSound object")
+NORMAL (U"The commands ##To Pitch (ac)...#, ##To Intensity...# and ##To Formant (burg)...# in the ##Analyse# menu "
+	"work as the same commands for a @Sound (see @@Sound: To Pitch (ac)...@, @@Sound: To Intensity...@ and @@Sound: To Formant (burg)...@), "
+	"but they read the file piece by piece, so that the whole sound never has to be in memory. "
+	"The resulting @Pitch and @Intensity are the same as those of the Sound read from the same file. "
+	"The resulting @Formant is also the same, except if the sound has to be resampled (i.e. if the maximum formant "
+	"is not half the sampling frequency) with a ratio of sampling frequencies that is not a simple fraction "
+	"(such as 110/441 for going from 44100 to 11000 Hz), or is exactly 2; "
+	"the formants can then differ slightly, because the anti-aliasing filter is applied to each piece separately.")
 ENTRY (U"Limitations")
 NORMAL (U"The length of the sound file is limited to 2 gigabytes, which is 3 hours of CD-quality stereo, "
 	"or 12 hours 16-bit mono sampled at 22050 Hz.")
@@ -2171,6 +2171,40 @@ DO
 	INFO_THREE_END
 }
 
+FORM (NEW1_Sound_Pitch_PointProcess_to_Table_voiceReport, U"To Table (voice report)", U"Voice") {
+	praat_TimeFunction_RANGE (fromTime, toTime)
+	POSITIVE (fromPitch, U"left Pitch range (Hz)", U"75.0")
+	POSITIVE (toPitch, U"right Pitch range (Hz)", U"600.0")
+	POSITIVE (maximumPeriodFactor, U"Maximum period factor", U"1.3")
+	POSITIVE (maximumAmplitudeFactor, U"Maximum amplitude factor", U"1.6")
+	REAL (silenceThreshold, U"Silence threshold", U"0.03")
+	REAL (voicingThreshold, U"Voicing threshold", U"0.45")
+	OK
+DO
+	CONVERT_THREE (Sound, Pitch, PointProcess)
+		autoTable result = Sound_Pitch_PointProcess_to_Table_voiceReport (me, you, him, fromTime, toTime, fromPitch, toPitch,
+			maximumPeriodFactor, maximumAmplitudeFactor, silenceThreshold, voicingThreshold);
+	CONVERT_THREE_END (my name.get())
+}
+
+// MARK: - SOUND & PITCH & POINTPROCESS & TEXTGRID
+
+FORM (NEW1_Sound_Pitch_PointProcess_TextGrid_to_Table_voiceReport, U"To Table (voice report)", U"Voice") {
+	NATURAL (tierNumber, U"Tier number", U"1")
+	POSITIVE (fromPitch, U"left Pitch range (Hz)", U"75.0")
+	POSITIVE (toPitch, U"right Pitch range (Hz)", U"600.0")
+	POSITIVE (maximumPeriodFactor, U"Maximum period factor", U"1.3")
+	POSITIVE (maximumAmplitudeFactor, U"Maximum amplitude factor", U"1.6")
+	REAL (silenceThreshold, U"Silence threshold", U"0.03")
+	REAL (voicingThreshold, U"Voicing threshold", U"0.45")
+	OK
+DO
+	CONVERT_FOUR (Sound, Pitch, PointProcess, TextGrid)
+		autoTable result = Sound_Pitch_PointProcess_TextGrid_to_Table_voiceReport (me, you, him, she, tierNumber, fromPitch, toPitch,
+			maximumPeriodFactor, maximumAmplitudeFactor, silenceThreshold, voicingThreshold);
+	CONVERT_FOUR_END (my name.get())
+}
+
 // MARK: - SOUND & POINTPROCESS & PITCHTIER & DURATIONTIER
 
 FORM (NEW1_Sound_Point_Pitch_Duration_to_Sound, U"To Sound", nullptr) {
@@ -3449,6 +3483,8 @@ praat_addAction1 (classTransition, 0, U"Cast", nullptr, 0, nullptr);
 	praat_addAction2 (classPitch, 1, classPitchTier, 1, U"To Pitch", nullptr, 0, NEW1_Pitch_PitchTier_to_Pitch);
 	praat_addAction2 (classPitch, 1, classPointProcess, 1, U"To PitchTier", nullptr, 0, NEW1_Pitch_PointProcess_to_PitchTier);
 	praat_addAction3 (classPitch, 1, classPointProcess, 1, classSound, 1, U"Voice report...", nullptr, 0, INFO_Sound_Pitch_PointProcess_voiceReport);
+	praat_addAction3 (classPitch, 1, classPointProcess, 1, classSound, 1, U"To Table (voice report)...", nullptr, 0, NEW1_Sound_Pitch_PointProcess_to_Table_voiceReport);
+	praat_addAction4 (classPitch, 1, classPointProcess, 1, classSound, 1, classTextGrid, 1, U"To Table (voice report)...", nullptr, 0, NEW1_Sound_Pitch_PointProcess_TextGrid_to_Table_voiceReport);
 	praat_addAction2 (classPitch, 1, classSound, 1, U"To PointProcess (cc)", nullptr, 0, NEW1_Sound_Pitch_to_PointProcess_cc);
 	praat_addAction2 (classPitch, 1, classSound, 1, U"To PointProcess (peaks)...", nullptr, 0, NEW1_Sound_Pitch_to_PointProcess_peaks);
 	praat_addAction2 (classPitch, 1, classSound, 1, U"To Manipulation", nullptr, 0, NEW1_Sound_Pitch_to_Manipulation);
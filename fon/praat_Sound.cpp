@@ -156,6 +156,56 @@ DO
 	CONVERT_EACH_END (my name.get())
 }
 
+FORM (NEW_LongSound_to_Formant_burg, U"LongSound: To Formant (Burg method)", U"Sound: To Formant (burg)...") {
+	REAL (timeStep, U"Time step (s)", U"0.0 (= auto)")
+	POSITIVE (maximumNumberOfFormants, U"Max. number of formants", U"5.0")
+	REAL (maximumFormant, U"Maximum formant (Hz)", U"5500.0 (= adult female)")
+	POSITIVE (windowLength, U"Window length (s)", U"0.025")
+	POSITIVE (preEmphasisFrom, U"Pre-emphasis from (Hz)", U"50.0")
+	OK
+DO
+	CONVERT_EACH (LongSound)
+		autoFormant result = LongSound_to_Formant_burg (me, timeStep,
+			maximumNumberOfFormants, maximumFormant, windowLength, preEmphasisFrom);
+	CONVERT_EACH_END (my name.get())
+}
+
+FORM (NEW_LongSound_to_Intensity, U"LongSound: To Intensity", U"Sound: To Intensity...") {
+	POSITIVE (minimumPitch, U"Minimum pitch (Hz)", U"100.0")
+	REAL (timeStep, U"Time step (s)", U"0.0 (= auto)")
+	BOOLEAN (subtractMean, U"Subtract mean", true)
+	OK
+DO
+	CONVERT_EACH (LongSound)
+		autoIntensity result = LongSound_to_Intensity (me,
+			minimumPitch, timeStep, subtractMean);
+	CONVERT_EACH_END (my name.get())
+}
+
+FORM (NEW_LongSound_to_Pitch_ac, U"LongSound: To Pitch (ac)", U"Sound: To Pitch (ac)...") {
+	LABEL (U"Finding the candidates")
+	REAL (timeStep, U"Time step (s)", U"0.0 (= auto)")
+	POSITIVE (pitchFloor, U"Pitch floor (Hz)", U"75.0")
+	NATURAL (maximumNumberOfCandidates, U"Max. number of candidates", U"15")
+	BOOLEAN (veryAccurate, U"Very accurate", false)
+	LABEL (U"Finding a path")
+	REAL (silenceThreshold, U"Silence threshold", U"0.03")
+	REAL (voicingThreshold, U"Voicing threshold", U"0.45")
+	REAL (octaveCost, U"Octave cost", U"0.01")
+	REAL (octaveJumpCost, U"Octave-jump cost", U"0.35")
+	REAL (voicedUnvoicedCost, U"Voiced / unvoiced cost", U"0.14")
+	POSITIVE (pitchCeiling, U"Pitch ceiling (Hz)", U"600.0")
+	OK
+DO
+	if (maximumNumberOfCandidates <= 1)
+		Melder_throw (U"Your maximum number of candidates should be greater than 1.");
+	CONVERT_EACH (LongSound)
+		autoPitch result = LongSound_to_Pitch_ac (me, timeStep,
+			pitchFloor, 3.0, maximumNumberOfCandidates, veryAccurate,
+			silenceThreshold, voicingThreshold, octaveCost, octaveJumpCost, voicedUnvoicedCost, pitchCeiling);
+	CONVERT_EACH_END (my name.get())
+}
+
 DIRECT (WINDOW_LongSound_view) {
 	if (theCurrentPraatApplication -> batch) Melder_throw (U"Cannot view or edit a LongSound from batch.");
 	FIND_ONE_WITH_IOBJECT (LongSound)
@@ -278,12 +328,23 @@ FORM (PREFS_LongSoundPrefs, U"LongSound preferences", U"LongSound") {
 	LABEL (U"for viewing the waveform and playing a sound in the LongSound window.")
 	LABEL (U"The LongSound window can become very slow if you set it too high.")
 	NATURAL (maximumViewablePart, U"Maximum viewable part (seconds)", U"60")
-	LABEL (U"Note: this setting works for the next long sound file that you open,")
+	LABEL (U"Compressed and non-16-bit sound files are decoded in blocks,")
+	LABEL (U"the most recently used of which are kept in memory.")
+	NATURAL (cacheSize, U"Cache size (seconds)", U"300")
+	LABEL (U"The cache keeps 24-bit and floating-point samples at full precision,")
+	LABEL (U"unless you choose 16 bits here, which halves the memory needed.")
+	OPTIONMENU_ENUM (kLongSound_cacheFormat, cacheFormat,
+			U"Cache format", kLongSound_cacheFormat::DEFAULT)
+	LABEL (U"Note: these settings work for the next long sound file that you open,")
 	LABEL (U"not for currently existing LongSound objects.")
 OK
 	SET_INTEGER (maximumViewablePart, LongSound_getBufferSizePref_seconds ())
+	SET_INTEGER (cacheSize, LongSound_getCacheSizePref_seconds ())
+	SET_ENUM (cacheFormat, kLongSound_cacheFormat, LongSound_getCacheFormatPref ())
 DO
 	LongSound_setBufferSizePref_seconds (maximumViewablePart);
+	LongSound_setCacheSizePref_seconds (cacheSize);
+	LongSound_setCacheFormatPref (cacheFormat);
 END }
 
 /********** LONGSOUND & SOUND **********/
@@ -2233,6 +2294,10 @@ void praat_Sound_init () {
 		praat_addAction1 (classLongSound, 0, U"Annotation tutorial", nullptr, 1, HELP_AnnotationTutorial);
 		praat_addAction1 (classLongSound, 0, U"-- to text grid --", nullptr, 1, nullptr);
 		praat_addAction1 (classLongSound, 0, U"To TextGrid...", nullptr, 1, NEW_LongSound_to_TextGrid);
+	praat_addAction1 (classLongSound, 0, U"Analyse -", nullptr, 0, nullptr);
+		praat_addAction1 (classLongSound, 0, U"To Pitch (ac)...", nullptr, 1, NEW_LongSound_to_Pitch_ac);
+		praat_addAction1 (classLongSound, 0, U"To Intensity...", nullptr, 1, NEW_LongSound_to_Intensity);
+		praat_addAction1 (classLongSound, 0, U"To Formant (burg)...", nullptr, 1, NEW_LongSound_to_Formant_burg);
 	praat_addAction1 (classLongSound, 0, U"Convert to Sound", nullptr, 0, nullptr);
 	praat_addAction1 (classLongSound, 0, U"Extract part...", nullptr, 0, NEW_LongSound_extractPart);
 	praat_addAction1 (classLongSound, 0, U"Concatenate?", nullptr, 0, INFO_LongSound_concatenate);
@@ -150,10 +150,10 @@ void Network_formula_activities (Network me, integer fromNode, integer toNode, c
 		const integer newNumberOfNodes = my checkAndDefaultNodeRange (& fromNode, & toNode);
 		autoMatrix thee = Matrix_create (0.5, newNumberOfNodes + 0.5, newNumberOfNodes, 1.0, 1.0,
 			1.0, 1.0, 1, 1.0, 1.0);
-		Formula_compile (interpreter, thee.get(), expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
+		autoFormulaProgram program = Formula_compile (interpreter, thee.get(), expression, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 		Formula_Result result;
 		for (integer icol = 1; icol <= thy nx; icol ++) {
-			Formula_run (1, icol, & result);
+			Formula_run (program.get(), 1, icol, & result);
 			my nodes [fromNode - 1 + icol]. activity = thy z [1] [icol] = result. numericResult;
 		}
 	} catch (MelderError) {
@@ -22,7 +22,7 @@
 	Local functions.
 */
 
-static longdouble NUMsum_longdouble (constVECVU const& vec) {
+longdouble NUMsum_longdouble (constVECVU const& vec) noexcept {
 	if (vec.stride == 1) {
 		PAIRWISE_SUM (
 			longdouble, sum,
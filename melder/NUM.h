@@ -328,6 +328,11 @@ extern double NUMstdev (constMATVU const& mat) noexcept;
 
 extern double NUMsum (constVECVU const& vec) noexcept;
 extern double NUMsum (constMATVU const& mat) noexcept;
+extern longdouble NUMsum_longdouble (constVECVU const& vec) noexcept;
+/*
+	The pairwise sum before it is rounded by NUMsum () or divided by NUMmean (),
+	for whoever has to add up a long vector in pieces in the same order.
+*/
 
 extern double NUMsum2 (constVECVU const& vec);
 extern double NUMsum2 (constMATVU const& mat);
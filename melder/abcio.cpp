@@ -23,119 +23,169 @@
 
 /********** text I/O **********/
 
-static int64 getInteger (MelderReadText me) {
+/*
+	While a number, string or enumerated value is scanned, the read pointer is kept in a local variable,
+	so that the characters can be taken directly from the buffer (UTF-32, or 8-bit text that is mostly ASCII)
+	rather than with a function call for every character.
+	The pointer is written back when the scan is complete, or before a line number is reported.
+	The characters are exactly those that MelderReadText_getChar () would give;
+	in all the 8-bit encodings that we support, the ASCII bytes stand for themselves.
+*/
+struct TextCursor {
+	MelderReadText text;
+	char32 *readPointer32;
+	char *readPointer8;
+	explicit TextCursor (MelderReadText givenText)
+		: text (givenText), readPointer32 (givenText -> readPointer32), readPointer8 (givenText -> readPointer8) { }
+	~ TextCursor () {
+		our commit ();
+	}
+	TextCursor (const TextCursor&) = delete;
+	TextCursor& operator= (const TextCursor&) = delete;
+	void commit () {
+		our text -> readPointer32 = our readPointer32;
+		our text -> readPointer8 = our readPointer8;
+	}
+	char32 getChar () {
+		if (our readPointer32) {
+			if (* our readPointer32 == U'\0')
+				return U'\0';
+			return * our readPointer32 ++;
+		}
+		const char8 kar = (char8) * our readPointer8;
+		if (kar == '\0')
+			return U'\0';
+		if (kar <= 0x7F) {
+			our readPointer8 ++;
+			return (char32) kar;
+		}
+		our commit ();
+		const char32 result = MelderReadText_getChar (our text);   // decode
+		our readPointer8 = our text -> readPointer8;
+		return result;
+	}
+	conststring32 getLineNumber () {
+		our commit ();
+		return MelderReadText_getLineNumber (our text);
+	}
+};
+
+static int64 getInteger (MelderReadText text) {
+	TextCursor cursor (text);
 	char buffer [41];
 	char32 c;
 	/*
 	 * Look for the first numeric character.
 	 */
-	for (c = MelderReadText_getChar (me); c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = MelderReadText_getChar (me)) {
+	for (c = cursor.getChar (); c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = cursor.getChar ()) {
 		if (c == U'\0')
-			Melder_throw (U"Early end of text detected while looking for an integer (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Early end of text detected while looking for an integer (line ", cursor.getLineNumber (), U").");
 		if (c == U'!') {   // end-of-line comment?
-			while ((c = MelderReadText_getChar (me)) != U'\n' && c != U'\r') {
+			while ((c = cursor.getChar ()) != U'\n' && c != U'\r') {
 				if (c == 0)
-					Melder_throw (U"Early end of text detected in comment while looking for an integer (line ", MelderReadText_getLineNumber (me), U").");
+					Melder_throw (U"Early end of text detected in comment while looking for an integer (line ", cursor.getLineNumber (), U").");
 			}
 		}
 		if (c == U'\"')
-			Melder_throw (U"Found a string while looking for an integer in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found a string while looking for an integer in text (line ", cursor.getLineNumber (), U").");
 		if (c == U'<')
-			Melder_throw (U"Found an enumerated value while looking for an integer in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found an enumerated value while looking for an integer in text (line ", cursor.getLineNumber (), U").");
 		while (! Melder_isHorizontalOrVerticalSpace (c)) {
 			if (c == U'\0')
-				Melder_throw (U"Early end of text detected in comment (line ", MelderReadText_getLineNumber (me), U").");
-			c = MelderReadText_getChar (me);
+				Melder_throw (U"Early end of text detected in comment (line ", cursor.getLineNumber (), U").");
+			c = cursor.getChar ();
 		}
 	}
 	int i = 0;
 	for (; i < 40; i ++) {
 		if (c > 127)
-			Melder_throw (U"Found strange text while looking for an integer in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found strange text while looking for an integer in text (line ", cursor.getLineNumber (), U").");
 		buffer [i] = (char) (char8) c;   // guarded conversion down
-		c = MelderReadText_getChar (me);
+		c = cursor.getChar ();
 		if (c == U'\0') { break; }   // this may well be OK here
 		if (Melder_isHorizontalOrVerticalSpace (c)) break;
 	}
 	if (i >= 40)
-		Melder_throw (U"Found long text while looking for an integer in text (line ", MelderReadText_getLineNumber (me), U").");
+		Melder_throw (U"Found long text while looking for an integer in text (line ", cursor.getLineNumber (), U").");
 	buffer [i + 1] = '\0';
 	return strtoll (buffer, nullptr, 10);
 }
 
-static uint64 getUnsigned (MelderReadText me) {
+static uint64 getUnsigned (MelderReadText text) {
+	TextCursor cursor (text);
 	char buffer [41];
 	char32 c;
-	for (c = MelderReadText_getChar (me); ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = MelderReadText_getChar (me)) {
+	for (c = cursor.getChar (); ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = cursor.getChar ()) {
 		if (c == U'\0')
-			Melder_throw (U"Early end of text detected while looking for an unsigned integer (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Early end of text detected while looking for an unsigned integer (line ", cursor.getLineNumber (), U").");
 		if (c == U'!') {   // end-of-line comment?
-			while ((c = MelderReadText_getChar (me)) != '\n' && c != '\r') {
+			while ((c = cursor.getChar ()) != '\n' && c != '\r') {
 				if (c == U'\0')
-					Melder_throw (U"Early end of text detected in comment while looking for an unsigned integer (line ", MelderReadText_getLineNumber (me), U").");
+					Melder_throw (U"Early end of text detected in comment while looking for an unsigned integer (line ", cursor.getLineNumber (), U").");
 			}
 		}
 		if (c == U'\"')
-			Melder_throw (U"Found a string while looking for an unsigned integer in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found a string while looking for an unsigned integer in text (line ", cursor.getLineNumber (), U").");
 		if (c == U'<')
-			Melder_throw (U"Found an enumerated value while looking for an unsigned integer in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found an enumerated value while looking for an unsigned integer in text (line ", cursor.getLineNumber (), U").");
 		if (c == U'-')
-			Melder_throw (U"Found a negative value while looking for an unsigned integer in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found a negative value while looking for an unsigned integer in text (line ", cursor.getLineNumber (), U").");
 		while (! Melder_isHorizontalOrVerticalSpace (c)) {
 			if (c == U'\0')
-				Melder_throw (U"Early end of text detected in comment (line ", MelderReadText_getLineNumber (me), U").");
-			c = MelderReadText_getChar (me);
+				Melder_throw (U"Early end of text detected in comment (line ", cursor.getLineNumber (), U").");
+			c = cursor.getChar ();
 		}
 	}
 	int i = 0;
 	for (i = 0; i < 40; i ++) {
 		if (c > 127)
-			Melder_throw (U"Found strange text while looking for an unsigned integer in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found strange text while looking for an unsigned integer in text (line ", cursor.getLineNumber (), U").");
 		buffer [i] = (char) (char8) c;   // guarded conversion down
-		c = MelderReadText_getChar (me);
+		c = cursor.getChar ();
 		if (c == U'\0') { break; }   // this may well be OK here
 		if (Melder_isHorizontalOrVerticalSpace (c)) break;
 	}
 	if (i >= 40)
-		Melder_throw (U"Found long text while searching for an unsigned integer in text (line ", MelderReadText_getLineNumber (me), U").");
+		Melder_throw (U"Found long text while searching for an unsigned integer in text (line ", cursor.getLineNumber (), U").");
 	buffer [i + 1] = '\0';
 	return strtoull (buffer, nullptr, 10);
 }
 
-static double getReal (MelderReadText me) {
+static double getReal (MelderReadText text) {
+	TextCursor cursor (text);
 	int i;
 	char buffer [41], *slash;
 	char32 c;
 	do {
-		for (c = MelderReadText_getChar (me); c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = MelderReadText_getChar (me)) {
+		for (c = cursor.getChar (); c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = cursor.getChar ()) {
 			if (c == U'\0')
-				Melder_throw (U"Early end of text detected while looking for a real number (line ", MelderReadText_getLineNumber (me), U").");
+				Melder_throw (U"Early end of text detected while looking for a real number (line ", cursor.getLineNumber (), U").");
 			if (c == U'!') {   // end-of-line comment?
-				while ((c = MelderReadText_getChar (me)) != U'\n' && c != U'\r') {
+				while ((c = cursor.getChar ()) != U'\n' && c != U'\r') {
 					if (c == U'\0')
-						Melder_throw (U"Early end of text detected in comment while looking for a real number (line ", MelderReadText_getLineNumber (me), U").");
+						Melder_throw (U"Early end of text detected in comment while looking for a real number (line ", cursor.getLineNumber (), U").");
 				}
 			}
 			if (c == U'\"')
-				Melder_throw (U"Found a string while looking for a real number in text (line ", MelderReadText_getLineNumber (me), U").");
+				Melder_throw (U"Found a string while looking for a real number in text (line ", cursor.getLineNumber (), U").");
 			if (c == U'<')
-				Melder_throw (U"Found an enumerated value while looking for a real number in text (line ", MelderReadText_getLineNumber (me), U").");
+				Melder_throw (U"Found an enumerated value while looking for a real number in text (line ", cursor.getLineNumber (), U").");
 			while (! Melder_isHorizontalOrVerticalSpace (c)) {
 				if (c == U'\0')
-					Melder_throw (U"Early end of text detected in comment while looking for a real number (line ", MelderReadText_getLineNumber (me), U").");
-				c = MelderReadText_getChar (me);
+					Melder_throw (U"Early end of text detected in comment while looking for a real number (line ", cursor.getLineNumber (), U").");
+				c = cursor.getChar ();
 			}
 		}
 		for (i = 0; i < 40; i ++) {
 			if (c > 127)
-				Melder_throw (U"Found strange text while looking for a real number in text (line ", MelderReadText_getLineNumber (me), U").");
+				Melder_throw (U"Found strange text while looking for a real number in text (line ", cursor.getLineNumber (), U").");
 			buffer [i] = (char) (char8) c;   // guarded conversion down
-			c = MelderReadText_getChar (me);
+			c = cursor.getChar ();
 			if (c == U'\0') { break; }   // this may well be OK here
 			if (Melder_isHorizontalOrVerticalSpace (c)) break;
 		}
 		if (i >= 40)
-			Melder_throw (U"Found long text while searching for a real number in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found long text while searching for a real number in text (line ", cursor.getLineNumber (), U").");
 	} while (i == 0 && buffer [0] == '+');   // guard against single '+' symbols, which occur in complex numbers
 	buffer [i + 1] = '\0';
 	slash = strchr (buffer, '/');
@@ -149,34 +199,35 @@ static double getReal (MelderReadText me) {
 	return Melder_a8tof (buffer);
 }
 
-static dcomplex getComplex (MelderReadText me) {
+static dcomplex getComplex (MelderReadText text) {
+	TextCursor cursor (text);
 	dcomplex result;
 	char realBuffer [41], imaginaryBuffer [41];
 	integer ireal = 0, iimag = 0;
 	char32 c;
 	bool inExponent = false, inExponentNumber = false, separatorIsMinus = false;
-	for (c = MelderReadText_getChar (me); c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = MelderReadText_getChar (me)) {
+	for (c = cursor.getChar (); c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+'; c = cursor.getChar ()) {
 		if (c == U'\0')
-			Melder_throw (U"Early end of text detected while looking for a complex number (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Early end of text detected while looking for a complex number (line ", cursor.getLineNumber (), U").");
 		if (c == U'!') {   // end-of-line comment?
-			while ((c = MelderReadText_getChar (me)) != U'\n' && c != U'\r') {
+			while ((c = cursor.getChar ()) != U'\n' && c != U'\r') {
 				if (c == U'\0')
-					Melder_throw (U"Early end of text detected in comment while looking for a complex number (line ", MelderReadText_getLineNumber (me), U").");
+					Melder_throw (U"Early end of text detected in comment while looking for a complex number (line ", cursor.getLineNumber (), U").");
 			}
 		}
 		if (c == U'\"')
-			Melder_throw (U"Found a string while looking for a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found a string while looking for a complex number in text (line ", cursor.getLineNumber (), U").");
 		if (c == U'<')
-			Melder_throw (U"Found an enumerated value while looking for a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found an enumerated value while looking for a complex number in text (line ", cursor.getLineNumber (), U").");
 		while (! Melder_isHorizontalOrVerticalSpace (c)) {
 			if (c == U'\0')
-				Melder_throw (U"Early end of text detected in comment while looking for a complex number (line ", MelderReadText_getLineNumber (me), U").");
-			c = MelderReadText_getChar (me);
+				Melder_throw (U"Early end of text detected in comment while looking for a complex number (line ", cursor.getLineNumber (), U").");
+			c = cursor.getChar ();
 		}
 	}
 	for (; ireal < 40; ireal ++) {
 		if (c > 127)
-			Melder_throw (U"Found strange text while looking for a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found strange text while looking for a complex number in text (line ", cursor.getLineNumber (), U").");
 		if (inExponent) {
 			if (c == U'+' || c == U'-')  {
 				if (inExponentNumber) {
@@ -195,7 +246,7 @@ static dcomplex getComplex (MelderReadText me) {
 				realBuffer [ireal] = U'\0';
 				break;
 			} else {
-				Melder_throw (U"Found unexpected symbol in the exponent of a complex number (line ", MelderReadText_getLineNumber (me), U").");
+				Melder_throw (U"Found unexpected symbol in the exponent of a complex number (line ", cursor.getLineNumber (), U").");
 			}
 		} else if (ireal > 0 && (c == U'+' || c == U'-')) {   // note: initial signs are not separators
 			separatorIsMinus = ( c == U'-' );
@@ -205,86 +256,87 @@ static dcomplex getComplex (MelderReadText me) {
 		if (c == 'e' || c == 'E')
 			inExponent = true;
 		realBuffer [ireal] = (char) (char8) c;   // guarded conversion down
-		c = MelderReadText_getChar (me);
+		c = cursor.getChar ();
 		if (c == U'\0')
-			Melder_throw (U"Missing imaginary part in complex number (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Missing imaginary part in complex number (line ", cursor.getLineNumber (), U").");
 		if (Melder_isHorizontalOrVerticalSpace (c))
-			Melder_throw (U"Found a space within a complex number (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found a space within a complex number (line ", cursor.getLineNumber (), U").");
 	}
 	if (ireal >= 40)
-		Melder_throw (U"Found long text while searching for a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
+		Melder_throw (U"Found long text while searching for a complex number in text (line ", cursor.getLineNumber (), U").");
 	realBuffer [ireal + 1] = '\0';
 	result. real (Melder_a8tof (realBuffer));
-	c = MelderReadText_getChar (me);
+	c = cursor.getChar ();
 	if (c != U'-' && ! Melder_isAsciiDecimalNumber (c) && c != U'+')
-		Melder_throw (U"Found strange text while looking for the imaginary part of a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
+		Melder_throw (U"Found strange text while looking for the imaginary part of a complex number in text (line ", cursor.getLineNumber (), U").");
 	if (c == U'\0')
-		Melder_throw (U"Early end of text detected while looking for the imaginary part of a complex number (line ", MelderReadText_getLineNumber (me), U").");
+		Melder_throw (U"Early end of text detected while looking for the imaginary part of a complex number (line ", cursor.getLineNumber (), U").");
 	if (Melder_isHorizontalOrVerticalSpace (c))
-		Melder_throw (U"Found a space within a complex number (line ", MelderReadText_getLineNumber (me), U").");
+		Melder_throw (U"Found a space within a complex number (line ", cursor.getLineNumber (), U").");
 	if (c == U'!') {   // end-of-line comment?
-		while ((c = MelderReadText_getChar (me)) != U'\n' && c != U'\r') {
+		while ((c = cursor.getChar ()) != U'\n' && c != U'\r') {
 			if (c == U'\0')
-				Melder_throw (U"Early end of text detected in comment while looking for the imaginary part of a complex number (line ", MelderReadText_getLineNumber (me), U").");
+				Melder_throw (U"Early end of text detected in comment while looking for the imaginary part of a complex number (line ", cursor.getLineNumber (), U").");
 		}
 	}
 	if (c == U'\"')
-		Melder_throw (U"Found a string while looking for the imaginary part of a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
+		Melder_throw (U"Found a string while looking for the imaginary part of a complex number in text (line ", cursor.getLineNumber (), U").");
 	if (c == U'<')
-		Melder_throw (U"Found an enumerated value while looking for the imaginary part of a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
+		Melder_throw (U"Found an enumerated value while looking for the imaginary part of a complex number in text (line ", cursor.getLineNumber (), U").");
 	for (; iimag < 40; iimag ++) {
 		if (c > 127)
-			Melder_throw (U"Found strange text while looking for the imaginary part of a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found strange text while looking for the imaginary part of a complex number in text (line ", cursor.getLineNumber (), U").");
 		imaginaryBuffer [iimag] = (char) (char8) c;   // guarded conversion down
-		c = MelderReadText_getChar (me);
+		c = cursor.getChar ();
 		if (c == U'\0')
-			Melder_throw (U"Missing i in a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Missing i in a complex number in text (line ", cursor.getLineNumber (), U").");
 		if (Melder_isHorizontalOrVerticalSpace (c))
-			Melder_throw (U"Missing i in a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Missing i in a complex number in text (line ", cursor.getLineNumber (), U").");
 		if (c == U'i')
 			break;
 	}
 	if (iimag >= 40)
-		Melder_throw (U"Found long text while searching for the imaginary part of a complex number in text (line ", MelderReadText_getLineNumber (me), U").");
+		Melder_throw (U"Found long text while searching for the imaginary part of a complex number in text (line ", cursor.getLineNumber (), U").");
 	imaginaryBuffer [iimag + 1] = '\0';
 	result. imag (Melder_a8tof (imaginaryBuffer) * ( separatorIsMinus ? -1.0 : 1.0 ));
 	return result;
 }
 
-static int getEnum (MelderReadText me, int (*getValue) (conststring32)) {
+static int getEnum (MelderReadText text, int (*getValue) (conststring32)) {
+	TextCursor cursor (text);
 	char32 buffer [41], c;
-	for (c = MelderReadText_getChar (me); c != U'<'; c = MelderReadText_getChar (me)) {
+	for (c = cursor.getChar (); c != U'<'; c = cursor.getChar ()) {
 		if (c == U'\0')
-			Melder_throw (U"Early end of text detected while looking for an enumerated value (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Early end of text detected while looking for an enumerated value (line ", cursor.getLineNumber (), U").");
 		if (c == U'!') {   /* End-of-line comment? */
-			while ((c = MelderReadText_getChar (me)) != U'\n' && c != U'\r') {
+			while ((c = cursor.getChar ()) != U'\n' && c != U'\r') {
 				if (c == U'\0')
-					Melder_throw (U"Early end of text detected in comment while looking for an enumerated value (line ", MelderReadText_getLineNumber (me), U").");
+					Melder_throw (U"Early end of text detected in comment while looking for an enumerated value (line ", cursor.getLineNumber (), U").");
 			}
 		}
 		if (c == U'-' || Melder_isAsciiDecimalNumber (c) || c == U'+')
-			Melder_throw (U"Found a number while looking for an enumerated value in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found a number while looking for an enumerated value in text (line ", cursor.getLineNumber (), U").");
 		if (c == U'\"')
-			Melder_throw (U"Found a string while looking for an enumerated value in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found a string while looking for an enumerated value in text (line ", cursor.getLineNumber (), U").");
 		while (! Melder_isHorizontalOrVerticalSpace (c)) {
 			if (c == U'\0')
-				Melder_throw (U"Early end of text detected in comment while looking for an enumerated value (line ", MelderReadText_getLineNumber (me), U").");
-			c = MelderReadText_getChar (me);
+				Melder_throw (U"Early end of text detected in comment while looking for an enumerated value (line ", cursor.getLineNumber (), U").");
+			c = cursor.getChar ();
 		}
 	}
 	int i = 0;
 	for (; i < 40; i ++) {
-		c = MelderReadText_getChar (me);   // read past first '<'
+		c = cursor.getChar ();   // read past first '<'
 		if (c == U'\0')
-			Melder_throw (U"Early end of text detected while reading an enumerated value (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Early end of text detected while reading an enumerated value (line ", cursor.getLineNumber (), U").");
 		if (Melder_isHorizontalOrVerticalSpace (c))
-			Melder_throw (U"No matching '>' while reading an enumerated value (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"No matching '>' while reading an enumerated value (line ", cursor.getLineNumber (), U").");
 		if (c == U'>')
 			break;   // the expected closing bracket; not added to the buffer
 		buffer [i] = c;
 	}
 	if (i >= 40)
-		Melder_throw (U"Found strange text while reading an enumerated value in text (line ", MelderReadText_getLineNumber (me), U").");
+		Melder_throw (U"Found strange text while reading an enumerated value in text (line ", cursor.getLineNumber (), U").");
 	buffer [i] = U'\0';
 	int value = getValue (buffer);
 	if (value < 0)
@@ -292,41 +344,42 @@ static int getEnum (MelderReadText me, int (*getValue) (conststring32)) {
 	return value;
 }
 
-static char32 * peekString (MelderReadText me) {
+static char32 * peekString (MelderReadText text) {
+	TextCursor cursor (text);
 	static MelderString buffer;
 	MelderString_empty (& buffer);
-	for (char32 c = MelderReadText_getChar (me); c != U'\"'; c = MelderReadText_getChar (me)) {
+	for (char32 c = cursor.getChar (); c != U'\"'; c = cursor.getChar ()) {
 		if (c == U'\0')
-			Melder_throw (U"Early end of text detected while looking for a string (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Early end of text detected while looking for a string (line ", cursor.getLineNumber (), U").");
 		if (c == U'!') {   // end-of-line comment?
-			while ((c = MelderReadText_getChar (me)) != '\n' && c != '\r') {
+			while ((c = cursor.getChar ()) != '\n' && c != '\r') {
 				if (c == U'\0')
-					Melder_throw (U"Early end of text detected in comment while looking for a string (line ", MelderReadText_getLineNumber (me), U").");
+					Melder_throw (U"Early end of text detected in comment while looking for a string (line ", cursor.getLineNumber (), U").");
 			}
 		}
 		if (c == U'-' || Melder_isAsciiDecimalNumber (c) || c == U'+')
-			Melder_throw (U"Found a number while looking for a string in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found a number while looking for a string in text (line ", cursor.getLineNumber (), U").");
 		if (c == U'<')
-			Melder_throw (U"Found an enumerated value while looking for a string in text (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Found an enumerated value while looking for a string in text (line ", cursor.getLineNumber (), U").");
 		while (! Melder_isHorizontalOrVerticalSpace (c)) {
 			if (c == U'\0')
-				Melder_throw (U"Early end of text detected while looking for a string (line ", MelderReadText_getLineNumber (me), U").");
-			c = MelderReadText_getChar (me);
+				Melder_throw (U"Early end of text detected while looking for a string (line ", cursor.getLineNumber (), U").");
+			c = cursor.getChar ();
 		}
 	}
 	for (int i = 0; 1; i ++) {
-		char32 c = MelderReadText_getChar (me);   // read past first '"'
+		char32 c = cursor.getChar ();   // read past first '"'
 		if (c == U'\0')
-			Melder_throw (U"Early end of text detected while reading a string (line ", MelderReadText_getLineNumber (me), U").");
+			Melder_throw (U"Early end of text detected while reading a string (line ", cursor.getLineNumber (), U").");
 		if (c == U'\"') {
-			char32 next = MelderReadText_getChar (me);
+			char32 next = cursor.getChar ();
 			if (next == U'\0') { break; }   // closing quote is last character in file: OK
 			if (next != U'\"') {
 				if (Melder_isHorizontalOrVerticalSpace (next)) {
 					// closing quote is followed by whitespace: it is OK to skip this whitespace (no need to "ungetChar")
 				} else {
 					char32 kar2 [2] = { next, U'\0' };
-					Melder_throw (U"Character ", kar2, U" following quote (line ", MelderReadText_getLineNumber (me), U"). End of string or undoubled quote?");
+					Melder_throw (U"Character ", kar2, U" following quote (line ", cursor.getLineNumber (), U"). End of string or undoubled quote?");
 				}
 				break;   // the expected closing double quote; not added to the buffer
 			}   // else: add only one of the two quotes to the buffer
@@ -1476,6 +1529,35 @@ void binputu32LE (uint32 u, FILE *f) {
 	}
 }
 
+static void encodeR32 (double x, uint8 bytes [4]) {
+	int sign, exponent;
+	double fMantissa, fsMantissa;
+	uint32 mantissa;
+	if (x < 0.0) { sign = 0x0100; x *= -1.0; }
+	else sign = 0;
+	if (x == 0.0) { exponent = 0; mantissa = 0; }
+	else {
+		fMantissa = frexp (x, & exponent);
+		if ((exponent > 128) || ! (fMantissa < 1.0))   // Infinity or Not-a-Number
+			{ exponent = sign | 0x00FF; mantissa = 0; }   // Infinity
+		else {   // finite
+			exponent += 126;   // add bias
+			if (exponent <= 0) {   // denormalized
+				fMantissa = ldexp (fMantissa, exponent - 1);
+				exponent = 0;
+			}
+			exponent |= sign;
+			fMantissa = ldexp (fMantissa, 24);          
+			fsMantissa = floor (fMantissa); 
+			mantissa = (uint32) fsMantissa & 0x007FFFFF;
+		}
+	}
+	bytes [0] = (uint8) (exponent >> 1);   // truncate: bits 2 through 9 (bit 9 is the sign bit)
+	bytes [1] = (uint8) ((exponent << 7) | (mantissa >> 16));   // truncate
+	bytes [2] = (uint8) (mantissa >> 8);   // truncate
+	bytes [3] = (uint8) mantissa;   // truncate
+}
+
 void binputr32 (double x, FILE *f) {
 	try {
 		if (binario_floatIEEE4msb && Melder_debug != 18) {
@@ -1483,32 +1565,7 @@ void binputr32 (double x, FILE *f) {
 			if (fwrite (& x32, sizeof (float), 1, f) != 1) writeError (U"a 32-bit floating-point number.");
 		} else {
 			uint8 bytes [4];
-			int sign, exponent;
-			double fMantissa, fsMantissa;
-			uint32 mantissa;
-			if (x < 0.0) { sign = 0x0100; x *= -1.0; }
-			else sign = 0;
-			if (x == 0.0) { exponent = 0; mantissa = 0; }
-			else {
-				fMantissa = frexp (x, & exponent);
-				if ((exponent > 128) || ! (fMantissa < 1.0))   // Infinity or Not-a-Number
-					{ exponent = sign | 0x00FF; mantissa = 0; }   // Infinity
-				else {   // finite
-					exponent += 126;   // add bias
-					if (exponent <= 0) {   // denormalized
-						fMantissa = ldexp (fMantissa, exponent - 1);
-						exponent = 0;
-					}
-					exponent |= sign;
-					fMantissa = ldexp (fMantissa, 24);          
-					fsMantissa = floor (fMantissa); 
-					mantissa = (uint32) fsMantissa & 0x007FFFFF;
-				}
-			}
-			bytes [0] = (uint8) (exponent >> 1);   // truncate: bits 2 through 9 (bit 9 is the sign bit)
-			bytes [1] = (uint8) ((exponent << 7) | (mantissa >> 16));   // truncate
-			bytes [2] = (uint8) (mantissa >> 8);   // truncate
-			bytes [3] = (uint8) mantissa;   // truncate
+			encodeR32 (x, bytes);
 			if (fwrite (bytes, sizeof (uint8), 4, f) != 4) writeError (U"four bytes.");
 		}
 	} catch (MelderError) {
@@ -1664,6 +1721,158 @@ void binputr64LE (double x, FILE *f) {
 	}
 }
 
+/*
+	Arrays of real numbers are converted in blocks in memory, with a single fread or fwrite per block.
+	The values and bytes are the same as with bingetr32/binputr32 and bingetr64/binputr64
+	called for every element, including the treatment of infinities, NaNs and negative zero:
+	if the format is not native, reading gives `undefined` for infinities and NaNs,
+	and writing (if not merely a matter of byte swapping) changes NaNs into +Infinity and -0.0 into +0.0.
+*/
+static_assert (std::numeric_limits <float>::is_iec559 && std::numeric_limits <double>::is_iec559,
+	"The conversion of arrays of real numbers assumes IEEE floating-point numbers.");
+
+constexpr integer binario_numberOfBytesPerBlock = 32768;
+
+void bingetr32array (double *x, integer n, FILE *f) {
+	if (Melder_debug == 18) {
+		for (integer i = 0; i < n; i ++)
+			x [i] = bingetr32 (f);
+		return;
+	}
+	try {
+		constexpr integer numberOfValuesPerBlock = binario_numberOfBytesPerBlock / 4;
+		union { float floats [numberOfValuesPerBlock]; uint8 bytes [binario_numberOfBytesPerBlock]; };
+		for (integer first = 0; first < n; first += numberOfValuesPerBlock) {
+			const integer numberOfValues = std::min (n - first, numberOfValuesPerBlock);
+			if (fread (bytes, 4, uinteger (numberOfValues), f) != uinteger (numberOfValues))
+				readError (f, U"a block of 32-bit floating-point numbers.");
+			if (binario_floatIEEE4msb) {
+				for (integer i = 0; i < numberOfValues; i ++)
+					x [first + i] = floats [i];
+			} else {
+				for (integer i = 0; i < numberOfValues; i ++) {
+					const uint8 *b = & bytes [4 * i];
+					const uint32 bits = (uint32) b [0] << 24 | (uint32) b [1] << 16 | (uint32) b [2] << 8 | (uint32) b [3];
+					if ((bits & 0x7F80'0000) == 0x7F80'0000) {   // Infinity or Not-a-Number
+						x [first + i] = undefined;
+					} else {
+						float value;
+						memcpy (& value, & bits, 4);
+						x [first + i] = value;
+					}
+				}
+			}
+		}
+	} catch (MelderError) {
+		Melder_throw (U"Floating-point numbers not read from binary file.");
+	}
+}
+
+void binputr32array (const double *x, integer n, FILE *f) {
+	if (Melder_debug == 18) {
+		for (integer i = 0; i < n; i ++)
+			binputr32 (x [i], f);
+		return;
+	}
+	try {
+		constexpr integer numberOfValuesPerBlock = binario_numberOfBytesPerBlock / 4;
+		union { float floats [numberOfValuesPerBlock]; uint8 bytes [binario_numberOfBytesPerBlock]; };
+		for (integer first = 0; first < n; first += numberOfValuesPerBlock) {
+			const integer numberOfValues = std::min (n - first, numberOfValuesPerBlock);
+			if (binario_floatIEEE4msb) {
+				for (integer i = 0; i < numberOfValues; i ++)
+					floats [i] = (float) x [first + i];   // convert down, with loss of precision
+			} else {
+				for (integer i = 0; i < numberOfValues; i ++)
+					encodeR32 (x [first + i], & bytes [4 * i]);
+			}
+			if (fwrite (bytes, 4, uinteger (numberOfValues), f) != uinteger (numberOfValues))
+				writeError (U"a block of 32-bit floating-point numbers.");
+		}
+	} catch (MelderError) {
+		Melder_throw (U"Floating-point numbers not written to binary file.");
+	}
+}
+
+void bingetr64array (double *x, integer n, FILE *f) {
+	if (Melder_debug == 18 || Melder_debug == 181) {
+		for (integer i = 0; i < n; i ++)
+			x [i] = bingetr64 (f);
+		return;
+	}
+	try {
+		if (binario_doubleIEEE8msb) {
+			if (fread (x, sizeof (double), uinteger (n), f) != uinteger (n))
+				readError (f, U"a block of 64-bit floating-point numbers.");
+			return;
+		}
+		constexpr integer numberOfValuesPerBlock = binario_numberOfBytesPerBlock / 8;
+		uint8 bytes [binario_numberOfBytesPerBlock];
+		for (integer first = 0; first < n; first += numberOfValuesPerBlock) {
+			const integer numberOfValues = std::min (n - first, numberOfValuesPerBlock);
+			if (fread (bytes, 8, uinteger (numberOfValues), f) != uinteger (numberOfValues))
+				readError (f, U"a block of 64-bit floating-point numbers.");
+			for (integer i = 0; i < numberOfValues; i ++) {
+				const uint8 *b = & bytes [8 * i];
+				const uint64 bits =
+					(uint64) b [0] << 56 | (uint64) b [1] << 48 | (uint64) b [2] << 40 | (uint64) b [3] << 32 |
+					(uint64) b [4] << 24 | (uint64) b [5] << 16 | (uint64) b [6] << 8 | (uint64) b [7];
+				if ((bits & 0x7FF0'0000'0000'0000) == 0x7FF0'0000'0000'0000) {   // Infinity or Not-a-Number
+					x [first + i] = undefined;
+				} else {
+					memcpy (& x [first + i], & bits, 8);
+				}
+			}
+		}
+	} catch (MelderError) {
+		Melder_throw (U"Floating-point numbers not read from binary file.");
+	}
+}
+
+void binputr64array (const double *x, integer n, FILE *f) {
+	if (Melder_debug == 18 || Melder_debug == 181) {
+		for (integer i = 0; i < n; i ++)
+			binputr64 (x [i], f);
+		return;
+	}
+	try {
+		if (binario_doubleIEEE8msb) {
+			if (fwrite (x, sizeof (double), uinteger (n), f) != uinteger (n))
+				writeError (U"a block of 64-bit floating-point numbers.");
+			return;
+		}
+		constexpr integer numberOfValuesPerBlock = binario_numberOfBytesPerBlock / 8;
+		uint8 bytes [binario_numberOfBytesPerBlock];
+		for (integer first = 0; first < n; first += numberOfValuesPerBlock) {
+			const integer numberOfValues = std::min (n - first, numberOfValuesPerBlock);
+			for (integer i = 0; i < numberOfValues; i ++) {
+				const double value = x [first + i];
+				uint64 bits;
+				memcpy (& bits, & value, 8);
+				if (! binario_doubleIEEE8lsb) {
+					if (value == 0.0)
+						bits = 0;   // also for -0.0
+					else if (isnan (value))
+						bits = 0x7FF0'0000'0000'0000;   // +Infinity
+				}
+				uint8 *b = & bytes [8 * i];
+				b [0] = (uint8) (bits >> 56);
+				b [1] = (uint8) (bits >> 48);
+				b [2] = (uint8) (bits >> 40);
+				b [3] = (uint8) (bits >> 32);
+				b [4] = (uint8) (bits >> 24);
+				b [5] = (uint8) (bits >> 16);
+				b [6] = (uint8) (bits >> 8);
+				b [7] = (uint8) bits;
+			}
+			if (fwrite (bytes, 8, uinteger (numberOfValues), f) != uinteger (numberOfValues))
+				writeError (U"a block of 64-bit floating-point numbers.");
+		}
+	} catch (MelderError) {
+		Melder_throw (U"Floating-point numbers not written to binary file.");
+	}
+}
+
 void binputr80 (double x, FILE *f) {
 	try {
 		unsigned char bytes [10];
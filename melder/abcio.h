@@ -170,6 +170,14 @@ double bingetr64 (FILE *f);   void binputr64 (double x, FILE *f);
 */
 double bingetr64LE (FILE *f);   void binputr64LE (double x, FILE *f);   // least significant bit first
 
+void bingetr32array (double *x, integer n, FILE *f);   void binputr32array (const double *x, integer n, FILE *f);
+void bingetr64array (double *x, integer n, FILE *f);   void binputr64array (const double *x, integer n, FILE *f);
+/*
+	Read or write the `n` real numbers x [0] .. x [n - 1] in the same format as `n` calls to
+	bingetr32/binputr32 or bingetr64/binputr64 would, but with one `fread` or `fwrite`
+	per block of thousands of numbers, so that large vectors and matrices are read and written at disk speed.
+*/
+
 double bingetr80 (FILE *f);   void binputr80 (double x, FILE *f);
 /*
 	Read or write a real number from or to 10 bytes in the stream `f`,
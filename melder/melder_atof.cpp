@@ -1,6 +1,6 @@
 /* melder_atof.cpp
  *
- * Copyright (C) 2003-2008,2011,2015-2019 Paul Boersma
+ * Copyright (C) 2003-2008,2011,2015-2020 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -17,6 +17,7 @@
  */
 
 #include "melder.h"
+#include <string>
 
 /**
 	Assume that the next thing that follows is a numeric string,
@@ -105,19 +106,114 @@ bool Melder_isStringNumeric (conststring32 string) noexcept {
 	return true;
 }
 
-double Melder_a8tof (conststring8 string) noexcept {
+/*
+	Most numbers in data files have few significant digits and a small exponent.
+	For those, the value can be computed exactly in double precision (Clinger's fast path):
+	a mantissa below 2^53 and a power of ten up to 10^22 are both exact,
+	so that a single multiplication or division rounds correctly, just as strtod () would.
+	Return false if the number is not of this kind.
+*/
+template <typename T>
+static bool fastStringToDouble (const T *string, double *out_value) noexcept {
+	static const double powersOfTen [] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10,
+			1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+	const T *p = & string [0];
+	while (Melder_isAsciiHorizontalOrVerticalSpace (*p))
+		p ++;
+	const bool isNegative = ( *p == '-' );
+	if (*p == '+' || *p == '-')
+		p ++;
+	uint64 mantissa = 0;
+	integer numberOfSignificantDigits = 0, exponent = 0;
+	for (; Melder_isAsciiDecimalNumber (*p); p ++) {
+		if (numberOfSignificantDigits == 19)
+			return false;
+		mantissa = 10 * mantissa + uint64 (*p - '0');
+		if (mantissa != 0)
+			numberOfSignificantDigits ++;
+	}
+	if (*p == '.')
+		for (p ++; Melder_isAsciiDecimalNumber (*p); p ++) {
+			if (numberOfSignificantDigits == 19)
+				return false;
+			mantissa = 10 * mantissa + uint64 (*p - '0');
+			if (mantissa != 0)
+				numberOfSignificantDigits ++;
+			exponent --;
+		}
+	if (*p == 'e' || *p == 'E') {
+		p ++;
+		const bool exponentIsNegative = ( *p == '-' );
+		if (*p == '+' || *p == '-')
+			p ++;
+		integer explicitExponent = 0;
+		for (; Melder_isAsciiDecimalNumber (*p); p ++) {
+			if (explicitExponent > 1000)
+				return false;
+			explicitExponent = 10 * explicitExponent + (*p - '0');
+		}
+		exponent += ( exponentIsNegative ? - explicitExponent : explicitExponent );
+	}
+	if (mantissa > (uint64 (1) << 53) || exponent < -22 || exponent > 22)
+		return false;
+	double value = double (mantissa);
+	if (exponent < 0)
+		value /= powersOfTen [- exponent];
+	else
+		value *= powersOfTen [exponent];
+	*out_value = ( isNegative ? - value : value );
+	return true;
+}
+
+template <typename T>
+static double stringToDouble (const T *string) noexcept {
 	if (! string)
 		return undefined;
-	const char *p = findEndOfNumericString (string);
-	bool weFoundANumber = !! p;
+	const T *end = findEndOfNumericString (string);
+	bool weFoundANumber = !! end;
 	if (! weFoundANumber)
 		return undefined;
-	Melder_assert (p - & string [0] > 0);
-	return p [-1] == '%' ? 0.01 * strtod (string, nullptr) : strtod (string, nullptr);
+	Melder_assert (end - & string [0] > 0);
+	const bool isPercentage = ( end [-1] == '%' );
+	/*
+		strtod () would also read some things that findEndOfNumericString () stops at, such as "0x1A";
+		we leave those to strtod (), as before.
+	*/
+	const bool strtodCouldReadOn = ( *end == 'x' || *end == 'X' );
+	double value;
+	if (strtodCouldReadOn || ! fastStringToDouble (string, & value)) {
+		if constexpr (sizeof (T) == sizeof (char)) {
+			value = strtod ((const char *) string, nullptr);
+		} else {
+			/*
+				strtod () reads ASCII characters only, so a plain narrowing copy of the ASCII part is enough.
+				We don't use a static buffer, so that this can be called from several threads at once.
+			*/
+			integer length = 0;
+			while (string [length] != '\0' && string [length] < 128)
+				length ++;
+			char buffer [100];
+			std::string longBuffer;
+			char *ascii = buffer;
+			if (length >= integer (sizeof buffer)) {
+				longBuffer. resize (uinteger (length));
+				ascii = & longBuffer [0];
+			}
+			for (integer i = 0; i < length; i ++)
+				ascii [i] = char (string [i]);
+			ascii [length] = '\0';
+			value = strtod (ascii, nullptr);
+		}
+	}
+	return isPercentage ? 0.01 * value : value;
+}
+
+double Melder_a8tof (conststring8 string) noexcept {
+	return stringToDouble (string);
 }
 
 double Melder_atof (conststring32 string) noexcept {
-	return Melder_a8tof (Melder_peek32to8 (string));
+	return stringToDouble (string);
 }
 
 int64 Melder_atoi (conststring32 string) noexcept {
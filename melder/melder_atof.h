@@ -2,7 +2,7 @@
 #define _melder_atof_h_
 /* melder_atof.h
  *
- * Copyright (C) 1992-2018 Paul Boersma
+ * Copyright (C) 1992-2018,2020 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -30,6 +30,7 @@ bool Melder_isStringNumeric (conststring32 string) noexcept;
 		"3.14e-3" -> 3.14e-3
 		"15.6%" -> 0.156
 		"fghfghj" -> undefined
+	These functions use no static buffers, so they can be called from several threads at once.
 */
 double Melder_a8tof (conststring8 string) noexcept;
 double Melder_atof (conststring32 string) noexcept;
@@ -880,379 +880,180 @@ static void Melder_readMp3File (FILE *f, MAT buffer) {
 		Melder_throw (U"Error decoding MP3 file.");
 }
 
+/*
+	Bulk decoding of uncompressed samples.
+	The file is read in blocks of about 64 kilobytes; each block is decoded channel by channel,
+	with one tight loop per encoding (assemble the bytes, extend the sign, scale),
+	which the compiler can vectorize and which writes each channel of the buffer contiguously.
+	All scale factors are powers of two, so the values are exactly what a sample-by-sample decoder would give.
+*/
+static double decodedFloat32 (uint32 bits, bool keepInfinityAndNaN) {
+	if ((bits & 0x7F80'0000) == 0x7F80'0000 && ! keepInfinityAndNaN)
+		return undefined;
+	float value;
+	memcpy (& value, & bits, sizeof (value));
+	return value;
+}
+
+static double decodedFloat64 (uint64 bits, bool keepInfinityAndNaN) {
+	if ((bits & 0x7FF0'0000'0000'0000ULL) == 0x7FF0'0000'0000'0000ULL && ! keepInfinityAndNaN)
+		return undefined;
+	double value;
+	memcpy (& value, & bits, sizeof (value));
+	return value;
+}
+
+/*
+	In a truncated file, the last value may be incomplete; for linear 16-, 24- and 32-bit encodings
+	it is decoded as if the missing bytes were zero (decodeIncompleteValue), for other encodings it is set to zero.
+*/
+template <typename Decode>
+static void Melder_readAudioToFloat_bulk (FILE *f, MAT buffer, integer numberOfBytesPerValue, bool decodeIncompleteValue,
+	conststring32 sampleDescription, Decode decode)
+{
+	const integer numberOfChannels = buffer.nrow, numberOfSamples = buffer.ncol;
+	const integer numberOfBytesPerFrame = numberOfChannels * numberOfBytesPerValue;
+	const integer numberOfFramesPerBlock = std::max (integer (1), integer (65536) / numberOfBytesPerFrame);
+	autovector <uint8> block = newvectorraw <uint8> (numberOfFramesPerBlock * numberOfBytesPerFrame);
+	for (integer firstSample = 1; firstSample <= numberOfSamples; firstSample += numberOfFramesPerBlock) {
+		const integer numberOfFrames = std::min (numberOfFramesPerBlock, numberOfSamples - firstSample + 1);
+		const integer numberOfBytes = numberOfFrames * numberOfBytesPerFrame;
+		const integer numberOfBytesRead = integer (fread (& block [1], 1, size_t (numberOfBytes), f));
+		integer numberOfValuesRead = numberOfBytesRead / numberOfBytesPerValue;
+		if (numberOfBytesRead < numberOfBytes) {
+			for (integer ibyte = numberOfBytesRead + 1; ibyte <= numberOfBytes; ibyte ++)
+				block [ibyte] = 0;
+			if (decodeIncompleteValue && numberOfBytesRead % numberOfBytesPerValue != 0)
+				numberOfValuesRead += 1;
+		}
+		for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
+			const integer numberOfFramesRead =   // for this channel; a truncated file can end in the middle of a frame
+				( numberOfValuesRead >= ichan ? (numberOfValuesRead - ichan) / numberOfChannels + 1 : 0 );
+			const uint8 *from = & block [1 + (ichan - 1) * numberOfBytesPerValue];
+			double *to = & buffer [ichan] [firstSample];
+			for (integer iframe = 0; iframe < numberOfFramesRead; iframe ++, from += numberOfBytesPerFrame)
+				to [iframe] = decode (from);
+			if (numberOfBytesRead < numberOfBytes)
+				for (integer iframe = numberOfFramesRead; iframe <= numberOfSamples - firstSample; iframe ++)
+					to [iframe] = 0.0;
+		}
+		if (numberOfBytesRead < numberOfBytes) {
+			Melder_warning (U"File too small (", numberOfChannels, U"-channel ", sampleDescription, U").\n",
+				decodeIncompleteValue ? U"Missing samples were set to zero." : U"Missing samples set to zero.");   // as the sample-by-sample readers said
+			return;
+		}
+	}
+}
+
+/*
+	Calls `action (numberOfBytesPerValue, decodeIncompleteValue, sampleDescription, decode)`
+	with the decoder of one value of an uncompressed encoding.
+	Returns false for compressed and unknown encodings.
+*/
+template <typename Action>
+static bool Melder_callWithDecoder (int encoding, Action action) {
+	static const uint16 byteOrderTest = 1;
+	const bool machineIsLittleEndian = ( * (const uint8 *) & byteOrderTest == 1 );
+	/*
+		Infinities and NaNs in floating-point files survive only if the file has the byte order of this machine,
+		just as with bingetr32 () and its relatives.
+	*/
+	const bool keepInfinityAndNaN_native = ( Melder_debug != 18 );
+	switch (encoding) {
+		case Melder_LINEAR_8_SIGNED:
+			action (1, false, U"8-bit", [] (const uint8 *bytes) {
+				return (int8) bytes [0] * (1.0 / 128);
+			});
+			return true;
+		case Melder_LINEAR_8_UNSIGNED:
+			action (1, false, U"8-bit", [] (const uint8 *bytes) {
+				return bytes [0] * (1.0 / 128) - 1.0;
+			});
+			return true;
+		case Melder_LINEAR_16_BIG_ENDIAN:
+			action (2, true, U"16-bit", [] (const uint8 *bytes) {
+				return (int16) (uint16) ((uint16) ((uint16) bytes [0] << 8) | (uint16) bytes [1]) * (1.0 / 32768);
+			});
+			return true;
+		case Melder_LINEAR_16_LITTLE_ENDIAN:
+			action (2, true, U"16-bit", [] (const uint8 *bytes) {
+				return (int16) (uint16) ((uint16) ((uint16) bytes [1] << 8) | (uint16) bytes [0]) * (1.0 / 32768);
+			});
+			return true;
+		case Melder_LINEAR_24_BIG_ENDIAN:
+			action (3, true, U"24-bit", [] (const uint8 *bytes) {
+				return (int32) ((uint32) bytes [0] << 24 | (uint32) bytes [1] << 16 | (uint32) bytes [2] << 8) * (1.0 / 32768 / 65536);
+			});
+			return true;
+		case Melder_LINEAR_24_LITTLE_ENDIAN:
+			action (3, true, U"24-bit", [] (const uint8 *bytes) {
+				return (int32) ((uint32) bytes [2] << 24 | (uint32) bytes [1] << 16 | (uint32) bytes [0] << 8) * (1.0 / 32768 / 65536);
+			});
+			return true;
+		case Melder_LINEAR_32_BIG_ENDIAN:
+			action (4, true, U"32-bit", [] (const uint8 *bytes) {
+				return (int32) ((uint32) bytes [0] << 24 | (uint32) bytes [1] << 16 | (uint32) bytes [2] << 8 | (uint32) bytes [3]) * (1.0 / 32768 / 65536);
+			});
+			return true;
+		case Melder_LINEAR_32_LITTLE_ENDIAN:
+			action (4, true, U"32-bit", [] (const uint8 *bytes) {
+				return (int32) ((uint32) bytes [3] << 24 | (uint32) bytes [2] << 16 | (uint32) bytes [1] << 8 | (uint32) bytes [0]) * (1.0 / 32768 / 65536);
+			});
+			return true;
+		case Melder_IEEE_FLOAT_32_BIG_ENDIAN: {
+			const bool keepInfinityAndNaN = ! machineIsLittleEndian && keepInfinityAndNaN_native;
+			action (4, false, U"32-bit floating point", [=] (const uint8 *bytes) {
+				return decodedFloat32 ((uint32) bytes [0] << 24 | (uint32) bytes [1] << 16 | (uint32) bytes [2] << 8 | (uint32) bytes [3],
+						keepInfinityAndNaN);
+			});
+			return true;
+		}
+		case Melder_IEEE_FLOAT_32_LITTLE_ENDIAN: {
+			const bool keepInfinityAndNaN = machineIsLittleEndian && keepInfinityAndNaN_native;
+			action (4, false, U"32-bit floating point", [=] (const uint8 *bytes) {
+				return decodedFloat32 ((uint32) bytes [3] << 24 | (uint32) bytes [2] << 16 | (uint32) bytes [1] << 8 | (uint32) bytes [0],
+						keepInfinityAndNaN);
+			});
+			return true;
+		}
+		case Melder_IEEE_FLOAT_64_BIG_ENDIAN: {
+			const bool keepInfinityAndNaN = ! machineIsLittleEndian && keepInfinityAndNaN_native;
+			action (8, false, U"64-bit floating point", [=] (const uint8 *bytes) {
+				uint64 bits = 0;
+				for (int ibyte = 0; ibyte < 8; ibyte ++)
+					bits = bits << 8 | (uint64) bytes [ibyte];
+				return decodedFloat64 (bits, keepInfinityAndNaN);
+			});
+			return true;
+		}
+		case Melder_IEEE_FLOAT_64_LITTLE_ENDIAN: {
+			const bool keepInfinityAndNaN = machineIsLittleEndian && keepInfinityAndNaN_native;
+			action (8, false, U"64-bit floating point", [=] (const uint8 *bytes) {
+				uint64 bits = 0;
+				for (int ibyte = 7; ibyte >= 0; ibyte --)
+					bits = bits << 8 | (uint64) bytes [ibyte];
+				return decodedFloat64 (bits, keepInfinityAndNaN);
+			});
+			return true;
+		}
+		case Melder_MULAW:
+			action (1, false, U"8-bit " "-law", [] (const uint8 *bytes) {
+				return ulaw2linear [bytes [0]] * (1.0 / 32768);
+			});
+			return true;
+		case Melder_ALAW:
+			action (1, false, U"8-bit A-law", [] (const uint8 *bytes) {
+				return alaw2linear [bytes [0]] * (1.0 / 32768);
+			});
+			return true;
+		default:
+			return false;
+	}
+}
+
 void Melder_readAudioToFloat (FILE *f, int encoding, MAT buffer) {
 	try {
-		integer numberOfChannels = buffer.nrow;
-		integer numberOfSamples = buffer.ncol;
 		switch (encoding) {
-			case Melder_LINEAR_8_SIGNED: {
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							int8 value;
-							if (fread (& value, 1, 1, f) < 1) throw MelderError ();
-							buffer [ichan] [isamp] = value * (1.0 / 128);
-						}
-					}
-				} catch (MelderError) {
-					Melder_clearError ();
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel 8-bit).\nMissing samples set to zero.");
-				}
-			} break;
-			case Melder_LINEAR_8_UNSIGNED:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++)
-							buffer [ichan] [isamp] = bingetu8 (f) * (1.0 / 128) - 1.0;
-					}
-				} catch (MelderError) {
-					Melder_clearError ();
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel 8-bit).\nMissing samples set to zero.");
-				}
-				break;
-			case Melder_LINEAR_16_BIG_ENDIAN:
-			case Melder_LINEAR_16_LITTLE_ENDIAN:
-			case Melder_LINEAR_24_BIG_ENDIAN:
-			case Melder_LINEAR_24_LITTLE_ENDIAN:
-			case Melder_LINEAR_32_BIG_ENDIAN:
-			case Melder_LINEAR_32_LITTLE_ENDIAN:
-			{
-				int numberOfBytesPerSamplePerChannel =
-					encoding == Melder_LINEAR_16_BIG_ENDIAN || encoding == Melder_LINEAR_16_LITTLE_ENDIAN ? 2 :
-					encoding == Melder_LINEAR_24_BIG_ENDIAN || encoding == Melder_LINEAR_24_LITTLE_ENDIAN ? 3 : 4;
-				double numberOfBytes_f = (double) numberOfChannels * (double) numberOfSamples * (double) numberOfBytesPerSamplePerChannel;
-				if (isinf (numberOfBytes_f) || numberOfBytes_f > (double) (1LL << 53)) {
-					Melder_throw (U"Cannot read ", numberOfBytes_f, U" bytes, "
-						U"because that crosses the 9-petabyte limit.");
-				}
-				if (numberOfBytes_f > (double) SIZE_MAX) {
-					Melder_throw (U"Cannot read ", numberOfBytes_f, U" bytes. "
-						U"Perhaps try a 64-bit edition of Praat?");
-				}
-				Melder_assert (numberOfBytes_f >= 0.0);
-				size_t numberOfBytes = (size_t) numberOfBytes_f;   // cast is safe because overflow and signedness have been checked
-				uint8 *bytes = (uint8 *) & buffer [numberOfChannels] [numberOfSamples] + sizeof (double) - numberOfBytes;
-				/*
-				 * Read 16-bit data into the last quarter of the buffer,
-				 * or 24-bit data into the last three-eighths of the buffer,
-				 * or 32-bit data into the last half of the buffer.
-				 */
-				size_t numberOfBytesRead = fread (bytes, 1, numberOfBytes, f);
-				if (numberOfChannels == 1) {
-					switch (encoding) {
-						case Melder_LINEAR_16_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								unsigned char byte1 = * bytes ++, byte2 = * bytes ++;
-								int value = (int) (int16) (((uint16) byte1 << 8) | (uint16) byte2);   // extend sign
-								buffer [1] [isamp] = value * (1.0 / 32768);
-							}
-						} break;
-						case Melder_LINEAR_16_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								unsigned char byte1 = * bytes ++, byte2 = * bytes ++;
-								int value = (int) (int16) (((uint16) byte2 << 8) | (uint16) byte1);   // extend sign
-								buffer [1] [isamp] = value * (1.0 / 32768);
-							}
-						} break;
-						case Melder_LINEAR_24_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								unsigned char byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++;
-								int32 value = (int32)
-									((uint32) ((uint32) byte1 << 24) |
-									 (uint32) ((uint32) byte2 << 16) |
-											  ((uint32) byte3 << 8));
-								buffer [1] [isamp] = value * (1.0 / 32768 / 65536);
-							}
-						} break;
-						case Melder_LINEAR_24_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								unsigned char byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++;
-								int32 value = (int32)
-									((uint32) ((uint32) byte3 << 24) |
-									 (uint32) ((uint32) byte2 << 16) |
-											  ((uint32) byte1 << 8));
-								buffer [1] [isamp] = value * (1.0 / 32768 / 65536);
-							}
-						} break;
-						case Melder_LINEAR_32_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								unsigned char byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++, byte4 = * bytes ++;
-								int32 value = (int32)
-									((uint32) ((uint32) byte1 << 24) |
-									 (uint32) ((uint32) byte2 << 16) |
-									 (uint32) ((uint32) byte3 << 8) |
-											   (uint32) byte4);
-								buffer [1] [isamp] = value * (1.0 / 32768 / 65536);
-							}
-						} break;
-						case Melder_LINEAR_32_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								unsigned char byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++, byte4 = * bytes ++;
-								int32 value = (int32)
-									((uint32) ((uint32) byte4 << 24) |
-									 (uint32) ((uint32) byte3 << 16) |
-									 (uint32) ((uint32) byte2 << 8) |
-											   (uint32) byte1);
-								buffer [1] [isamp] = value * (1.0 / 32768 / 65536);
-							}
-						} break;
-					}
-				} else if (numberOfChannels <= (int) sizeof (double) / numberOfBytesPerSamplePerChannel) {
-					switch (encoding) {
-						case Melder_LINEAR_16_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++;
-									int value = (int) (int16) (uint16) ((uint16) ((uint16) byte1 << 8) | (uint16) byte2);
-									buffer [ichan] [isamp] = value * (1.0 / 32768);
-								}
-							}
-						} break;
-						case Melder_LINEAR_16_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++;
-									int value = (int) (int16) (uint16) ((uint16) ((uint16) byte2 << 8) | (uint16) byte1);
-									buffer [ichan] [isamp] = value * (1.0 / 32768);
-								}
-							}
-						} break;
-						case Melder_LINEAR_24_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++;
-									uint32 unsignedValue =
-										(uint32) ((uint32) byte1 << 16) |
-										(uint32) ((uint32) byte2 << 8) |
-												  (uint32) byte3;
-									if ((byte1 & 128) != 0) unsignedValue |= 0xFF000000;   // extend sign
-									buffer [ichan] [isamp] = (int32) unsignedValue * (1.0 / 8388608);
-								}
-							}
-						} break;
-						case Melder_LINEAR_24_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++;
-									uint32 unsignedValue = ((uint32) byte3 << 16) | ((uint32) byte2 << 8) | (uint32) byte1;
-									if ((byte3 & 128) != 0) unsignedValue |= 0xFF000000;
-									buffer [ichan] [isamp] = (int32) unsignedValue * (1.0 / 8388608);
-								}
-							}
-						} break;
-						case Melder_LINEAR_32_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++, byte4 = * bytes ++;
-									int32 value = (int32)
-										((uint32) ((uint32) byte1 << 24) |
-										 (uint32) ((uint32) byte2 << 16) |
-										 (uint32) ((uint32) byte3 << 8) |
-												   (uint32) byte4);
-									buffer [ichan] [isamp] = value * (1.0 / 32768 / 65536);
-								}
-							}
-						} break;
-						case Melder_LINEAR_32_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++, byte4 = * bytes ++;
-									int32 value = (int32)
-										((uint32) ((uint32) byte4 << 24) |
-										 (uint32) ((uint32) byte3 << 16) |
-										 (uint32) ((uint32) byte2 << 8) |
-												   (uint32) byte1);
-									buffer [ichan] [isamp] = value * (1.0 / 32768 / 65536);
-								}
-							}
-						} break;
-					}
-				} else {
-					Melder_assert (sizeof (double) == 8);
-					int32 *ints = (int32 *) & buffer [1] [1];
-					switch (encoding) {
-						case Melder_LINEAR_16_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++;
-									int32 value = (int32)
-										((uint32) ((uint32) byte1 << 24) |
-										 (uint32) ((uint32) byte2 << 16));
-									* ints ++ = value;
-									* ints ++ = 0;   // the marker
-								}
-							}
-						} break;
-						case Melder_LINEAR_16_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++;
-									int32 value = (int32)
-										(((uint32) byte2 << 24) |
-										 ((uint32) byte1 << 16));
-									* ints ++ = value;
-									* ints ++ = 0;   // the marker
-								}
-							}
-						} break;
-						case Melder_LINEAR_24_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++;
-									int32 value = (int32)
-										(((uint32) byte1 << 24) |
-										 ((uint32) byte2 << 16) |
-										 ((uint32) byte3 << 8));
-									* ints ++ = value;
-									* ints ++ = 0;   // the marker
-								}
-							}
-						} break;
-						case Melder_LINEAR_24_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++;
-									int32 value = (int32)
-										(((uint32) byte3 << 24) |
-										 ((uint32) byte2 << 16) |
-										 ((uint32) byte1 << 8));
-									* ints ++ = value;
-									* ints ++ = 0;   // the marker
-								}
-							}
-						} break;
-						case Melder_LINEAR_32_BIG_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++, byte4 = * bytes ++;
-									int32 value = (int32)
-										(((uint32) byte1 << 24) |
-										 ((uint32) byte2 << 16) |
-										 ((uint32) byte3 << 8) |
-										  (uint32) byte4);
-									* ints ++ = value;
-									* ints ++ = 0;   // the marker
-								}
-							}
-						} break;
-						case Melder_LINEAR_32_LITTLE_ENDIAN: {
-							for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-								for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-									uint8 byte1 = * bytes ++, byte2 = * bytes ++, byte3 = * bytes ++, byte4 = * bytes ++;
-									int32 value = (int32)
-										(((uint32) byte4 << 24) |
-										 ((uint32) byte3 << 16) |
-										 ((uint32) byte2 << 8) |
-										  (uint32) byte1);
-									* ints ++ = value;
-									* ints ++ = 0;   // the marker
-								}
-							}
-						}
-					}
-					double *doubles = & buffer [1] [1];
-					integer n = numberOfSamples * numberOfChannels;
-					for (integer i = 0; i < n; i ++) {
-						int32 *valuePosition = (int32 *) & doubles [i];
-						int32 *markerPosition = valuePosition + 1;
-						if (! *markerPosition) {
-							int32 value = *valuePosition;
-							integer ichan = i / numberOfSamples, isamp = i % numberOfSamples;
-							for (integer other = isamp * numberOfChannels + ichan; other != i; ) {
-								int32 *otherValuePosition = (int32 *) & doubles [other];
-								*valuePosition = *otherValuePosition;
-								*markerPosition = 1;
-								valuePosition = otherValuePosition;
-								markerPosition = valuePosition + 1;
-								ichan = other / numberOfSamples, isamp = other % numberOfSamples;
-								other = isamp * numberOfChannels + ichan;
-							}
-							*valuePosition = value;
-							*markerPosition = 1;
-						}
-					}
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							buffer [ichan] [isamp] = * (int32 *) & buffer [ichan] [isamp] * (1.0 / 32768 / 65536);
-						}
-					}
-				}
-				if (numberOfBytesRead < numberOfBytes)
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel ", numberOfBytesPerSamplePerChannel * 8, U"-bit).\n"
-						U"Missing samples were set to zero.");
-			} break;
-			case Melder_IEEE_FLOAT_32_BIG_ENDIAN:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							buffer [ichan] [isamp] = bingetr32 (f);
-						}
-					}
-				} catch (MelderError) {
-					Melder_clearError ();
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel 32-bit floating point).\nMissing samples set to zero.");
-				}
-				break;
-			case Melder_IEEE_FLOAT_32_LITTLE_ENDIAN:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							buffer [ichan] [isamp] = bingetr32LE (f);
-						}
-					}
-				} catch (MelderError) {
-					Melder_clearError ();
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel 32-bit floating point).\nMissing samples set to zero.");
-				}
-				break;
-			case Melder_IEEE_FLOAT_64_BIG_ENDIAN:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							buffer [ichan] [isamp] = bingetr64 (f);
-						}
-					}
-				} catch (MelderError) {
-					Melder_clearError ();
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel 64-bit floating point).\nMissing samples set to zero.");
-				}
-				break;
-			case Melder_IEEE_FLOAT_64_LITTLE_ENDIAN:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							buffer [ichan] [isamp] = bingetr64LE (f);
-						}
-					}
-				} catch (MelderError) {
-					Melder_clearError ();
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel 64-bit floating point).\nMissing samples set to zero.");
-				}
-				break;
-			case Melder_MULAW:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							buffer [ichan] [isamp] = ulaw2linear [bingetu8 (f)] * (1.0 / 32768);
-						}
-					}
-				} catch (MelderError) {
-					Melder_clearError ();
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel 8-bit " "-law).\nMissing samples set to zero.");
-				}
-				break;
-			case Melder_ALAW:
-				try {
-					for (integer isamp = 1; isamp <= numberOfSamples; isamp ++) {
-						for (integer ichan = 1; ichan <= numberOfChannels; ichan ++) {
-							buffer [ichan] [isamp] = alaw2linear [bingetu8 (f)] * (1.0 / 32768);
-						}
-					}
-				} catch (MelderError) {
-					Melder_clearError ();
-					Melder_warning (U"File too small (", numberOfChannels, U"-channel 8-bit A-law).\nMissing samples set to zero.");
-				}
-				break;
 			case Melder_FLAC_COMPRESSION_16:
 			case Melder_FLAC_COMPRESSION_24:
 			case Melder_FLAC_COMPRESSION_32:
@@ -1263,14 +1064,35 @@ void Melder_readAudioToFloat (FILE *f, int encoding, MAT buffer) {
 			case Melder_MPEG_COMPRESSION_32:
 				Melder_readMp3File (f, buffer);
 				break;
-			default:
-				Melder_throw (U"Unknown encoding ", encoding, U".");
+			default: {
+				const bool encodingIsKnown = Melder_callWithDecoder (encoding,
+					[&] (integer numberOfBytesPerValue, bool decodeIncompleteValue, conststring32 sampleDescription, auto decode) {
+						Melder_readAudioToFloat_bulk (f, buffer, numberOfBytesPerValue, decodeIncompleteValue, sampleDescription, decode);
+					}
+				);
+				if (! encodingIsKnown)
+					Melder_throw (U"Unknown encoding ", encoding, U".");
+			}
 		}
 	} catch (MelderError) {
 		Melder_throw (U"Audio samples not read from file.");
 	}
 }
 
+bool Melder_decodeAudioToFloat (const uint8 *bytes, int encoding, MAT buffer) noexcept {
+	return Melder_callWithDecoder (encoding,
+		[&] (integer numberOfBytesPerValue, bool /* decodeIncompleteValue */, conststring32 /* sampleDescription */, auto decode) {
+			const integer numberOfBytesPerFrame = buffer.nrow * numberOfBytesPerValue;
+			for (integer ichan = 1; ichan <= buffer.nrow; ichan ++) {
+				const uint8 *from = bytes + (ichan - 1) * numberOfBytesPerValue;
+				double *to = & buffer [ichan] [1];
+				for (integer iframe = 0; iframe < buffer.ncol; iframe ++, from += numberOfBytesPerFrame)
+					to [iframe] = decode (from);
+			}
+		}
+	);
+}
+
 void Melder_readAudioToShort (FILE *f, integer numberOfChannels, int encoding, short *buffer, integer numberOfSamples) {
 	try {
 		integer n = numberOfSamples * numberOfChannels, i;
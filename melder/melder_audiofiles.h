@@ -68,6 +68,10 @@ int Melder_bytesPerSamplePoint (int encoding);
 void Melder_readAudioToFloat (FILE *f, int encoding, MAT buffer);
 /* Reads channels into buffer [ichannel], which are base-1.
  */
+bool Melder_decodeAudioToFloat (const uint8 *bytes, int encoding, MAT buffer) noexcept;
+/* Decodes buffer.ncol interleaved frames of an uncompressed encoding from memory, with the same values as Melder_readAudioToFloat.
+ * Returns false for compressed and unknown encodings. Does not throw, so it can be called from any thread.
+ */
 void Melder_readAudioToShort (FILE *f, integer numberOfChannels, int encoding, short *buffer, integer numberOfSamples);
 /* If stereo, buffer will contain alternating left and right values.
  * Buffer is base-0.
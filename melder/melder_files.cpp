@@ -872,50 +872,43 @@ autostring32 MelderFile_readText (MelderFile file, autostring8 *string8) {
 			}
 		} else {
 			length = length / 2 - 1;   // Byte Order Mark subtracted. Length = number of UTF-16 codes
+			/*
+				Read all the UTF-16 codes at once, and decode them in memory.
+			*/
+			autostring8 bytes (2 * length);
+			const size_t numberOfBytesRead = fread_multi (bytes.get(), (size_t) (2 * length), f);
+			Melder_require ((int64) numberOfBytesRead == 2 * length,
+				U"The file contains ", 2 * length, U" bytes after the byte-order mark, but we could read only ", numberOfBytesRead, U" of them."
+			);
+			const char8 *codes = (const char8 *) bytes.get();
+			const bool isBigEndian = ( type == 1 );
+			auto getCode = [codes, isBigEndian] (int64 icode) -> char16 {
+				const char8 *code = & codes [2 * icode];
+				return isBigEndian ? (char16) (code [0] << 8 | code [1]) : (char16) (code [1] << 8 | code [0]);
+			};
 			text = autostring32 (length + 1);
-			if (type == 1) {
-				for (int64 i = 0; i < length; i ++) {
-					char16 kar1 = bingetu16 (f);
-					if (kar1 < 0xD800) {
-						text [i] = (char32) kar1;   // convert up without sign extension
-					} else if (kar1 < 0xDC00) {
-						length --;
-						char16 kar2 = bingetu16 (f);
-						if (kar2 >= 0xDC00 && kar2 <= 0xDFFF) {
-							text [i] = (char32) (0x010000 +
-									(char32) (((char32) kar1 & 0x0003FF) << 10) +
-									(char32)  ((char32) kar2 & 0x0003FF));
-						} else {
-							text [i] = UNICODE_REPLACEMENT_CHARACTER;
-						}
-					} else if (kar1 < 0xE000) {
-						text [i] = UNICODE_REPLACEMENT_CHARACTER;
+			const int64 numberOfCodes = length;
+			int64 icode = 0;
+			for (int64 i = 0; i < length; i ++) {
+				char16 kar1 = getCode (icode ++);
+				if (kar1 < 0xD800) {
+					text [i] = (char32) kar1;   // convert up without sign extension
+				} else if (kar1 < 0xDC00) {
+					length --;
+					if (icode >= numberOfCodes)
+						Melder_throw (U"The file ends in the middle of a UTF-16 surrogate pair.");
+					char16 kar2 = getCode (icode ++);
+					if (kar2 >= 0xDC00 && kar2 <= 0xDFFF) {
+						text [i] = (char32) (0x01'0000 +
+							(char32) (((char32) kar1 & 0x00'03FF) << 10) +
+							(char32)  ((char32) kar2 & 0x00'03FF));
 					} else {
-						text [i] = (char32) kar1;   // convert up without sign extension
-					}
-				}
-			} else {
-				for (int64 i = 0; i < length; i ++) {
-					char16 kar1 = bingetu16LE (f);
-					if (kar1 < 0xD800) {
-						text [i] = (char32) kar1;   // convert up without sign extension
-					} else if (kar1 < 0xDC00) {
-						length --;
-						char16 kar2 = bingetu16LE (f);
-						if (kar2 >= 0xDC00 && kar2 <= 0xDFFF) {
-							text [i] = (char32) (0x01'0000 +
-								(char32) (((char32) kar1 & 0x00'03FF) << 10) +
-								(char32)  ((char32) kar2 & 0x00'03FF));
-						} else {
-							text [i] = UNICODE_REPLACEMENT_CHARACTER;
-						}
-					} else if (kar1 < 0xE000) {
 						text [i] = UNICODE_REPLACEMENT_CHARACTER;
-					} else if (kar1 <= 0xFFFF) {
-						text [i] = (char32) kar1;   // convert up without sign extension
-					} else {
-						Melder_fatal (U"MelderFile_readText: unsigned short greater than 0xFFFF: should not occur.");
 					}
+				} else if (kar1 < 0xE000) {
+					text [i] = UNICODE_REPLACEMENT_CHARACTER;
+				} else {
+					text [i] = (char32) kar1;   // convert up without sign extension
 				}
 			}
 			text [length] = U'\0';
@@ -20,6 +20,38 @@
 
 /*** Typed I/O functions for vectors and matrices. ***/
 
+/*
+	Vectors and matrices are contiguous, so they can be read and written as a single array.
+	For most storage types this is done element by element;
+	real numbers, which make up the bulk of large Sounds, Matrices and Spectrograms,
+	are converted in blocks (see abcio.h).
+*/
+#define ELEMENTWISE(T,storage)  \
+	static void binputarray_##storage (const T *x, integer n, FILE *f) { \
+		for (integer i = 0; i < n; i ++) \
+			binput##storage (x [i], f); \
+	} \
+	static void bingetarray_##storage (T *x, integer n, FILE *f) { \
+		for (integer i = 0; i < n; i ++) \
+			x [i] = binget##storage (f); \
+	}
+ELEMENTWISE (signed char, i8)
+ELEMENTWISE (int, i16)
+ELEMENTWISE (long, i32)
+ELEMENTWISE (integer, integer32BE)
+ELEMENTWISE (integer, integer16BE)
+ELEMENTWISE (unsigned char, u8)
+ELEMENTWISE (unsigned int, u16)
+ELEMENTWISE (unsigned long, u32)
+ELEMENTWISE (dcomplex, c64)
+ELEMENTWISE (dcomplex, c128)
+ELEMENTWISE (bool, eb)
+#undef ELEMENTWISE
+static void binputarray_r32 (const double *x, integer n, FILE *f) { binputr32array (x, n, f); }
+static void bingetarray_r32 (double *x, integer n, FILE *f) { bingetr32array (x, n, f); }
+static void binputarray_r64 (const double *x, integer n, FILE *f) { binputr64array (x, n, f); }
+static void bingetarray_r64 (double *x, integer n, FILE *f) { bingetr64array (x, n, f); }
+
 #define FUNCTION(T,storage)  \
 	void vector_writeText_##storage (const constvector<T>& vec, MelderFile file, conststring32 name) { \
 		texputintro (file, name, U" []: ", vec.size >= 1 ? nullptr : U"(empty)", 0,0,0); \
@@ -29,8 +61,7 @@
 		if (feof (file -> filePointer) || ferror (file -> filePointer)) Melder_throw (U"Write error."); \
 	} \
 	void vector_writeBinary_##storage (const constvector<T>& vec, FILE *f) { \
-		for (integer i = 1; i <= vec.size; i ++) \
-			binput##storage (vec [i], f); \
+		binputarray_##storage (vec.cells, vec.size, f); \
 		if (feof (f) || ferror (f)) Melder_throw (U"Write error."); \
 	} \
 	autovector<T> vector_readText_##storage (integer size, MelderReadText text, const char *name) { \
@@ -45,10 +76,8 @@
 		return result; \
 	} \
 	autovector<T> vector_readBinary_##storage (integer size, FILE *f) { \
-		autovector<T> result = newvectorzero<T> (size); \
-		for (integer i = 1; i <= size; i ++) { \
-			result [i] = binget##storage (f); \
-		} \
+		autovector<T> result = newvectorraw<T> (size); \
+		bingetarray_##storage (result.cells, size, f); \
 		return result; \
 	} \
 	void matrix_writeText_##storage (const constmatrix<T>& mat, MelderFile file, conststring32 name) { \
@@ -64,10 +93,7 @@
 		if (feof (file -> filePointer) || ferror (file -> filePointer)) Melder_throw (U"Write error."); \
 	} \
 	void matrix_writeBinary_##storage (const constmatrix<T>& mat, FILE *f) { \
-		for (integer irow = 1; irow <= mat.nrow; irow ++) { \
-			for (integer icol = 1; icol <= mat.ncol; icol ++) \
-				binput##storage (mat [irow] [icol], f); \
-		} \
+		binputarray_##storage (mat.cells, mat.nrow * mat.ncol, f); \
 		if (feof (f) || ferror (f)) Melder_throw (U"Write error."); \
 	} \
 	automatrix<T> matrix_readText_##storage (integer nrow, integer ncol, MelderReadText text, const char *name) { \
@@ -82,9 +108,8 @@
 		return result; \
 	} \
 	automatrix<T> matrix_readBinary_##storage (integer nrow, integer ncol, FILE *f) { \
-		automatrix<T> result = newmatrixzero<T> (nrow, ncol); \
-		for (integer irow = 1; irow <= nrow; irow ++) for (integer icol = 1; icol <= ncol; icol ++) \
-			result [irow] [icol] = binget##storage (f); \
+		automatrix<T> result = newmatrixraw<T> (nrow, ncol); \
+		bingetarray_##storage (result.cells, nrow * ncol, f); \
 		return result; \
 	} \
 	void tensor3_writeText_##storage (const consttensor3<T>& ten3, MelderFile file, conststring32 name) { \
@@ -20,6 +20,9 @@
 #include "NUM2.h"
 #include "Formula.h"
 #include "SSCP.h"
+#include "MelderThread.h"
+#include <atomic>
+#include <unordered_map>
 
 #include "oo_DESTROY.h"
 #include "Table_def.h"
@@ -85,6 +88,11 @@ static autoTableRow TableRow_create (integer numberOfColumns) {
 	return me;
 }
 
+static void Table_forgetNumericColumns (Table me) noexcept {
+	my numericColumns. clear ();
+	my stringGroups. clear ();
+}
+
 void Table_initWithoutColumnNames (Table me, integer numberOfRows, integer numberOfColumns) {
 	if (numberOfColumns < 1)
 		Melder_throw (U"Cannot create table without columns.");
@@ -189,6 +197,7 @@ void Table_removeColumn (Table me, integer columnNumber) {
 			row -> numberOfColumns --;   // maintain invariant
 		}
 		my numberOfColumns --;   // maintain invariant
+		Table_forgetNumericColumns (me);
 	} catch (MelderError) {
 		Melder_throw (me, U": column ", Table_messageColumn (me, columnNumber), U" not removed.");
 	}
@@ -264,6 +273,7 @@ void Table_insertColumn (Table me, integer columnNumber, conststring32 label /*
 		my columnHeaders = thy columnHeaders.move();
 		my rows = thy rows.move();
 		my numberOfColumns ++;   // maintain invariant
+		Table_forgetNumericColumns (me);
 	} catch (MelderError) {
 		Melder_throw (me, U": column not inserted.");
 	}
@@ -350,13 +360,7 @@ void Table_setNumericValue (Table me, integer rowNumber, integer columnNumber, d
 	}
 }
 
-bool Table_isCellNumeric_ErrorFalse (Table me, integer rowNumber, integer columnNumber) {
-	if (rowNumber < 1 || rowNumber > my rows.size)
-		return false;
-	if (columnNumber < 1 || columnNumber > my numberOfColumns)
-		return false;
-	const TableRow row = my rows.at [rowNumber];
-	conststring32 cell = row -> cells [columnNumber]. string.get();
+static bool isCellStringNumeric (conststring32 cell) noexcept {
 	if (! cell)
 		return true;   // namely the value --undefined--
 	/*
@@ -376,6 +380,25 @@ bool Table_isCellNumeric_ErrorFalse (Table me, integer rowNumber, integer column
 	return Melder_isStringNumeric (cell);
 }
 
+bool Table_isCellNumeric_ErrorFalse (Table me, integer rowNumber, integer columnNumber) {
+	if (rowNumber < 1 || rowNumber > my rows.size)
+		return false;
+	if (columnNumber < 1 || columnNumber > my numberOfColumns)
+		return false;
+	const TableRow row = my rows.at [rowNumber];
+	return isCellStringNumeric (row -> cells [columnNumber]. string.get());
+}
+
+/*
+	The value of a numeric cell, as computed by Table_numericize_Assert.
+	Melder_atof () is thread-safe, so this can be called from several threads at once.
+*/
+static double numericCellStringToNumber (conststring32 cell) noexcept {
+	if (! cell || cell [0] == U'\0' || (cell [0] == U'?' && cell [1] == U'\0'))
+		return undefined;
+	return Melder_atof (cell);
+}
+
 bool Table_isColumnNumeric_ErrorFalse (Table me, integer columnNumber) {
 	if (columnNumber < 1 || columnNumber > my numberOfColumns)
 		return false;
@@ -385,74 +408,62 @@ bool Table_isColumnNumeric_ErrorFalse (Table me, integer columnNumber) {
 	return true;
 }
 
-static integer stringCompare_column;
-
-static int stringCompare_NoError (const void *first, const void *second) {
-	const TableRow me = * (TableRow *) first, thee = * (TableRow *) second;
-	const conststring32 firstString = my cells [stringCompare_column]. string.get();
-	const conststring32 secondString = thy cells [stringCompare_column]. string.get();
-	return str32cmp (firstString ? firstString : U"", secondString ? secondString : U"");
-}
-
-static void sortRowsByStrings_Assert (Table me, integer columnNumber) {
-	Melder_assert (columnNumber >= 1 && columnNumber <= my numberOfColumns);
-	stringCompare_column = columnNumber;
-	qsort (& my rows.at [1], (unsigned long) my rows.size, sizeof (TableRow), stringCompare_NoError);
-}
-
-static int indexCompare_NoError (const void *first, const void *second) {
-	TableRow me = * (TableRow *) first, thee = * (TableRow *) second;
-	if (my sortingIndex < thy sortingIndex)
-		return -1;
-	if (my sortingIndex > thy sortingIndex)
-		return +1;
-	return 0;
-}
-
-static void sortRowsByIndex_NoError (Table me) {
-	qsort (& my rows.at [1], (unsigned long) my rows.size, sizeof (TableRow), indexCompare_NoError);
-}
-
 void Table_numericize_Assert (Table me, integer columnNumber) {
 	Melder_assert (columnNumber >= 1 && columnNumber <= my numberOfColumns);
 	if (my columnHeaders [columnNumber]. numericized)
 		return;
+	if (columnNumber <= integer (my numericColumns. size ()))
+		my numericColumns [uinteger (columnNumber - 1)]. reset ();
+	if (columnNumber <= integer (my stringGroups. size ()))
+		my stringGroups [uinteger (columnNumber - 1)]. reset ();
 	if (Table_isColumnNumeric_ErrorFalse (me, columnNumber)) {
 		for (integer irow = 1; irow <= my rows.size; irow ++) {
 			TableRow row = my rows.at [irow];
-			const conststring32 string = row -> cells [columnNumber]. string.get();
-			row -> cells [columnNumber]. number =
-					! string || string [0] == U'\0' || (string [0] == U'?' && string [1] == U'\0') ? undefined :
-					Melder_atof (string);
+			row -> cells [columnNumber]. number = numericCellStringToNumber (row -> cells [columnNumber]. string.get());
 		}
 	} else {
-		integer iunique = 0;
-		conststring32 previousString = nullptr;
+		/*
+			Dictionary encoding: every cell gets the rank of its string
+			among the sorted distinct strings of the column.
+			Finding the distinct strings with a hash table, and sorting only those,
+			is much faster than sorting all the rows on their strings.
+		*/
+		std::unordered_map <std::u32string_view, integer> dictionary;
+		std::vector <conststring32> distinctStrings;
 		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			row -> sortingIndex = irow;
-		}
-		sortRowsByStrings_Assert (me, columnNumber);
+			const conststring32 string = Table_getStringValue_Assert (me, irow, columnNumber);
+			if (dictionary. emplace (string, 0). second)
+				distinctStrings. push_back (string);
+		}
+		std::sort (distinctStrings. begin (), distinctStrings. end (),
+			[] (conststring32 first, conststring32 second) { return str32cmp (first, second) < 0; });
+		for (integer iunique = 1; iunique <= integer (distinctStrings. size ()); iunique ++)
+			dictionary [distinctStrings [uinteger (iunique - 1)]] = iunique;
 		for (integer irow = 1; irow <= my rows.size; irow ++) {
 			TableRow row = my rows.at [irow];
-			conststring32 string = row -> cells [columnNumber]. string.get();
-			if (! string)
-				string = U"";
-			if (! previousString || ! str32equ (string, previousString))
-				iunique ++;
-			row -> cells [columnNumber]. number = iunique;
-			previousString = string;
+			row -> cells [columnNumber]. number = dictionary [Table_getStringValue_Assert (me, irow, columnNumber)];
 		}
-		sortRowsByIndex_NoError (me);
 	}
 	my columnHeaders [columnNumber]. numericized = true;
 }
 
-static void Table_numericize_checkDefined (Table me, integer columnNumber) {
+constVEC Table_getNumericColumn_Assert (Table me, integer columnNumber) {
 	Table_numericize_Assert (me, columnNumber);
-	for (integer irow = 1; irow <= my rows.size; irow ++) {
-		const TableRow row = my rows.at [irow];
-		if (isundef (row -> cells [columnNumber]. number)) {
+	if (integer (my numericColumns. size ()) < my numberOfColumns)
+		my numericColumns. resize (uinteger (my numberOfColumns));
+	autoVEC& numbers = my numericColumns [uinteger (columnNumber - 1)];
+	if (numbers.size != my rows.size) {
+		numbers = newVECraw (my rows.size);
+		for (integer irow = 1; irow <= my rows.size; irow ++)
+			numbers [irow] = my rows.at [irow] -> cells [columnNumber]. number;
+	}
+	return numbers.get();
+}
+
+static void Table_numericize_checkDefined (Table me, integer columnNumber) {
+	const constVEC numbers = Table_getNumericColumn_Assert (me, columnNumber);
+	for (integer irow = 1; irow <= numbers.size; irow ++) {
+		if (isundef (numbers [irow])) {
 			Melder_throw (me, U": the cell in row ", irow,
 				U" of column \"", my columnHeaders [columnNumber]. label ? my columnHeaders [columnNumber]. label.get() : Melder_integer (columnNumber),
 				U"\" is undefined."
@@ -461,6 +472,244 @@ static void Table_numericize_checkDefined (Table me, integer columnNumber) {
 	}
 }
 
+/*
+	Group-by engine.
+	Rows with equal keys are collected into groups with an open-addressing hash table,
+	which takes linear time, whereas sorting the rows by their keys takes n log n time
+	with a comparison of (string) cells for every step.
+	The hash table is kept in the TableGroups, so that rows of other tables can be looked up in it (see Tables_join).
+*/
+
+/*
+	A partition of the rows of a Table into groups of rows that have the same key,
+	i.e. the same contents in one or more key columns.
+	The groups are found with a hash table, which is kept for looking up keys later.
+*/
+struct TableGroups {
+	integer numberOfGroups = 0;
+	autoINTVEC groupOfRow;   // the group number of every row
+	autoINTVEC rowsByGroup;   // all row numbers, group after group, and in their original order within each group
+	autoINTVEC groupStart;   // the rows of group igroup are rowsByGroup [groupStart [igroup] .. groupStart [igroup + 1] - 1]
+	constINTVEC rowsOfGroup (integer igroup) const {
+		return rowsByGroup.part (groupStart [igroup], groupStart [igroup + 1] - 1);
+	}
+	autoINTVEC slotRows;   // the first row of the group in every slot of the hash table, or 0 if the slot is empty
+	std::vector <uint64> slotHashes;   // the hash value of the key of that row
+};
+
+/*
+	The rows grouped by the strings in a column, as cached in the Table (see Table_getStringGroups_Assert).
+*/
+Thing_define (TableStringGroups, Thing) {
+	TableGroups groups;
+};
+Thing_implement (TableStringGroups, Thing, 0);
+
+static uint64 mixHash (uint64 hash) noexcept {
+	/*
+		The finalizer of SplitMix64, which spreads every input bit over all the output bits,
+		so that we can take the slot number from the lower bits.
+	*/
+	hash ^= hash >> 30;
+	hash *= 0xbf58476d1ce4e5b9ULL;
+	hash ^= hash >> 27;
+	hash *= 0x94d049bb133111ebULL;
+	hash ^= hash >> 31;
+	return hash;
+}
+
+static uint64 combineHash (uint64 hash, uint64 valueHash) noexcept {
+	return mixHash (hash + 0x9e3779b97f4a7c15ULL + valueHash);
+}
+
+static uint64 numberHash (double value) noexcept {
+	if (value == 0.0)
+		value = 0.0;   // -0.0 and +0.0 are the same key
+	uint64 bits;
+	memcpy (& bits, & value, sizeof (bits));
+	return bits;
+}
+
+static std::u32string_view cellStringView (Table me, integer rowNumber, integer columnNumber) noexcept {
+	const conststring32 string = my rows.at [rowNumber] -> cells [columnNumber]. string.get();
+	return string ? std::u32string_view (string) : std::u32string_view ();   // an empty cell has the key ""
+}
+
+static uint64 stringHash (std::u32string_view string) noexcept {
+	return std::hash <std::u32string_view> () (string);
+}
+
+static void TableGroups_collectRows (TableGroups *me) {
+	my groupStart = newINTVECzero (my numberOfGroups + 1);
+	for (integer irow = 1; irow <= my groupOfRow.size; irow ++)
+		my groupStart [my groupOfRow [irow]] ++;   // group sizes, for now
+	integer numberOfPrecedingRows = 0;
+	for (integer igroup = 1; igroup <= my numberOfGroups; igroup ++) {
+		const integer groupSize = my groupStart [igroup];
+		my groupStart [igroup] = numberOfPrecedingRows + 1;
+		numberOfPrecedingRows += groupSize;
+	}
+	my groupStart [my numberOfGroups + 1] = numberOfPrecedingRows + 1;
+	my rowsByGroup = newINTVECraw (my groupOfRow.size);
+	autoINTVEC nextPosition = newINTVECcopy (my groupStart.get());
+	for (integer irow = 1; irow <= my groupOfRow.size; irow ++)
+		my rowsByGroup [nextPosition [my groupOfRow [irow]] ++] = irow;
+}
+
+template <typename RowMatches>
+static integer TableGroups_find (const TableGroups *me, uint64 hash, RowMatches rowMatches) {
+	const uint64 slotMask = uint64 (my slotRows.size - 1);
+	for (uint64 islot = hash & slotMask; ; islot = (islot + 1) & slotMask) {
+		const integer representativeRow = my slotRows [integer (islot) + 1];
+		if (representativeRow == 0)
+			return 0;
+		if (my slotHashes [islot] == hash && rowMatches (representativeRow))
+			return my groupOfRow [representativeRow];
+	}
+}
+
+template <typename RowHash, typename RowsHaveEqualKeys>
+static TableGroups groupRows (integer numberOfRows, RowHash rowHash, RowsHaveEqualKeys rowsHaveEqualKeys) {
+	TableGroups result;
+	integer numberOfSlots = 2;
+	while (numberOfSlots < 2 * numberOfRows)
+		numberOfSlots *= 2;   // a power of two, so that the slot number can be found by masking
+	result. slotRows = newINTVECzero (numberOfSlots);
+	result. slotHashes = std::vector <uint64> (uinteger (numberOfSlots));
+	result. groupOfRow = newINTVECraw (numberOfRows);
+	const uint64 slotMask = uint64 (numberOfSlots - 1);
+	for (integer irow = 1; irow <= numberOfRows; irow ++) {
+		const uint64 hash = rowHash (irow);
+		for (uint64 islot = hash & slotMask; ; islot = (islot + 1) & slotMask) {
+			const integer representativeRow = result. slotRows [integer (islot) + 1];
+			if (representativeRow == 0) {
+				result. slotRows [integer (islot) + 1] = irow;
+				result. slotHashes [islot] = hash;
+				result. groupOfRow [irow] = ++ result. numberOfGroups;
+				break;
+			}
+			if (result. slotHashes [islot] == hash && rowsHaveEqualKeys (representativeRow, irow)) {
+				result. groupOfRow [irow] = result. groupOfRow [representativeRow];
+				break;
+			}
+		}
+	}
+	TableGroups_collectRows (& result);
+	return result;
+}
+
+/*
+	Group the rows by the numericized values of the key columns,
+	which is how Table_sortRows_Assert () compares them:
+	text columns by their strings, numeric columns by their numbers.
+	The groups are numbered in the order in which sorting would put them.
+*/
+static TableGroups Table_groupRowsByNumbers_Assert (Table me, constINTVEC columns) {
+	std::vector <constVEC> keys;
+	for (integer icol = 1; icol <= columns.size; icol ++)
+		keys. push_back (Table_getNumericColumn_Assert (me, columns [icol]));
+	TableGroups result = groupRows (my rows.size,
+		[&] (integer irow) {
+			uint64 hash = 0;
+			for (constVEC const& key : keys)
+				hash = combineHash (hash, numberHash (key [irow]));
+			return hash;
+		},
+		[&] (integer irow, integer jrow) {
+			for (constVEC const& key : keys)
+				if (key [irow] != key [jrow])
+					return false;
+			return true;
+		}
+	);
+	/*
+		Renumber the groups in sorted order. There are usually few groups, so this is cheap.
+	*/
+	autoINTVEC sortedGroups = newINTVECraw (result.numberOfGroups);
+	for (integer igroup = 1; igroup <= result.numberOfGroups; igroup ++)
+		sortedGroups [igroup] = igroup;
+	std::sort (sortedGroups.begin(), sortedGroups.end(),
+		[&] (integer igroup, integer jgroup) {
+			const integer irow = result.rowsByGroup [result.groupStart [igroup]];
+			const integer jrow = result.rowsByGroup [result.groupStart [jgroup]];
+			for (constVEC const& key : keys) {
+				const double x = key [irow], y = key [jrow];
+				if (isundef (x) || isundef (y)) {
+					if (isundef (x) != isundef (y))
+						return isundef (y);   // undefined values come last, so that std::sort gets a strict weak ordering
+					continue;
+				}
+				if (x < y)
+					return true;
+				if (x > y)
+					return false;
+			}
+			return false;
+		}
+	);
+	autoINTVEC newGroupNumber = newINTVECraw (result.numberOfGroups);
+	for (integer i = 1; i <= result.numberOfGroups; i ++)
+		newGroupNumber [sortedGroups [i]] = i;
+	for (integer irow = 1; irow <= result.groupOfRow.size; irow ++)
+		result.groupOfRow [irow] = newGroupNumber [result.groupOfRow [irow]];
+	TableGroups_collectRows (& result);
+	return result;
+}
+
+static uint64 Table_rowStringHash (Table me, integer rowNumber, constINTVEC columns) noexcept {
+	uint64 hash = 0;
+	for (integer icol = 1; icol <= columns.size; icol ++)
+		hash = combineHash (hash, stringHash (cellStringView (me, rowNumber, columns [icol])));
+	return hash;
+}
+
+static bool Tables_rowsHaveEqualStrings (Table me, integer myRow, constINTVEC myColumns, Table thee, integer thyRow, constINTVEC thyColumns) noexcept {
+	Melder_assert (myColumns.size == thyColumns.size);
+	for (integer icol = 1; icol <= myColumns.size; icol ++)
+		if (cellStringView (me, myRow, myColumns [icol]) != cellStringView (thee, thyRow, thyColumns [icol]))
+			return false;
+	return true;
+}
+
+/*
+	Group the rows by the exact strings in the key columns.
+	The groups are numbered in the order of their first rows.
+*/
+static TableGroups Table_groupRowsByStrings (Table me, constINTVEC columns) {
+	return groupRows (my rows.size,
+		[&] (integer irow) { return Table_rowStringHash (me, irow, columns); },
+		[&] (integer irow, integer jrow) { return Tables_rowsHaveEqualStrings (me, irow, columns, me, jrow, columns); }
+	);
+}
+
+/*
+	The rows grouped by their exact strings in a column, for instance for group statistics.
+	The result is owned by the Table, and is valid only until the next change to the Table.
+*/
+static TableGroups const& Table_getStringGroups_Assert (Table me, integer columnNumber) {
+	/*
+		The cache is valid under the same conditions as the numeric column cache.
+	*/
+	Table_numericize_Assert (me, columnNumber);
+	if (integer (my stringGroups. size ()) < my numberOfColumns)
+		my stringGroups. resize (uinteger (my numberOfColumns));
+	autoThing& cache = my stringGroups [uinteger (columnNumber - 1)];
+	if (! cache || static_cast <TableStringGroups> (cache.get()) -> groups.groupOfRow.size != my rows.size) {
+		autoTableStringGroups stringGroups = Thing_new (TableStringGroups);
+		integer columns [1] = { columnNumber };
+		stringGroups -> groups = Table_groupRowsByStrings (me, constINTVEC (columns, 1));
+		cache = stringGroups.move();
+	}
+	return static_cast <TableStringGroups> (cache.get()) -> groups;
+}
+
+integer Table_findStringGroup_Assert (Table me, integer columnNumber, conststring32 string) {
+	TableGroups const& groups = Table_getStringGroups_Assert (me, columnNumber);
+	const std::u32string_view key = ( string ? std::u32string_view (string) : std::u32string_view () );
+	return TableGroups_find (& groups, combineHash (0, stringHash (key)),
+		[&] (integer irow) { return cellStringView (me, irow, columnNumber) == key; });
+}
+
 conststring32 Table_getStringValue_Assert (Table me, integer rowNumber, integer columnNumber) {
 	Melder_assert (rowNumber >= 1 && rowNumber <= my rows.size);
 	Melder_assert (columnNumber >= 1 && columnNumber <= my numberOfColumns);
@@ -482,11 +731,10 @@ double Table_getMean (Table me, integer columnNumber) {
 		Table_numericize_checkDefined (me, columnNumber);
 		if (my rows.size < 1)
 			return undefined;
+		const constVEC numbers = Table_getNumericColumn_Assert (me, columnNumber);
 		longdouble sum = 0.0;
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			const TableRow row = my rows.at [irow];
-			sum += row -> cells [columnNumber]. number;
-		}
+		for (integer irow = 1; irow <= numbers.size; irow ++)
+			sum += numbers [irow];
 		return double (sum) / my rows.size;
 	} catch (MelderError) {
 		Melder_throw (me, U": cannot compute mean of column ", columnNumber, U".");
@@ -499,13 +747,11 @@ double Table_getMaximum (Table me, integer columnNumber) {
 		Table_numericize_checkDefined (me, columnNumber);
 		if (my rows.size < 1)
 			return undefined;
-		TableRow firstRow = my rows.at [1];
-		double maximum = firstRow -> cells [columnNumber]. number;
-		for (integer irow = 2; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			if (row -> cells [columnNumber]. number > maximum)
-				maximum = row -> cells [columnNumber]. number;
-		}
+		const constVEC numbers = Table_getNumericColumn_Assert (me, columnNumber);
+		double maximum = numbers [1];
+		for (integer irow = 2; irow <= numbers.size; irow ++)
+			if (numbers [irow] > maximum)
+				maximum = numbers [irow];
 		return maximum;
 	} catch (MelderError) {
 		Melder_throw (me, U": cannot compute maximum of column ", columnNumber, U".");
@@ -518,13 +764,11 @@ double Table_getMinimum (Table me, integer columnNumber) {
 		Table_numericize_checkDefined (me, columnNumber);
 		if (my rows.size < 1)
 			return undefined;
-		TableRow firstRow = my rows.at [1];
-		double minimum = firstRow -> cells [columnNumber]. number;
-		for (integer irow = 2; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			if (row -> cells [columnNumber]. number < minimum)
-				minimum = row -> cells [columnNumber]. number;
-		}
+		const constVEC numbers = Table_getNumericColumn_Assert (me, columnNumber);
+		double minimum = numbers [1];
+		for (integer irow = 2; irow <= numbers.size; irow ++)
+			if (numbers [irow] < minimum)
+				minimum = numbers [irow];
 		return minimum;
 	} catch (MelderError) {
 		Melder_throw (me, U": cannot compute minimum of column ", columnNumber, U".");
@@ -535,18 +779,16 @@ double Table_getGroupMean (Table me, integer columnNumber, integer groupColumnNu
 	try {
 		Table_checkSpecifiedColumnNumberWithinRange (me, columnNumber);
 		Table_numericize_checkDefined (me, columnNumber);
-		integer n = 0;
-		longdouble sum = 0.0;
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			if (Melder_equ (row -> cells [groupColumnNumber]. string.get(), group)) {
-				n += 1;
-				sum += row -> cells [columnNumber]. number;
-			}
-		}
-		if (n < 1)
+		Table_checkSpecifiedColumnNumberWithinRange (me, groupColumnNumber);
+		const constVEC numbers = Table_getNumericColumn_Assert (me, columnNumber);
+		const integer igroup = Table_findStringGroup_Assert (me, groupColumnNumber, group);
+		if (igroup == 0)
 			return undefined;
-		double mean = double (sum) / n;
+		const constINTVEC rowsOfGroup = Table_getStringGroups_Assert (me, groupColumnNumber). rowsOfGroup (igroup);
+		longdouble sum = 0.0;
+		for (integer i = 1; i <= rowsOfGroup.size; i ++)
+			sum += numbers [rowsOfGroup [i]];
+		double mean = double (sum) / rowsOfGroup.size;
 		return mean;
 	} catch (MelderError) {
 		Melder_throw (me, U": cannot compute mean of column ", columnNumber, U" for group \"", group, U"\" of column ", groupColumnNumber, U".");
@@ -559,11 +801,7 @@ double Table_getQuantile (Table me, integer columnNumber, double quantile) {
 		Table_numericize_checkDefined (me, columnNumber);
 		if (my rows.size < 1)
 			return undefined;
-		autoVEC sortingColumn = newVECraw (my rows.size);
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			const TableRow row = my rows.at [irow];
-			sortingColumn [irow] = row -> cells [columnNumber]. number;
-		}
+		autoVEC sortingColumn = newVECcopy (Table_getNumericColumn_Assert (me, columnNumber));
 		VECsort_inplace (sortingColumn.get());
 		return NUMquantile (sortingColumn.get(), quantile);
 	} catch (MelderError) {
@@ -576,10 +814,10 @@ double Table_getStdev (Table me, integer columnNumber) {
 		const double mean = Table_getMean (me, columnNumber);   // already checks for columnNumber and undefined cells
 		if (my rows.size < 2)
 			return undefined;
+		const constVEC numbers = Table_getNumericColumn_Assert (me, columnNumber);
 		longdouble sum = 0.0;
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			double d = row -> cells [columnNumber]. number - mean;
+		for (integer irow = 1; irow <= numbers.size; irow ++) {
+			const double d = numbers [irow] - mean;
 			sum += d * d;
 		}
 		return sqrt (double (sum) / (my rows.size - 1));
@@ -594,20 +832,18 @@ integer Table_drawRowFromDistribution (Table me, integer columnNumber) {
 		Table_numericize_checkDefined (me, columnNumber);
 		if (my rows.size < 1)
 			Melder_throw (me, U": no rows.");
+		const constVEC numbers = Table_getNumericColumn_Assert (me, columnNumber);
 		longdouble total = 0.0;
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			total += row -> cells [columnNumber]. number;
-		}
+		for (integer irow = 1; irow <= numbers.size; irow ++)
+			total += numbers [irow];
 		if (total <= 0.0)
 			Melder_throw (me, U": the total weight of column ", columnNumber, U" is not positive.");
 		integer irow;
 		do {
 			double rand = NUMrandomUniform (0.0, double (total));
 			longdouble sum = 0.0;
-			for (irow = 1; irow <= my rows.size; irow ++) {
-				TableRow row = my rows.at [irow];
-				sum += row -> cells [columnNumber]. number;
+			for (irow = 1; irow <= numbers.size; irow ++) {
+				sum += numbers [irow];
 				if (rand <= sum)
 					break;
 			}
@@ -679,7 +915,6 @@ autoTable Table_collapseRows (Table me, conststring32 factors_string, conststrin
 	conststring32 columnsToAverage_string, conststring32 columnsToMedianize_string,
 	conststring32 columnsToAverageLogarithmically_string, conststring32 columnsToMedianizeLogarithmically_string)
 {
-	bool originalChanged = false;
 	try {
 		Melder_assert (factors_string);
 
@@ -716,9 +951,9 @@ autoTable Table_collapseRows (Table me, conststring32 factors_string, conststrin
 				columnsToAverageLogarithmically.size + columnsToMedianizeLogarithmically.size);
 		Melder_assert (thy numberOfColumns > 0);
 
-		autoVEC sortingColumn;
+		autoVEC medianBuffer;
 		if (columnsToMedianize.size > 0 || columnsToMedianizeLogarithmically.size > 0)
-			sortingColumn = newVECzero (my rows.size);
+			medianBuffer = newVECraw (my rows.size);
 		/*
 			Set the column names. Within the dependent variables, the same name may occur more than once.
 		*/
@@ -758,157 +993,93 @@ autoTable Table_collapseRows (Table me, conststring32 factors_string, conststrin
 			Table_numericize_checkDefined (me, columns [icol]);
 		}
 		/*
-			Remember the present sorting of the original table.
-			(This is safe: the sorting index may change only vacuously when numericizing.)
-			But this cannot be done before the previous block!
-		*/
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			const TableRow row = my rows.at [irow];
-			row -> sortingIndex = irow;
-		}
-		/*
-			We will now sort the original table temporarily, by the factors (independent variables) only.
-		*/
-		Table_sortRows_Assert (me, constINTVEC (columns.cells, factors.size));   /* This works only because the factors come first. */
-		originalChanged = true;
-		/*
-			Find stretches of identical factors.
+			Find the groups of rows with identical factors.
+			The original table stays as it is.
 		*/
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			integer rowmin = irow, rowmax = irow;
-			for (;;) {
-				bool identical = true;
-				if (++ rowmax > my rows.size)
-					break;
-				for (integer icol = 1; icol <= factors.size; icol ++) {
-					if (my rows.at [rowmax] -> cells [columns [icol]]. number !=
-						my rows.at [rowmin] -> cells [columns [icol]]. number)
-					{
-						identical = false;
-						break;
-					}
-				}
-				if (! identical)
-					break;
-			}
-			rowmax --;
-			/*
-				We have the stretch.
-			*/
+		TableGroups groups = Table_groupRowsByNumbers_Assert (me, constINTVEC (columns.cells, factors.size));   // this works only because the factors come first
+		for (integer igroup = 1; igroup <= groups.numberOfGroups; igroup ++) {
+			const constINTVEC rowsOfGroup = groups.rowsOfGroup (igroup);
+			const integer groupSize = rowsOfGroup.size;
 			Table_insertRow (thee.get(), thy rows.size + 1);
 			{// scope
 				integer icol = 0;
 				for (integer i = 1; i <= factors.size; i ++) {
 					++ icol;
 					Table_setStringValue (thee.get(), thy rows.size, icol,
-						my rows.at [rowmin] -> cells [columns [icol]]. string.get());
+						my rows.at [rowsOfGroup [1]] -> cells [columns [icol]]. string.get());
 				}
 				for (integer i = 1; i <= columnsToSum.size; i ++) {
 					++ icol;
+					const constVEC numbers = Table_getNumericColumn_Assert (me, columns [icol]);
 					longdouble sum = 0.0;
-					for (integer jrow = rowmin; jrow <= rowmax; jrow ++)
-						sum += my rows.at [jrow] -> cells [columns [icol]]. number;
+					for (integer j = 1; j <= groupSize; j ++)
+						sum += numbers [rowsOfGroup [j]];
 					Table_setNumericValue (thee.get(), thy rows.size, icol, double (sum));
 				}
 				for (integer i = 1; i <= columnsToAverage.size; i ++) {
 					++ icol;
+					const constVEC numbers = Table_getNumericColumn_Assert (me, columns [icol]);
 					longdouble sum = 0.0;
-					for (integer jrow = rowmin; jrow <= rowmax; jrow ++)
-						sum += my rows.at [jrow] -> cells [columns [icol]]. number;
-					Table_setNumericValue (thee.get(), thy rows.size, icol, double (sum) / (rowmax - rowmin + 1));
+					for (integer j = 1; j <= groupSize; j ++)
+						sum += numbers [rowsOfGroup [j]];
+					Table_setNumericValue (thee.get(), thy rows.size, icol, double (sum) / groupSize);
 				}
 				for (integer i = 1; i <= columnsToMedianize.size; i ++) {
 					++ icol;
-					for (integer jrow = rowmin; jrow <= rowmax; jrow ++)
-						sortingColumn [jrow] = my rows.at [jrow] -> cells [columns [icol]]. number;
-					const VEC part = sortingColumn.part (rowmin, rowmax);
+					const constVEC numbers = Table_getNumericColumn_Assert (me, columns [icol]);
+					const VEC part = medianBuffer.part (1, groupSize);
+					for (integer j = 1; j <= groupSize; j ++)
+						part [j] = numbers [rowsOfGroup [j]];
 					VECsort_inplace (part);
 					const double median = NUMquantile (part, 0.5);
 					Table_setNumericValue (thee.get(), thy rows.size, icol, median);
 				}
 				for (integer i = 1; i <= columnsToAverageLogarithmically.size; i ++) {
 					++ icol;
+					const constVEC numbers = Table_getNumericColumn_Assert (me, columns [icol]);
 					longdouble sum = 0.0;
-					for (integer jrow = rowmin; jrow <= rowmax; jrow ++) {
-						const double value = my rows.at [jrow] -> cells [columns [icol]]. number;
+					for (integer j = 1; j <= groupSize; j ++) {
+						const double value = numbers [rowsOfGroup [j]];
 						if (value <= 0.0) {
 							Melder_throw (
 								U"The cell in column \"", columnsToAverageLogarithmically [i].get(),
-								U"\" of row ", jrow, U" of ", me,
+								U"\" of row ", rowsOfGroup [j], U" of ", me,
 								U" is not positive.\nCannot average logarithmically."
 							);
 						}
 						sum += log (value);
 					}
-					Table_setNumericValue (thee.get(), thy rows.size, icol, exp (double (sum / (rowmax - rowmin + 1))));
+					Table_setNumericValue (thee.get(), thy rows.size, icol, exp (double (sum / groupSize)));
 				}
 				for (integer i = 1; i <= columnsToMedianizeLogarithmically.size; i ++) {
 					++ icol;
-					for (integer jrow = rowmin; jrow <= rowmax; jrow ++) {
-						const double value = my rows.at [jrow] -> cells [columns [icol]]. number;
+					const constVEC numbers = Table_getNumericColumn_Assert (me, columns [icol]);
+					const VEC part = medianBuffer.part (1, groupSize);
+					for (integer j = 1; j <= groupSize; j ++) {
+						const double value = numbers [rowsOfGroup [j]];
 						if (value <= 0.0) {
 							Melder_throw (
 								U"The cell in column \"", columnsToMedianizeLogarithmically [i].get(),
-								U"\" of row ", jrow, U" of ", me,
+								U"\" of row ", rowsOfGroup [j], U" of ", me,
 								U" is not positive.\nCannot medianize logarithmically."
 							);
 						}
-						sortingColumn [jrow] = log (value);
+						part [j] = log (value);
 					}
-					const VEC part = sortingColumn.part (rowmin, rowmax);
 					VECsort_inplace (part);
 					const double median = NUMquantile (part, 0.5);
 					Table_setNumericValue (thee.get(), thy rows.size, icol, exp (median));
 				}
 				Melder_assert (icol == thy numberOfColumns);
 			}
-			irow = rowmax;
 		}
-		if (originalChanged)
-			sortRowsByIndex_NoError (me);   // unsort the original table
 		return thee;
 	} catch (MelderError) {
-		if (originalChanged)
-			sortRowsByIndex_NoError (me);   // unsort the original table   // UGLY
-		throw;
-	}
-}
-
-static autoSTRVEC Table_getLevels_ (Table me, integer column) {
-	try {
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			row -> sortingIndex = irow;
-		}
-		integer columns [1] = { column };
-		Table_sortRows_Assert (me, constINTVEC (columns, 1));
-		integer numberOfLevels = 0;
-		integer irow = 1;
-		while (irow <= my rows.size) {
-			const double value = my rows.at [irow] -> cells [column]. number;
-			numberOfLevels ++;
-			while (++ irow <= my rows.size && my rows.at [irow] -> cells [column]. number == value) {
-				;
-			}
-		}
-		autoSTRVEC result (numberOfLevels);
-		numberOfLevels = 0;
-		irow = 1;
-		while (irow <= my rows.size) {
-			const double value = my rows.at [irow] -> cells [column]. number;
-			result [++ numberOfLevels] = Melder_dup (Table_getStringValue_Assert (me, irow, column));
-			while (++ irow <= my rows.size && my rows.at [irow] -> cells [column]. number == value) { }
-		}
-		sortRowsByIndex_NoError (me);   // unsort the original table
-		return result;
-	} catch (MelderError) {
-		sortRowsByIndex_NoError (me);   // unsort the original table   // UGLY
 		throw;
 	}
 }
 
 autoTable Table_rowsToColumns (Table me, conststring32 factors_string, integer columnToTranspose, conststring32 columnsToExpand_string) {
-	bool originalChanged = false;
 	try {
 		Melder_assert (factors_string);
 
@@ -927,8 +1098,15 @@ autoTable Table_rowsToColumns (Table me, conststring32 factors_string, integer c
 			Melder_throw (U"In order to nest table data, you should supply at least one dependent variable (to expand).");
 		Table_columns_checkExist (me, columnsToExpand_names.get());
 		Table_columns_checkCrossSectionEmpty (factors_names.get(), columnsToExpand_names.get());
-		autoSTRVEC levels_names = Table_getLevels_ (me, columnToTranspose);
-		const integer numberOfLevels = levels_names.size;
+		/*
+			The levels of the column to transpose, in sorted order.
+		*/
+		integer transposeColumns [1] = { columnToTranspose };
+		TableGroups levels = Table_groupRowsByNumbers_Assert (me, constINTVEC (transposeColumns, 1));
+		const integer numberOfLevels = levels.numberOfGroups;
+		autoSTRVEC levels_names (numberOfLevels);
+		for (integer ilevel = 1; ilevel <= numberOfLevels; ilevel ++)
+			levels_names [ilevel] = Melder_dup (Table_getStringValue_Assert (me, levels.rowsOfGroup (ilevel) [1], columnToTranspose));
 		/*
 			Get the column numbers for the factors.
 		*/
@@ -966,76 +1144,106 @@ autoTable Table_rowsToColumns (Table me, conststring32 factors_string, integer c
 			}
 		}
 		/*
-			Remember the present sorting of the original table.
-			(This is safe: the sorting index may change only vacuously when numericizing.)
-			But this cannot be done before the previous blocks that numericize!
-		*/
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			row -> sortingIndex = irow;
-		}
-		/*
-			We will now sort the original table temporarily, by the factors (independent variables) only.
-		*/
-		Table_sortRows_Assert (me, factorColumns.get());
-		originalChanged = true;
-		/*
-			Find stretches of identical factors.
+			Find the groups of rows with identical factors.
+			The original table stays as it is.
 		*/
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			integer rowmin = irow, rowmax = irow;
-			for (;;) {
-				bool identical = true;
-				if (++ rowmax > my rows.size)
-					break;
-				for (integer ifactor = 1; ifactor <= numberOfFactors; ifactor ++) {
-					if (my rows.at [rowmax] -> cells [factorColumns [ifactor]]. number !=
-						my rows.at [rowmin] -> cells [factorColumns [ifactor]]. number)
-					{
-						identical = false;
-						break;
-					}
-				}
-				if (! identical) break;
-			}
-			#if 0
-			if (rowmax - rowmin > numberOfLevels && ! warned) {
-				Melder_warning (U"Some rows of the original table have not been included in the new table. "
-					U"You could perhaps add more factors.");
-				warned = true;
-			}
-			#endif
-			rowmax --;
-			/*
-				We have the stretch.
-			*/
+		TableGroups groups = Table_groupRowsByNumbers_Assert (me, factorColumns.get());
+		for (integer igroup = 1; igroup <= groups.numberOfGroups; igroup ++) {
+			const constINTVEC rowsOfGroup = groups.rowsOfGroup (igroup);
 			Table_insertRow (thee.get(), thy rows.size + 1);
 			TableRow thyRow = thy rows.at [thy rows.size];
 			for (integer ifactor = 1; ifactor <= numberOfFactors; ifactor ++) {
 				Table_setStringValue (thee.get(), thy rows.size, ifactor,
-					my rows.at [rowmin] -> cells [factorColumns [ifactor]]. string.get());
+					my rows.at [rowsOfGroup [1]] -> cells [factorColumns [ifactor]]. string.get());
 			}
 			for (integer iexpand = 1; iexpand <= numberToExpand; iexpand ++) {
-				for (integer jrow = rowmin; jrow <= rowmax; jrow ++) {
-					TableRow myRow = my rows.at [jrow];
-					const double value = myRow -> cells [columnsToExpand [iexpand]]. number;
-					const integer level = Melder_iround (myRow -> cells [columnToTranspose]. number);
+				const constVEC numbers = Table_getNumericColumn_Assert (me, columnsToExpand [iexpand]);
+				for (integer j = 1; j <= rowsOfGroup.size; j ++) {
+					const integer myRow = rowsOfGroup [j];
+					const integer level = levels.groupOfRow [myRow];
 					const integer thyColumn = numberOfFactors + (iexpand - 1) * numberOfLevels + level;
 					if (thyRow -> cells [thyColumn]. string && ! warned) {
 						Melder_warning (U"Some information from the original table has not been included in the new table. "
 							U"You could perhaps add more factors.");
 						warned = true;
 					}
-					Table_setNumericValue (thee.get(), thy rows.size, thyColumn, value);
+					Table_setNumericValue (thee.get(), thy rows.size, thyColumn, numbers [myRow]);
 				}
 			}
-			irow = rowmax;
 		}
-		if (originalChanged) sortRowsByIndex_NoError (me);   // unsort the original table
 		return thee;
 	} catch (MelderError) {
-		if (originalChanged) sortRowsByIndex_NoError (me);   // unsort the original table   // UGLY
-		throw;
+		Melder_throw (me, U": rows not transposed to columns.");
+	}
+}
+
+autoTable Tables_join (Table me, Table thee, conststring32 keyColumns_string) {
+	try {
+		autoSTRVEC keyColumns_names = newSTRVECtokenize (keyColumns_string);
+		const integer numberOfKeyColumns = keyColumns_names.size;
+		if (numberOfKeyColumns < 1)
+			Melder_throw (U"In order to join tables, you should supply at least one key column.");
+		Table_columns_checkExist (me, keyColumns_names.get());
+		Table_columns_checkExist (thee, keyColumns_names.get());
+		autoINTVEC myKeyColumns = newINTVECraw (numberOfKeyColumns), thyKeyColumns = newINTVECraw (numberOfKeyColumns);
+		for (integer ikey = 1; ikey <= numberOfKeyColumns; ikey ++) {
+			myKeyColumns [ikey] = Table_findColumnIndexFromColumnLabel (me, keyColumns_names [ikey].get());
+			thyKeyColumns [ikey] = Table_findColumnIndexFromColumnLabel (thee, keyColumns_names [ikey].get());
+		}
+		/*
+			The new table has all my columns, followed by those columns of thee that are not keys.
+		*/
+		autoINTVEC thyOtherColumns;
+		for (integer icol = 1; icol <= thy numberOfColumns; icol ++) {
+			bool isKey = false;
+			for (integer ikey = 1; ikey <= numberOfKeyColumns; ikey ++)
+				if (thyKeyColumns [ikey] == icol)
+					isKey = true;
+			if (! isKey)
+				* thyOtherColumns. append () = icol;
+		}
+		/*
+			Look up the key of each of my rows in a hash index of thy rows.
+		*/
+		TableGroups thyGroups = Table_groupRowsByStrings (thee, thyKeyColumns.get());
+		autoINTVEC matchingGroup = newINTVECraw (my rows.size);
+		integer numberOfJoinedRows = 0;
+		for (integer irow = 1; irow <= my rows.size; irow ++) {
+			matchingGroup [irow] = TableGroups_find (& thyGroups, Table_rowStringHash (me, irow, myKeyColumns.get()),
+				[&] (integer thyRow) {
+					return Tables_rowsHaveEqualStrings (me, irow, myKeyColumns.get(), thee, thyRow, thyKeyColumns.get());
+				}
+			);
+			if (matchingGroup [irow] != 0)
+				numberOfJoinedRows += thyGroups.rowsOfGroup (matchingGroup [irow]).size;
+		}
+		/*
+			Every combination of one of my rows and one of thy rows with the same key becomes a row of the new table,
+			in the order of my rows, and for each of my rows in the order of thy rows.
+		*/
+		autoTable him = Table_createWithoutColumnNames (numberOfJoinedRows, my numberOfColumns + thyOtherColumns.size);
+		for (integer icol = 1; icol <= my numberOfColumns; icol ++)
+			Table_setColumnLabel (him.get(), icol, my columnHeaders [icol]. label.get());
+		for (integer i = 1; i <= thyOtherColumns.size; i ++)
+			Table_setColumnLabel (him.get(), my numberOfColumns + i, thy columnHeaders [thyOtherColumns [i]]. label.get());
+		integer hisRow = 0;
+		for (integer irow = 1; irow <= my rows.size; irow ++) {
+			if (matchingGroup [irow] == 0)
+				continue;
+			const constINTVEC thyRows = thyGroups.rowsOfGroup (matchingGroup [irow]);
+			for (integer j = 1; j <= thyRows.size; j ++) {
+				hisRow ++;
+				for (integer icol = 1; icol <= my numberOfColumns; icol ++)
+					Table_setStringValue (him.get(), hisRow, icol, Table_getStringValue_Assert (me, irow, icol));
+				for (integer i = 1; i <= thyOtherColumns.size; i ++)
+					Table_setStringValue (him.get(), hisRow, my numberOfColumns + i,
+							Table_getStringValue_Assert (thee, thyRows [j], thyOtherColumns [i]));
+			}
+		}
+		Melder_assert (hisRow == numberOfJoinedRows);
+		return him;
+	} catch (MelderError) {
+		Melder_throw (me, U" & ", thee, U": not joined.");
 	}
 }
 
@@ -1073,6 +1281,7 @@ void Table_sortRows_Assert (Table me, constINTVEC columns) {
 		Table_numericize_Assert (me, columns [icol]);
 	cellCompare_columns = & columns;
 	qsort (& my rows.at [1], (unsigned long) my rows.size, sizeof (TableRow), cellCompare);
+	Table_forgetNumericColumns (me);
 }
 
 void Table_sortRows_string (Table me, conststring32 columns_string) {
@@ -1100,6 +1309,7 @@ void Table_randomizeRows (Table me) noexcept {
 		my rows.at [irow] = my rows.at [jrow];
 		my rows.at [jrow] = tmp;
 	}
+	Table_forgetNumericColumns (me);
 }
 
 void Table_reflectRows (Table me) noexcept {
@@ -1109,6 +1319,7 @@ void Table_reflectRows (Table me) noexcept {
 		my rows.at [irow] = my rows.at [jrow];
 		my rows.at [jrow] = tmp;
 	}
+	Table_forgetNumericColumns (me);
 }
 
 autoTable Tables_append (OrderedOf<structTable>* me) {
@@ -1293,11 +1504,48 @@ void Table_formula_columnRange (Table me, integer fromColumn, integer toColumn,
 	try {
 		Table_checkSpecifiedColumnNumberWithinRange (me, fromColumn);
 		Table_checkSpecifiedColumnNumberWithinRange (me, toColumn);
-		Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_UNKNOWN, true);
+		autoFormulaProgram program = Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_UNKNOWN, true);
 		Formula_Result result;
+		const integer numberOfColumns = toColumn - fromColumn + 1;
+		const integer numberOfCells = my rows.size * numberOfColumns;
+		const integer numberOfThreads = ( Formula_isCellwise (program.get()) ?
+				MelderThread_computeNumberOfThreads (numberOfCells - 1, 10000) : 1 );
+		const bool isVectorizable = Formula_isVectorizable (program.get());
+		if (numberOfCells > 0 && (numberOfThreads > 1 || isVectorizable)) {
+			/*
+				The value of a cell depends on nothing but the cell itself, and is a number.
+				We compute the first cell in this thread, so that any error is reported from here,
+				and the other cells in parallel, in blocks if possible,
+				and otherwise cell by cell, each thread with its own copy of the program.
+				Turning the numbers into cell strings is left to this thread.
+			*/
+			autoVEC values = newVECraw (numberOfCells);
+			Formula_run (program.get(), 1, fromColumn, & result);
+			values [1] = result. numericResult;
+			std::vector <autoFormulaProgram> threadPrograms;
+			if (! isVectorizable)
+				for (integer ithread = 2; ithread <= numberOfThreads; ithread ++)
+					threadPrograms. push_back (Formula_compile (interpreter, me, expression, kFormula_EXPRESSION_TYPE_UNKNOWN, true));
+			MelderThread_parallelFor (numberOfCells - 1, numberOfThreads, [&] (integer ithread, integer firstCell, integer lastCell) {
+				if (isVectorizable) {
+					Formula_runForCells (program.get(), 1, fromColumn, numberOfColumns, firstCell, values. part (1 + firstCell, 1 + lastCell));
+					return;
+				}
+				const FormulaProgram threadProgram = ( ithread == 1 ? program.get() : threadPrograms [uinteger (ithread - 2)].get() );
+				Formula_Result threadResult;
+				for (integer icell = firstCell; icell <= lastCell; icell ++) {   // cell 0 is the first cell
+					Formula_run (threadProgram, 1 + icell / numberOfColumns, fromColumn + icell % numberOfColumns, & threadResult);
+					values [1 + icell] = threadResult. numericResult;
+				}
+			});
+			for (integer irow = 1; irow <= my rows.size; irow ++)
+				for (integer icol = fromColumn; icol <= toColumn; icol ++)
+					Table_setNumericValue (me, irow, icol, values [(irow - 1) * numberOfColumns + (icol - fromColumn) + 1]);
+			return;
+		}
 		for (integer irow = 1; irow <= my rows.size; irow ++) {
 			for (integer icol = fromColumn; icol <= toColumn; icol ++) {
-				Formula_run (irow, icol, & result);
+				Formula_run (program.get(), irow, icol, & result);
 				if (result. expressionType == kFormula_EXPRESSION_TYPE_STRING) {
 					Table_setStringValue (me, irow, icol, result. stringResult.get());
 				} else if (result. expressionType == kFormula_EXPRESSION_TYPE_NUMERIC) {
@@ -1523,34 +1771,26 @@ double Table_getGroupMean_studentT (Table me, integer column, integer groupColum
 	if (out_upperLimit)               *out_upperLimit               = undefined;
 	if (column < 1 || column > my numberOfColumns)
 		return undefined;
-	Table_numericize_Assert (me, column);
-	integer n = 0;
-	longdouble sum = 0.0;
-	for (integer irow = 1; irow <= my rows.size; irow ++) {
-		TableRow row = my rows.at [irow];
-		if (row -> cells [groupColumn]. string) {
-			if (str32equ (row -> cells [groupColumn]. string.get(), group)) {
-				n += 1;
-				sum += row -> cells [column]. number;
-			}
-		}
-	}
-	if (n < 1)
+	if (groupColumn < 1 || groupColumn > my numberOfColumns)
+		return undefined;
+	const constVEC numbers = Table_getNumericColumn_Assert (me, column);
+	const integer igroup = Table_findStringGroup_Assert (me, groupColumn, group);
+	if (igroup == 0)
 		return undefined;
+	const constINTVEC rowsOfGroup = Table_getStringGroups_Assert (me, groupColumn). rowsOfGroup (igroup);
+	const integer n = rowsOfGroup.size;
+	longdouble sum = 0.0;
+	for (integer i = 1; i <= n; i ++)
+		sum += numbers [rowsOfGroup [i]];
 	double mean = double (sum) / n;
 	integer degreesOfFreedom = n - 1;
 	if (out_numberOfDegreesOfFreedom)
 		*out_numberOfDegreesOfFreedom = degreesOfFreedom;
 	if (degreesOfFreedom >= 1 && (out_tFromZero || out_significanceFromZero || out_lowerLimit || out_upperLimit)) {
 		longdouble sumOfSquares = 0.0;
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			const TableRow row = my rows.at [irow];
-			if (row -> cells [groupColumn]. string) {
-				if (str32equ (row -> cells [groupColumn]. string.get(), group)) {
-					const double diff = row -> cells [column]. number - mean;
-					sumOfSquares += diff * diff;
-				}
-			}
+		for (integer i = 1; i <= n; i ++) {
+			const double diff = numbers [rowsOfGroup [i]] - mean;
+			sumOfSquares += diff * diff;
 		}
 		const double standardError = sqrt (double (sumOfSquares) / degreesOfFreedom / n);
 		if (out_tFromZero && standardError != 0.0)
@@ -1578,23 +1818,19 @@ double Table_getGroupDifference_studentT (Table me, integer column, integer grou
 		return undefined;
 	if (groupColumn < 1 || groupColumn > my numberOfColumns)
 		return undefined;
-	Table_numericize_Assert (me, column);
-	integer n1 = 0, n2 = 0;
-	longdouble sum1 = 0.0, sum2 = 0.0;
-	for (integer irow = 1; irow <= my rows.size; irow ++) {
-		TableRow row = my rows.at [irow];
-		if (row -> cells [groupColumn]. string) {
-			if (str32equ (row -> cells [groupColumn]. string.get(), group1)) {
-				n1 ++;
-				sum1 += row -> cells [column]. number;
-			} else if (str32equ (row -> cells [groupColumn]. string.get(), group2)) {
-				n2 ++;
-				sum2 += row -> cells [column]. number;
-			}
-		}
-	}
-	if (n1 < 1 || n2 < 1)
+	const constVEC numbers = Table_getNumericColumn_Assert (me, column);
+	const integer igroup1 = Table_findStringGroup_Assert (me, groupColumn, group1);
+	const integer igroup2 = Table_findStringGroup_Assert (me, groupColumn, group2);
+	if (igroup1 == 0 || igroup2 == 0 || igroup2 == igroup1)
 		return undefined;
+	TableGroups const& groups = Table_getStringGroups_Assert (me, groupColumn);
+	const constINTVEC rowsOfGroup1 = groups. rowsOfGroup (igroup1), rowsOfGroup2 = groups. rowsOfGroup (igroup2);
+	const integer n1 = rowsOfGroup1.size, n2 = rowsOfGroup2.size;
+	longdouble sum1 = 0.0, sum2 = 0.0;
+	for (integer i = 1; i <= n1; i ++)
+		sum1 += numbers [rowsOfGroup1 [i]];
+	for (integer i = 1; i <= n2; i ++)
+		sum2 += numbers [rowsOfGroup2 [i]];
 	const integer degreesOfFreedom = n1 + n2 - 2;
 	if (out_numberOfDegreesOfFreedom)
 		*out_numberOfDegreesOfFreedom = degreesOfFreedom;
@@ -1603,17 +1839,13 @@ double Table_getGroupDifference_studentT (Table me, integer column, integer grou
 	const double difference = mean1 - mean2;
 	if (degreesOfFreedom >= 1 && (out_tFromZero || out_significanceFromZero || out_lowerLimit || out_upperLimit)) {
 		longdouble sumOfSquares = 0.0;
-		for (integer irow = 1; irow <= my rows.size; irow ++) {
-			TableRow row = my rows.at [irow];
-			if (row -> cells [groupColumn]. string) {
-				if (str32equ (row -> cells [groupColumn]. string.get(), group1)) {
-					const double diff = row -> cells [column]. number - mean1;
-					sumOfSquares += diff * diff;
-				} else if (str32equ (row -> cells [groupColumn]. string.get(), group2)) {
-					const double diff = row -> cells [column]. number - mean2;
-					sumOfSquares += diff * diff;
-				}
-			}
+		for (integer i = 1; i <= n1; i ++) {
+			const double diff = numbers [rowsOfGroup1 [i]] - mean1;
+			sumOfSquares += diff * diff;
+		}
+		for (integer i = 1; i <= n2; i ++) {
+			const double diff = numbers [rowsOfGroup2 [i]] - mean2;
+			sumOfSquares += diff * diff;
 		}
 		const double standardError = sqrt (double (sumOfSquares) / degreesOfFreedom * (1.0 / n1 + 1.0 / n2));
 		if (out_tFromZero && standardError != 0.0)
@@ -1638,32 +1870,26 @@ double Table_getGroupDifference_wilcoxonRankSum (Table me, integer column, integ
 		return undefined;
 	if (groupColumn < 1 || groupColumn > my numberOfColumns)
 		return undefined;
-	Table_numericize_Assert (me, column);
-	integer n1 = 0, n2 = 0;
-	for (integer irow = 1; irow <= my rows.size; irow ++) {
-		const TableRow row = my rows.at [irow];
-		if (row -> cells [groupColumn]. string) {
-			if (str32equ (row -> cells [groupColumn]. string.get(), group1))
-				n1 ++;
-			else if (str32equ (row -> cells [groupColumn]. string.get(), group2))
-				n2 ++;
-		}
-	}
+	const constVEC numbers = Table_getNumericColumn_Assert (me, column);
+	const integer igroup1 = Table_findStringGroup_Assert (me, groupColumn, group1);
+	const integer igroup2 = Table_findStringGroup_Assert (me, groupColumn, group2);
+	if (igroup1 == 0 || igroup2 == 0 || igroup2 == igroup1)
+		return undefined;
+	TableGroups const& groups = Table_getStringGroups_Assert (me, groupColumn);
+	const constINTVEC rowsOfGroup1 = groups. rowsOfGroup (igroup1), rowsOfGroup2 = groups. rowsOfGroup (igroup2);
+	const integer n1 = rowsOfGroup1.size, n2 = rowsOfGroup2.size;
 	const integer n = n1 + n2;
-	if (n1 < 1 || n2 < 1 || n < 3)
+	if (n < 3)
 		return undefined;
 	autoTable ranks = Table_createWithoutColumnNames (n, 3);   // column 1 = group, 2 = value, 3 = rank
-	for (integer irow = 1, jrow = 0; irow <= my rows.size; irow ++) {
-		const TableRow row = my rows.at [irow];
-		if (row -> cells [groupColumn]. string) {
-			if (str32equ (row -> cells [groupColumn]. string.get(), group1)) {
-				Table_setNumericValue (ranks.get(), ++ jrow, 1, 1.0);
-				Table_setNumericValue (ranks.get(), jrow, 2, row -> cells [column]. number);
-			} else if (str32equ (row -> cells [groupColumn]. string.get(), group2)) {
-				Table_setNumericValue (ranks.get(), ++ jrow, 1, 2.0);
-				Table_setNumericValue (ranks.get(), jrow, 2, row -> cells [column]. number);
-			}
-		}
+	/*
+		Merge the two groups in the original order of the rows.
+	*/
+	for (integer jrow = 1, i1 = 1, i2 = 1; jrow <= n; jrow ++) {
+		const bool takeFromGroup1 = ( i2 > n2 || (i1 <= n1 && rowsOfGroup1 [i1] < rowsOfGroup2 [i2]) );
+		const integer irow = ( takeFromGroup1 ? rowsOfGroup1 [i1 ++] : rowsOfGroup2 [i2 ++] );
+		Table_setNumericValue (ranks.get(), jrow, 1, takeFromGroup1 ? 1.0 : 2.0);
+		Table_setNumericValue (ranks.get(), jrow, 2, numbers [irow]);
 	}
 	Table_numericize_Assert (ranks.get(), 1);
 	Table_numericize_Assert (ranks.get(), 2);
@@ -1979,6 +2205,46 @@ void Table_writeToSemicolonSeparatedFile (Table me, MelderFile file) {
 	}
 }
 
+/*
+	Reading a table from a text file goes in two steps.
+	First, a quick sequential scan finds out where the rows (or cells) start.
+	Then several threads copy the cells into the table;
+	while doing so, they check whether each column is numeric,
+	so that the numeric columns are numericized right away
+	and do not have to be parsed again by the first query.
+*/
+
+static autostring32 newCellString (const char32 *first, const char32 *end, bool skipQuotes) {
+	integer length = 0;
+	for (const char32 *p = first; p < end; p ++)
+		if (! skipQuotes || *p != U'\"')
+			length ++;
+	autostring32 result (length);
+	integer ichar = 0;
+	for (const char32 *p = first; p < end; p ++)
+		if (! skipQuotes || *p != U'\"')
+			result [ichar ++] = *p;
+	return result;
+}
+
+static void numericizeCellWhileReading (TableCell cell, integer *inout_numberOfNonnumericCells) {
+	if (*inout_numberOfNonnumericCells > 0)
+		return;   // this column is not numeric anyway
+	if (isCellStringNumeric (cell -> string.get()))
+		cell -> number = numericCellStringToNumber (cell -> string.get());
+	else
+		(*inout_numberOfNonnumericCells) ++;
+}
+
+static void Table_numericizeAfterReading (Table me, constINTMAT const& numberOfNonnumericCells) {
+	for (integer icol = 1; icol <= my numberOfColumns; icol ++) {
+		integer numberOfNonnumericCellsInColumn = 0;
+		for (integer ithread = 1; ithread <= numberOfNonnumericCells.nrow; ithread ++)
+			numberOfNonnumericCellsInColumn += numberOfNonnumericCells [ithread] [icol];
+		my columnHeaders [icol]. numericized = ( numberOfNonnumericCellsInColumn == 0 );
+	}
+}
+
 autoTable Table_readFromTableFile (MelderFile file) {
 	try {
 		autostring32 string = MelderFile_readText (file);
@@ -2002,21 +2268,22 @@ autoTable Table_readFromTableFile (MelderFile file) {
 			Melder_throw (U"No columns.");
 
 		/*
-			Count elements.
+			Find the elements.
 		*/
+		autoINTVEC elementStarts;   // offsets into the string
 		p = & string [0];
-		integer numberOfElements = 0;
 		for (;;) {
 			char32 kar = *p++;
 			if (kar == U'\0')
 				break;
 			if (kar == U' ' || kar == U'\t' || kar == U'\n')
 				continue;
-			numberOfElements ++;
+			* elementStarts. append () = p - 1 - & string [0];
 			do { kar = *p++; } while (kar != U' ' && kar != U'\t' && kar != U'\n' && kar != U'\0');
 			if (kar == U'\0')
 				break;
 		}
+		const integer numberOfElements = elementStarts.size;
 
 		/*
 			Check if all columns are complete.
@@ -2033,35 +2300,28 @@ autoTable Table_readFromTableFile (MelderFile file) {
 		/*
 			Read elements.
 		*/
-		p = & string [0];
+		auto endOfElement = [] (const char32 *element) {
+			while (*element != U' ' && *element != U'\t' && *element != U'\n' && *element != U'\0')
+				element ++;
+			return element;
+		};
 		for (integer icol = 1; icol <= numberOfColumns; icol ++) {
-			while (*p == U' ' || *p == U'\t') {
-				Melder_assert (*p != U'\0');
-				p ++;
-			}
-			static MelderString buffer;
-			MelderString_empty (& buffer);
-			while (*p != U' ' && *p != U'\t' && *p != U'\n') {
-				MelderString_appendCharacter (& buffer, *p);
-				p ++;
-			}
-			Table_setColumnLabel (me.get(), icol, buffer.string);
-			MelderString_empty (& buffer);
+			const char32 *label = & string [elementStarts [icol]];
+			my columnHeaders [icol]. label = newCellString (label, endOfElement (label), false);
 		}
-		for (integer irow = 1; irow <= numberOfRows; irow ++) {
-			TableRow row = my rows.at [irow];
-			for (integer icol = 1; icol <= numberOfColumns; icol ++) {
-				while (*p == U' ' || *p == U'\t' || *p == U'\n') { Melder_assert (*p != U'\0'); p ++; }
-				static MelderString buffer;
-				MelderString_empty (& buffer);
-				while (*p != U' ' && *p != U'\t' && *p != U'\n' && *p != U'\0') {
-					MelderString_appendCharacter (& buffer, *p);
-					p ++;
+		const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfRows, 1000);
+		autoINTMAT numberOfNonnumericCells = newINTMATzero (numberOfThreads, numberOfColumns);
+		MelderThread_parallelFor (numberOfRows, numberOfThreads, [&] (integer ithread, integer firstRow, integer lastRow) {
+			for (integer irow = firstRow; irow <= lastRow; irow ++) {
+				TableRow row = my rows.at [irow];
+				for (integer icol = 1; icol <= numberOfColumns; icol ++) {
+					const char32 *element = & string [elementStarts [irow * numberOfColumns + icol]];
+					row -> cells [icol]. string = newCellString (element, endOfElement (element), false);
+					numericizeCellWhileReading (& row -> cells [icol], & numberOfNonnumericCells [ithread] [icol]);
 				}
-				row -> cells [icol]. string = Melder_dup_f (buffer.string);
-				MelderString_empty (& buffer);
 			}
-		}
+		});
+		Table_numericizeAfterReading (me.get(), numberOfNonnumericCells.get());
 		return me;
 	} catch (MelderError) {
 		Melder_throw (U"Table object not read from space-separated text file ", file, U".");
@@ -2075,12 +2335,9 @@ autoTable Table_readFromCharacterSeparatedTextFile (MelderFile file, char32 sepa
 		/*
 			Kill final new-line symbols.
 	 	*/
-		for (int64 length = str32len (string.get());
-		     length > 0 && string [length - 1] == U'\n';
-			 length = str32len (string.get()))
-		{
-			string [length - 1] = U'\0';
-		}
+		integer length = str32len (string.get());
+		while (length > 0 && string [length - 1] == U'\n')
+			string [-- length] = U'\0';
 
 		/*
 			Count columns.
@@ -2095,21 +2352,26 @@ autoTable Table_readFromCharacterSeparatedTextFile (MelderFile file, char32 sepa
 		}
 
 		/*
-			Count rows.
+			Find the rows. A row ends in a new-line symbol that is not within quotes.
 	 	*/
-		integer numberOfRows = 1;
+		autoINTVEC rowStarts;   // offsets into the string
+		* rowStarts. append () = p - & string [0];
+		bool lastCellHasUnmatchedQuote = false;
 	 	{// scope
 			bool withinQuotes = false;
 			for (;;) {
 				char32 kar = *p++;
+				if (kar == U'\0') {
+					lastCellHasUnmatchedQuote = withinQuotes;
+					break;
+				}
 				if (interpretQuotes && kar == U'\"')
 					withinQuotes = ! withinQuotes;
-				if (! withinQuotes) {
-					if (kar == U'\0') break;
-					if (kar == U'\n') numberOfRows ++;
-				}
+				if (! withinQuotes && kar == U'\n')
+					* rowStarts. append () = p - & string [0];
 			}
 		}
+		const integer numberOfRows = rowStarts.size;
 
 		/*
 			Create empty table.
@@ -2134,46 +2396,66 @@ autoTable Table_readFromCharacterSeparatedTextFile (MelderFile file, char32 sepa
 
 		/*
 			Read cells.
+			The threads cannot throw an error about the contents of the file themselves,
+			so they report the first bad row, and we throw afterwards.
 	 	*/
-		for (integer irow = 1; irow <= numberOfRows; irow ++) {
-			TableRow row = my rows.at [irow];
-			for (integer icol = 1; icol <= numberOfColumns; icol ++) {
-				MelderString_empty (& buffer);
-				bool withinQuotes = false;
-				while (*p != U'\0' && (*p != separator && *p != U'\n' || withinQuotes)) {
-					if (interpretQuotes && *p == U'\"') {
-						withinQuotes = ! withinQuotes;
-					} else {
-						MelderString_appendCharacter (& buffer, *p);
+		const integer numberOfThreads = MelderThread_computeNumberOfThreads (numberOfRows, 1000);
+		autoINTMAT numberOfNonnumericCells = newINTMATzero (numberOfThreads, numberOfColumns);
+		std::atomic <integer> firstIncompleteRow (numberOfRows + 1), firstOverfullRow (numberOfRows + 1);
+		auto reportRow = [] (std::atomic <integer> & firstRow, integer irow) {
+			integer current = firstRow;
+			while (irow < current && ! firstRow. compare_exchange_weak (current, irow)) { }
+		};
+		std::atomic <integer> numberOfRowsDone (0);
+		autoMelderProgress progress (U"Reading table...");
+		MelderThread_parallelFor (numberOfRows, numberOfThreads, [&] (integer ithread, integer firstRow, integer lastRow) {
+			for (integer irow = firstRow; irow <= lastRow; irow ++) {
+				TableRow row = my rows.at [irow];
+				const char32 *q = & string [rowStarts [irow]];
+				for (integer icol = 1; icol <= numberOfColumns; icol ++) {
+					const char32 *cellStart = q;
+					bool withinQuotes = false;
+					while (*q != U'\0' && (*q != separator && *q != U'\n' || withinQuotes)) {
+						if (interpretQuotes && *q == U'\"')
+							withinQuotes = ! withinQuotes;
+						q ++;
 					}
-					p ++;
-				}
-				if (*p == U'\0') {
-					if (irow != numberOfRows)
-						Melder_fatal (U"irow ", irow, U", nrow ", numberOfRows, U", icol ", icol, U", ncol ", numberOfColumns);
-					if (icol != numberOfColumns)
-						Melder_throw (U"Last row incomplete.");
-					if (withinQuotes) {
-						if (str32chr (buffer.string, U'\n'))
-							Melder_warning (U"The last cell contains an unmatched double-quote (\") and also multiple lines, "
-									"so perhaps multiple lines were unintentionally combined into one cell. "
-									"The problem may be in row ", irow, U".");
-						else
-							Melder_warning (U"The last cell contains an unmatched double-quote (\"), "
-									"so perhaps multiple cells were unintentionally combined. "
-									"The problem is in row ", irow, U".");
+					row -> cells [icol]. string = newCellString (cellStart, q, interpretQuotes);
+					numericizeCellWhileReading (& row -> cells [icol], & numberOfNonnumericCells [ithread] [icol]);
+					if (icol < numberOfColumns) {
+						if (*q != separator) {
+							reportRow (firstIncompleteRow, irow);
+							break;
+						}
+						q ++;
+					} else if (*q == separator) {
+						reportRow (firstOverfullRow, irow);
 					}
-				} else if (*p == U'\n') {
-					if (icol != numberOfColumns)
-						Melder_throw (U"Row ", irow, U" incomplete.");
-					p ++;
-				} else {
-					Melder_assert (*p == separator);
-					p ++;
 				}
-				row -> cells [icol]. string = Melder_dup (buffer.string);   // BUG? could be null
 			}
+			numberOfRowsDone += lastRow - firstRow + 1;
+			if (ithread == 1)   // only the calling thread can show progress (and be cancelled)
+				Melder_progress (double (numberOfRowsDone) / numberOfRows,
+					U"Reading table: row ", numberOfRowsDone.load (), U" out of ", numberOfRows);
+		});
+		if (firstIncompleteRow <= numberOfRows && firstIncompleteRow <= firstOverfullRow) {
+			if (firstIncompleteRow == numberOfRows)
+				Melder_throw (U"Last row incomplete.");
+			Melder_throw (U"Row ", firstIncompleteRow.load (), U" incomplete.");
+		}
+		if (firstOverfullRow <= numberOfRows)
+			Melder_throw (U"Row ", firstOverfullRow.load (), U" has more than ", numberOfColumns, U" cells.");
+		if (lastCellHasUnmatchedQuote) {
+			if (str32chr (Table_getStringValue_Assert (me.get(), numberOfRows, numberOfColumns), U'\n'))
+				Melder_warning (U"The last cell contains an unmatched double-quote (\") and also multiple lines, "
+						"so perhaps multiple lines were unintentionally combined into one cell. "
+						"The problem may be in row ", numberOfRows, U".");
+			else
+				Melder_warning (U"The last cell contains an unmatched double-quote (\"), "
+						"so perhaps multiple cells were unintentionally combined. "
+						"The problem is in row ", numberOfRows, U".");
 		}
+		Table_numericizeAfterReading (me.get(), numberOfNonnumericCells.get());
 		return me;
 	} catch (MelderError) {
 		Melder_throw (U"Table object not read from character-separated text file ", file, U".");
@@ -2,7 +2,7 @@
 #define _Table_h_
 /* Table.h
  *
- * Copyright (C) 2002-2011,2012,2014,2015,2017 Paul Boersma
+ * Copyright (C) 2002-2011,2012,2014,2015,2017,2020 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -20,6 +20,7 @@
 
 #include "Collection.h"
 #include "Graphics.h"
+#include <vector>
 Thing_declare (Interpreter);
 
 #include "Table_def.h"
@@ -63,6 +64,16 @@ void Table_setNumericValue (Table me, integer row, integer column, double value)
 
 /* For optimizations only (e.g. conversion to Matrix or TableOfReal). */
 void Table_numericize_Assert (Table me, integer columnNumber);
+constVEC Table_getNumericColumn_Assert (Table me, integer columnNumber);
+/*
+	The numericized values of a column, contiguous in memory (element irow belongs to row irow).
+	The result is owned by the Table, and is valid only until the next change to the Table.
+*/
+integer Table_findStringGroup_Assert (Table me, integer columnNumber, conststring32 string);
+/*
+	The number of the group of rows whose string in the column is `string`, or 0 if there is no such group.
+	The groups are numbered in the order of their first rows.
+*/
 
 double Table_getQuantile (Table me, integer column, double quantile);
 double Table_getMean (Table me, integer column);
@@ -117,6 +128,7 @@ autoTable Table_collapseRows (Table me, conststring32 factors_string, conststrin
 	conststring32 columnsToAverage_string, conststring32 columnsToMedianize_string,
 	conststring32 columnsToAverageLogarithmically_string, conststring32 columnsToMedianizeLogarithmically_string);
 autoTable Table_rowsToColumns (Table me, conststring32 factors_string, integer columnToTranspose, conststring32 columnsToExpand_string);
+autoTable Tables_join (Table me, Table thee, conststring32 keyColumns_string);
 autoTable Table_transpose (Table me);
 
 void Table_checkSpecifiedRowNumberWithinRange (Table me, integer rowNumber);
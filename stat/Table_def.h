@@ -1,6 +1,6 @@
 /* Table_def.h
  *
- * Copyright (C) 2002-2007,2011,2012,2014-2019 Paul Boersma
+ * Copyright (C) 2002-2007,2011,2012,2014-2020 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -36,10 +36,6 @@ oo_DEFINE_CLASS (TableRow, Daata)
 	oo_INTEGER (numberOfColumns)
 	oo_STRUCTVEC (TableCell, cells, numberOfColumns)
 
-	#if oo_DECLARING || oo_COPYING
-		oo_INTEGER (sortingIndex)
-	#endif
-
 oo_END_CLASS (TableRow)
 #undef ooSTRUCT
 
@@ -65,6 +61,20 @@ oo_DEFINE_CLASS (Table, Daata)
 	oo_COLLECTION_OF (OrderedOf, rows, TableRow, 0)
 
 	#if oo_DECLARING
+		/*
+			Cache: the numbers of the numericized columns, each column contiguous in memory,
+			so that statistics do not have to visit every TableRow.
+			numericColumns [icol - 1] is valid only if column icol is numericized
+			and the cache has as many elements as there are rows (see Table_getNumericColumn_Assert);
+			it is cleared by every function that changes the order of the rows or columns.
+		*/
+		std::vector <autoVEC> numericColumns;
+		/*
+			Cache: the rows grouped by the strings in a column (see Table_getStringGroups_Assert),
+			valid under the same conditions as numericColumns.
+		*/
+		std::vector <autoThing> stringGroups;   // each a TableStringGroups (see Table.cpp), or null
+
 		void v_info ()
 			override;
 		bool v_hasGetNrow ()
@@ -1,6 +1,6 @@
 /* praat_Stat.cpp
  *
- * Copyright (C) 1992-2019 Paul Boersma
+ * Copyright (C) 1992-2020 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -922,6 +922,15 @@ DIRECT (NEW1_Tables_append) {
 	CONVERT_LIST_END (U"appended")
 }
 
+FORM (NEW1_Tables_join, U"Tables: Join", nullptr) {
+	TEXTFIELD (keyColumns, U"Key columns (rows with the same strings in these columns will be joined):", U"speaker")
+	OK
+DO
+	CONVERT_COUPLE (Table)
+		autoTable result = Tables_join (me, you, keyColumns);
+	CONVERT_COUPLE_END (U"joined")
+}
+
 FORM (NEW_Table_extractRowsWhereColumn_number, U"Table: Extract rows where column (number)", nullptr) {
 	SENTENCE (extractAllRowsWhereColumn___, U"Extract all rows where column...", U"")
 	RADIO_ENUM (kMelder_number, ___is___, U"...is...", kMelder_number::DEFAULT)
@@ -1174,6 +1183,7 @@ void praat_uvafon_stat_init () {
 		praat_addAction1 (classTable, 0, U"To logistic regression...", nullptr, 1, NEW_Table_to_LogisticRegression);
 	praat_addAction1 (classTable, 0, U"Synthesize -", nullptr, 0, nullptr);
 		praat_addAction1 (classTable, 0, U"Append", nullptr, 1, NEW1_Tables_append);
+		praat_addAction1 (classTable, 2, U"Join...", nullptr, 1, NEW1_Tables_join);
 	praat_addAction1 (classTable, 0, U"Generate -", nullptr, 0, nullptr);
 		praat_addAction1 (classTable, 1, U"Draw row from distribution...", nullptr, 1, INTEGER_Table_drawRowFromDistribution);
 	praat_addAction1 (classTable, 0, U"Extract -", nullptr, 0, nullptr);
@@ -30,16 +30,21 @@
 #include "UiPause.h"
 #include "DemoEditor.h"
 
-static Interpreter theInterpreter;
-static autoInterpreter theLocalInterpreter;
-static Daata theSource;
-static conststring32 theExpression;
-static int theLevel = 1;
-#define MAXIMUM_NUMBER_OF_LEVELS  20
-static int theExpressionType [1 + MAXIMUM_NUMBER_OF_LEVELS];
-static bool theOptimize;
-
-typedef struct structFormulaInstruction {
+Thing_implement (FormulaProgram, Thing, 0);
+
+/*
+	The state of the compiler and of the machine.
+	Every thread has its own state, which is bound to the program that is being compiled or run.
+	A compilation or run from within a run (e.g. via runScript) saves and restores the state
+	(see FormulaState below).
+*/
+static thread_local Interpreter theInterpreter;
+static thread_local Daata theSource;
+static thread_local conststring32 theExpression;
+static thread_local int theExpressionType;
+static thread_local bool theOptimize;
+
+struct structFormulaInstruction {
 	int symbol;
 	int position;
 	union {
@@ -49,10 +54,51 @@ typedef struct structFormulaInstruction {
 		Daata object;
 		InterpreterVariable variable;
 	} content;
-} *FormulaInstruction;
+};
 
-static FormulaInstruction lexan, parse;
-static int ilabel, ilexan, iparse, numberOfInstructions, numberOfStringConstants;
+static thread_local FormulaInstruction lexan, parse;   // `lexan` is scratch memory; `parse` is scratch memory while compiling
+static thread_local int ilabel, ilexan, iparse, numberOfInstructions, numberOfStringConstants;
+static thread_local int programPointer;
+static thread_local Stackel theStack;
+static thread_local integer w, wmax;   /* w = stack pointer; */
+
+struct FormulaState {
+	Interpreter interpreter;
+	Daata source;
+	conststring32 expression;
+	int expressionType;
+	bool optimize;
+	FormulaInstruction instructions;
+	int numberOfInstructions, programPointer;
+	Stackel stack;
+	integer w, wmax;
+	FormulaState () {
+		our interpreter = theInterpreter;
+		our source = theSource;
+		our expression = theExpression;
+		our expressionType = theExpressionType;
+		our optimize = theOptimize;
+		our instructions = parse;
+		our numberOfInstructions = ::numberOfInstructions;
+		our programPointer = ::programPointer;
+		our stack = theStack;
+		our w = ::w;
+		our wmax = ::wmax;
+	}
+	~ FormulaState () {
+		theInterpreter = our interpreter;
+		theSource = our source;
+		theExpression = our expression;
+		theExpressionType = our expressionType;
+		theOptimize = our optimize;
+		parse = our instructions;
+		::numberOfInstructions = our numberOfInstructions;
+		::programPointer = our programPointer;
+		theStack = our stack;
+		::w = our w;
+		::wmax = our wmax;
+	}
+};
 
 enum { NO_SYMBOL_,
 
@@ -2133,27 +2179,67 @@ static void Formula_print (FormulaInstruction f) {
 	} while (symbol != END_);
 }
 
-void Formula_compile (Interpreter interpreter, Daata data, conststring32 expression, int expressionType, bool optimize) {
-	theInterpreter = interpreter;
-	if (! theInterpreter) {
-		if (! theLocalInterpreter)
-			theLocalInterpreter = Interpreter_create (nullptr, nullptr);
-		theInterpreter = theLocalInterpreter.get();
-		theInterpreter -> variablesMap. clear ();
+static thread_local FormulaInstruction theParseBuffer;
+
+/*
+	Most programs are small and short-lived (e.g. the expressions on the lines of a script),
+	so a destroyed program leaves its stack and (if small) its instructions to the next program
+	that is compiled or run in the same thread, which saves allocation time.
+*/
+#define SMALL_PROGRAM_CAPACITY  100
+static thread_local FormulaInstruction theSpareSmallInstructions;
+static thread_local Stackel theSpareStack;
+
+void structFormulaProgram :: v_destroy () noexcept {
+	if (our instructions) {
+		if (our numberOfInstructions + 2 <= SMALL_PROGRAM_CAPACITY && ! theSpareSmallInstructions)
+			theSpareSmallInstructions = our instructions;
+		else
+			Melder_free (our instructions);
+	}
+	if (our strings) {
+		for (integer istring = 1; istring <= our numberOfStrings; istring ++)
+			Melder_free (our strings [istring]);
+		Melder_free (our strings);
 	}
+	if (our stack) {
+		if (! theSpareStack)
+			theSpareStack = our stack;   // all elements have been reset at the end of the last run
+		else
+			Melder_free (our stack);
+		our stack = nullptr;
+	}
+	FormulaProgram_Parent :: v_destroy ();
+}
+
+autoFormulaProgram Formula_compile (Interpreter interpreter, Daata data, conststring32 expression, int expressionType, bool optimize) {
+	autoFormulaProgram me = Thing_new (FormulaProgram);
+	if (! interpreter) {
+		autoInterpreter localInterpreter = Interpreter_create (nullptr, nullptr);
+		interpreter = localInterpreter.get();
+		my localInterpreter = localInterpreter.move();
+	}
+	my interpreter = interpreter;
+	my source = data;
+	my expressionType = expressionType;
+	my optimize = optimize;
+
+	FormulaState savedState;   // we may be compiling from within a running formula (e.g. one that called runScript)
+	theInterpreter = interpreter;
 	theSource = data;
 	theExpression = expression;
-	theExpressionType [theLevel] = expressionType;
+	theExpressionType = expressionType;
 	theOptimize = optimize;
 	if (! lexan) {
 		lexan = Melder_calloc_f (struct structFormulaInstruction, 3000);
 		lexan [3000 - 1]. symbol = END_;   // make sure that cleaning up always terminates
 	}
-	if (! parse)
-		parse = Melder_calloc_f (struct structFormulaInstruction, 3000);
+	if (! theParseBuffer)
+		theParseBuffer = Melder_calloc_f (struct structFormulaInstruction, 3000);
+	parse = theParseBuffer;
 
 	/*
-		Clean up strings from the previous call.
+		Clean up strings from a previous call that failed.
 		These strings are in a union, that's why this cannot be done later, when a new string is created.
 	*/
 	if (numberOfStringConstants) {
@@ -2186,6 +2272,122 @@ void Formula_compile (Interpreter interpreter, Daata data, conststring32 express
 	}
 	Formula_removeLabels ();
 	if (Melder_debug == 17) Formula_print (parse);
+
+	/*
+		Object names are looked up during compilation, so a program that refers to objects by name
+		is valid only as long as the list of objects does not change.
+	*/
+	for (ilexan = 1; lexan [ilexan]. symbol != END_; ilexan ++)
+		if (lexan [ilexan]. symbol == MATRIX_ || lexan [ilexan]. symbol == MATRIXSTR_)
+			my refersToObjects = true;
+
+	/*
+		Move the instructions and the strings they refer to into the program.
+		The strings are owned by `lexan`; the instructions in `parse` contain reference copies.
+	*/
+	if (numberOfInstructions + 2 <= SMALL_PROGRAM_CAPACITY) {
+		if (theSpareSmallInstructions) {
+			my instructions = theSpareSmallInstructions;
+			theSpareSmallInstructions = nullptr;
+		} else {
+			my instructions = Melder_malloc (struct structFormulaInstruction, SMALL_PROGRAM_CAPACITY);
+		}
+	} else {
+		my instructions = Melder_malloc (struct structFormulaInstruction, numberOfInstructions + 2);
+	}
+	my numberOfInstructions = numberOfInstructions;
+	for (integer i = 0; i <= numberOfInstructions + 1; i ++)
+		my instructions [i] = parse [i];
+	if (numberOfStringConstants > 0)
+		my strings = Melder_calloc (char32 *, 1 + numberOfStringConstants);
+	for (ilexan = 1; my numberOfStrings < numberOfStringConstants; ilexan ++) {
+		int symbol = lexan [ilexan]. symbol;
+		Melder_assert (symbol != END_);
+		if (symbol == STRING_ ||
+			symbol == VARIABLE_NAME_ ||
+			symbol == INDEXED_NUMERIC_VARIABLE_ ||
+			symbol == INDEXED_STRING_VARIABLE_ ||
+			symbol == CALL_
+		) {
+			my strings [++ my numberOfStrings] = lexan [ilexan]. content.string;
+			lexan [ilexan]. content.string = nullptr;
+		}
+	}
+	numberOfStringConstants = 0;
+	return me;
+}
+
+bool Formula_isCellwise (FormulaProgram me) {
+	for (integer i = 1; i <= my numberOfInstructions; i ++) {
+		switch (my instructions [i]. symbol) {
+			case NUMBER_: case TRUE_: case FALSE_: case NUMERIC_VARIABLE_:
+			case ROW_: case COL_: case X_: case Y_: case SELF0_:
+			case NOT_: case EQ_: case NE_: case LE_: case LT_: case GE_: case GT_:
+			case ADD_: case SUB_: case MUL_: case RDIV_: case IDIV_: case MOD_: case MINUS_: case POWER_: case SQR_:
+			case IFTRUE_: case IFFALSE_: case GOTO_: case LABEL_:
+			case ABS_: case ROUND_: case FLOOR_: case CEILING_: case RECTIFY_:
+			case SQRT_: case SIN_: case COS_: case TAN_: case ARCSIN_: case ARCCOS_: case ARCTAN_: case SINC_: case SINCPI_:
+			case EXP_: case SINH_: case COSH_: case TANH_: case ARCSINH_: case ARCCOSH_: case ARCTANH_:
+			case SIGMOID_: case INV_SIGMOID_: case ERF_: case ERFC_: case GAUSS_P_: case GAUSS_Q_: case INV_GAUSS_Q_:
+			case LOG2_: case LN_: case LOG10_: case LN_GAMMA_:
+			case HERTZ_TO_BARK_: case BARK_TO_HERTZ_: case PHON_TO_DIFFERENCE_LIMENS_: case DIFFERENCE_LIMENS_TO_PHON_:
+			case HERTZ_TO_MEL_: case MEL_TO_HERTZ_: case HERTZ_TO_SEMITONES_: case SEMITONES_TO_HERTZ_:
+			case ERB_: case HERTZ_TO_ERB_: case ERB_TO_HERTZ_:
+			case ARCTAN2_: case MIN_: case MAX_: case IMIN_: case IMAX_:
+				break;
+			default:
+				return false;   // strings, vectors, objects, other cells, random numbers, side effects, loops...
+		}
+	}
+	return true;
+}
+
+/*
+	The depth of the stack of blocks that bulk evaluation (see Formula_runForCells) needs for this program,
+	or 0 if the program cannot be evaluated in bulk. Bulk evaluation runs every instruction once for a whole block of cells,
+	which works only if all cells run through the same instructions, i.e. if there are no jumps.
+*/
+static integer FormulaProgram_getBulkStackDepth (FormulaProgram me) {
+	if (! Formula_isCellwise (me))
+		return 0;
+	integer depth = 0, maximumDepth = 0;
+	for (integer i = 1; i <= my numberOfInstructions; i ++) {
+		const int symbol = my instructions [i]. symbol;
+		switch (symbol) {
+			case NUMBER_: case TRUE_: case FALSE_: case NUMERIC_VARIABLE_:
+			case ROW_: case COL_: case X_: case Y_: case SELF0_:
+				depth += 1;
+				break;
+			case EQ_: case NE_: case LE_: case LT_: case GE_: case GT_:
+			case ADD_: case SUB_: case MUL_: case RDIV_: case IDIV_: case MOD_: case POWER_: case ARCTAN2_:
+				depth -= 1;
+				break;
+			case MIN_: case MAX_: case IMIN_: case IMAX_: {
+				/*
+					The number of arguments is the number that the parser pushed just before the function.
+				*/
+				if (my instructions [i - 1]. symbol != NUMBER_)
+					return 0;
+				const double numberOfArguments = my instructions [i - 1]. content.number;
+				if (numberOfArguments < 1.0 || numberOfArguments != round (numberOfArguments) || numberOfArguments > depth - 1)
+					return 0;
+				depth -= integer (numberOfArguments);
+			} break;
+			case IFTRUE_: case IFFALSE_: case GOTO_: case LABEL_:
+				return 0;   // data-dependent control flow: run cell by cell
+			default:
+				break;   // the remaining cellwise instructions are functions of one argument
+		}
+		if (depth < 1)
+			return 0;
+		if (depth > maximumDepth)
+			maximumDepth = depth;
+	}
+	return ( depth == 1 ? maximumDepth : 0 );
+}
+
+bool Formula_isVectorizable (FormulaProgram me) {
+	return FormulaProgram_getBulkStackDepth (me) > 0;
 }
 
 /*
@@ -2203,12 +2405,8 @@ conststring32 structStackel :: whichText () {
 		U"???";
 }
 
-static int programPointer;
-
 #define Formula_MAXIMUM_STACK_SIZE  1000
 
-static Stackel theStack;
-static integer w, wmax;   /* w = stack pointer; */
 #define pop  & theStack [w --]
 #define topOfStack  & theStack [w]
 inline static void pushNumber (double x) {
@@ -4071,14 +4269,7 @@ static void do_runScript () {
 	Stackel fileName = & theStack [w + 1];
 	if (fileName->which != Stackel_STRING)
 		Melder_throw (U"The first argument to \"runScript\" should be a string (the file name), not ", fileName->whichText());
-	theLevel += 1;
-	try {
-		praat_executeScriptFromFileName (fileName->getString(), numberOfArguments - 1, & theStack [w + 1]);
-		theLevel -= 1;
-	} catch (MelderError) {
-		theLevel -= 1;
-		throw;
-	}
+	praat_executeScriptFromFileName (fileName->getString(), numberOfArguments - 1, & theStack [w + 1]);
 	pushNumber (1);
 }
 static void do_runSystem () {
@@ -6870,14 +7061,28 @@ static double NUMerf (double x) {
 	return 1.0 - NUMerfcc (x);
 }
 
-void Formula_run (integer row, integer col, Formula_Result *result) {
+void Formula_run (FormulaProgram program, integer row, integer col, Formula_Result *result) {
+	if (! program -> stack) {
+		if (theSpareStack) {
+			program -> stack = theSpareStack;
+			theSpareStack = nullptr;
+		} else {
+			program -> stack = Melder_calloc_f (struct structStackel, 1+Formula_MAXIMUM_STACK_SIZE);
+			if (! program -> stack)
+				Melder_throw (U"Out of memory during formula computation.");
+		}
+	}
+	FormulaState savedState;   // we may be running from within another running formula (e.g. one that called runScript)
+	theInterpreter = program -> interpreter;
+	theSource = program -> source;
+	theExpression = nullptr;
+	theExpressionType = program -> expressionType;
+	theOptimize = program -> optimize;
+	parse = program -> instructions;
+	numberOfInstructions = program -> numberOfInstructions;
+	theStack = program -> stack;
 	FormulaInstruction f = parse;
 	programPointer = 1;   // first symbol of the program
-	if (! theStack) {
-		theStack = Melder_calloc_f (struct structStackel, 1+Formula_MAXIMUM_STACK_SIZE);
-		if (! theStack)
-			Melder_throw (U"Out of memory during formula computation.");
-	}
 	w = 0;   // start new stack
 	wmax = 0;   // start new stack
 	try {
@@ -7280,7 +7485,7 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 			Move the result from the stack to `result`.
 		*/
 		result -> reset();
-		if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_NUMERIC) {
+		if (theExpressionType == kFormula_EXPRESSION_TYPE_NUMERIC) {
 			if (theStack [1]. which == Stackel_STRING)
 				Melder_throw (U"Found a string expression instead of a numeric expression.");
 			if (theStack [1]. which == Stackel_NUMERIC_VECTOR)
@@ -7290,7 +7495,7 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 			Melder_assert (theStack [1]. which == Stackel_NUMBER);
 			result -> expressionType = kFormula_EXPRESSION_TYPE_NUMERIC;
 			result -> numericResult = theStack [1]. number;
-		} else if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_STRING) {
+		} else if (theExpressionType == kFormula_EXPRESSION_TYPE_STRING) {
 			if (theStack [1]. which == Stackel_NUMBER)
 				Melder_throw (U"Found a numeric expression (value ", theStack [1]. number, U") instead of a string expression.");
 			if (theStack [1]. which == Stackel_NUMERIC_VECTOR)
@@ -7303,7 +7508,7 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 			result -> stringResult = theStack [1]. moveString();
 			Melder_assert (theStack [1]. which == Stackel_STRING);
 			Melder_assert (! theStack [1]. getString());
-		} else if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR) {
+		} else if (theExpressionType == kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR) {
 			if (theStack [1]. which == Stackel_NUMBER)
 				Melder_throw (U"Found a numeric expression instead of a vector expression.");
 			if (theStack [1]. which == Stackel_STRING)
@@ -7315,7 +7520,7 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 			result -> numericVectorResult = theStack [1]. numericVector;
 			result -> owned = theStack [1]. owned;
 			theStack [1]. owned = false;
-		} else if (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX) {
+		} else if (theExpressionType == kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX) {
 			if (theStack [1]. which == Stackel_NUMBER)
 				Melder_throw (U"Found a numeric expression instead of a matrix expression.");
 			if (theStack [1]. which == Stackel_STRING)
@@ -7328,7 +7533,7 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 			result -> owned = theStack [1]. owned;
 			theStack [1]. owned = false;
 		} else {
-			Melder_assert (theExpressionType [theLevel] == kFormula_EXPRESSION_TYPE_UNKNOWN);
+			Melder_assert (theExpressionType == kFormula_EXPRESSION_TYPE_UNKNOWN);
 			if (theStack [1]. which == Stackel_NUMBER) {
 				result -> expressionType = kFormula_EXPRESSION_TYPE_NUMERIC;
 				result -> numericResult = theStack [1]. number;
@@ -7371,4 +7576,276 @@ case NUMBER_: { pushNumber (f [programPointer]. content.number);
 	}
 }
 
+/*
+	Bulk evaluation.
+	Instead of interpreting the program once for every cell, we interpret it once for a block of cells,
+	so that every instruction becomes a tight loop over the block.
+	Every loop performs exactly the arithmetic of the corresponding do_xxx () above,
+	including the replacement of infinities by `undefined` wherever pushNumber () does that,
+	so that the results are identical to those of Formula_run ().
+	Bulk evaluation changes neither the program nor the thread-local state of the formula interpreter,
+	so several threads can run the same program at the same time.
+*/
+#define BULK_BLOCK_SIZE  256
+
+inline static double bulk_number (double x) {
+	return isdefined (x) ? x : undefined;   // as in pushNumber ()
+}
+
+template <typename FunctionOfOneNumber>
+inline static void bulk_unary (VEC x, FunctionOfOneNumber f) {
+	for (integer i = 1; i <= x.size; i ++)
+		x [i] = bulk_number (f (x [i]));
+}
+
+inline static void bulk_function (VEC x, double (*f) (double)) {
+	for (integer i = 1; i <= x.size; i ++)
+		x [i] = bulk_number (isundef (x [i]) ? undefined : f (x [i]));
+}
+
+template <typename FunctionOfTwoNumbers>
+inline static void bulk_binary (VEC x, constVEC y, FunctionOfTwoNumbers f) {
+	for (integer i = 1; i <= x.size; i ++)
+		x [i] = f (x [i], y [i]);
+}
+
+void Formula_runForCells (FormulaProgram me, integer fromRow, integer fromColumn, integer numberOfColumns,
+	integer firstCell, VEC result)
+{
+	const integer stackDepth = FormulaProgram_getBulkStackDepth (me);
+	Melder_assert (stackDepth > 0);
+	autoMAT stack = newMATraw (stackDepth, BULK_BLOCK_SIZE);
+	autoINTVEC rowNumbers = newINTVECraw (BULK_BLOCK_SIZE), columnNumbers = newINTVECraw (BULK_BLOCK_SIZE);
+	const Daata source = my source;
+	for (integer offset = 0; offset < result.size; offset += BULK_BLOCK_SIZE) {
+		const integer n = std::min (integer (BULK_BLOCK_SIZE), result.size - offset);
+		for (integer i = 1; i <= n; i ++) {
+			const integer icell = firstCell + offset + i - 1;
+			rowNumbers [i] = fromRow + icell / numberOfColumns;
+			columnNumbers [i] = fromColumn + icell % numberOfColumns;
+		}
+		auto block = [&] (integer istack) { return stack.row (istack). part (1, n); };
+		integer top = 0;
+		for (integer iinstruction = 1; iinstruction <= my numberOfInstructions; iinstruction ++) {
+			const structFormulaInstruction& instruction = my instructions [iinstruction];
+			switch (instruction. symbol) {
+				case NUMBER_: {
+					const VEC x = block (++ top);
+					x <<= bulk_number (instruction. content.number);
+				} break; case TRUE_: {
+					const VEC x = block (++ top);
+					x <<= 1.0;
+				} break; case FALSE_: {
+					const VEC x = block (++ top);
+					x <<= 0.0;
+				} break; case NUMERIC_VARIABLE_: {
+					const VEC x = block (++ top);
+					x <<= bulk_number (instruction. content.variable -> numericValue);
+				} break; case ROW_: {
+					const VEC x = block (++ top);
+					for (integer i = 1; i <= n; i ++)
+						x [i] = rowNumbers [i];
+				} break; case COL_: {
+					const VEC x = block (++ top);
+					for (integer i = 1; i <= n; i ++)
+						x [i] = columnNumbers [i];
+				} break; case X_: {
+					const VEC x = block (++ top);
+					for (integer i = 1; i <= n; i ++)
+						x [i] = bulk_number (source -> v_getX (columnNumbers [i]));
+				} break; case Y_: {
+					const VEC x = block (++ top);
+					for (integer i = 1; i <= n; i ++)
+						x [i] = bulk_number (source -> v_getY (rowNumbers [i]));
+				} break; case SELF0_: {
+					const VEC x = block (++ top);
+					if (source -> v_hasGetCell ()) {
+						x <<= bulk_number (source -> v_getCell ());
+					} else if (source -> v_hasGetVector ()) {
+						for (integer i = 1; i <= n; i ++)
+							x [i] = bulk_number (source -> v_getVector (rowNumbers [i], columnNumbers [i]));
+					} else {
+						Melder_assert (source -> v_hasGetMatrix ());
+						for (integer i = 1; i <= n; i ++)
+							x [i] = bulk_number (source -> v_getMatrix (rowNumbers [i], columnNumbers [i]));
+					}
+				} break; case NOT_: {
+					bulk_unary (block (top), [] (double x) { return isundef (x) ? undefined : x == 0.0 ? 1.0 : 0.0; });
+				} break; case EQ_: {
+					const constVEC right = block (top --);
+					bulk_binary (block (top), right, [] (double x, double y) { return NUMequal (x, y) ? 1.0 : 0.0; });
+				} break; case NE_: {
+					const constVEC right = block (top --);
+					bulk_binary (block (top), right, [] (double x, double y) { return NUMequal (x, y) ? 0.0 : 1.0; });
+				} break; case LE_: {
+					const constVEC right = block (top --);
+					bulk_binary (block (top), right, [] (double x, double y) {
+						return isdefined (x) ? ( isdefined (y) && x <= y ? 1.0 : 0.0 ) : ( isdefined (y) ? 0.0 : 1.0 );
+					});
+				} break; case LT_: {
+					const constVEC right = block (top --);
+					bulk_binary (block (top), right, [] (double x, double y) { return isdefined (x) && isdefined (y) && x < y ? 1.0 : 0.0; });
+				} break; case GE_: {
+					const constVEC right = block (top --);
+					bulk_binary (block (top), right, [] (double x, double y) {
+						return isdefined (x) ? ( isdefined (y) && x >= y ? 1.0 : 0.0 ) : ( isdefined (y) ? 0.0 : 1.0 );
+					});
+				} break; case GT_: {
+					const constVEC right = block (top --);
+					bulk_binary (block (top), right, [] (double x, double y) { return isdefined (x) && isdefined (y) && x > y ? 1.0 : 0.0; });
+				} break; case ADD_: {
+					const constVEC right = block (top --);
+					bulk_binary (block (top), right, [] (double x, double y) { return x + y; });   // as in do_add (), without pushNumber ()
+				} break; case SUB_: {
+					const constVEC right = block (top --);
+					bulk_binary (block (top), right, [] (double x, double y) { return x - y; });
+				} break; case MUL_: {
+					const constVEC right = block (top --);
+					bulk_binary (block (top), right, [] (double x, double y) { return x * y; });
+				} break; case RDIV_: {
+					const constVEC right = block (top --);
+					bulk_binary (block (top), right, [] (double x, double y) { return bulk_number (x / y); });
+				} break; case IDIV_: {
+					const constVEC right = block (top --);
+					bulk_binary (block (top), right, [] (double x, double y) { return bulk_number (floor (x / y)); });
+				} break; case MOD_: {
+					const constVEC right = block (top --);
+					bulk_binary (block (top), right, [] (double x, double y) { return bulk_number (x - floor (x / y) * y); });
+				} break; case POWER_: {
+					const constVEC right = block (top --);
+					bulk_binary (block (top), right, [] (double x, double y) {
+						return bulk_number (isundef (x) || isundef (y) ? undefined : pow (x, y));
+					});
+				} break; case ARCTAN2_: {
+					const constVEC right = block (top --);
+					bulk_binary (block (top), right, [] (double x, double y) {
+						return bulk_number (isundef (x) || isundef (y) ? undefined : atan2 (x, y));
+					});
+				} break; case MINUS_: {
+					bulk_unary (block (top), [] (double x) { return - x; });
+				} break; case SQR_: {
+					bulk_unary (block (top), [] (double x) { return isundef (x) ? undefined : x * x; });
+				} break; case ABS_: {
+					bulk_function (block (top), fabs);
+				} break; case ROUND_: {
+					bulk_unary (block (top), [] (double x) { return isundef (x) ? undefined : floor (x + 0.5); });
+				} break; case FLOOR_: {
+					bulk_unary (block (top), [] (double x) { return isundef (x) ? undefined : Melder_roundDown (x); });
+				} break; case CEILING_: {
+					bulk_unary (block (top), [] (double x) { return isundef (x) ? undefined : Melder_roundUp (x); });
+				} break; case RECTIFY_: {
+					bulk_unary (block (top), [] (double x) { return isundef (x) ? undefined : x > 0.0 ? x : 0.0; });
+				} break; case SQRT_: {
+					bulk_unary (block (top), [] (double x) { return isundef (x) || x < 0.0 ? undefined : sqrt (x); });
+				} break; case SIN_: {
+					bulk_function (block (top), sin);
+				} break; case COS_: {
+					bulk_function (block (top), cos);
+				} break; case TAN_: {
+					bulk_function (block (top), tan);
+				} break; case ARCSIN_: {
+					bulk_unary (block (top), [] (double x) { return isundef (x) || fabs (x) > 1.0 ? undefined : asin (x); });
+				} break; case ARCCOS_: {
+					bulk_unary (block (top), [] (double x) { return isundef (x) || fabs (x) > 1.0 ? undefined : acos (x); });
+				} break; case ARCTAN_: {
+					bulk_function (block (top), atan);
+				} break; case SINC_: {
+					bulk_function (block (top), NUMsinc);
+				} break; case SINCPI_: {
+					bulk_function (block (top), NUMsincpi);
+				} break; case EXP_: {
+					bulk_function (block (top), exp);
+				} break; case SINH_: {
+					bulk_function (block (top), sinh);
+				} break; case COSH_: {
+					bulk_function (block (top), cosh);
+				} break; case TANH_: {
+					bulk_function (block (top), tanh);
+				} break; case ARCSINH_: {
+					bulk_function (block (top), NUMarcsinh);
+				} break; case ARCCOSH_: {
+					bulk_function (block (top), NUMarccosh);
+				} break; case ARCTANH_: {
+					bulk_function (block (top), NUMarctanh);
+				} break; case SIGMOID_: {
+					bulk_function (block (top), NUMsigmoid);
+				} break; case INV_SIGMOID_: {
+					bulk_function (block (top), NUMinvSigmoid);
+				} break; case ERF_: {
+					bulk_function (block (top), NUMerf);
+				} break; case ERFC_: {
+					bulk_function (block (top), NUMerfcc);
+				} break; case GAUSS_P_: {
+					bulk_function (block (top), NUMgaussP);
+				} break; case GAUSS_Q_: {
+					bulk_function (block (top), NUMgaussQ);
+				} break; case INV_GAUSS_Q_: {
+					bulk_function (block (top), NUMinvGaussQ);
+				} break; case LOG2_: {
+					bulk_unary (block (top), [] (double x) { return isundef (x) || x <= 0.0 ? undefined : log (x) * NUMlog2e; });
+				} break; case LN_: {
+					bulk_unary (block (top), [] (double x) { return isundef (x) || x <= 0.0 ? undefined : log (x); });
+				} break; case LOG10_: {
+					bulk_unary (block (top), [] (double x) { return isundef (x) || x <= 0.0 ? undefined : log10 (x); });
+				} break; case LN_GAMMA_: {
+					bulk_function (block (top), NUMlnGamma);
+				} break; case HERTZ_TO_BARK_: {
+					bulk_function (block (top), NUMhertzToBark);
+				} break; case BARK_TO_HERTZ_: {
+					bulk_function (block (top), NUMbarkToHertz);
+				} break; case PHON_TO_DIFFERENCE_LIMENS_: {
+					bulk_function (block (top), NUMphonToDifferenceLimens);
+				} break; case DIFFERENCE_LIMENS_TO_PHON_: {
+					bulk_function (block (top), NUMdifferenceLimensToPhon);
+				} break; case HERTZ_TO_MEL_: {
+					bulk_function (block (top), NUMhertzToMel);
+				} break; case MEL_TO_HERTZ_: {
+					bulk_function (block (top), NUMmelToHertz);
+				} break; case HERTZ_TO_SEMITONES_: {
+					bulk_function (block (top), NUMhertzToSemitones);
+				} break; case SEMITONES_TO_HERTZ_: {
+					bulk_function (block (top), NUMsemitonesToHertz);
+				} break; case ERB_: {
+					bulk_function (block (top), NUMerb);
+				} break; case HERTZ_TO_ERB_: {
+					bulk_function (block (top), NUMhertzToErb);
+				} break; case ERB_TO_HERTZ_: {
+					bulk_function (block (top), NUMerbToHertz);
+				} break; case MIN_: case MAX_: case IMIN_: case IMAX_: {
+					/*
+						As in do_min () and the like: the arguments are combined from the last one back to the first one.
+					*/
+					const integer numberOfArguments = integer (block (top --) [1]);
+					top -= numberOfArguments - 1;   // the first argument, which will receive the result
+					const int symbol = instruction. symbol;
+					for (integer i = 1; i <= n; i ++) {
+						double extremum = stack [top + numberOfArguments - 1] [i];
+						double index = numberOfArguments;
+						for (integer j = numberOfArguments - 1; j > 0; j --) {
+							const double previous = stack [top + j - 1] [i];
+							if (isundef (extremum) || isundef (previous)) {
+								extremum = undefined;
+								index = undefined;
+							} else if (symbol == MIN_) {
+								extremum = ( extremum < previous ? extremum : previous );
+							} else if (symbol == MAX_) {
+								extremum = ( extremum > previous ? extremum : previous );
+							} else if (symbol == IMIN_ ? previous < extremum : previous > extremum) {
+								extremum = previous;
+								index = j;
+							}
+						}
+						stack [top] [i] = bulk_number (symbol == MIN_ || symbol == MAX_ ? extremum : index);
+					}
+				} break; default: {
+					Melder_fatal (U"Formula_runForCells: instruction ", Formula_instructionNames [instruction. symbol], U" cannot be run in bulk.");
+				}
+			}
+		}
+		Melder_assert (top == 1);
+		for (integer i = 1; i <= n; i ++)
+			result [offset + i] = stack [1] [i];
+	}
+}
+
 /* End of file Formula.cpp */
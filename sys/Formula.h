@@ -2,7 +2,7 @@
 #define _Formula_h_
 /* Formula.h
  *
- * Copyright (C) 1990-2005,2007,2008,2011-2019 Paul Boersma
+ * Copyright (C) 1990-2005,2007,2008,2011-2020 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -161,9 +161,61 @@ struct Formula_Result {
 
 Thing_declare (Interpreter);
 
-void Formula_compile (Interpreter interpreter, Daata data, conststring32 expression, int expressionType, bool optimize);
+typedef struct structFormulaInstruction *FormulaInstruction;
 
-void Formula_run (integer row, integer col, Formula_Result *result);
+/*
+	A compiled formula. It carries its own instructions and its own stack,
+	so that several programs can be alive at the same time,
+	and a program can run while another one is running (e.g. in a script called by runScript)
+	or at the same time in another thread.
+*/
+Thing_define (FormulaProgram, Thing) {
+	Interpreter interpreter;   // the interpreter of the script, or `localInterpreter`
+	autoThing localInterpreter;   // if no interpreter was supplied, this one contains the loop variables
+	Daata source;   // the object that is "self"
+	int expressionType;
+	bool optimize;
+	bool refersToObjects;   // contains object names, which were looked up during compilation
+	integer numberOfInstructions;
+	FormulaInstruction instructions;   // [0 .. numberOfInstructions + 1]
+	integer numberOfStrings;
+	char32 **strings;   // [1 .. numberOfStrings]: the string constants and names that the instructions point to
+	Stackel stack;   // allocated when the program is first run
+
+	void v_destroy () noexcept
+		override;
+};
+
+autoFormulaProgram Formula_compile (Interpreter interpreter, Daata data, conststring32 expression, int expressionType, bool optimize);
+
+void Formula_run (FormulaProgram program, integer row, integer col, Formula_Result *result);
+
+/*
+	Whether the program computes a number from nothing else than constants, numeric variables,
+	`row`, `col`, `x`, `y` and `self` (the current cell), with pure numeric functions,
+	so that it can be run for different cells at the same time (in different threads,
+	each with its own program) and the cells can be visited in any order.
+*/
+bool Formula_isCellwise (FormulaProgram program);
+
+/*
+	Whether the program is cellwise and contains no jumps (`if`, `and`, `or`),
+	so that every cell runs through the same instructions
+	and the program can be run for many cells at once with Formula_runForCells ().
+*/
+bool Formula_isVectorizable (FormulaProgram program);
+
+/*
+	Run a vectorizable program for `result.size` consecutive cells, starting at cell number `firstCell`,
+	where the cells of the block that starts at [`fromRow`, `fromColumn`] and is `numberOfColumns` wide
+	are numbered row by row from 0 on.
+	The values are the same as those of Formula_run (), but this is much faster for large numbers of cells.
+	The program should first have been run successfully with Formula_run () for a cell of the same object,
+	because no errors are reported.
+	Does not change any state, so that several threads can run the same program at the same time.
+*/
+void Formula_runForCells (FormulaProgram program, integer fromRow, integer fromColumn, integer numberOfColumns,
+	integer firstCell, VEC result);
 
 /* End of file Formula.h */
 #endif
@@ -656,6 +656,26 @@ InterpreterVariable Interpreter_lookUpVariable (Interpreter me, conststring32 ke
 	return variable_ref;
 }
 
+/*
+	Find the variable that the current line of the running script assigns to,
+	without looking it up in the table of variables if the line did that already.
+	This is safe because no variables are removed while a script is running,
+	and a local variable (one that starts with a period) always belongs to the procedure in which the line stands.
+*/
+static InterpreterVariable Interpreter_findVariableOfCurrentLine (Interpreter me, conststring32 key, bool mayCreate) {
+	if (my currentLineNumber == 0)
+		return mayCreate ? Interpreter_lookUpVariable (me, key) : Interpreter_hasVariable (me, key);
+	InterpreterLine& line = my lines [uinteger (my currentLineNumber)];
+	if (line.variable && str32equ (line.variableName.get(), key))
+		return line.variable;
+	InterpreterVariable var = ( mayCreate ? Interpreter_lookUpVariable (me, key) : Interpreter_hasVariable (me, key) );
+	if (var) {
+		line.variableName = Melder_dup (key);
+		line.variable = var;
+	}
+	return var;
+}
+
 static integer lookupLabel (Interpreter me, conststring32 labelName) {
 	for (integer ilabel = 1; ilabel <= my numberOfLabels; ilabel ++)
 		if (str32equ (labelName, my labelNames [ilabel]))
@@ -859,6 +879,18 @@ inline static void NumericMatrixVariable_divide (InterpreterVariable variable, c
 			variableMatrix [irow] [icol] /= matrix [irow] [icol];
 }
 
+static bool Interpreter_lineDefinesProcedure (conststring32 line, conststring32 callName, integer callLength) {
+	if (! str32nequ (line, U"procedure ", 10))
+		return false;
+	const char32 *q = line + 10;
+	while (Melder_isHorizontalSpace (*q))
+		q ++;
+	if (! str32nequ (q, callName, callLength))
+		return false;
+	const char32 next = q [callLength];
+	return ! Melder_staysWithinInk (next) || next == U'(' || next == U':';
+}
+
 static void Interpreter_do_procedureCall (Interpreter me, char32 *command,
 	constvector <mutablestring32> const& lines, integer& lineNumber, integer callStack [], int& callDepth)
 {
@@ -890,7 +922,10 @@ static void Interpreter_do_procedureCall (Interpreter me, char32 *command,
 		p ++;   // step over parenthesis or colon
 	}
 	integer callLength = str32len (callName);
+	InterpreterLine& callLine = my lines [uinteger (lineNumber)];
 	integer iline = 1;
+	if (callLine.jumpLine > 0 && Interpreter_lineDefinesProcedure (lines [callLine.jumpLine], callName, callLength))
+		iline = callLine.jumpLine;   // where the procedure was found the previous time this line was run
 	for (; iline <= lines.size; iline ++) {
 		if (! str32nequ (lines [iline], U"procedure ", 10))
 			continue;
@@ -1022,6 +1057,7 @@ static void Interpreter_do_procedureCall (Interpreter me, char32 *command,
 			if (callDepth == Interpreter_MAX_CALL_DEPTH)
 				Melder_throw (U"Call depth greater than ", Interpreter_MAX_CALL_DEPTH, U".");
 			callStack [++ callDepth] = lineNumber;
+			callLine.jumpLine = iline;
 			lineNumber = iline;
 			break;
 		}
@@ -1046,7 +1082,10 @@ static void Interpreter_do_oldProcedureCall (Interpreter me, char32 *command,
 	bool hasArguments = ( *p != U'\0' );
 	*p = U'\0';   // close procedure name
 	integer callLength = str32len (callName);
+	InterpreterLine& callLine = my lines [uinteger (lineNumber)];
 	integer iline = 1;
+	if (callLine.jumpLine > 0 && Interpreter_lineDefinesProcedure (lines [callLine.jumpLine], callName, callLength))
+		iline = callLine.jumpLine;   // where the procedure was found the previous time this line was run
 	for (; iline <= lines.size; iline ++) {
 		if (! str32nequ (lines [iline], U"procedure ", 10))
 			continue;
@@ -1133,6 +1172,7 @@ static void Interpreter_do_oldProcedureCall (Interpreter me, char32 *command,
 			if (callDepth == Interpreter_MAX_CALL_DEPTH)
 				Melder_throw (U"Call depth greater than ", Interpreter_MAX_CALL_DEPTH, U".");
 			callStack [++ callDepth] = lineNumber;
+			callLine.jumpLine = iline;
 			lineNumber = iline;
 			break;
 		}
@@ -1418,6 +1458,8 @@ void Interpreter_run (Interpreter me, char32 *text) {
 			Copy the parameter names and argument values into the array of variables.
 		*/
 		my variablesMap. clear ();
+		my lines. clear ();
+		my lines. resize (uinteger (numberOfLines + 1));
 		for (ipar = 1; ipar <= my numberOfParameters; ipar ++) {
 			char32 parameter [200];
 			/*
@@ -1490,6 +1532,9 @@ void Interpreter_run (Interpreter me, char32 *text) {
 				c0 = command2. string [0];
 				if (c0 == U'\0')
 					continue;
+				InterpreterLine& lineInfo = my lines [uinteger (lineNumber)];
+				my currentLineNumber = lineNumber;
+				my numberOfEvaluatedExpressions = 0;
 				/*
 					Substitute variables.
 				*/
@@ -1581,7 +1626,7 @@ void Interpreter_run (Interpreter me, char32 *text) {
 						break;
 					case U'd':
 						if (str32nequ (command2.string, U"dec ", 4)) {
-							InterpreterVariable var = Interpreter_lookUpVariable (me, command2.string + 4);
+							InterpreterVariable var = Interpreter_findVariableOfCurrentLine (me, command2.string + 4, true);
 							var -> numericValue -= 1.0;
 						} else
 							fail = true;
@@ -1601,42 +1646,50 @@ void Interpreter_run (Interpreter me, char32 *text) {
 								const char32 *startOfInk = Melder_findInk (command2.string + 6);
 								if (startOfInk && *startOfInk != U';')
 									Melder_throw (U"Stray text after 'endfor'.");
-								int depth = 0;
-								integer iline;
-								for (iline = lineNumber - 1; iline > 0; iline --) {
-									char32 *line = lines [iline];
-									if (line [0] == U'f' && line [1] == U'o' && line [2] == U'r' && line [3] == U' ') {
-										if (depth == 0) { lineNumber = iline - 1; fromendfor = true; break; }   // go before 'for'
-										else depth --;
-									} else if (str32nequ (lines [iline], U"endfor", 6) &&
-											(! Melder_staysWithinInk (lines [iline] [6]) || lines [iline] [6] == U';'))
-									{
-										depth ++;
+								integer iline = lineInfo. jumpLine;
+								if (iline == 0) {
+									int depth = 0;
+									for (iline = lineNumber - 1; iline > 0; iline --) {
+										char32 *line = lines [iline];
+										if (line [0] == U'f' && line [1] == U'o' && line [2] == U'r' && line [3] == U' ') {
+											if (depth == 0) break;
+											else depth --;
+										} else if (str32nequ (lines [iline], U"endfor", 6) &&
+												(! Melder_staysWithinInk (lines [iline] [6]) || lines [iline] [6] == U';'))
+										{
+											depth ++;
+										}
 									}
+									if (iline <= 0) Melder_throw (U"Unmatched 'endfor'.");
+									lineInfo. jumpLine = iline;
 								}
-								if (iline <= 0) Melder_throw (U"Unmatched 'endfor'.");
+								lineNumber = iline - 1;   // go before 'for'
+								fromendfor = true;
 							} else if (str32nequ (command2.string, U"endwhile", 8) &&
 									(! Melder_staysWithinInk (command2.string [8]) || command2.string [8] == U';'))
 							{
 								const char32 *startOfInk = Melder_findInk (command2.string + 8);
 								if (startOfInk && *startOfInk != U';')
 									Melder_throw (U"Stray text after 'endwhile'.");
-								int depth = 0;
-								integer iline;
-								for (iline = lineNumber - 1; iline > 0; iline --) {
-									if (str32nequ (lines [iline], U"while ", 6)) {
-										if (depth == 0) {
-											lineNumber = iline - 1;
-											break;   // go before 'while'
-										} else
-											depth --;
-									} else if (str32nequ (lines [iline], U"endwhile", 8) &&
-											(! Melder_staysWithinInk (lines [iline] [8]) || lines [iline] [8] == U';'))
-									{
-										depth ++;
+								integer iline = lineInfo. jumpLine;
+								if (iline == 0) {
+									int depth = 0;
+									for (iline = lineNumber - 1; iline > 0; iline --) {
+										if (str32nequ (lines [iline], U"while ", 6)) {
+											if (depth == 0)
+												break;
+											else
+												depth --;
+										} else if (str32nequ (lines [iline], U"endwhile", 8) &&
+												(! Melder_staysWithinInk (lines [iline] [8]) || lines [iline] [8] == U';'))
+										{
+											depth ++;
+										}
 									}
+									if (iline <= 0) Melder_throw (U"Unmatched 'endwhile'.");
+									lineInfo. jumpLine = iline;
 								}
-								if (iline <= 0) Melder_throw (U"Unmatched 'endwhile'.");
+								lineNumber = iline - 1;   // go before 'while'
 							} else if (str32nequ (command2.string, U"endproc", 7) &&
 									(! Melder_staysWithinInk (command2.string [7]) || command2.string [7] == U';'))
 							{
@@ -1654,33 +1707,85 @@ void Interpreter_run (Interpreter me, char32 *text) {
 							const char32 *startOfInk = Melder_findInk (command2.string + 4);
 							if (startOfInk && *startOfInk != U';')
 								Melder_throw (U"Stray text after 'else'.");
-							int depth = 0;
-							integer iline;
-							for (iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
-								if (str32nequ (lines [iline], U"endif", 5) &&
-										(! Melder_staysWithinInk (lines [iline] [5]) || lines [iline] [5] == U';'))
-								{
-									startOfInk = Melder_findInk (lines [iline] + 5);
-									if (startOfInk && *startOfInk != U';') {
-										lineNumber = iline;   // on behalf of the error message
-										Melder_throw (U"Stray text after 'endif'.");
+							integer iline = lineInfo. jumpLine;
+							if (iline == 0) {
+								int depth = 0;
+								for (iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
+									if (str32nequ (lines [iline], U"endif", 5) &&
+											(! Melder_staysWithinInk (lines [iline] [5]) || lines [iline] [5] == U';'))
+									{
+										startOfInk = Melder_findInk (lines [iline] + 5);
+										if (startOfInk && *startOfInk != U';') {
+											lineNumber = iline;   // on behalf of the error message
+											Melder_throw (U"Stray text after 'endif'.");
+										}
+										if (depth == 0) break;
+										else depth --;
+									} else if (str32nequ (lines [iline], U"if ", 3)) {
+										depth ++;
 									}
-									if (depth == 0) { lineNumber = iline; break; }   // go after `endif`
-									else depth --;
-								} else if (str32nequ (lines [iline], U"if ", 3)) {
-									depth ++;
 								}
+								if (iline > numberOfLines)
+									Melder_throw (U"Unmatched 'else'.");
+								lineInfo. jumpLine = iline;
 							}
-							if (iline > numberOfLines)
-								Melder_throw (U"Unmatched 'else'.");
+							lineNumber = iline;   // go after `endif`
 						} else if (str32nequ (command2.string, U"elsif ", 6) || str32nequ (command2.string, U"elif ", 5)) {
 							if (fromif) {
 								double value;
 								fromif = false;
 								Interpreter_numericExpression (me, command2.string + 5, & value);
 								if (value == 0.0) {
+									integer iline = lineInfo. jumpLine;
+									if (iline == 0) {
+										int depth = 0;
+										for (iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
+											if (str32nequ (lines [iline], U"endif", 5) &&
+													(! Melder_staysWithinInk (lines [iline] [5]) || lines [iline] [5] == U';'))
+											{
+												const char32 *startOfInk = Melder_findInk (lines [iline] + 5);
+												if (startOfInk && *startOfInk != U';') {
+													lineNumber = iline;   // on behalf of error message
+													Melder_throw (U"Stray text after 'endif'.");
+												}
+												if (depth == 0)
+													break;
+												else
+													depth --;
+											} else if (str32nequ (lines [iline], U"else", 4) &&
+													(! Melder_staysWithinInk (lines [iline] [4]) || lines [iline] [4] == U';'))
+											{
+												const char32 *startOfInk = Melder_findInk (lines [iline] + 4);
+												if (startOfInk && *startOfInk != U';') {
+													lineNumber = iline;   // on behalf of error message
+													Melder_throw (U"Stray text after 'else'.");
+												}
+												if (depth == 0)
+													break;
+											} else if ((str32nequ (lines [iline], U"elsif", 5) && ! Melder_staysWithinInk (lines [iline] [5]))
+												|| (str32nequ (lines [iline], U"elif", 4) && ! Melder_staysWithinInk (lines [iline] [4]))) {
+												if (depth == 0)
+													break;
+											} else if (str32nequ (lines [iline], U"if ", 3)) {
+												depth ++;
+											}
+										}
+										if (iline > numberOfLines)
+											Melder_throw (U"Unmatched 'elsif'.");
+										lineInfo. jumpLine = iline;
+									}
+									if ((str32nequ (lines [iline], U"elsif", 5) && ! Melder_staysWithinInk (lines [iline] [5]))
+										|| (str32nequ (lines [iline], U"elif", 4) && ! Melder_staysWithinInk (lines [iline] [4]))) {
+										lineNumber = iline - 1;
+										fromif = true;   // go at next 'elsif' or 'elif'
+									} else {
+										lineNumber = iline;   // go after `endif` or `else`
+									}
+								}
+							} else {
+								integer iline = lineInfo. alternativeJumpLine;
+								if (iline == 0) {
 									int depth = 0;
-									integer iline;
 									for (iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
 										if (str32nequ (lines [iline], U"endif", 5) &&
 												(! Melder_staysWithinInk (lines [iline] [5]) || lines [iline] [5] == U';'))
@@ -1690,60 +1795,19 @@ void Interpreter_run (Interpreter me, char32 *text) {
 												lineNumber = iline;   // on behalf of error message
 												Melder_throw (U"Stray text after 'endif'.");
 											}
-											if (depth == 0) {
-												lineNumber = iline;
-												break;   // go after `endif`
-											} else
+											if (depth == 0)
+												break;
+											else
 												depth --;
-										} else if (str32nequ (lines [iline], U"else", 4) &&
-												(! Melder_staysWithinInk (lines [iline] [4]) || lines [iline] [4] == U';'))
-										{
-											const char32 *startOfInk = Melder_findInk (lines [iline] + 4);
-											if (startOfInk && *startOfInk != U';') {
-												lineNumber = iline;   // on behalf of error message
-												Melder_throw (U"Stray text after 'else'.");
-											}
-											if (depth == 0) {
-												lineNumber = iline;
-												break;   // go after `else`
-											}
-										} else if ((str32nequ (lines [iline], U"elsif", 5) && ! Melder_staysWithinInk (lines [iline] [5]))
-											|| (str32nequ (lines [iline], U"elif", 4) && ! Melder_staysWithinInk (lines [iline] [4]))) {
-											if (depth == 0) {
-												lineNumber = iline - 1;
-												fromif = true;
-												break;   // go at next 'elsif' or 'elif'
-											}
 										} else if (str32nequ (lines [iline], U"if ", 3)) {
 											depth ++;
 										}
 									}
 									if (iline > numberOfLines)
-										Melder_throw (U"Unmatched 'elsif'.");
-								}
-							} else {
-								int depth = 0;
-								integer iline;
-								for (iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
-									if (str32nequ (lines [iline], U"endif", 5) &&
-											(! Melder_staysWithinInk (lines [iline] [5]) || lines [iline] [5] == U';'))
-									{
-										const char32 *startOfInk = Melder_findInk (lines [iline] + 5);
-										if (startOfInk && *startOfInk != U';') {
-											lineNumber = iline;   // on behalf of error message
-											Melder_throw (U"Stray text after 'endif'.");
-										}
-										if (depth == 0) {
-											lineNumber = iline;
-											break;   // go after `endif`
-										} else
-											depth --;
-									} else if (str32nequ (lines [iline], U"if ", 3)) {
-										depth ++;
-									}
+										Melder_throw (U"'elsif' not matched with 'endif'.");
+									lineInfo. alternativeJumpLine = iline;
 								}
-								if (iline > numberOfLines)
-									Melder_throw (U"'elsif' not matched with 'endif'.");
+								lineNumber = iline;   // go after `endif`
 							}
 						} else if (str32nequ (command2.string, U"exit", 4)) {
 							if (command2.string [4] == U'\0') {
@@ -1777,7 +1841,7 @@ void Interpreter_run (Interpreter me, char32 *text) {
 								varpos ++;
 							if (endvar - varpos < 0)
 								Melder_throw (U"Missing loop variable after \'for\'.");
-							InterpreterVariable var = Interpreter_lookUpVariable (me, varpos);
+							InterpreterVariable var = Interpreter_findVariableOfCurrentLine (me, varpos, true);
 							Interpreter_numericExpression (me, topos + 4, & toValue);
 							if (fromendfor) {
 								fromendfor = false;
@@ -1790,28 +1854,31 @@ void Interpreter_run (Interpreter me, char32 *text) {
 							}
 							var -> numericValue = loopVariable;
 							if (loopVariable > toValue) {
-								int depth = 0;
-								integer iline;
-								for (iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
-									if (str32nequ (lines [iline], U"endfor", 6) &&
-											(! Melder_staysWithinInk (lines [iline] [6]) || lines [iline] [6] == U';'))
-									{
-										const char32 *startOfInk = Melder_findInk (lines [iline] + 6);
-										if (startOfInk && *startOfInk != U';') {
-											lineNumber = iline;   // on behalf of error message
-											Melder_throw (U"Stray text after 'endfor'.");
+								integer iline = lineInfo. jumpLine;
+								if (iline == 0) {
+									int depth = 0;
+									for (iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
+										if (str32nequ (lines [iline], U"endfor", 6) &&
+												(! Melder_staysWithinInk (lines [iline] [6]) || lines [iline] [6] == U';'))
+										{
+											const char32 *startOfInk = Melder_findInk (lines [iline] + 6);
+											if (startOfInk && *startOfInk != U';') {
+												lineNumber = iline;   // on behalf of error message
+												Melder_throw (U"Stray text after 'endfor'.");
+											}
+											if (depth == 0)
+												break;
+											else
+												depth --;
+										} else if (str32nequ (lines [iline], U"for ", 4)) {
+											depth ++;
 										}
-										if (depth == 0) {
-											lineNumber = iline;
-											break;   // go after 'endfor'
-										} else
-											depth --;
-									} else if (str32nequ (lines [iline], U"for ", 4)) {
-										depth ++;
 									}
+									if (iline > numberOfLines)
+										Melder_throw (U"Unmatched 'for'.");
+									lineInfo. jumpLine = iline;
 								}
-								if (iline > numberOfLines)
-									Melder_throw (U"Unmatched 'for'.");
+								lineNumber = iline;   // go after 'endfor'
 							}
 						} else if (str32nequ (command2.string, U"form", 4) && Melder_isEndOfInk (command2.string [4])) {
 							integer iline;
@@ -1856,51 +1923,54 @@ void Interpreter_run (Interpreter me, char32 *text) {
 							double value;
 							Interpreter_numericExpression (me, command2.string + 3, & value);
 							if (value == 0.0) {
-								int depth = 0;
-								integer iline;
-								for (iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
-									if (str32nequ (lines [iline], U"endif", 5) &&
-											(! Melder_staysWithinInk (lines [iline] [5]) || lines [iline] [5] == U';'))
-									{
-										const char32 *startOfInk = Melder_findInk (lines [iline] + 5);
-										if (startOfInk && *startOfInk != U';') {
-											lineNumber = iline;   // on behalf of error message
-											Melder_throw (U"Stray text after 'endif'.");
-										}
-										if (depth == 0) {
-											lineNumber = iline;
-											break;   // go after 'endif'
-										} else
-											depth --;
-									} else if (str32nequ (lines [iline], U"else", 4) &&
-											(! Melder_staysWithinInk (lines [iline] [4]) || lines [iline] [4] == U';'))
-									{
-										const char32 *startOfInk = Melder_findInk (lines [iline] + 4);
-										if (startOfInk && *startOfInk != U';') {
-											lineNumber = iline;   // on behalf of error message
-											Melder_throw (U"Stray text after 'else'.");
-										}
-										if (depth == 0) {
-											lineNumber = iline;
-											break;   // go after 'else'
-										}
-									} else if (str32nequ (lines [iline], U"elsif ", 6) || str32nequ (lines [iline], U"elif ", 5)) {
-										if (depth == 0) {
-											lineNumber = iline - 1;
-											fromif = true;
-											break;   // go at 'elsif'
+								integer iline = lineInfo. jumpLine;
+								if (iline == 0) {
+									int depth = 0;
+									for (iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
+										if (str32nequ (lines [iline], U"endif", 5) &&
+												(! Melder_staysWithinInk (lines [iline] [5]) || lines [iline] [5] == U';'))
+										{
+											const char32 *startOfInk = Melder_findInk (lines [iline] + 5);
+											if (startOfInk && *startOfInk != U';') {
+												lineNumber = iline;   // on behalf of error message
+												Melder_throw (U"Stray text after 'endif'.");
+											}
+											if (depth == 0)
+												break;
+											else
+												depth --;
+										} else if (str32nequ (lines [iline], U"else", 4) &&
+												(! Melder_staysWithinInk (lines [iline] [4]) || lines [iline] [4] == U';'))
+										{
+											const char32 *startOfInk = Melder_findInk (lines [iline] + 4);
+											if (startOfInk && *startOfInk != U';') {
+												lineNumber = iline;   // on behalf of error message
+												Melder_throw (U"Stray text after 'else'.");
+											}
+											if (depth == 0)
+												break;
+										} else if (str32nequ (lines [iline], U"elsif ", 6) || str32nequ (lines [iline], U"elif ", 5)) {
+											if (depth == 0)
+												break;
+										} else if (str32nequ (lines [iline], U"if ", 3)) {
+											depth ++;
 										}
-									} else if (str32nequ (lines [iline], U"if ", 3)) {
-										depth ++;
 									}
+									if (iline > numberOfLines)
+										Melder_throw (U"Unmatched 'if'.");
+									lineInfo. jumpLine = iline;
+								}
+								if (str32nequ (lines [iline], U"elsif ", 6) || str32nequ (lines [iline], U"elif ", 5)) {
+									lineNumber = iline - 1;
+									fromif = true;   // go at 'elsif'
+								} else {
+									lineNumber = iline;   // go after 'endif' or 'else'
 								}
-								if (iline > numberOfLines)
-									Melder_throw (U"Unmatched 'if'.");
 							} else if (isundef (value)) {
 								Melder_throw (U"The value of the 'if' condition is undefined.");
 							}
 						} else if (str32nequ (command2.string, U"inc ", 4)) {
-							InterpreterVariable var = Interpreter_lookUpVariable (me, command2.string + 4);
+							InterpreterVariable var = Interpreter_findVariableOfCurrentLine (me, command2.string + 4, true);
 							var -> numericValue += 1.0;
 						} else
 							fail = true;
@@ -1982,23 +2052,26 @@ void Interpreter_run (Interpreter me, char32 *text) {
 							double value;
 							Interpreter_numericExpression (me, command2.string + 6, & value);
 							if (value == 0.0) {
-								int depth = 0;
-								integer iline = lineNumber - 1;
-								for (; iline > 0; iline --) {
-									if (str32nequ (lines [iline], U"repeat", 6) &&
-											(! Melder_staysWithinInk (lines [iline] [6]) || lines [iline] [6] == U';'))
-									{
-										if (depth == 0) {
-											lineNumber = iline;
-											break;   // go after `repeat`
-										} else
-											depth --;
-									} else if (str32nequ (lines [iline], U"until ", 6)) {
-										depth ++;
+								integer iline = lineInfo. jumpLine;
+								if (iline == 0) {
+									int depth = 0;
+									for (iline = lineNumber - 1; iline > 0; iline --) {
+										if (str32nequ (lines [iline], U"repeat", 6) &&
+												(! Melder_staysWithinInk (lines [iline] [6]) || lines [iline] [6] == U';'))
+										{
+											if (depth == 0)
+												break;
+											else
+												depth --;
+										} else if (str32nequ (lines [iline], U"until ", 6)) {
+											depth ++;
+										}
 									}
+									if (iline <= 0)
+										Melder_throw (U"Unmatched 'until'.");
+									lineInfo. jumpLine = iline;
 								}
-								if (iline <= 0)
-									Melder_throw (U"Unmatched 'until'.");
+								lineNumber = iline;   // go after `repeat`
 							}
 						} else
 							fail = true;
@@ -2011,28 +2084,31 @@ void Interpreter_run (Interpreter me, char32 *text) {
 							double value;
 							Interpreter_numericExpression (me, command2.string + 6, & value);
 							if (value == 0.0) {
-								int depth = 0;
-								integer iline = lineNumber + 1;
-								for (; iline <= numberOfLines; iline ++) {
-									if (str32nequ (lines [iline], U"endwhile", 8) &&
-											(! Melder_staysWithinInk (lines [iline] [8]) || lines [iline] [8] == U';'))
-									{
-										const char32 *startOfInk = Melder_findInk (lines [iline] + 8);
-										if (startOfInk && *startOfInk != U';') {
-											lineNumber = iline;
-											Melder_throw (U"Stray text after 'endwhile'.");
+								integer iline = lineInfo. jumpLine;
+								if (iline == 0) {
+									int depth = 0;
+									for (iline = lineNumber + 1; iline <= numberOfLines; iline ++) {
+										if (str32nequ (lines [iline], U"endwhile", 8) &&
+												(! Melder_staysWithinInk (lines [iline] [8]) || lines [iline] [8] == U';'))
+										{
+											const char32 *startOfInk = Melder_findInk (lines [iline] + 8);
+											if (startOfInk && *startOfInk != U';') {
+												lineNumber = iline;
+												Melder_throw (U"Stray text after 'endwhile'.");
+											}
+											if (depth == 0)
+												break;
+											else
+												depth --;
+										} else if (str32nequ (lines [iline], U"while ", 6)) {
+											depth ++;
 										}
-										if (depth == 0) {
-											lineNumber = iline;
-											break;   // go after `endwhile`
-										} else
-											depth --;
-									} else if (str32nequ (lines [iline], U"while ", 6)) {
-										depth ++;
 									}
+									if (iline > numberOfLines)
+										Melder_throw (U"Unmatched 'while'.");
+									lineInfo. jumpLine = iline;
 								}
-								if (iline > numberOfLines)
-									Melder_throw (U"Unmatched 'while'.");
+								lineNumber = iline;   // go after `endwhile`
 							}
 						} else
 							fail = true;
@@ -2188,7 +2264,7 @@ void Interpreter_run (Interpreter me, char32 *text) {
 							autostring32 stringValue = Interpreter_stringExpression (me, p);
 							trace (U"assigning to string variable ", variableName);
 							if (typeOfAssignment == 1) {
-								InterpreterVariable var = Interpreter_hasVariable (me, variableName);
+								InterpreterVariable var = Interpreter_findVariableOfCurrentLine (me, variableName, false);
 								if (! var)
 									Melder_throw (U"The string ", variableName, U" does not exist.\n"
 									              U"You can increment (+=) only existing strings.");
@@ -2198,7 +2274,7 @@ void Interpreter_run (Interpreter me, char32 *text) {
 								str32cpy (newString.get() + oldLength, stringValue.get());
 								var -> stringValue = newString.move();
 							} else {
-								InterpreterVariable var = Interpreter_lookUpVariable (me, variableName);
+								InterpreterVariable var = Interpreter_findVariableOfCurrentLine (me, variableName, true);
 								var -> stringValue = stringValue.move();
 							}
 						}
@@ -2562,13 +2638,13 @@ void Interpreter_run (Interpreter me, char32 *text) {
 								Use an existing variable, or create a new one.
 							*/
 							//Melder_casual (U"looking up variable ", variableName);
-							InterpreterVariable var = Interpreter_lookUpVariable (me, variableName);
+							InterpreterVariable var = Interpreter_findVariableOfCurrentLine (me, variableName, true);
 							var -> numericValue = value;
 						} else {
 							/*
 								Modify an existing variable.
 							*/
-							InterpreterVariable var = Interpreter_hasVariable (me, variableName);
+							InterpreterVariable var = Interpreter_findVariableOfCurrentLine (me, variableName, false);
 							if (! var)
 								Melder_throw (U"The variable ", variableName, U" does not exist. You can modify only existing variables.");
 							if (isundef (var -> numericValue)) {
@@ -2620,6 +2696,8 @@ void Interpreter_run (Interpreter me, char32 *text) {
 			}
 		} // endfor lineNumber
 		my numberOfLabels = 0;
+		my currentLineNumber = 0;
+		my lines. clear ();
 		my running = false;
 		my stopped = false;
 	} catch (MelderError) {
@@ -2634,6 +2712,8 @@ void Interpreter_run (Interpreter me, char32 *text) {
 			}
 		}
 		my numberOfLabels = 0;
+		my currentLineNumber = 0;
+		my lines. clear ();
 		my running = false;
 		my stopped = false;
 		if (str32equ (Melder_getError (), U"\nScript exited.\n")) {
@@ -2650,10 +2730,45 @@ void Interpreter_stop (Interpreter me) {
 //Melder_casual (U"Interpreter_stop out: ", Melder_pointer (me));
 }
 
+/*
+	While a script is running, the expressions in each line are compiled only once, namely the first time the line is executed.
+	An expression is recognized by its position in the line and by its text,
+	which can differ between executions if the line contains 'variable' substitutions.
+	Expressions that refer to objects by name are not cached, because the objects can be replaced between executions.
+*/
+static FormulaProgram Interpreter_compileExpression (Interpreter me, conststring32 expression, int expressionType,
+	autoFormulaProgram *out_uncachedProgram)
+{
+	if (! me || my currentLineNumber == 0) {   // no script running
+		*out_uncachedProgram = Formula_compile (me, nullptr, expression, expressionType, false);
+		return out_uncachedProgram -> get();
+	}
+	InterpreterLine& line = my lines [uinteger (my currentLineNumber)];
+	const uinteger slot = uinteger (my numberOfEvaluatedExpressions ++);
+	if (slot < line.expressions.size ()) {
+		InterpreterExpression& cached = line.expressions [slot];
+		if (cached.program && cached.expressionType == expressionType && str32equ (cached.text.get(), expression))
+			return cached.program.get();
+	}
+	autoFormulaProgram program = Formula_compile (me, nullptr, expression, expressionType, false);
+	if (program -> refersToObjects) {
+		*out_uncachedProgram = program.move();
+		return out_uncachedProgram -> get();
+	}
+	if (slot >= line.expressions.size ())
+		line.expressions. resize (slot + 1);
+	InterpreterExpression& cached = line.expressions [slot];
+	cached.expressionType = expressionType;
+	cached.text = Melder_dup (expression);
+	cached.program = program.move();
+	return cached.program.get();
+}
+
 void Interpreter_voidExpression (Interpreter me, conststring32 expression) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_NUMERIC, false);
+	autoFormulaProgram uncachedProgram;
+	FormulaProgram program = Interpreter_compileExpression (me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, & uncachedProgram);
 	Formula_Result result;
-	Formula_run (0, 0, & result);
+	Formula_run (program, 0, 0, & result);
 }
 
 void Interpreter_numericExpression (Interpreter me, conststring32 expression, double *p_value) {
@@ -2661,41 +2776,46 @@ void Interpreter_numericExpression (Interpreter me, conststring32 expression, do
 	if (str32str (expression, U"(=")) {
 		*p_value = Melder_atof (expression);
 	} else {
-		Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_NUMERIC, false);
+		autoFormulaProgram uncachedProgram;
+		FormulaProgram program = Interpreter_compileExpression (me, expression, kFormula_EXPRESSION_TYPE_NUMERIC, & uncachedProgram);
 		Formula_Result result;
-		Formula_run (0, 0, & result);
+		Formula_run (program, 0, 0, & result);
 		*p_value = result. numericResult;
 	}
 }
 
 void Interpreter_numericVectorExpression (Interpreter me, conststring32 expression, VEC *p_value, bool *p_owned) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR, false);
+	autoFormulaProgram uncachedProgram;
+	FormulaProgram program = Interpreter_compileExpression (me, expression, kFormula_EXPRESSION_TYPE_NUMERIC_VECTOR, & uncachedProgram);
 	Formula_Result result;
-	Formula_run (0, 0, & result);
+	Formula_run (program, 0, 0, & result);
 	*p_value = result. numericVectorResult;
 	*p_owned = result. owned;
 	result. owned = false;
 }
 
 void Interpreter_numericMatrixExpression (Interpreter me, conststring32 expression, MAT *p_value, bool *p_owned) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX, false);
+	autoFormulaProgram uncachedProgram;
+	FormulaProgram program = Interpreter_compileExpression (me, expression, kFormula_EXPRESSION_TYPE_NUMERIC_MATRIX, & uncachedProgram);
 	Formula_Result result;
-	Formula_run (0, 0, & result);
+	Formula_run (program, 0, 0, & result);
 	*p_value = result. numericMatrixResult;
 	*p_owned = result. owned;
 	result. owned = false;
 }
 
 autostring32 Interpreter_stringExpression (Interpreter me, conststring32 expression) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_STRING, false);
+	autoFormulaProgram uncachedProgram;
+	FormulaProgram program = Interpreter_compileExpression (me, expression, kFormula_EXPRESSION_TYPE_STRING, & uncachedProgram);
 	Formula_Result result;
-	Formula_run (0, 0, & result);
+	Formula_run (program, 0, 0, & result);
 	return result. stringResult.move();
 }
 
 void Interpreter_anyExpression (Interpreter me, conststring32 expression, Formula_Result *p_result) {
-	Formula_compile (me, nullptr, expression, kFormula_EXPRESSION_TYPE_UNKNOWN, false);
-	Formula_run (0, 0, p_result);
+	autoFormulaProgram uncachedProgram;
+	FormulaProgram program = Interpreter_compileExpression (me, expression, kFormula_EXPRESSION_TYPE_UNKNOWN, & uncachedProgram);
+	Formula_run (program, 0, 0, p_result);
 }
 
 /* End of file Interpreter.cpp */
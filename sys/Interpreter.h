@@ -2,7 +2,7 @@
 #define _Interpreter_h_
 /* Interpreter.h
  *
- * Copyright (C) 1993-2018 Paul Boersma
+ * Copyright (C) 1993-2020 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -24,6 +24,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 Thing_define (InterpreterVariable, SimpleString) {
 	autostring32 stringValue;
@@ -42,6 +43,26 @@ Thing_define (InterpreterVariable, SimpleString) {
 Thing_declare (UiForm);
 Thing_declare (Editor);
 
+/*
+	What Interpreter_run () learned about a line of the script when it ran the line,
+	so that it does not have to learn it again when it runs the line again (in a loop or a procedure).
+	Everything here depends only on the text of the line,
+	which is why the expressions and the variable name are compared with the text
+	(which can change from run to run by the substitution of 'variables').
+*/
+struct InterpreterExpression {
+	int expressionType;
+	autostring32 text;
+	autoFormulaProgram program;
+};
+struct InterpreterLine {
+	integer jumpLine;   // the line found by searching for the matching `endif`, `endfor`, `procedure` and so on; 0 if not yet known
+	integer alternativeJumpLine;   // the line found by the second kind of search that `elsif` can do; 0 if not yet known
+	std::vector <InterpreterExpression> expressions;   // in the order in which the line evaluated them
+	autostring32 variableName;   // the variable that the line assigns to
+	InterpreterVariable variable;
+};
+
 Thing_define (Interpreter, Thing) {
 	autostring32 environmentName;
 	ClassInfo editorClass;
@@ -55,6 +76,9 @@ Thing_define (Interpreter, Thing) {
 	char32 dialogTitle [1+Interpreter_MAX_DIALOG_TITLE_LENGTH], procedureNames [1+Interpreter_MAX_CALL_DEPTH] [100];
 	std::unordered_map <std::u32string, autoInterpreterVariable> variablesMap;
 	bool running, stopped;
+	std::vector <InterpreterLine> lines;   // [0 .. numberOfLines] while running
+	integer currentLineNumber;   // the line whose expressions are being evaluated, or 0
+	integer numberOfEvaluatedExpressions;   // the number of expressions evaluated so far in the current line
 };
 
 autoInterpreter Interpreter_create (conststring32 environmentName, ClassInfo editorClass);
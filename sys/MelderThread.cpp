@@ -0,0 +1,237 @@
+/* MelderThread.cpp
+ *
+ * Copyright (C) 2026 Paul Boersma
+ *
+ * This code is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or (at
+ * your option) any later version.
+ *
+ * This code is distributed in the hope that it will be useful, but
+ * WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+ * See the GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this work. If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include "MelderThread.h"
+#include "Preferences.h"
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static integer theMaximumNumberOfThreadsPreference;   // 0 = automatic
+
+void MelderThread_prefs () {
+	Preferences_addInteger (U"MelderThread.maximumNumberOfThreads", & theMaximumNumberOfThreadsPreference, 0);
+}
+
+integer MelderThread_getMaximumNumberOfThreadsPreference () {
+	return theMaximumNumberOfThreadsPreference;
+}
+
+void MelderThread_setMaximumNumberOfThreadsPreference (integer maximumNumberOfThreads) {
+	theMaximumNumberOfThreadsPreference = std::max (0_integer, maximumNumberOfThreads);
+}
+
+integer MelderThread_getNumberOfProcessors () {
+	return std::max (1_integer, uinteger_to_integer (std::thread::hardware_concurrency ()));
+}
+
+integer MelderThread_getMaximumNumberOfThreads () {
+	const integer numberOfProcessors = MelderThread_getNumberOfProcessors ();
+	if (theMaximumNumberOfThreadsPreference <= 0)
+		return numberOfProcessors;
+	return theMaximumNumberOfThreadsPreference;
+}
+
+integer MelderThread_computeNumberOfThreads (integer numberOfFrames, integer minimumNumberOfFramesPerThread) {
+	if (numberOfFrames <= 1)
+		return 1;
+	Melder_clipLeft (1_integer, & minimumNumberOfFramesPerThread);
+	integer numberOfThreads = (numberOfFrames - 1) / minimumNumberOfFramesPerThread + 1;
+	Melder_clip (1_integer, & numberOfThreads, MelderThread_getMaximumNumberOfThreads ());
+	return numberOfThreads;
+}
+
+/*
+	A job is split into chunks of consecutive frames.
+	Each participating thread owns a contiguous slice of chunks, which it handles from front to back;
+	a thread that has finished its own slice steals the remaining chunks of the other slices.
+	Owner and thieves take chunks with the same atomic counter,
+	so a chunk is handled by exactly one thread.
+*/
+struct alignas (64) MelderThread_Slice {
+	std::atomic <integer> nextChunk;
+	integer endChunk;   // one past the last chunk
+};
+
+struct MelderThread_Job {
+	MelderThread_FrameRangeFunction const *body;
+	integer numberOfFrames, numberOfThreads, chunkSize;
+	std::vector <MelderThread_Slice> slices;
+	std::atomic <bool> stopRequested;
+	std::mutex errorMutex;
+	std::exception_ptr firstError;
+	/*
+		The following two are protected by the pool mutex.
+	*/
+	integer numberOfClaimedHelpers, numberOfFinishedHelpers;
+
+	void participate (integer ithread) {
+		for (integer islice = 0; islice < numberOfThreads; islice ++) {
+			MelderThread_Slice& slice = slices [(ithread - 1 + islice) % numberOfThreads];   // own slice first
+			while (! stopRequested. load (std::memory_order_relaxed)) {
+				const integer ichunk = slice. nextChunk. fetch_add (1, std::memory_order_relaxed);
+				if (ichunk >= slice. endChunk)
+					break;
+				const integer firstFrame = 1 + ichunk * chunkSize;
+				const integer lastFrame = std::min (firstFrame + chunkSize - 1, numberOfFrames);
+				try {
+					(*body) (ithread, firstFrame, lastFrame);
+				} catch (...) {
+					std::lock_guard <std::mutex> lock (errorMutex);
+					if (! firstError)
+						firstError = std::current_exception ();
+					stopRequested = true;
+				}
+			}
+		}
+	}
+};
+
+static struct MelderThread_Pool {
+	std::mutex mutex;
+	std::condition_variable jobAvailable, helpersFinished;
+	std::vector <std::thread> workers;
+	MelderThread_Job *job = nullptr;
+	uinteger jobGeneration = 0;
+	bool shuttingDown = false;
+	std::mutex dispatchMutex;   // one job at a time
+	/*
+		The workers wait on our mutex and condition variables,
+		so they have to be gone before these are destroyed at exit.
+	*/
+	~ MelderThread_Pool () {
+		{
+			std::lock_guard <std::mutex> lock (mutex);
+			shuttingDown = true;
+		}
+		jobAvailable. notify_all ();
+		for (std::thread& worker : workers) {
+			if (worker. get_id () == std::this_thread::get_id ())
+				worker. detach ();   // exit () was called from a job
+			else if (worker. joinable ())
+				worker. join ();
+		}
+	}
+} thePool;
+
+static thread_local bool theThreadIsInsideParallelFor = false;
+
+static void MelderThread_Pool_workerLoop () {
+	theThreadIsInsideParallelFor = true;
+	uinteger lastSeenGeneration = 0;
+	for (;;) {
+		MelderThread_Job *job;
+		integer ithread;
+		{
+			std::unique_lock <std::mutex> lock (thePool. mutex);
+			thePool. jobAvailable. wait (lock, [& lastSeenGeneration] {
+				return thePool. jobGeneration != lastSeenGeneration || thePool. shuttingDown;
+			});
+			if (thePool. shuttingDown)
+				return;
+			lastSeenGeneration = thePool. jobGeneration;
+			job = thePool. job;
+			if (! job || job -> numberOfClaimedHelpers >= job -> numberOfThreads - 1)
+				continue;   // nothing left for us in this generation
+			ithread = 2 + job -> numberOfClaimedHelpers ++;
+		}
+		job -> participate (ithread);
+		{
+			std::lock_guard <std::mutex> lock (thePool. mutex);
+			job -> numberOfFinishedHelpers ++;
+		}
+		thePool. helpersFinished. notify_one ();
+	}
+}
+
+static void MelderThread_Pool_ensureNumberOfWorkers (integer numberOfWorkers) {
+	/*
+		The workers live until the end of the process, waiting for jobs;
+		the destructor of the pool stops and joins them.
+	*/
+	while (integer (thePool. workers. size ()) < numberOfWorkers)
+		thePool. workers. emplace_back (MelderThread_Pool_workerLoop);
+}
+
+void MelderThread_parallelFor (integer numberOfFrames, integer numberOfThreads, MelderThread_FrameRangeFunction const& body) {
+	if (numberOfFrames < 1)
+		return;
+	Melder_clip (1_integer, & numberOfThreads, numberOfFrames);
+	std::unique_lock <std::mutex> dispatchLock (thePool. dispatchMutex, std::defer_lock);
+	if (numberOfThreads == 1 || theThreadIsInsideParallelFor || ! dispatchLock. try_lock ()) {
+		body (1, 1, numberOfFrames);
+		return;
+	}
+	try {
+		MelderThread_Pool_ensureNumberOfWorkers (numberOfThreads - 1);
+	} catch (...) {
+		dispatchLock. unlock ();
+		body (1, 1, numberOfFrames);   // no threads available
+		return;
+	}
+
+	MelderThread_Job job;
+	job. body = & body;
+	job. numberOfFrames = numberOfFrames;
+	job. numberOfThreads = numberOfThreads;
+	/*
+		Several chunks per thread give the thieves something to steal,
+		but chunks should not be so small that the atomic operations start to count.
+	*/
+	constexpr integer numberOfChunksPerThread = 8;
+	job. chunkSize = std::max (1_integer, numberOfFrames / (numberOfThreads * numberOfChunksPerThread));
+	const integer numberOfChunks = (numberOfFrames - 1) / job. chunkSize + 1;
+	job. slices = std::vector <MelderThread_Slice> (uinteger (numberOfThreads));
+	for (integer islice = 0; islice < numberOfThreads; islice ++) {
+		job. slices [islice]. nextChunk = islice * numberOfChunks / numberOfThreads;
+		job. slices [islice]. endChunk = (islice + 1) * numberOfChunks / numberOfThreads;
+	}
+	job. stopRequested = false;
+	job. numberOfClaimedHelpers = 0;
+	job. numberOfFinishedHelpers = 0;
+
+	{
+		std::lock_guard <std::mutex> lock (thePool. mutex);
+		thePool. job = & job;
+		thePool. jobGeneration ++;
+	}
+	thePool. jobAvailable. notify_all ();
+
+	theThreadIsInsideParallelFor = true;
+	job. participate (1);
+	theThreadIsInsideParallelFor = false;
+
+	{
+		/*
+			The job lives on our stack, so we have to wait until every helper has let go of it.
+		*/
+		std::unique_lock <std::mutex> lock (thePool. mutex);
+		thePool. helpersFinished. wait (lock, [& job] {
+			return job. numberOfFinishedHelpers == job. numberOfThreads - 1;
+		});
+		thePool. job = nullptr;
+	}
+	dispatchLock. unlock ();
+	if (job. firstError)
+		std::rethrow_exception (job. firstError);
+}
+
+/* End of file MelderThread.cpp */
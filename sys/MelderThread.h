@@ -2,7 +2,7 @@
 #define _MelderThread_h_
 /* MelderThread.h
  *
- * Copyright (C) 2014-2018,2020 Paul Boersma
+ * Copyright (C) 2014-2018,2020,2026 Paul Boersma
  *
  * This code is free software; you can redistribute it and/or modify
  * it under the terms of the GNU General Public License as published by
@@ -18,34 +18,49 @@
  * along with this work. If not, see <http://www.gnu.org/licenses/>.
  */
 
-#include <vector>
-#include "Thing.h"
-#include <thread>
-
-inline static integer MelderThread_getNumberOfProcessors () {
-	return uinteger_to_integer (std::thread::hardware_concurrency ());
-}
-
-template <class T> void MelderThread_run (void (*func) (T *), autoSomeThing <T> *args, integer numberOfThreads) {
-	uinteger unsignedNumberOfThreads = integer_to_uinteger (numberOfThreads);
-	if (unsignedNumberOfThreads == 1) {
-		func (args [0].get());
-	} else {
-		std::vector <std::thread> thread (unsignedNumberOfThreads);
-		try {
-			for (uinteger ithread = 1; ithread < unsignedNumberOfThreads; ithread ++)
-				thread [ithread - 1] = std::thread (func, args [ithread - 1].get());
-			func (args [unsignedNumberOfThreads - 1].get());
-		} catch (MelderError) {
-			for (uinteger ithread = 1; ithread < unsignedNumberOfThreads; ithread ++)
-				if (thread [ithread - 1]. joinable ())
-					thread [ithread - 1]. join ();
-			throw;
-		}
-		for (uinteger ithread = 1; ithread < unsignedNumberOfThreads; ithread ++)
-			thread [ithread - 1]. join ();
-	}
-}
+#include "melder.h"
+#include <functional>
+
+integer MelderThread_getNumberOfProcessors ();
+
+/*
+	The user preference for the maximum number of threads that an analysis can use.
+	Zero means "as many as there are processors".
+*/
+integer MelderThread_getMaximumNumberOfThreadsPreference ();
+void MelderThread_setMaximumNumberOfThreadsPreference (integer maximumNumberOfThreads);
+void MelderThread_prefs ();
+
+/*
+	The actual maximum number of threads (at least 1),
+	as determined by the preference and the number of processors.
+*/
+integer MelderThread_getMaximumNumberOfThreads ();
+
+/*
+	The number of threads that it makes sense to use for `numberOfFrames` frames,
+	if a thread should have at least `minimumNumberOfFramesPerThread` frames to work on.
+*/
+integer MelderThread_computeNumberOfThreads (integer numberOfFrames, integer minimumNumberOfFramesPerThread);
+
+/*
+	Call `body (ithread, firstFrame, lastFrame)` for consecutive ranges of frames
+	that together cover the frames 1 .. numberOfFrames exactly once,
+	using at most `numberOfThreads` threads from a persistent process-wide pool.
+
+	`ithread` runs from 1 to `numberOfThreads` and identifies the participating thread,
+	so that `body` can use scratch memory per thread.
+	Thread number 1 is always the calling thread, which is the only one
+	that is allowed to call Melder_progress (). Every range is handled by one thread,
+	but which thread handles a range is decided at run time ("work stealing"),
+	so that frames of unequal cost do not leave processors idle.
+
+	If `body` throws, no new ranges are started, and after all threads have finished
+	the first exception is rethrown in the calling thread.
+	A call from within `body` (nested parallelism) runs serially in the calling thread.
+*/
+using MelderThread_FrameRangeFunction = std::function <void (integer ithread, integer firstFrame, integer lastFrame)>;
+void MelderThread_parallelFor (integer numberOfFrames, integer numberOfThreads, MelderThread_FrameRangeFunction const& body);
 
 /* End of file MelderThread.h */
 #endif
@@ -43,6 +43,7 @@
 #include "Strings_.h"
 #include "../kar/UnicodeData.h"
 #include "InfoEditor.h"
+#include "MelderThread.h"
 
 #if gtk
 	#include <gdk/gdkx.h>
@@ -1018,6 +1019,7 @@ static void installPraatShellPreferences () {
 	Melder_audio_prefs ();   // asynchronicity, silence after...
 	Melder_textEncoding_prefs ();
 	Printer_prefs ();   // paper size, printer command...
+	MelderThread_prefs ();   // maximum number of threads
 	structTextEditor :: f_preferences ();   // font size...
 }
 
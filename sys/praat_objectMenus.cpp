@@ -23,6 +23,7 @@
 #include "DataEditor.h"
 #include "site.h"
 #include "GraphicsP.h"
+#include "MelderThread.h"
 //#include <string>
 
 #undef iam
@@ -254,6 +255,18 @@ DO
 	theGraphicsCjkFontStyle = cjkFontStyle;
 END }
 
+FORM (PREFS_MultithreadingSettings, U"Multithreading preferences", nullptr) {
+	LABEL (U"Analyses such as Sound: To Pitch distribute their frames over several threads.")
+	LABEL (U"Zero means: use as many threads as there are processors.")
+	INTEGER (maximumNumberOfThreads, U"Maximum number of threads", U"0")
+OK
+	SET_INTEGER (maximumNumberOfThreads, MelderThread_getMaximumNumberOfThreadsPreference ())
+DO
+	Melder_require (maximumNumberOfThreads >= 0,
+		U"The maximum number of threads should not be negative.");
+	MelderThread_setMaximumNumberOfThreadsPreference (maximumNumberOfThreads);
+END }
+
 /********** Callbacks of the Goodies menu. **********/
 
 FORM (STRING_praat_calculator, U"Calculator", U"Calculator") {
@@ -685,6 +698,8 @@ void praat_addMenus (GuiWindow window) {
 	praat_addMenuCommand (U"Objects", U"Preferences", U"Text reading preferences...", nullptr, 0, PREFS_TextInputEncodingSettings);
 	praat_addMenuCommand (U"Objects", U"Preferences", U"Text writing preferences...", nullptr, 0, PREFS_TextOutputEncodingSettings);
 	praat_addMenuCommand (U"Objects", U"Preferences", U"CJK font style preferences...", nullptr, 0, PREFS_GraphicsCjkFontStyleSettings);
+	praat_addMenuCommand (U"Objects", U"Preferences", U"-- multithreading prefs --", nullptr, 0, nullptr);
+	praat_addMenuCommand (U"Objects", U"Preferences", U"Multithreading preferences...", nullptr, 0, PREFS_MultithreadingSettings);
 
 	menuItem = praat_addMenuCommand (U"Objects", U"Praat", U"Technical", nullptr, praat_UNHIDABLE, nullptr);
 	technicalMenu = menuItem ? menuItem -> d_menu : nullptr;
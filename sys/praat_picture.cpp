@@ -746,10 +746,10 @@ DO
 	function -> nx = numberOfHorizontalSteps;
 	function -> x1 = fromX;
 	function -> dx = (toX - fromX) / (numberOfHorizontalSteps - 1);
-	Formula_compile (interpreter, function.get(), formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
+	autoFormulaProgram program = Formula_compile (interpreter, function.get(), formula, kFormula_EXPRESSION_TYPE_NUMERIC, true);
 	Formula_Result result;
 	for (integer i = 1; i <= numberOfHorizontalSteps; i ++) {
-		Formula_run (1, i, & result);
+		Formula_run (program.get(), 1, i, & result);
 		y [i] = result. numericResult;
 	}
 	GRAPHICS_NONE
@@ -23,6 +23,7 @@
 	#include <pwd.h>
 #endif
 #include "praatP.h"
+#include "MelderThread.h"
 
 static struct {
 	integer batchSessions, interactiveSessions;
@@ -163,6 +164,7 @@ void praat_reportSystemProperties () {
 		MelderInfo_writeLine (U"linux is \"" xstr (linux) "\".");
 	#endif
 	MelderInfo_writeLine (U"The number of processors is ", std::thread::hardware_concurrency(), U".");
+	MelderInfo_writeLine (U"The maximum number of analysis threads is ", MelderThread_getMaximumNumberOfThreads (), U".");
 	#ifdef macintosh
 		MelderInfo_writeLine (U"system version is ", Melder_systemVersion, U".");
 	#endif